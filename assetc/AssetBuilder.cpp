@@ -0,0 +1,489 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <libassets/asset/LevelMaterialAsset.h>
+#include <libassets/asset/ModelAsset.h>
+#include <libassets/asset/ShaderAsset.h>
+#include <libassets/asset/SoundAsset.h>
+#include <libassets/asset/TextureAsset.h>
+#include <libassets/type/Material.h>
+#include <libassets/type/StaticCollisionMesh.h>
+#include <libassets/util/BlockCompressor.h>
+#include <libassets/util/BuildCache.h>
+#include <libassets/util/Checksum.h>
+#include <libassets/util/ConvexDecomposition.h>
+#include <libassets/util/Error.h>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "AssetBuilder.h"
+#include "AssetManifest.h"
+
+namespace
+{
+    constexpr std::array<std::pair<const char *, TextureAsset::PixelFormat>, 6> COMPRESSED_FORMATS = {
+        std::pair{"bc1", TextureAsset::PixelFormat::BC1},
+        std::pair{"bc3", TextureAsset::PixelFormat::BC3},
+        std::pair{"bc4", TextureAsset::PixelFormat::BC4},
+        std::pair{"bc5", TextureAsset::PixelFormat::BC5},
+        std::pair{"bc7", TextureAsset::PixelFormat::BC7},
+        std::pair{"bc6h", TextureAsset::PixelFormat::BC6H},
+    };
+
+    constexpr std::array<std::pair<const char *, BlockCompressor::Quality>, 3> COMPRESSION_QUALITIES = {
+        std::pair{"fast", BlockCompressor::Quality::FAST},
+        std::pair{"normal", BlockCompressor::Quality::NORMAL},
+        std::pair{"best", BlockCompressor::Quality::BEST},
+    };
+
+    constexpr std::array<std::pair<const char *, Material::MaterialShader>, 3> MATERIAL_SHADERS = {
+        std::pair{"sky", Material::MaterialShader::SHADER_SKY},
+        std::pair{"unshaded", Material::MaterialShader::SHADER_UNSHADED},
+        std::pair{"shaded", Material::MaterialShader::SHADER_SHADED},
+    };
+
+    constexpr std::array<std::pair<const char *, ShaderAsset::ShaderKind>, 4> SHADER_KINDS = {
+        std::pair{"fragment", ShaderAsset::ShaderKind::SHADER_KIND_FRAGMENT},
+        std::pair{"vertex", ShaderAsset::ShaderKind::SHADER_KIND_VERTEX},
+        std::pair{"compute", ShaderAsset::ShaderKind::SHADER_KIND_COMPUTE},
+        std::pair{"geometry", ShaderAsset::ShaderKind::SHADER_KIND_GEOMETRY},
+    };
+
+    /// Look up a name in one of the tables above
+    template<typename T, size_t N>
+    bool FindByName(const std::array<std::pair<const char *, T>, N> &table, const std::string &name, T &outValue)
+    {
+        for (const auto &[entryName, value]: table)
+        {
+            if (name == entryName)
+            {
+                outValue = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Material::MaterialShader GetMaterialShader(const nlohmann::json &options,
+                                               std::string &errorMessage,
+                                               bool &valid)
+    {
+        Material::MaterialShader shader = Material::MaterialShader::SHADER_SHADED;
+        const std::string name = options.value("shader", "shaded");
+        if (!FindByName(MATERIAL_SHADERS, name, shader))
+        {
+            errorMessage = std::format("unknown shader \"{}\"", name);
+            valid = false;
+        }
+        return shader;
+    }
+} // namespace
+
+std::vector<std::string> AssetBuilder::GetInputs(const AssetManifest::Entry &entry)
+{
+    std::vector<std::string> inputs{};
+    if (!entry.sourcePath.empty())
+    {
+        inputs.push_back(entry.sourcePath);
+    }
+    switch (entry.kind)
+    {
+        case AssetManifest::AssetKind::MODEL:
+            for (const nlohmann::json &lod: entry.options.value("lods", nlohmann::json::array()))
+            {
+                inputs.push_back(GetSourcePath(entry, lod.value("source", "")));
+            }
+            if (entry.options.contains("collision") && entry.options.at("collision").contains("source"))
+            {
+                inputs.push_back(GetSourcePath(entry, entry.options.at("collision").value("source", "")));
+            }
+            break;
+        case AssetManifest::AssetKind::SHADER:
+            AddShaderIncludes(entry.sourcePath, inputs);
+            break;
+        default:
+            break;
+    }
+    return inputs;
+}
+
+uint64_t AssetBuilder::GetOptionsHash(const AssetManifest::Entry &entry)
+{
+    const std::string options = std::format("{}:{}", BUILD_VERSION, entry.options.dump());
+    return Checksum::Hash64(reinterpret_cast<const uint8_t *>(options.data()), options.size());
+}
+
+bool AssetBuilder::GetCacheKey(const AssetManifest::Entry &entry,
+                               const std::vector<std::string> &inputs,
+                               uint64_t &outKey)
+{
+    BuildCache::KeyBuilder key{};
+    key.AddString(std::format("assetc:{}:{}", BUILD_VERSION, AssetManifest::GetKindName(entry.kind)));
+    // The output name doesn't change the output, so the same source built to another path still hits the cache
+    nlohmann::json options = entry.options;
+    options.erase("output");
+    key.AddString(options.dump());
+    for (const std::string &input: inputs)
+    {
+        if (!key.AddFile(input))
+        {
+            return false;
+        }
+    }
+    outKey = key.GetKey();
+    return true;
+}
+
+Error::ErrorCode AssetBuilder::Build(const AssetManifest::Entry &entry, std::string &errorMessage)
+{
+    std::error_code error{};
+    std::filesystem::create_directories(std::filesystem::path(entry.outputPath).parent_path(), error);
+    if (error)
+    {
+        errorMessage = std::format("can't create the output folder: {}", error.message());
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+
+    // Build next to the real output and rename over it, so an output is either the old or the new version
+    const std::string temporaryPath = entry.outputPath + ".tmp";
+    Error::ErrorCode e = Error::ErrorCode::UNKNOWN;
+    switch (entry.kind)
+    {
+        case AssetManifest::AssetKind::TEXTURE:
+            e = BuildTexture(entry, temporaryPath, errorMessage);
+            break;
+        case AssetManifest::AssetKind::MODEL:
+            e = BuildModel(entry, temporaryPath, errorMessage);
+            break;
+        case AssetManifest::AssetKind::SOUND:
+            e = BuildSound(entry, temporaryPath, errorMessage);
+            break;
+        case AssetManifest::AssetKind::SHADER:
+            e = BuildShader(entry, temporaryPath, errorMessage);
+            break;
+        case AssetManifest::AssetKind::MATERIAL:
+            e = BuildMaterial(entry, temporaryPath, errorMessage);
+            break;
+    }
+    if (e != Error::ErrorCode::OK)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return e;
+    }
+    std::filesystem::rename(temporaryPath, entry.outputPath, error);
+    if (error)
+    {
+        errorMessage = std::format("can't replace the output: {}", error.message());
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    return Error::ErrorCode::OK;
+}
+
+Error::ErrorCode AssetBuilder::BuildTexture(const AssetManifest::Entry &entry,
+                                            const std::string &outputPath,
+                                            std::string &errorMessage)
+{
+    TextureAsset texture{};
+    Error::ErrorCode e = texture.Import(entry.sourcePath);
+    if (e != Error::ErrorCode::OK)
+    {
+        errorMessage = std::format("can't import {}", entry.sourcePath);
+        return e;
+    }
+    texture.filter = entry.options.value("filter", texture.filter);
+    texture.repeat = entry.options.value("repeat", texture.repeat);
+    texture.mipmaps = entry.options.value("mipmaps", texture.mipmaps);
+
+    const std::string formatName = entry.options.value("format", "");
+    if (!formatName.empty() && formatName != "rgba8" && formatName != "rgbaf16")
+    {
+        TextureAsset::PixelFormat format = TextureAsset::PixelFormat::RGBA8;
+        if (!FindByName(COMPRESSED_FORMATS, formatName, format))
+        {
+            errorMessage = std::format("unknown texture format \"{}\"", formatName);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        BlockCompressor::Quality quality = BlockCompressor::Quality::NORMAL;
+        const std::string qualityName = entry.options.value("quality", "normal");
+        if (!FindByName(COMPRESSION_QUALITIES, qualityName, quality))
+        {
+            errorMessage = std::format("unknown compression quality \"{}\"", qualityName);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        e = texture.Compress(format, quality);
+        if (e != Error::ErrorCode::OK)
+        {
+            errorMessage = std::format("can't compress to {}", formatName);
+            return e;
+        }
+    }
+    return texture.SaveToAsset(outputPath);
+}
+
+Error::ErrorCode AssetBuilder::BuildModel(const AssetManifest::Entry &entry,
+                                          const std::string &outputPath,
+                                          std::string &errorMessage)
+{
+    ModelAsset model{};
+    if (entry.options.contains("weld"))
+    {
+        const nlohmann::json &weld = entry.options.at("weld");
+        model.weldTolerances.position = weld.value("position", model.weldTolerances.position);
+        model.weldTolerances.normal = weld.value("normal", model.weldTolerances.normal);
+        model.weldTolerances.uv = weld.value("uv", model.weldTolerances.uv);
+        model.weldTolerances.color = weld.value("color", model.weldTolerances.color);
+    }
+    if (entry.options.value("quantize", false))
+    {
+        model.vertexFormat = ModelAsset::VertexFormat::QUANTIZED;
+    }
+    Error::ErrorCode e = model.Import(entry.sourcePath);
+    if (e != Error::ErrorCode::OK)
+    {
+        errorMessage = std::format("can't import {}", entry.sourcePath);
+        return e;
+    }
+
+    const bool generateLods = entry.options.contains("generateLods");
+    if (generateLods)
+    {
+        std::vector<ModelAsset::LodGenerationStep> steps{};
+        for (const nlohmann::json &step: entry.options.at("generateLods"))
+        {
+            ModelAsset::LodGenerationStep &added = steps.emplace_back();
+            added.ratio = step.value("ratio", added.ratio);
+            added.maxError = step.value("maxError", added.maxError);
+        }
+        model.GenerateLods(steps);
+    }
+    // Generated LODs take the place of LOD files
+    const nlohmann::json lods = generateLods ? nlohmann::json::array()
+                                             : entry.options.value("lods", nlohmann::json::array());
+    std::vector<std::string> lodPaths{};
+    for (const nlohmann::json &lod: lods)
+    {
+        lodPaths.push_back(GetSourcePath(entry, lod.value("source", "")));
+    }
+    if (!lodPaths.empty() && !model.AddLods(lodPaths))
+    {
+        errorMessage = "can't add LODs, they may have a different number of materials";
+        return Error::ErrorCode::INVALID_BODY;
+    }
+    for (size_t i = 0; i < lods.size(); i++)
+    {
+        // LOD 0 is the source, added LODs follow it in manifest order
+        ModelLod &added = model.GetLod(i + 1);
+        added.distance = lods.at(i).value("distance", added.distance);
+    }
+    if (!model.ValidateLodDistances())
+    {
+        errorMessage = "LODs need unique distances, and the first must be 0";
+        return Error::ErrorCode::INVALID_BODY;
+    }
+
+    if (entry.options.contains("materials"))
+    {
+        bool valid = true;
+        for (const nlohmann::json &material: entry.options.at("materials"))
+        {
+            const Material::MaterialShader shader = GetMaterialShader(material, errorMessage, valid);
+            model.AddMaterial(Material(material.value("texture", ""), material.value("color", -1u), shader));
+        }
+        if (!valid)
+        {
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        // Replace the default material that Import created
+        if (model.GetMaterialCount() > 1)
+        {
+            model.RemoveMaterial(0);
+        }
+    }
+    if (entry.options.contains("skins"))
+    {
+        const nlohmann::json &skins = entry.options.at("skins");
+        while (model.GetSkinCount() < skins.size())
+        {
+            model.AddSkin();
+        }
+        for (size_t i = 0; i < skins.size(); i++)
+        {
+            std::vector<uint32_t> &skin = model.GetSkin(i);
+            for (size_t slot = 0; slot < skin.size() && slot < skins.at(i).size(); slot++)
+            {
+                skin.at(slot) = std::min(skins.at(i).at(slot).get<uint32_t>(), model.GetMaterialCount() - 1);
+            }
+        }
+    }
+
+    if (entry.options.contains("collision"))
+    {
+        const nlohmann::json &collision = entry.options.at("collision");
+        const std::string type = collision.value("type", "none");
+        const std::string collisionPath = GetSourcePath(entry, collision.value("source", ""));
+        if (type == "static")
+        {
+            const StaticCollisionMesh mesh(collisionPath, e);
+            if (e != Error::ErrorCode::OK)
+            {
+                errorMessage = std::format("can't import collision mesh {}", collisionPath);
+                return e;
+            }
+            model.SetStaticCollisionMesh(mesh);
+            model.GetCollisionModelType() = ModelAsset::CollisionModelType::STATIC_SINGLE_CONCAVE;
+        } else if (type == "convex")
+        {
+            e = model.AddHulls(collisionPath);
+            if (e != Error::ErrorCode::OK)
+            {
+                errorMessage = std::format("can't import convex hulls {}", collisionPath);
+                return e;
+            }
+            model.GetCollisionModelType() = ModelAsset::CollisionModelType::DYNAMIC_MULTIPLE_CONVEX;
+        } else if (type == "decompose")
+        {
+            ConvexDecomposition::Parameters parameters{};
+            parameters.maxHulls = collision.value("maxHulls", parameters.maxHulls);
+            parameters.maxConcavity = collision.value("maxConcavity", parameters.maxConcavity);
+            parameters.maxVerticesPerHull = collision.value("maxVerticesPerHull", parameters.maxVerticesPerHull);
+            parameters.resolution = collision.value("resolution", parameters.resolution);
+            if (model.GenerateHulls(parameters) == 0)
+            {
+                errorMessage = "can't decompose the model into convex hulls";
+                return Error::ErrorCode::INVALID_BODY;
+            }
+            model.GetCollisionModelType() = ModelAsset::CollisionModelType::DYNAMIC_MULTIPLE_CONVEX;
+        } else if (type != "none")
+        {
+            errorMessage = std::format("unknown collision type \"{}\"", type);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+    }
+    return model.SaveToAsset(outputPath);
+}
+
+Error::ErrorCode AssetBuilder::BuildSound(const AssetManifest::Entry &entry,
+                                          const std::string &outputPath,
+                                          std::string &errorMessage)
+{
+    SoundAsset sound{};
+    const Error::ErrorCode e = sound.Import(entry.sourcePath);
+    if (e != Error::ErrorCode::OK)
+    {
+        errorMessage = std::format("can't import {}", entry.sourcePath);
+        return e;
+    }
+    return sound.SaveToAsset(outputPath);
+}
+
+Error::ErrorCode AssetBuilder::BuildShader(const AssetManifest::Entry &entry,
+                                           const std::string &outputPath,
+                                           std::string &errorMessage)
+{
+    ShaderAsset shader{};
+    Error::ErrorCode e = shader.Import(entry.sourcePath);
+    if (e != Error::ErrorCode::OK)
+    {
+        errorMessage = std::format("can't import {}", entry.sourcePath);
+        return e;
+    }
+
+    if (entry.options.contains("kind"))
+    {
+        const std::string kindName = entry.options.value("kind", "");
+        if (!FindByName(SHADER_KINDS, kindName, shader.kind))
+        {
+            errorMessage = std::format("unknown shader kind \"{}\"", kindName);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+    } else if (entry.sourcePath.ends_with(".vert") || entry.sourcePath.ends_with("_v.glsl"))
+    {
+        shader.kind = ShaderAsset::ShaderKind::SHADER_KIND_VERTEX;
+    } else if (entry.sourcePath.ends_with(".comp") || entry.sourcePath.ends_with("_c.glsl"))
+    {
+        shader.kind = ShaderAsset::ShaderKind::SHADER_KIND_COMPUTE;
+    } else if (entry.sourcePath.ends_with(".geom") || entry.sourcePath.ends_with("_g.glsl"))
+    {
+        shader.kind = ShaderAsset::ShaderKind::SHADER_KIND_GEOMETRY;
+    }
+
+    // The source path is passed as the file name so that includes resolve relative to it
+    e = shader.SaveToAssetEx(outputPath, entry.options.value("optimize", true), &errorMessage, entry.sourcePath);
+    return e;
+}
+
+Error::ErrorCode AssetBuilder::BuildMaterial(const AssetManifest::Entry &entry,
+                                             const std::string &outputPath,
+                                             std::string &errorMessage)
+{
+    LevelMaterialAsset material{};
+    bool valid = true;
+    material.texture = entry.options.value("texture", "");
+    material.shader = GetMaterialShader(entry.options, errorMessage, valid);
+    if (!valid)
+    {
+        return Error::ErrorCode::INVALID_BODY;
+    }
+    if (entry.options.contains("baseScale"))
+    {
+        const nlohmann::json &baseScale = entry.options.at("baseScale");
+        if (!baseScale.is_array() || baseScale.size() != 2)
+        {
+            errorMessage = "baseScale must be an array of 2 numbers";
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        material.baseScale = {baseScale.at(0).get<float>(), baseScale.at(1).get<float>()};
+    }
+    material.compileInvisible = entry.options.value("compileInvisible", false);
+    material.compileNoClip = entry.options.value("compileNoClip", false);
+    material.emissive = entry.options.value("emissive", 0.0f);
+    return material.SaveToAsset(outputPath);
+}
+
+void AssetBuilder::AddShaderIncludes(const std::string &sourcePath, std::vector<std::string> &inputs)
+{
+    std::ifstream file(sourcePath);
+    if (!file.is_open())
+    {
+        return;
+    }
+    const std::filesystem::path directory = std::filesystem::path(sourcePath).parent_path();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const size_t directive = line.find_first_not_of(" \t");
+        if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0)
+        {
+            continue;
+        }
+        const size_t start = line.find('"', directive);
+        const size_t end = start == std::string::npos ? std::string::npos : line.find('"', start + 1);
+        if (end == std::string::npos)
+        {
+            continue;
+        }
+        const std::string includePath = (directory / line.substr(start + 1, end - start - 1))
+                                                .lexically_normal()
+                                                .string();
+        if (std::ranges::find(inputs, includePath) == inputs.end())
+        {
+            inputs.push_back(includePath);
+            AddShaderIncludes(includePath, inputs);
+        }
+    }
+}
+
+std::string AssetBuilder::GetSourcePath(const AssetManifest::Entry &entry, const std::string &path)
+{
+    return (std::filesystem::path(entry.sourceDirectory) / path).lexically_normal().string();
+}
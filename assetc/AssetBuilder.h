@@ -0,0 +1,84 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <libassets/util/Error.h>
+#include <string>
+#include <vector>
+#include "AssetManifest.h"
+
+/**
+ * Converts the entries of an asset manifest into compiled assets
+ */
+class AssetBuilder
+{
+    public:
+        /// Bump to rebuild every asset after a change to how assets are built
+        static constexpr uint32_t BUILD_VERSION = 3;
+
+        /**
+         * Get every file an entry is built from, including extra LOD and collision models and included shader files
+         */
+        [[nodiscard]] static std::vector<std::string> GetInputs(const AssetManifest::Entry &entry);
+
+        /**
+         * Get a hash of the import options of an entry and the build version
+         */
+        [[nodiscard]] static uint64_t GetOptionsHash(const AssetManifest::Entry &entry);
+
+        /**
+         * Get the build cache key of an entry, from the contents of its inputs, its options and the build version
+         * @param entry The entry
+         * @param inputs The inputs of the entry from GetInputs()
+         * @param outKey Where to store the key
+         * @return False if an input can't be read, in which case the entry can't be cached
+         */
+        [[nodiscard]] static bool GetCacheKey(const AssetManifest::Entry &entry,
+                                              const std::vector<std::string> &inputs,
+                                              uint64_t &outKey);
+
+        /**
+         * Build an entry. The output is written to a temporary file first, so a failed build never leaves a partial
+         * output behind. Safe to call from several threads for different entries.
+         * @param entry The entry to build
+         * @param errorMessage Where to store a description of the problem if the build fails
+         * @return Error code
+         */
+        [[nodiscard]] static Error::ErrorCode Build(const AssetManifest::Entry &entry, std::string &errorMessage);
+
+    private:
+        [[nodiscard]] static Error::ErrorCode BuildTexture(const AssetManifest::Entry &entry,
+                                                           const std::string &outputPath,
+                                                           std::string &errorMessage);
+
+        [[nodiscard]] static Error::ErrorCode BuildModel(const AssetManifest::Entry &entry,
+                                                         const std::string &outputPath,
+                                                         std::string &errorMessage);
+
+        [[nodiscard]] static Error::ErrorCode BuildSound(const AssetManifest::Entry &entry,
+                                                         const std::string &outputPath,
+                                                         std::string &errorMessage);
+
+        [[nodiscard]] static Error::ErrorCode BuildShader(const AssetManifest::Entry &entry,
+                                                          const std::string &outputPath,
+                                                          std::string &errorMessage);
+
+        [[nodiscard]] static Error::ErrorCode BuildMaterial(const AssetManifest::Entry &entry,
+                                                            const std::string &outputPath,
+                                                            std::string &errorMessage);
+
+        /**
+         * Add the files a GLSL source includes with @c #include "file", recursively
+         * @param sourcePath The GLSL source to scan
+         * @param inputs The list to add to. Files already in it are not scanned again.
+         */
+        static void AddShaderIncludes(const std::string &sourcePath, std::vector<std::string> &inputs);
+
+        /**
+         * Resolve a path from the manifest relative to the entry's manifest
+         */
+        [[nodiscard]] static std::string GetSourcePath(const AssetManifest::Entry &entry, const std::string &path);
+};
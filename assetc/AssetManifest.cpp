@@ -0,0 +1,352 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
+#include <nlohmann/json.hpp>
+#include <span>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "AssetManifest.h"
+
+namespace
+{
+    constexpr std::array<AssetManifest::AssetKind, 5> ASSET_KINDS = {
+        AssetManifest::AssetKind::TEXTURE,
+        AssetManifest::AssetKind::MODEL,
+        AssetManifest::AssetKind::SOUND,
+        AssetManifest::AssetKind::SHADER,
+        AssetManifest::AssetKind::MATERIAL,
+    };
+
+    enum class OptionType : uint8_t
+    {
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        OBJECT,
+        ARRAY,
+    };
+
+    /// The type a key must have, if it is present
+    struct OptionRule
+    {
+            const char *key;
+            OptionType type;
+    };
+
+    constexpr std::array<OptionRule, 3> COMMON_OPTIONS = {
+        OptionRule{"type", OptionType::STRING},
+        OptionRule{"output", OptionType::STRING},
+        OptionRule{"source", OptionType::STRING},
+    };
+    constexpr std::array<OptionRule, 5> TEXTURE_OPTIONS = {
+        OptionRule{"filter", OptionType::BOOLEAN},
+        OptionRule{"repeat", OptionType::BOOLEAN},
+        OptionRule{"mipmaps", OptionType::BOOLEAN},
+        OptionRule{"format", OptionType::STRING},
+        OptionRule{"quality", OptionType::STRING},
+    };
+    constexpr std::array<OptionRule, 7> MODEL_OPTIONS = {
+        OptionRule{"weld", OptionType::OBJECT},
+        OptionRule{"quantize", OptionType::BOOLEAN},
+        OptionRule{"generateLods", OptionType::ARRAY},
+        OptionRule{"lods", OptionType::ARRAY},
+        OptionRule{"materials", OptionType::ARRAY},
+        OptionRule{"skins", OptionType::ARRAY},
+        OptionRule{"collision", OptionType::OBJECT},
+    };
+    constexpr std::array<OptionRule, 4> WELD_OPTIONS = {
+        OptionRule{"position", OptionType::NUMBER},
+        OptionRule{"normal", OptionType::NUMBER},
+        OptionRule{"uv", OptionType::NUMBER},
+        OptionRule{"color", OptionType::NUMBER},
+    };
+    constexpr std::array<OptionRule, 2> LOD_GENERATION_OPTIONS = {
+        OptionRule{"ratio", OptionType::NUMBER},
+        OptionRule{"maxError", OptionType::NUMBER},
+    };
+    constexpr std::array<OptionRule, 2> LOD_OPTIONS = {
+        OptionRule{"source", OptionType::STRING},
+        OptionRule{"distance", OptionType::NUMBER},
+    };
+    constexpr std::array<OptionRule, 3> MODEL_MATERIAL_OPTIONS = {
+        OptionRule{"texture", OptionType::STRING},
+        OptionRule{"color", OptionType::NUMBER},
+        OptionRule{"shader", OptionType::STRING},
+    };
+    constexpr std::array<OptionRule, 6> COLLISION_OPTIONS = {
+        OptionRule{"type", OptionType::STRING},
+        OptionRule{"source", OptionType::STRING},
+        OptionRule{"maxHulls", OptionType::NUMBER},
+        OptionRule{"maxConcavity", OptionType::NUMBER},
+        OptionRule{"maxVerticesPerHull", OptionType::NUMBER},
+        OptionRule{"resolution", OptionType::NUMBER},
+    };
+    constexpr std::array<OptionRule, 2> SHADER_OPTIONS = {
+        OptionRule{"kind", OptionType::STRING},
+        OptionRule{"optimize", OptionType::BOOLEAN},
+    };
+    constexpr std::array<OptionRule, 6> MATERIAL_OPTIONS = {
+        OptionRule{"texture", OptionType::STRING},
+        OptionRule{"shader", OptionType::STRING},
+        OptionRule{"baseScale", OptionType::ARRAY},
+        OptionRule{"compileInvisible", OptionType::BOOLEAN},
+        OptionRule{"compileNoClip", OptionType::BOOLEAN},
+        OptionRule{"emissive", OptionType::NUMBER},
+    };
+
+    bool HasType(const nlohmann::json &value, const OptionType type)
+    {
+        switch (type)
+        {
+            case OptionType::BOOLEAN:
+                return value.is_boolean();
+            case OptionType::NUMBER:
+                return value.is_number();
+            case OptionType::STRING:
+                return value.is_string();
+            case OptionType::OBJECT:
+                return value.is_object();
+            case OptionType::ARRAY:
+                return value.is_array();
+        }
+        return false;
+    }
+
+    const char *GetTypeName(const OptionType type)
+    {
+        switch (type)
+        {
+            case OptionType::BOOLEAN:
+                return "a boolean";
+            case OptionType::NUMBER:
+                return "a number";
+            case OptionType::STRING:
+                return "a string";
+            case OptionType::OBJECT:
+                return "an object";
+            case OptionType::ARRAY:
+                return "an array";
+        }
+        return "unknown";
+    }
+
+    /// Check the keys of an object that are present against rules, and describe the first one that is wrong
+    bool CheckOptions(const nlohmann::json &object,
+                      const std::span<const OptionRule> rules,
+                      const std::string &context,
+                      std::string &outError)
+    {
+        if (!object.is_object())
+        {
+            outError = std::format("{} must be an object", context);
+            return false;
+        }
+        for (const OptionRule &rule: rules)
+        {
+            if (object.contains(rule.key) && !HasType(object.at(rule.key), rule.type))
+            {
+                outError = std::format("{}{} must be {}", context, rule.key, GetTypeName(rule.type));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Check every element of an array option, if it is present
+    bool CheckArrayElements(const nlohmann::json &object,
+                            const char *key,
+                            const std::span<const OptionRule> rules,
+                            std::string &outError)
+    {
+        if (!object.contains(key))
+        {
+            return true;
+        }
+        const nlohmann::json &array = object.at(key);
+        for (size_t i = 0; i < array.size(); i++)
+        {
+            if (!CheckOptions(array.at(i), rules, std::format("{}[{}].", key, i), outError))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Check that an array only holds numbers
+    bool CheckNumberArray(const nlohmann::json &array, const std::string &context, std::string &outError)
+    {
+        for (const nlohmann::json &element: array)
+        {
+            if (!element.is_number())
+            {
+                outError = std::format("{} must only hold numbers", context);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Check that the options the builder reads have the types it reads them as
+    bool CheckEntryOptions(const nlohmann::json &asset, const AssetManifest::AssetKind kind, std::string &outError)
+    {
+        switch (kind)
+        {
+            case AssetManifest::AssetKind::TEXTURE:
+                return CheckOptions(asset, TEXTURE_OPTIONS, "", outError);
+            case AssetManifest::AssetKind::MODEL:
+                if (!CheckOptions(asset, MODEL_OPTIONS, "", outError) ||
+                    (asset.contains("weld") && !CheckOptions(asset.at("weld"), WELD_OPTIONS, "weld.", outError)) ||
+                    (asset.contains("collision") &&
+                     !CheckOptions(asset.at("collision"), COLLISION_OPTIONS, "collision.", outError)) ||
+                    !CheckArrayElements(asset, "generateLods", LOD_GENERATION_OPTIONS, outError) ||
+                    !CheckArrayElements(asset, "lods", LOD_OPTIONS, outError) ||
+                    !CheckArrayElements(asset, "materials", MODEL_MATERIAL_OPTIONS, outError))
+                {
+                    return false;
+                }
+                if (asset.contains("skins"))
+                {
+                    const nlohmann::json &skins = asset.at("skins");
+                    for (size_t i = 0; i < skins.size(); i++)
+                    {
+                        if (!skins.at(i).is_array() || !CheckNumberArray(skins.at(i), "", outError))
+                        {
+                            outError = std::format("skins[{}] must be an array of material indices", i);
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            case AssetManifest::AssetKind::SHADER:
+                return CheckOptions(asset, SHADER_OPTIONS, "", outError);
+            case AssetManifest::AssetKind::MATERIAL:
+                return CheckOptions(asset, MATERIAL_OPTIONS, "", outError) &&
+                       (!asset.contains("baseScale") || CheckNumberArray(asset.at("baseScale"), "baseScale", outError));
+            case AssetManifest::AssetKind::SOUND:
+                return true;
+        }
+        return true;
+    }
+} // namespace
+
+Error::ErrorCode AssetManifest::Load(const std::string &manifestPath, const std::string &outputDirectory)
+{
+    std::ifstream file(manifestPath);
+    if (!file.is_open())
+    {
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    file.close();
+    const nlohmann::json json = nlohmann::json::parse(ss.str(), nullptr, false);
+    if (json.is_discarded() || !json.is_object() || !json.contains("assets") || !json.at("assets").is_array())
+    {
+        Logger::Error("{} is not a valid asset manifest", manifestPath);
+        return Error::ErrorCode::INCORRECT_FORMAT;
+    }
+
+    const std::filesystem::path sourceDirectory = std::filesystem::absolute(manifestPath).parent_path();
+    std::unordered_set<std::string> outputNames{};
+    for (const Entry &entry: entries)
+    {
+        outputNames.insert(entry.outputName);
+    }
+
+    const nlohmann::json &assets = json.at("assets");
+    for (size_t i = 0; i < assets.size(); i++)
+    {
+        const nlohmann::json &asset = assets.at(i);
+        if (!asset.is_object() || !asset.contains("type") || !asset.contains("output"))
+        {
+            Logger::Error("{}: asset {} needs a type and an output", manifestPath, i);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        std::string optionError{};
+        if (!CheckOptions(asset, COMMON_OPTIONS, "", optionError))
+        {
+            Logger::Error("{}: asset {}: {}", manifestPath, i, optionError);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+
+        Entry entry{
+            .outputName = asset.value("output", ""),
+            .sourceDirectory = sourceDirectory.string(),
+            .options = asset,
+        };
+        const std::string type = asset.value("type", "");
+        bool knownType = false;
+        for (const AssetKind kind: ASSET_KINDS)
+        {
+            if (type == GetKindName(kind))
+            {
+                entry.kind = kind;
+                knownType = true;
+            }
+        }
+        if (!knownType)
+        {
+            Logger::Error("{}: asset {} has unknown type \"{}\"", manifestPath, i, type);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        // The builder reads options on worker threads, where a wrong type would take the whole build down
+        if (!CheckEntryOptions(asset, entry.kind, optionError))
+        {
+            Logger::Error("{}: asset {} ({}): {}", manifestPath, i, entry.outputName, optionError);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+
+        if (entry.kind != AssetKind::MATERIAL)
+        {
+            if (!asset.contains("source"))
+            {
+                Logger::Error("{}: asset {} needs a source", manifestPath, i);
+                return Error::ErrorCode::INVALID_BODY;
+            }
+            entry.sourcePath = (sourceDirectory / asset.value("source", "")).lexically_normal().string();
+        }
+        if (!outputNames.insert(entry.outputName).second)
+        {
+            Logger::Error("{}: more than one asset writes to {}", manifestPath, entry.outputName);
+            return Error::ErrorCode::INVALID_BODY;
+        }
+        entry.outputPath = (std::filesystem::path(outputDirectory) / entry.outputName).lexically_normal().string();
+        entries.push_back(entry);
+    }
+    return Error::ErrorCode::OK;
+}
+
+const std::vector<AssetManifest::Entry> &AssetManifest::GetEntries() const
+{
+    return entries;
+}
+
+const char *AssetManifest::GetKindName(const AssetKind kind)
+{
+    switch (kind)
+    {
+        case AssetKind::TEXTURE:
+            return "texture";
+        case AssetKind::MODEL:
+            return "model";
+        case AssetKind::SOUND:
+            return "sound";
+        case AssetKind::SHADER:
+            return "shader";
+        case AssetKind::MATERIAL:
+            return "material";
+    }
+    return "unknown";
+}
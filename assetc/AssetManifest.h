@@ -0,0 +1,63 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <libassets/util/Error.h>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * A list of assets to build, read from one or more JSON manifests.
+ * Each manifest has an "assets" array. Every entry names its "type", an "output" path relative to the output
+ * directory and (except for materials) a "source" path relative to the manifest. Any other keys are import options,
+ * whose types are checked when the manifest is loaded.
+ */
+class AssetManifest
+{
+    public:
+        enum class AssetKind : uint8_t
+        {
+            TEXTURE,
+            MODEL,
+            SOUND,
+            SHADER,
+            MATERIAL,
+        };
+
+        struct Entry
+        {
+                AssetKind kind;
+                /// The output path as written in the manifest, used to identify the asset
+                std::string outputName;
+                /// The path of the file to write
+                std::string outputPath;
+                /// The path of the main source file, empty for materials
+                std::string sourcePath;
+                /// The directory the entry's source paths are relative to
+                std::string sourceDirectory;
+                /// The manifest entry, which holds the import options
+                nlohmann::json options;
+        };
+
+        /**
+         * Add the assets of a manifest
+         * @param manifestPath The path to the manifest JSON
+         * @param outputDirectory The directory output paths are relative to
+         * @return Error code
+         */
+        [[nodiscard]] Error::ErrorCode Load(const std::string &manifestPath, const std::string &outputDirectory);
+
+        [[nodiscard]] const std::vector<Entry> &GetEntries() const;
+
+        /**
+         * Get the name of an asset kind as written in manifests
+         */
+        [[nodiscard]] static const char *GetKindName(AssetKind kind);
+
+    private:
+        std::vector<Entry> entries{};
+};
@@ -0,0 +1,199 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <libassets/util/Checksum.h>
+#include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "BuildState.h"
+
+Error::ErrorCode BuildState::Load(const std::string &statePath)
+{
+    std::ifstream file(statePath);
+    if (!file.is_open())
+    {
+        return Error::ErrorCode::OK;
+    }
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    file.close();
+    const nlohmann::json json = nlohmann::json::parse(ss.str(), nullptr, false);
+    if (json.is_discarded() || !json.is_object() || json.value("version", 0) != STATE_VERSION)
+    {
+        Logger::Warning("Ignoring unreadable build state {}, everything will be rebuilt", statePath);
+        return Error::ErrorCode::OK;
+    }
+
+    const std::lock_guard lock(mutex);
+    outputs.clear();
+    for (const auto &[outputPath, jsonOutput]: json.value("outputs", nlohmann::json::object()).items())
+    {
+        OutputRecord &output = outputs[outputPath];
+        output.optionsHash = jsonOutput.value("optionsHash", uint64_t{0});
+        output.outputTime = jsonOutput.value("outputTime", int64_t{0});
+        for (const nlohmann::json &jsonInput: jsonOutput.value("inputs", nlohmann::json::array()))
+        {
+            output.inputs.push_back({
+                .path = jsonInput.value("path", ""),
+                .time = jsonInput.value("time", int64_t{0}),
+                .size = jsonInput.value("size", uintmax_t{0}),
+                .hash = jsonInput.value("hash", uint64_t{0}),
+            });
+        }
+    }
+    return Error::ErrorCode::OK;
+}
+
+Error::ErrorCode BuildState::Save(const std::string &statePath) const
+{
+    nlohmann::json jsonOutputs = nlohmann::json::object();
+    {
+        const std::lock_guard lock(mutex);
+        for (const auto &[outputPath, output]: outputs)
+        {
+            nlohmann::json jsonInputs = nlohmann::json::array();
+            for (const InputRecord &input: output.inputs)
+            {
+                jsonInputs.push_back({
+                    {"path", input.path},
+                    {"time", input.time},
+                    {"size", input.size},
+                    {"hash", input.hash},
+                });
+            }
+            jsonOutputs[outputPath] = {
+                {"optionsHash", output.optionsHash},
+                {"outputTime", output.outputTime},
+                {"inputs", jsonInputs},
+            };
+        }
+    }
+    const nlohmann::json json = {
+        {"version", STATE_VERSION},
+        {"outputs", jsonOutputs},
+    };
+
+    // Write next to the real file and rename over it, so an interrupted build never leaves a truncated state
+    const std::string temporaryPath = statePath + ".tmp";
+    std::ofstream file(temporaryPath);
+    if (!file)
+    {
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    file << json.dump();
+    file.close();
+    std::error_code error{};
+    std::filesystem::rename(temporaryPath, statePath, error);
+    return error ? Error::ErrorCode::CANT_OPEN_FILE : Error::ErrorCode::OK;
+}
+
+bool BuildState::IsStale(const std::string &outputPath,
+                         const uint64_t optionsHash,
+                         const std::vector<std::string> &inputs,
+                         std::vector<InputRecord> &outSnapshot)
+{
+    outSnapshot.clear();
+    const std::lock_guard lock(mutex);
+    if (!outputs.contains(outputPath))
+    {
+        return true;
+    }
+    OutputRecord &output = outputs.at(outputPath);
+    if (output.optionsHash != optionsHash ||
+        output.inputs.size() != inputs.size() ||
+        output.outputTime != GetFileTime(outputPath))
+    {
+        return true;
+    }
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        InputRecord &input = output.inputs.at(i);
+        if (input.path != inputs.at(i))
+        {
+            return true;
+        }
+        if (GetFileTime(input.path) == input.time)
+        {
+            outSnapshot.push_back(input);
+            continue;
+        }
+        InputRecord current{};
+        if (!ReadInput(input.path, current))
+        {
+            return true;
+        }
+        outSnapshot.push_back(current);
+        if (current.size != input.size || current.hash != input.hash)
+        {
+            return true;
+        }
+        // Same contents with a new time, remember the time so the file isn't hashed again next build
+        input.time = current.time;
+    }
+    return false;
+}
+
+bool BuildState::SnapshotInputs(const std::vector<std::string> &inputs, std::vector<InputRecord> &snapshot)
+{
+    for (size_t i = snapshot.size(); i < inputs.size(); i++)
+    {
+        InputRecord &input = snapshot.emplace_back();
+        if (!ReadInput(inputs.at(i), input))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BuildState::Record(const std::string &outputPath,
+                        const uint64_t optionsHash,
+                        const std::vector<InputRecord> &inputs)
+{
+    const OutputRecord output{
+        .optionsHash = optionsHash,
+        .outputTime = GetFileTime(outputPath),
+        .inputs = inputs,
+    };
+    const std::lock_guard lock(mutex);
+    outputs[outputPath] = output;
+}
+
+bool BuildState::ReadInput(const std::string &path, InputRecord &outRecord)
+{
+    outRecord.path = path;
+    outRecord.time = GetFileTime(path);
+    std::error_code error{};
+    outRecord.size = std::filesystem::file_size(path, error);
+    return !error && HashFile(path, outRecord.hash);
+}
+
+bool BuildState::HashFile(const std::string &path, uint64_t &outHash)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    outHash = Checksum::Hash64(bytes.data(), bytes.size());
+    return true;
+}
+
+int64_t BuildState::GetFileTime(const std::string &path)
+{
+    std::error_code error{};
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
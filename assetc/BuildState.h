@@ -0,0 +1,100 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <libassets/util/Error.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Remembers what every output was last built from, so that only stale outputs are rebuilt.
+ * Like make, inputs are first compared by modification time and size. Unlike make, an input whose time changed is
+ * then hashed, so touching a file or checking out an identical copy of it doesn't cause a rebuild.
+ */
+class BuildState
+{
+    public:
+        struct InputRecord
+        {
+                std::string path;
+                int64_t time;
+                uintmax_t size;
+                uint64_t hash;
+        };
+
+        struct OutputRecord
+        {
+                /// Hash of the import options and build version the output was built with
+                uint64_t optionsHash;
+                int64_t outputTime;
+                std::vector<InputRecord> inputs;
+        };
+
+        /**
+         * Load the state saved by a previous build. A missing file is not an error.
+         */
+        [[nodiscard]] Error::ErrorCode Load(const std::string &statePath);
+
+        /**
+         * Save the state, replacing the previous file atomically
+         */
+        [[nodiscard]] Error::ErrorCode Save(const std::string &statePath) const;
+
+        /**
+         * Check if an output has to be rebuilt
+         * @param outputPath The output file
+         * @param optionsHash The hash of the options it would be built with
+         * @param inputs Every file it would be built from
+         * @param outSnapshot Where to store the records of the first inputs, as far as they were read. Pass it to
+         *                    SnapshotInputs() to read the rest.
+         */
+        [[nodiscard]] bool IsStale(const std::string &outputPath,
+                                   uint64_t optionsHash,
+                                   const std::vector<std::string> &inputs,
+                                   std::vector<InputRecord> &outSnapshot);
+
+        /**
+         * Read the time, size and hash of the inputs that are not in a snapshot yet. Call before building, so that
+         * an input changed during the build looks changed to the next build.
+         * @param inputs Every file the output is built from
+         * @param snapshot The records of the first inputs, from IsStale()
+         * @return False if an input can't be read
+         */
+        [[nodiscard]] static bool SnapshotInputs(const std::vector<std::string> &inputs,
+                                                 std::vector<InputRecord> &snapshot);
+
+        /**
+         * Record a successful build of an output. Safe to call from several threads.
+         * @param outputPath The output file
+         * @param optionsHash The hash of the options it was built with
+         * @param inputs The inputs as they were before the build, from SnapshotInputs()
+         */
+        void Record(const std::string &outputPath, uint64_t optionsHash, const std::vector<InputRecord> &inputs);
+
+        /**
+         * Get the hash of the contents of a file
+         * @return False if the file can't be read
+         */
+        [[nodiscard]] static bool HashFile(const std::string &path, uint64_t &outHash);
+
+        /**
+         * Get the modification time of a file, or 0 if it doesn't exist
+         */
+        [[nodiscard]] static int64_t GetFileTime(const std::string &path);
+
+    private:
+        static constexpr int STATE_VERSION = 1;
+
+        /**
+         * Read the record of an input. The time is read first, so a change while hashing makes the record stale.
+         */
+        [[nodiscard]] static bool ReadInput(const std::string &path, InputRecord &outRecord);
+
+        mutable std::mutex mutex{};
+        std::unordered_map<std::string, OutputRecord> outputs{};
+};
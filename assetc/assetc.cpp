@@ -0,0 +1,271 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <libassets/util/ArgumentParser.h>
+#include <libassets/util/BuildCache.h>
+#include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
+#include <libassets/util/ThreadPool.h>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "AssetBuilder.h"
+#include "AssetManifest.h"
+#include "BuildState.h"
+
+namespace
+{
+    /// An entry that has to be rebuilt
+    struct StaleEntry
+    {
+            const AssetManifest::Entry *entry;
+            uint64_t optionsHash;
+            std::vector<std::string> inputs;
+            /// The inputs as far as the up to date check read them
+            std::vector<BuildState::InputRecord> snapshot;
+    };
+} // namespace
+
+int main(const int argc, const char **argv)
+{
+    setvbuf(stdout, nullptr, _IONBF, 0);
+    setvbuf(stderr, nullptr, _IONBF, 0);
+    const ArgumentParser args = ArgumentParser(argc, argv);
+    Logger::ansi = !args.HasFlag("--no-ansi");
+    Logger::verbose = args.HasFlag("--verbose");
+
+    Logger::Info("GAME SDK Asset Compiler");
+
+    if (args.HasFlag("--help") || args.HasFlag("-h"))
+    {
+        printf("Usage: assetc [options]\n");
+        printf("\n-- Input Options --\n");
+        printf("--manifest=/path/to/assets.json.......The asset manifest to build.\n");
+        printf("--manifests-dir=/path/to/folder.......Build every manifest (*.json) in a folder and its subfolders.\n");
+        printf("--output=/path/to/assets..............The folder to write compiled assets to.\n");
+        printf("\n-- Build Options --\n");
+        printf("--jobs=N..............................The number of assets to build at once (default: every core).\n");
+        printf("--cache-dir=/path/to/cache............A build cache folder, which may be shared between checkouts.\n");
+        printf("--cache-size=MB.......................The size limit of the build cache (default: 4096).\n");
+        printf("--force...............................Rebuild every asset, even if it is up to date.\n");
+        printf("--verbose.............................Log every asset that is up to date.\n");
+        printf("--no-ansi.............................Don't color log output.\n");
+        printf("\nOnly assets whose sources, options or outputs changed since the last build are rebuilt.\n");
+        return 0;
+    }
+
+    if (!(args.HasFlagWithValue("--manifest") || args.HasFlagWithValue("--manifests-dir")))
+    {
+        Logger::Error("--manifest not specified!");
+        return 1;
+    }
+    if (!args.HasFlagWithValue("--output"))
+    {
+        Logger::Error("--output not specified!");
+        return 1;
+    }
+    size_t jobs = 0;
+    if (args.HasFlagWithValue("--jobs") && !args.GetFlagNumber("--jobs", jobs))
+    {
+        Logger::Error("--jobs must be a number!");
+        return 1;
+    }
+    uintmax_t cacheSize = BuildCache::DEFAULT_MAX_BYTES;
+    if (args.HasFlagWithValue("--cache-size"))
+    {
+        constexpr uintmax_t MIB = 1024 * 1024;
+        uintmax_t cacheSizeMiB = 0;
+        if (!args.GetFlagNumber("--cache-size", cacheSizeMiB) ||
+            cacheSizeMiB > std::numeric_limits<uintmax_t>::max() / MIB)
+        {
+            Logger::Error("--cache-size must be a number of megabytes!");
+            return 1;
+        }
+        cacheSize = cacheSizeMiB * MIB;
+    }
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const std::string outputDirectory = args.GetFlagValue("--output");
+
+    std::vector<std::string> manifestPaths{};
+    if (args.HasFlagWithValue("--manifest"))
+    {
+        manifestPaths.push_back(args.GetFlagValue("--manifest"));
+    }
+    if (args.HasFlagWithValue("--manifests-dir"))
+    {
+        std::error_code error{};
+        for (const std::filesystem::directory_entry &file:
+             std::filesystem::recursive_directory_iterator(args.GetFlagValue("--manifests-dir"), error))
+        {
+            if (file.is_regular_file() && file.path().extension() == ".json")
+            {
+                manifestPaths.push_back(file.path().string());
+            }
+        }
+        if (error)
+        {
+            Logger::Error("Failed to list manifests: {}", error.message());
+            return 1;
+        }
+    }
+
+    std::error_code outputError{};
+    std::filesystem::create_directories(outputDirectory, outputError);
+    if (outputError)
+    {
+        Logger::Error("Failed to create output folder {}: {}", outputDirectory, outputError.message());
+        return 1;
+    }
+
+    AssetManifest manifest{};
+    for (const std::string &manifestPath: manifestPaths)
+    {
+        const Error::ErrorCode e = manifest.Load(manifestPath, outputDirectory);
+        if (e != Error::ErrorCode::OK)
+        {
+            Logger::Error("Failed to load manifest {}: {}", manifestPath, e);
+            return 1;
+        }
+    }
+
+    const std::string statePath = (std::filesystem::path(outputDirectory) / ".assetc_state.json").string();
+    BuildState state{};
+    if (!args.HasFlag("--force"))
+    {
+        (void)state.Load(statePath);
+    }
+
+    // Checking is cheap (a stat per input unless a time changed), so it is done up front on this thread
+    std::vector<StaleEntry> staleEntries{};
+    for (const AssetManifest::Entry &entry: manifest.GetEntries())
+    {
+        StaleEntry stale{
+            .entry = &entry,
+            .optionsHash = AssetBuilder::GetOptionsHash(entry),
+            .inputs = AssetBuilder::GetInputs(entry),
+            .snapshot = {},
+        };
+        if (state.IsStale(entry.outputPath, stale.optionsHash, stale.inputs, stale.snapshot))
+        {
+            staleEntries.push_back(std::move(stale));
+        } else
+        {
+            Logger::Verbose("{} is up to date", entry.outputName);
+        }
+    }
+
+    const BuildCache cache(args.HasFlagWithValue("--cache-dir") ? args.GetFlagValue("--cache-dir") : "", cacheSize);
+    std::atomic<size_t> failedCount = 0;
+    std::atomic<size_t> cachedCount = 0;
+    if (!staleEntries.empty())
+    {
+        const size_t threadCount = jobs == 0 ? std::max(1u, std::thread::hardware_concurrency()) : jobs;
+        Logger::Info("Building {} of {} assets on {} threads...",
+                     staleEntries.size(),
+                     manifest.GetEntries().size(),
+                     threadCount);
+
+        // Logger writes a line in several calls, so lines from different workers would interleave without this
+        std::mutex logMutex{};
+        std::atomic<size_t> finishedCount = 0;
+        ThreadPool pool(threadCount);
+        for (StaleEntry &stale: staleEntries)
+        {
+            pool.Submit([&stale,
+                         &state,
+                         &cache,
+                         &logMutex,
+                         &finishedCount,
+                         &failedCount,
+                         &cachedCount,
+                         total = staleEntries.size()] {
+                // Read the inputs before building, so that one edited during the build is rebuilt next time.
+                // An input that can't be read can't be compared later, so the output is always rebuilt.
+                const bool recordable = BuildState::SnapshotInputs(stale.inputs, stale.snapshot);
+                uint64_t cacheKey = 0;
+                const bool cacheable = cache.IsEnabled() &&
+                                       AssetBuilder::GetCacheKey(*stale.entry, stale.inputs, cacheKey);
+                if (cacheable)
+                {
+                    std::error_code error{};
+                    std::filesystem::create_directories(std::filesystem::path(stale.entry->outputPath).parent_path(),
+                                                        error);
+                    if (cache.Fetch(cacheKey, stale.entry->outputPath))
+                    {
+                        ++cachedCount;
+                        if (recordable)
+                        {
+                            state.Record(stale.entry->outputPath, stale.optionsHash, stale.snapshot);
+                        }
+                        const size_t finished = ++finishedCount;
+                        const std::lock_guard lock(logMutex);
+                        Logger::Info("[{}/{}] {} (cached)", finished, total, stale.entry->outputName);
+                        return;
+                    }
+                }
+
+                std::string errorMessage{};
+                const Error::ErrorCode e = AssetBuilder::Build(*stale.entry, errorMessage);
+                const size_t finished = ++finishedCount;
+                if (e != Error::ErrorCode::OK)
+                {
+                    ++failedCount;
+                    const std::lock_guard lock(logMutex);
+                    Logger::Error("[{}/{}] {} ({}) failed: {} {}",
+                                  finished,
+                                  total,
+                                  stale.entry->outputName,
+                                  AssetManifest::GetKindName(stale.entry->kind),
+                                  e,
+                                  errorMessage);
+                    return;
+                }
+                if (recordable)
+                {
+                    state.Record(stale.entry->outputPath, stale.optionsHash, stale.snapshot);
+                }
+                const Error::ErrorCode insertError = cacheable ? cache.Insert(cacheKey, stale.entry->outputPath)
+                                                               : Error::ErrorCode::OK;
+                const std::lock_guard lock(logMutex);
+                Logger::Info("[{}/{}] {}", finished, total, stale.entry->outputName);
+                if (insertError != Error::ErrorCode::OK)
+                {
+                    Logger::Warning("Failed to add {} to the build cache", stale.entry->outputName);
+                }
+            });
+        }
+        pool.Wait();
+        cache.CollectGarbage();
+    }
+
+    const Error::ErrorCode e = state.Save(statePath);
+    if (e != Error::ErrorCode::OK)
+    {
+        Logger::Warning("Failed to save build state to {}: {}", statePath, e);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (failedCount > 0)
+    {
+        Logger::Error("{} of {} assets failed to build in {:.2f}s", failedCount.load(), staleEntries.size(), seconds);
+        return 1;
+    }
+    Logger::Info("{} built, {} from cache, {} up to date in {:.2f}s",
+                 staleEntries.size() - cachedCount,
+                 cachedCount.load(),
+                 manifest.GetEntries().size() - staleEntries.size(),
+                 seconds);
+    return 0;
+}
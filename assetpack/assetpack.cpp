@@ -0,0 +1,71 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <cstdio>
+#include <format>
+#include <libassets/util/ArgumentParser.h>
+#include <libassets/util/AssetPack.h>
+#include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
+#include <string>
+
+int main(const int argc, const char **argv)
+{
+    Logger::Info("GAME SDK Asset Packer");
+    const ArgumentParser args = ArgumentParser(argc, argv);
+
+    if (args.HasFlag("--help") || args.HasFlag("-h"))
+    {
+        printf("Usage: assetpack [options]\n");
+        printf("\n-- Packing Options --\n");
+        printf("--input=/path/to/assets...............The asset folder to pack. It becomes the root of the pack.\n");
+        printf("--output=/path/to/assets.gpak.........The pack file to create.\n");
+        printf("\n-- Inspection Options --\n");
+        printf("--list=/path/to/assets.gpak...........List the contents of an existing pack.\n");
+        printf("\nOnly compiled asset files are packed. Other files (such as definition JSON) are skipped.\n");
+        return 0;
+    }
+
+    if (args.HasFlagWithValue("--list"))
+    {
+        AssetPack pack{};
+        const Error::ErrorCode e = pack.Open(args.GetFlagValue("--list"));
+        if (e != Error::ErrorCode::OK)
+        {
+            Logger::Error("Failed to open pack: {}", e);
+            return 1;
+        }
+        for (const AssetPack::Entry &entry: pack.GetEntries())
+        {
+            const std::string line = std::format("{:016x} {:>10} {:>10} {}",
+                                                 entry.hash,
+                                                 entry.offset,
+                                                 entry.size,
+                                                 entry.path);
+            printf("%s\n", line.c_str());
+        }
+        Logger::Info("{} entries", pack.GetEntries().size());
+        return 0;
+    }
+
+    if (!args.HasFlagWithValue("--input"))
+    {
+        Logger::Error("Missing --input argument!");
+        return 1;
+    }
+    if (!args.HasFlagWithValue("--output"))
+    {
+        Logger::Error("Missing --output argument!");
+        return 1;
+    }
+
+    Logger::Info("Packing \"{}\"...", args.GetFlagValue("--input"));
+    const Error::ErrorCode e = AssetPack::Build(args.GetFlagValue("--input"), args.GetFlagValue("--output"));
+    if (e != Error::ErrorCode::OK)
+    {
+        Logger::Error("Failed to build pack: {}", e);
+        return 1;
+    }
+    return 0;
+}
@@ -2,8 +2,8 @@
 
 out vec4 COLOR;
 
-uniform vec4 alb;
+in vec4 FSVCOL;
 
 void main() {
-    COLOR = alb;
-}
\ No newline at end of file
+    COLOR = FSVCOL;
+}
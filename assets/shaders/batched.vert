@@ -0,0 +1,15 @@
+#version 460
+
+layout(location = 0) in vec3 VERTEX;
+layout(location = 1) in vec4 VERTEX_COLOR;
+layout(location = 2) in float VERTEX_SIZE;
+
+uniform mat4 VIEW_MATRIX;
+
+out vec4 FSVCOL;
+
+void main() {
+    gl_Position = VIEW_MATRIX * vec4(VERTEX, 1.0);
+    gl_PointSize = VERTEX_SIZE;
+    FSVCOL = VERTEX_COLOR;
+}
@@ -0,0 +1,11 @@
+#version 460
+
+out vec4 COLOR;
+
+in vec4 FSVCOL;
+
+uniform sampler2D sprite;
+
+void main() {
+    COLOR = texture(sprite, gl_PointCoord) * FSVCOL;
+}
@@ -0,0 +1,14 @@
+#version 460
+
+layout(location = 0) in vec3 VERTEX;
+layout(location = 3) in mat4 INSTANCE_WORLD_MATRIX;
+layout(location = 7) in vec4 INSTANCE_COLOR;
+
+uniform mat4 VIEW_MATRIX;
+
+out vec4 FSVCOL;
+
+void main() {
+    gl_Position = VIEW_MATRIX * INSTANCE_WORLD_MATRIX * vec4(VERTEX, 1.0);
+    FSVCOL = INSTANCE_COLOR;
+}
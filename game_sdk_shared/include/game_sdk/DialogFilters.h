@@ -23,6 +23,9 @@ class DialogFilters
         static inline const std::vector<SDL_DialogFileFilter> LOG_FILTERS = {
             SDL_DialogFileFilter{.name = "Log File (*.log)", .pattern = "log"},
         };
+        static inline const std::vector<SDL_DialogFileFilter> TRACE_FILTERS = {
+            SDL_DialogFileFilter{.name = "Trace File (*.json)", .pattern = "json"},
+        };
 
         // fonedit
         static inline const std::vector<SDL_DialogFileFilter> GFON_FILTERS = {
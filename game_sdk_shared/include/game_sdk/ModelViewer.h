@@ -5,6 +5,7 @@
 #ifndef GAME_SDK_MODELVIEWER_H
 #define GAME_SDK_MODELVIEWER_H
 
+#include <cstddef>
 #include <game_sdk/gl/GLHelper.h>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
@@ -66,6 +67,11 @@ class ModelViewer
          */
         [[nodiscard]] ModelAsset &GetModel();
 
+        /**
+         * Get a number that changes every time the model is set or reloaded, for caching things derived from it
+         */
+        [[nodiscard]] size_t GetModelGeneration() const;
+
         /**
          * Set the view
          * @param pitchDegrees Pitch in degrees
@@ -144,6 +150,7 @@ class ModelViewer
         };
 
         ModelAsset model{};
+        size_t modelGeneration = 0;
 
         GLHelper::GL_IndexedBuffer bboxBuffer{};
 
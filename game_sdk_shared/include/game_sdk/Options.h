@@ -56,9 +56,13 @@ class Options
 
         Theme theme = Theme::SYSTEM;
 
+        /// The memory the map editor's undo history may use, in MiB
+        uint32_t mapUndoMemoryMiB = DEFAULT_MAP_UNDO_MEMORY_MIB;
+
     private:
         Options() = default;
 
         static inline const char *DEFAULT_TEXTURE = "texture/level/uvtest.gtex";
         static inline const char *DEFAULT_MATERIAL = "material/dev/uv_test.gmtl";
+        static constexpr uint32_t DEFAULT_MAP_UNDO_MEMORY_MIB = 256;
 };
@@ -0,0 +1,205 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+/**
+ * Measures where each frame's time goes, for the frame profiler window.
+ * CPU time is measured with scopes, GPU time with timestamp queries that are read back a few frames later so the CPU
+ * never waits for the GPU. Draw calls and buffer uploads are counted by the code that makes them.
+ * Nothing is measured while the profiler is disabled, so instrumented code costs next to nothing normally.
+ */
+class Profiler
+{
+    public:
+        /// How many frame times are kept for the frame time graph
+        static constexpr size_t FRAME_HISTORY = 240;
+        /// How many frames a capture records
+        static constexpr size_t CAPTURE_FRAMES = 120;
+
+        /// One measured scope. Times are in nanoseconds since the profiler was created.
+        struct ScopeTime
+        {
+                /// The scope name, which must be a string literal
+                const char *name;
+                /// How many scopes of the same kind (CPU or GPU) were open when this one started
+                uint32_t depth;
+                uint64_t startNs;
+                uint64_t endNs;
+        };
+
+        struct FrameStats
+        {
+                uint64_t startNs;
+                uint64_t endNs;
+                std::vector<ScopeTime> cpuScopes;
+                /// Empty if the GPU results were not ready in time
+                std::vector<ScopeTime> gpuScopes;
+                size_t drawCalls;
+                size_t uploads;
+                size_t uploadBytes;
+        };
+
+        /**
+         * Measures the CPU time until it goes out of scope
+         */
+        class Scope
+        {
+            public:
+                /// @param name The scope name, which must be a string literal
+                explicit Scope(const char *name);
+                ~Scope();
+                Scope(const Scope &) = delete;
+                Scope &operator=(const Scope &) = delete;
+
+            private:
+                size_t index;
+                bool active;
+        };
+
+        /**
+         * Measures the GPU time of the commands issued until it goes out of scope
+         */
+        class GpuScope
+        {
+            public:
+                /// @param name The scope name, which must be a string literal
+                explicit GpuScope(const char *name);
+                ~GpuScope();
+                GpuScope(const GpuScope &) = delete;
+                GpuScope &operator=(const GpuScope &) = delete;
+
+            private:
+                size_t index;
+                bool active;
+        };
+
+        static Profiler &Get();
+
+        /**
+         * Start measuring a frame. Called by the main loop.
+         */
+        void BeginFrame();
+
+        /**
+         * Finish measuring a frame. Called by the main loop after the frame was presented.
+         */
+        void EndFrame();
+
+        /**
+         * Enable or disable measuring, starting from the next frame
+         */
+        void SetEnabled(bool enable);
+
+        /**
+         * Count draw calls made this frame
+         * @param count The number of draw calls, for multi-draw calls the number of draws they make
+         */
+        void CountDrawCall(size_t count = 1);
+
+        /**
+         * Count data uploaded to the GPU this frame
+         * @param bytes The size of the upload
+         */
+        void CountUpload(size_t bytes);
+
+        /**
+         * Record the next CAPTURE_FRAMES frames and write them to a trace file, which can be opened in a trace viewer
+         * such as Perfetto or chrome://tracing
+         * @param path The file to write
+         */
+        void StartCapture(const std::string &path);
+
+        [[nodiscard]] bool IsCapturing() const;
+
+        /// @return The number of frames captured so far
+        [[nodiscard]] size_t GetCapturedFrameCount() const;
+
+        /**
+         * Get the last frame whose GPU times are known
+         */
+        [[nodiscard]] const FrameStats &GetLastFrame() const;
+
+        /**
+         * Get the CPU time of recent frames in milliseconds, oldest first starting at GetFrameTimeOffset()
+         */
+        [[nodiscard]] const std::array<float, FRAME_HISTORY> &GetFrameTimes() const;
+
+        [[nodiscard]] size_t GetFrameTimeOffset() const;
+
+    private:
+        /// How many frames the GPU results are read back after
+        static constexpr size_t GPU_FRAME_LATENCY = 4;
+
+        struct GpuQuery
+        {
+                const char *name;
+                uint32_t depth;
+                GLuint start;
+                GLuint end;
+        };
+
+        /// A frame waiting for its GPU results
+        struct PendingFrame
+        {
+                FrameStats stats;
+                /// GPU time at the start of the frame, to line the GPU scopes up with the CPU ones
+                uint64_t gpuStartNs;
+                std::vector<GpuQuery> queries;
+                bool pending;
+        };
+
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+        bool enabled = false;
+        /// Whether the current frame is being measured
+        bool recording = false;
+
+        std::array<PendingFrame, GPU_FRAME_LATENCY> frames{};
+        size_t frameIndex = 0;
+        uint32_t cpuDepth = 0;
+        uint32_t gpuDepth = 0;
+        /// Query objects that can be reused
+        std::vector<GLuint> freeQueries{};
+
+        FrameStats lastFrame{};
+        std::array<float, FRAME_HISTORY> frameTimes{};
+        size_t frameTimeOffset = 0;
+
+        std::string capturePath{};
+        std::vector<FrameStats> capturedFrames{};
+        /// Frames that started before the capture are not part of it
+        uint64_t captureStartNs = 0;
+        bool capturing = false;
+
+        Profiler() = default;
+
+        [[nodiscard]] uint64_t GetTimeNs() const;
+
+        [[nodiscard]] GLuint GetQuery();
+
+        [[nodiscard]] PendingFrame &GetCurrentFrame();
+
+        [[nodiscard]] static bool GpuResultsReady(const PendingFrame &frame);
+
+        /**
+         * Read a frame's GPU results and hand the frame on to the window and the capture
+         */
+        void FinishFrame(PendingFrame &frame);
+
+        /**
+         * Give up on a frame's GPU results and free its queries
+         */
+        void DropGpuResults(PendingFrame &frame);
+
+        void WriteCapture() const;
+};
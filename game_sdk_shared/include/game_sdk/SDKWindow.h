@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <imgui.h>
 #include <SDL3/SDL_dialog.h>
@@ -62,9 +64,24 @@ class SDKWindow
          * Run the main loop
          * @param Render The render function
          * @param ProcessEvent The event handler function, nullptr by default
+         * @note While nothing happens, the main loop sleeps until an event arrives or a redraw is requested, and only
+         * redraws every IDLE_REDRAW_INTERVAL_MS
          */
         void MainLoop(SDKWindowRenderFunction Render, SDKWindowProcessEventFunction ProcessEvent = nullptr);
 
+        /**
+         * Make the main loop render the next few frames, waking it up if it is idle
+         * @note This may be called from any thread, such as when a background load finishes
+         * @note Call this every frame while something is animating
+         */
+        void RequestRedraw();
+
+        /**
+         * Render every frame instead of waiting for events
+         * @param continuous Whether to render continuously
+         */
+        void SetContinuousRendering(bool continuous);
+
         /**
          * Get the main window's pointer
          */
@@ -156,6 +173,11 @@ class SDKWindow
         void SetThemeChangeCallback(SDKWindowThemeChangeCallback Callback);
 
     private:
+        /// ImGui can take a couple of frames to settle after input (such as hover changes and window resizes)
+        static constexpr int REDRAW_FRAMES = 3;
+        /// How often to redraw while idle, which keeps text cursors blinking and polled state up to date
+        static constexpr int32_t IDLE_REDRAW_INTERVAL_MS = 500;
+
         bool initDone = false;
         SDL_Window *window = nullptr;
         SDL_GLContext glContext = nullptr;
@@ -164,6 +186,12 @@ class SDKWindow
         ImFont *monospaceFont = nullptr;
         SDKWindowThemeChangeCallback ThemeChangeCallback = nullptr;
 
+        /// The number of frames left to render before the main loop goes idle
+        std::atomic<int> redrawFrames = REDRAW_FRAMES;
+        bool continuousRendering = false;
+        /// An event pushed by RequestRedraw to wake the main loop up from other threads
+        uint32_t wakeEventType = 0;
+
         struct FileDialogMainThreadCallbackData
         {
                 SDKWindowFileDialogCallback Callback;
@@ -178,6 +206,8 @@ class SDKWindow
 
         SDKWindow() = default;
 
+        void HandleEvent(SDL_Event &event, SDKWindowProcessEventFunction ProcessEvent);
+
         static void FileDialogMainThreadCallback(void *userdata);
 
         static void FileDialogCallback(void *callbackPtr, const char *const *fileList, int filter);
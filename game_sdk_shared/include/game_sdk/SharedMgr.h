@@ -7,6 +7,7 @@
 #include <game_sdk/gl/GLTextureCache.h>
 #include <libassets/type/OptionDefinition.h>
 #include <libassets/util/SearchPathManager.h>
+#include <libassets/util/ThreadPool.h>
 #include <string>
 
 class SharedMgr
@@ -41,9 +42,15 @@ class SharedMgr
 
         SearchPathManager pathManager{};
 
+        /// Worker threads for loading assets in the background
+        ThreadPool loadPool{};
+
     private:
         bool metricsVisible = false;
         bool demoVisible = false;
+        bool textureCacheStatsVisible = false;
+
+        void RenderTextureCacheStats();
 
         SharedMgr() = default;
 };
@@ -5,21 +5,53 @@
 #pragma once
 
 #include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <imgui.h>
 #include <libassets/asset/TextureAsset.h>
+#include <libassets/util/AssetCache.h>
 #include <libassets/util/Error.h>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
-
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Caches OpenGL textures loaded from texture assets.
+ * Loaded textures are evicted least recently used first once they use more than the budget of video memory. Textures
+ * used during a frame are kept alive until EndFrame() so that IDs handed to ImGui stay valid until it renders.
+ * RequestTexture() decodes textures on the shared load pool instead of the calling thread, and EndFrame() uploads the
+ * decoded textures a few at a time so that a burst of new textures does not stall a frame.
+ */
 class GLTextureCache
 {
     public:
+        /// The default amount of video memory that loaded textures may use
+        static constexpr size_t DEFAULT_BUDGET_BYTES = 512ull * 1024 * 1024;
+        /// The amount of texture data that EndFrame() uploads per frame. At least one texture is always uploaded.
+        static constexpr size_t UPLOAD_BUDGET_BYTES_PER_FRAME = 8ull * 1024 * 1024;
+
+        /// An OpenGL texture that is deleted when the last handle to it is released
+        struct GLTexture
+        {
+                GLuint id;
+                ImVec2 size;
+
+                GLTexture(GLuint id, ImVec2 size);
+                ~GLTexture();
+                GLTexture(const GLTexture &) = delete;
+                GLTexture &operator=(const GLTexture &) = delete;
+        };
+
         GLTextureCache() = default;
 
         ~GLTextureCache();
 
         /**
-         * Create the fallback missing texture
+         * Create the fallback missing texture and the placeholder shown while textures load
          */
         void InitMissingTexture();
 
@@ -50,6 +82,15 @@ class GLTextureCache
          */
         [[nodiscard]] Error::ErrorCode GetTextureGLuint(const std::string &relPath, GLuint &outTexture);
 
+        /**
+         * Get a texture without blocking, starting a background load if it is not loaded yet
+         * @param relPath The texture path
+         * @param outTexture Where to store the ID. Set to a placeholder while loading, or the missing texture on error.
+         * @param outSize Where to store the size of the texture that outTexture is set to
+         * @return Whether the texture has finished loading
+         */
+        bool RequestTexture(const std::string &relPath, ImTextureID &outTexture, ImVec2 &outSize);
+
         /**
          * Load a texture from a given path
          * @param relPath The path to load
@@ -70,10 +111,99 @@ class GLTextureCache
                                                    bool repeat = false,
                                                    bool mipmaps = false);
 
+        /**
+         * Upload textures that finished loading in the background, then release the textures used during this frame so
+         * that they may be evicted. Call after ImGui has rendered.
+         */
+        void EndFrame();
+
+        /**
+         * Unload every texture loaded from an asset and forget failed loads. Registered PNG textures are kept.
+         */
+        void Clear();
+
+        [[nodiscard]] AssetCache<GLTexture>::Stats GetStats();
+
+        void ResetStats();
+
         [[nodiscard]] static GLuint CreateTexture(const TextureAsset &textureAsset);
 
+        /**
+         * Get the amount of video memory a texture created by CreateTexture uses
+         */
+        [[nodiscard]] static size_t GetTextureBytes(const TextureAsset &textureAsset);
+
     private:
-        std::unordered_map<std::string, ImTextureID> textureBuffers{};
+        /// A texture decoded on a worker thread, waiting to be uploaded
+        struct DecodedTexture
+        {
+                std::string relPath;
+                /// nullptr if the texture failed to load
+                std::unique_ptr<TextureAsset> asset;
+        };
+
+        /// Shared with the worker threads so that loads finishing after the cache is destroyed are harmless
+        struct DecodeQueue
+        {
+                std::mutex mutex;
+                std::vector<DecodedTexture> textures;
+        };
+
+        AssetCache<GLTexture> textures{DEFAULT_BUDGET_BYTES};
+        /// Textures registered by name with RegisterPng, which are never evicted
+        std::unordered_map<std::string, std::shared_ptr<GLTexture>> registeredTextures{};
+        /// Textures used since the last EndFrame()
+        std::vector<std::shared_ptr<GLTexture>> frameTextures{};
+
+        std::shared_ptr<GLTexture> missingTexture{};
+        std::shared_ptr<GLTexture> loadingTexture{};
+
+        std::shared_ptr<DecodeQueue> decodeQueue = std::make_shared<DecodeQueue>();
+        /// Decoded textures waiting for upload budget
+        std::deque<DecodedTexture> uploadQueue{};
+        /// Textures requested with RequestTexture() that are not uploaded yet
+        std::unordered_set<std::string> pendingTextures{};
+        /// Textures that failed to load in the background, which are not retried until Clear()
+        std::unordered_set<std::string> failedTextures{};
+        /// The pixel buffer object used to stream uploads
+        GLuint uploadBuffer = 0;
+
+        /**
+         * Upload decoded textures until this frame's upload budget is used
+         */
+        void ProcessUploads();
+
+        /**
+         * Create a texture from a decoded asset, copying the pixels through the upload buffer
+         */
+        [[nodiscard]] GLuint UploadTexture(const TextureAsset &textureAsset);
+
+        /**
+         * Create a texture with the pixels from the bound pixel unpack buffer, or from client memory if none is bound
+         * @param textureAsset The texture to create
+         * @param pixels The pixel data, or an offset into the bound pixel unpack buffer
+         */
+        [[nodiscard]] static GLuint CreateTexture(const TextureAsset &textureAsset, const void *pixels);
+
+        /**
+         * Get the GL internal format of a block compressed pixel format
+         */
+        [[nodiscard]] static GLenum GetCompressedInternalFormat(TextureAsset::PixelFormat format);
 
-        ImTextureID missingTexture{};
+        /**
+         * Get the number of stored mip levels of a texture that get uploaded
+         */
+        [[nodiscard]] static uint32_t GetUploadedLevelCount(const TextureAsset &textureAsset);
+
+        /**
+         * Get the size of the pixel data of a texture that gets uploaded
+         */
+        [[nodiscard]] static size_t GetPixelBytes(const TextureAsset &textureAsset);
+
+        /**
+         * Get the texture for a given path, loading it if needed
+         * @param relPath The texture path
+         * @param outTexture Where to store the texture
+         */
+        [[nodiscard]] Error::ErrorCode GetTexture(const std::string &relPath, std::shared_ptr<GLTexture> &outTexture);
 };
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <libassets/asset/LevelMaterialAsset.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -22,15 +24,31 @@ class MaterialBrowserWindow
         void InputMaterial(const char *label, std::string *material);
 
     private:
+        /// A material that is loaded in the background
+        struct MaterialSlot
+        {
+                /// Set by the loading thread once material is ready to read
+                std::atomic<bool> loaded = false;
+                /// Whether loading has started, only used by the UI thread
+                bool requested = false;
+                std::string absolutePath{};
+                LevelMaterialAsset material{};
+        };
+
         MaterialBrowserWindow() = default;
 
         bool visible = false;
         std::string *str = nullptr;
 
         std::vector<std::string> materialPaths{};
-        std::vector<LevelMaterialAsset> materials{};
+        std::vector<std::shared_ptr<MaterialSlot>> materials{};
 
         std::string filter;
 
         static constexpr int TILE_SIZE = 128;
+
+        /**
+         * Start loading a material in the background, unless it already is
+         */
+        static void RequestMaterial(const std::shared_ptr<MaterialSlot> &slot);
 };
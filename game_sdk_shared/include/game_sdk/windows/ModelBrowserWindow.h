@@ -5,7 +5,11 @@
 #ifndef GAME_SDK_MODELBROWSERWINDOW_H
 #define GAME_SDK_MODELBROWSERWINDOW_H
 
+#include <atomic>
 #include <game_sdk/ModelViewer.h>
+#include <libassets/asset/ModelAsset.h>
+#include <libassets/util/Error.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +27,15 @@ class ModelBrowserWindow
         void InputModel(const char *label, std::string *model);
 
     private:
+        /// A preview model that is loaded in the background
+        struct PendingModel
+        {
+                /// Set by the loading thread once model and error are ready to read
+                std::atomic<bool> loaded = false;
+                Error::ErrorCode error = Error::ErrorCode::UNKNOWN;
+                ModelAsset model{};
+        };
+
         ModelBrowserWindow() = default;
 
         bool visible = false;
@@ -31,8 +44,21 @@ class ModelBrowserWindow
         std::vector<std::string> models{};
         std::vector<std::string> modelAbsPaths{};
         ModelViewer viewer{};
+        /// The most recently requested preview. Earlier requests still loading are dropped when they finish.
+        std::shared_ptr<PendingModel> pendingModel{};
 
         std::string filter;
+
+        /**
+         * Start loading a model for the preview
+         * @param absolutePath The model file
+         */
+        void LoadPreviewModel(const std::string &absolutePath);
+
+        /**
+         * Show the pending preview model if it has finished loading
+         */
+        void UpdatePreviewModel();
 };
 
 
@@ -0,0 +1,49 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <game_sdk/Profiler.h>
+#include <string>
+#include <vector>
+
+/**
+ * Shows where the time of recent frames went, as measured by the Profiler
+ */
+class ProfilerWindow
+{
+    public:
+        static ProfilerWindow &Get();
+
+        void Show();
+
+        void Hide();
+
+        void Render();
+
+    private:
+        /// The time spent in every scope with the same name and depth, in the order they first started
+        struct ScopeTotal
+        {
+                const char *name;
+                uint32_t depth;
+                uint64_t totalNs;
+                uint32_t calls;
+        };
+
+        ProfilerWindow() = default;
+
+        bool visible = false;
+        bool continuousRendering = false;
+
+        std::vector<ScopeTotal> cpuTotals{};
+        std::vector<ScopeTotal> gpuTotals{};
+
+        static void SumScopes(const std::vector<Profiler::ScopeTime> &scopes, std::vector<ScopeTotal> &outTotals);
+
+        static void RenderScopeTable(const char *id, const std::vector<ScopeTotal> &totals);
+
+        static void CaptureCallback(const std::string &path);
+};
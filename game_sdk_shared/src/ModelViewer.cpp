@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <game_sdk/gl/GLHelper.h>
 #include <game_sdk/ModelViewer.h>
+#include <game_sdk/Profiler.h>
 #include <game_sdk/SharedMgr.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -87,6 +88,7 @@ void ModelViewer::SetModel(ModelAsset &&newModel)
 void ModelViewer::ReloadModel()
 {
     DestroyModel();
+    modelGeneration++;
     for (size_t i = 0; i < model.GetLodCount(); i++)
     {
         const ModelLod &lod = model.GetLod(i);
@@ -100,16 +102,7 @@ void ModelViewer::ReloadModel()
         std::vector<uint8_t> buffer;
         writer.CopyToVector(buffer);
         glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(writer.GetBufferSize()), buffer.data(), GL_STATIC_DRAW);
-
-        for (size_t j = 0; j < model.GetSkinCount(); j++)
-        {
-            for (size_t k = 0; k < model.GetMaterialsPerSkin(); k++)
-            {
-                const size_t matIndex = model.GetSkin(j).at(k);
-                const Material &mat = model.GetMaterial(matIndex);
-                (void)SharedMgr::Get().textureCache.LoadTexture(mat.texture);
-            }
-        }
+        Profiler::Get().CountUpload(writer.GetBufferSize());
 
         for (size_t j = 0; j < model.GetMaterialsPerSkin(); j++)
         {
@@ -120,6 +113,7 @@ void ModelViewer::ReloadModel()
                          static_cast<GLsizeiptr>(lod.indexCounts.at(j) * sizeof(uint32_t)),
                          lod.materialIndices.at(j).data(),
                          GL_STATIC_DRAW);
+            Profiler::Get().CountUpload(lod.indexCounts.at(j) * sizeof(uint32_t));
             glod.ebos.push_back(ebo);
         }
 
@@ -137,6 +131,11 @@ ModelAsset &ModelViewer::GetModel()
     return model;
 }
 
+size_t ModelViewer::GetModelGeneration() const
+{
+    return modelGeneration;
+}
+
 void ModelViewer::UpdateView(const float pitchDegrees, const float yawDegrees, const float cameraDistance)
 {
     pitch = glm::radians(pitchDegrees);
@@ -229,6 +228,8 @@ void ModelViewer::RenderImGui()
 
 void ModelViewer::RenderFramebuffer()
 {
+    const Profiler::Scope scope("Model viewer");
+    const Profiler::GpuScope gpuScope("Model viewer");
     GLHelper::BindFramebuffer(framebuffer);
 
     const float *color = backgroundColor.GetDataPointer();
@@ -324,13 +325,11 @@ void ModelViewer::RenderFramebuffer()
         glUniform1i(glGetUniformLocation(ModelViewerShared::Get().program, "displayMode"), static_cast<GLint>(mode));
         glUniform4fv(glGetUniformLocation(ModelViewerShared::Get().program, "ALBEDO"), 1, mat.color.GetDataPointer());
 
-        GLuint texture = 0;
-        const Error::ErrorCode code = SharedMgr::Get().textureCache.GetTextureGLuint(mat.texture, texture);
-        if (code != Error::ErrorCode::OK)
-        {
-            texture = SharedMgr::Get().textureCache.GetMissingTextureGLuint();
-        }
-        glBindTexture(GL_TEXTURE_2D, texture);
+        // Textures load in the background, drawing with a placeholder until they are ready
+        ImTextureID texture = 0;
+        ImVec2 textureSize{};
+        (void)SharedMgr::Get().textureCache.RequestTexture(mat.texture, texture, textureSize);
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture));
         glUniform1i(glGetUniformLocation(ModelViewerShared::Get().program, "ALBEDO_TEXTURE"), 0);
 
         const GLuint ebo = glod.ebos.at(i);
@@ -339,6 +338,7 @@ void ModelViewer::RenderFramebuffer()
                        static_cast<GLsizei>(model.GetLod(lodIndex).indexCounts.at(i)),
                        GL_UNSIGNED_INT,
                        nullptr);
+        Profiler::Get().CountDrawCall();
     }
 
     if (showUnitCube)
@@ -360,6 +360,7 @@ void ModelViewer::RenderFramebuffer()
                            glm::value_ptr(view));
         glUniform4f(glGetUniformLocation(ModelViewerShared::Get().linesProgram, "lineColor"), 0.2f, 0.2f, 0.2f, 1.0f);
         glDrawArrays(GL_LINES, 0, 24);
+        Profiler::Get().CountDrawCall();
     }
 
     if (showCollisionModel)
@@ -390,6 +391,7 @@ void ModelViewer::RenderFramebuffer()
                 glEnableVertexAttribArray(posAttrib);
                 glPointSize(3.0);
                 glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(hull.elements));
+                Profiler::Get().CountDrawCall();
             }
         } else
         {
@@ -424,6 +426,7 @@ void ModelViewer::RenderFramebuffer()
                         1.0f);
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
             glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(model.GetStaticCollisionMesh().GetNumTriangles()) * 3);
+            Profiler::Get().CountDrawCall(2);
         }
     }
 
@@ -433,6 +436,7 @@ void ModelViewer::RenderFramebuffer()
         GLHelper::BindIndexedBuffer(bboxBuffer);
         const std::array<float, 24> points = model.GetBoundingBox().GetPointsFlat();
         glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * points.size(), points.data(), GL_STATIC_DRAW);
+        Profiler::Get().CountUpload(sizeof(GLfloat) * points.size());
 
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         glUseProgram(ModelViewerShared::Get().linesProgram);
@@ -453,6 +457,7 @@ void ModelViewer::RenderFramebuffer()
         glUniform4f(glGetUniformLocation(ModelViewerShared::Get().linesProgram, "lineColor"), 0.1f, 0.5f, 0.8f, 1.0f);
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+        Profiler::Get().CountDrawCall(2);
     }
 
     GLHelper::UnbindFramebuffer();
@@ -555,6 +560,7 @@ void ModelViewer::LoadHulls()
                      static_cast<GLsizeiptr>(sizeof(GLfloat) * points.size()),
                      points.data(),
                      GL_STATIC_DRAW);
+        Profiler::Get().CountUpload(sizeof(GLfloat) * points.size());
         glHull.elements = points.size() / 3;
         hulls.push_back(glHull);
     }
@@ -569,6 +575,7 @@ void ModelViewer::LoadStaticCollision()
                  static_cast<GLsizeiptr>(sizeof(GLfloat) * verts.size()),
                  verts.data(),
                  GL_STATIC_DRAW);
+    Profiler::Get().CountUpload(sizeof(GLfloat) * verts.size());
 }
 
 ModelViewer::ModelViewerShared &ModelViewer::ModelViewerShared::Get()
@@ -50,6 +50,7 @@ void Options::Load()
         defaultTexture = savedata.value("default_texture", DEFAULT_TEXTURE);
         defaultMaterial = savedata.value("default_material", DEFAULT_MATERIAL);
         theme = savedata.value("theme", Theme::SYSTEM);
+        mapUndoMemoryMiB = savedata.value("map_undo_memory_mib", DEFAULT_MAP_UNDO_MEMORY_MIB);
     }
     file.close();
 }
@@ -61,6 +62,7 @@ void Options::LoadDefault()
     defaultMaterial = DEFAULT_MATERIAL;
     gameConfigPath = "";
     theme = Theme::SYSTEM;
+    mapUndoMemoryMiB = DEFAULT_MAP_UNDO_MEMORY_MIB;
 }
 
 void Options::Save()
@@ -71,6 +73,7 @@ void Options::Save()
         {"default_material", defaultMaterial},
         {"theme", theme},
         {"game_config_path", gameConfigPath},
+        {"map_undo_memory_mib", mapUndoMemoryMiB},
     };
     const std::string path = SDL_GetBasePath() + std::string("sdk_options.json");
     std::ofstream file(path);
@@ -0,0 +1,367 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <game_sdk/Profiler.h>
+#include <GL/glew.h>
+#include <libassets/util/Logger.h>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+Profiler::Scope::Scope(const char *name): index(0), active(Get().recording)
+{
+    if (!active)
+    {
+        return;
+    }
+    Profiler &profiler = Get();
+    std::vector<ScopeTime> &scopes = profiler.GetCurrentFrame().stats.cpuScopes;
+    index = scopes.size();
+    scopes.push_back({
+        .name = name,
+        .depth = profiler.cpuDepth,
+        .startNs = profiler.GetTimeNs(),
+        .endNs = 0,
+    });
+    profiler.cpuDepth++;
+}
+
+Profiler::Scope::~Scope()
+{
+    if (!active)
+    {
+        return;
+    }
+    Profiler &profiler = Get();
+    profiler.GetCurrentFrame().stats.cpuScopes.at(index).endNs = profiler.GetTimeNs();
+    profiler.cpuDepth--;
+}
+
+Profiler::GpuScope::GpuScope(const char *name): index(0), active(Get().recording)
+{
+    if (!active)
+    {
+        return;
+    }
+    Profiler &profiler = Get();
+    std::vector<GpuQuery> &queries = profiler.GetCurrentFrame().queries;
+    index = queries.size();
+    const GLuint start = profiler.GetQuery();
+    glQueryCounter(start, GL_TIMESTAMP);
+    queries.push_back({
+        .name = name,
+        .depth = profiler.gpuDepth,
+        .start = start,
+        .end = 0,
+    });
+    profiler.gpuDepth++;
+}
+
+Profiler::GpuScope::~GpuScope()
+{
+    if (!active)
+    {
+        return;
+    }
+    Profiler &profiler = Get();
+    const GLuint end = profiler.GetQuery();
+    glQueryCounter(end, GL_TIMESTAMP);
+    profiler.GetCurrentFrame().queries.at(index).end = end;
+    profiler.gpuDepth--;
+}
+
+Profiler &Profiler::Get()
+{
+    static Profiler profilerSingleton{};
+
+    return profilerSingleton;
+}
+
+void Profiler::BeginFrame()
+{
+    recording = enabled || capturing;
+    if (!recording)
+    {
+        // Results from before the profiler was disabled would be stale by the time it is enabled again
+        for (PendingFrame &frame: frames)
+        {
+            if (frame.pending)
+            {
+                DropGpuResults(frame);
+                frame.pending = false;
+            }
+        }
+        return;
+    }
+
+    PendingFrame &frame = GetCurrentFrame();
+    if (frame.pending)
+    {
+        // The GPU is more than GPU_FRAME_LATENCY frames behind, waiting for it would change what is being measured
+        DropGpuResults(frame);
+        FinishFrame(frame);
+    }
+
+    frame.stats.startNs = GetTimeNs();
+    frame.stats.endNs = frame.stats.startNs;
+    frame.stats.cpuScopes.clear();
+    frame.stats.gpuScopes.clear();
+    frame.stats.drawCalls = 0;
+    frame.stats.uploads = 0;
+    frame.stats.uploadBytes = 0;
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    frame.gpuStartNs = static_cast<uint64_t>(gpuTime);
+    cpuDepth = 0;
+    gpuDepth = 0;
+}
+
+void Profiler::EndFrame()
+{
+    if (!recording)
+    {
+        return;
+    }
+    recording = false;
+
+    PendingFrame &frame = GetCurrentFrame();
+    frame.stats.endNs = GetTimeNs();
+    frame.pending = true;
+    frameTimes.at(frameTimeOffset) = static_cast<float>(frame.stats.endNs - frame.stats.startNs) / 1'000'000.0f;
+    frameTimeOffset = (frameTimeOffset + 1) % FRAME_HISTORY;
+    frameIndex++;
+
+    // Finish every frame the GPU is done with, oldest first
+    for (size_t i = 0; i < GPU_FRAME_LATENCY; i++)
+    {
+        PendingFrame &pendingFrame = frames.at((frameIndex + i) % GPU_FRAME_LATENCY);
+        if (!pendingFrame.pending)
+        {
+            continue;
+        }
+        if (!GpuResultsReady(pendingFrame))
+        {
+            break;
+        }
+        FinishFrame(pendingFrame);
+    }
+}
+
+void Profiler::SetEnabled(const bool enable)
+{
+    enabled = enable;
+}
+
+void Profiler::CountDrawCall(const size_t count)
+{
+    if (recording)
+    {
+        GetCurrentFrame().stats.drawCalls += count;
+    }
+}
+
+void Profiler::CountUpload(const size_t bytes)
+{
+    if (recording)
+    {
+        GetCurrentFrame().stats.uploads++;
+        GetCurrentFrame().stats.uploadBytes += bytes;
+    }
+}
+
+void Profiler::StartCapture(const std::string &path)
+{
+    capturePath = path;
+    capturedFrames.clear();
+    capturedFrames.reserve(CAPTURE_FRAMES);
+    captureStartNs = GetTimeNs();
+    capturing = true;
+}
+
+bool Profiler::IsCapturing() const
+{
+    return capturing;
+}
+
+size_t Profiler::GetCapturedFrameCount() const
+{
+    return capturedFrames.size();
+}
+
+const Profiler::FrameStats &Profiler::GetLastFrame() const
+{
+    return lastFrame;
+}
+
+const std::array<float, Profiler::FRAME_HISTORY> &Profiler::GetFrameTimes() const
+{
+    return frameTimes;
+}
+
+size_t Profiler::GetFrameTimeOffset() const
+{
+    return frameTimeOffset;
+}
+
+uint64_t Profiler::GetTimeNs() const
+{
+    const std::chrono::nanoseconds time = std::chrono::steady_clock::now() - epoch;
+    return static_cast<uint64_t>(time.count());
+}
+
+GLuint Profiler::GetQuery()
+{
+    if (freeQueries.empty())
+    {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        return query;
+    }
+    const GLuint query = freeQueries.back();
+    freeQueries.pop_back();
+    return query;
+}
+
+Profiler::PendingFrame &Profiler::GetCurrentFrame()
+{
+    return frames.at(frameIndex % GPU_FRAME_LATENCY);
+}
+
+bool Profiler::GpuResultsReady(const PendingFrame &frame)
+{
+    if (frame.queries.empty())
+    {
+        return true;
+    }
+    // Timestamps are written in order, so once the last one is available all of them are
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries.back().end, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+void Profiler::FinishFrame(PendingFrame &frame)
+{
+    frame.stats.gpuScopes.clear();
+    for (const GpuQuery &query: frame.queries)
+    {
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(query.start, GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+        start = std::max<GLuint64>(start, frame.gpuStartNs);
+        end = std::max<GLuint64>(end, start);
+        // Line the GPU clock up with the CPU one at the start of the frame
+        frame.stats.gpuScopes.push_back({
+            .name = query.name,
+            .depth = query.depth,
+            .startNs = frame.stats.startNs + (start - frame.gpuStartNs),
+            .endNs = frame.stats.startNs + (end - frame.gpuStartNs),
+        });
+    }
+    DropGpuResults(frame);
+    frame.pending = false;
+
+    lastFrame = frame.stats;
+    if (capturing && frame.stats.startNs >= captureStartNs)
+    {
+        capturedFrames.push_back(frame.stats);
+        if (capturedFrames.size() >= CAPTURE_FRAMES)
+        {
+            WriteCapture();
+            capturedFrames.clear();
+            capturing = false;
+        }
+    }
+}
+
+void Profiler::DropGpuResults(PendingFrame &frame)
+{
+    for (const GpuQuery &query: frame.queries)
+    {
+        freeQueries.push_back(query.start);
+        freeQueries.push_back(query.end);
+    }
+    frame.queries.clear();
+}
+
+void Profiler::WriteCapture() const
+{
+    // Chrome's trace event format, with the CPU and GPU scopes as two threads
+    constexpr int CPU_THREAD = 1;
+    constexpr int GPU_THREAD = 2;
+    const uint64_t baseNs = capturedFrames.front().startNs;
+    const auto toMicroseconds = [baseNs](const uint64_t ns) {
+        return static_cast<double>(ns - baseNs) / 1000.0;
+    };
+    const auto makeEvent = [&toMicroseconds](const char *name,
+                                             const uint64_t startNs,
+                                             const uint64_t endNs,
+                                             const int thread) {
+        return nlohmann::json{
+            {"name", name},
+            {"ph", "X"},
+            {"ts", toMicroseconds(startNs)},
+            {"dur", static_cast<double>(endNs - startNs) / 1000.0},
+            {"pid", 1},
+            {"tid", thread},
+        };
+    };
+
+    nlohmann::json events = nlohmann::json::array();
+    for (const auto &[thread, threadName]: {std::pair{CPU_THREAD, "CPU"}, std::pair{GPU_THREAD, "GPU"}})
+    {
+        events.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 1},
+            {"tid", thread},
+            {"args", {{"name", threadName}}},
+        });
+    }
+    for (const FrameStats &frame: capturedFrames)
+    {
+        events.push_back(makeEvent("Frame", frame.startNs, frame.endNs, CPU_THREAD));
+        for (const ScopeTime &scope: frame.cpuScopes)
+        {
+            events.push_back(makeEvent(scope.name, scope.startNs, scope.endNs, CPU_THREAD));
+        }
+        for (const ScopeTime &scope: frame.gpuScopes)
+        {
+            events.push_back(makeEvent(scope.name, scope.startNs, scope.endNs, GPU_THREAD));
+        }
+        events.push_back({
+            {"name", "Frame counters"},
+            {"ph", "C"},
+            {"ts", toMicroseconds(frame.startNs)},
+            {"pid", 1},
+            {"args",
+             {
+                 {"draw_calls", frame.drawCalls},
+                 {"uploads", frame.uploads},
+                 {"upload_bytes", frame.uploadBytes},
+             }},
+        });
+    }
+    const nlohmann::json trace = {
+        {"traceEvents", events},
+        {"displayTimeUnit", "ms"},
+    };
+
+    std::ofstream file(capturePath);
+    if (!file.is_open())
+    {
+        Logger::Error("Could not open file {}", capturePath);
+        return;
+    }
+    file << trace.dump();
+    file.close();
+    Logger::Info("Wrote a {} frame trace to {}", capturedFrames.size(), capturePath);
+}
@@ -2,11 +2,13 @@
 // Created by droc101 on 2/2/26.
 //
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <game_sdk/gl/GLHelper.h>
 #include <game_sdk/ModelViewer.h>
 #include <game_sdk/Options.h>
+#include <game_sdk/Profiler.h>
 #include <game_sdk/SDKWindow.h>
 #include <game_sdk/SharedMgr.h>
 #include <imgui.h>
@@ -58,6 +60,12 @@ bool SDKWindow::Init(const std::string &appName, const glm::ivec2 windowSize, co
         return false;
     }
 
+    wakeEventType = SDL_RegisterEvents(1);
+    if (wakeEventType == 0)
+    {
+        Logger::Error("SDL_RegisterEvents() failed: {}", SDL_GetError());
+    }
+
     SharedMgr::Get().InitSharedMgr();
 
     const char *glslVersion = "#version 460";
@@ -186,41 +194,69 @@ void SDKWindow::MainLoop(const SDKWindowRenderFunction Render, const SDKWindowPr
     while (true)
     {
         SDL_Event event;
-        while (SDL_PollEvent(&event))
+        if (!continuousRendering && redrawFrames.load() <= 0)
         {
-            if (event.type == SDL_EVENT_QUIT)
-            {
-                quitRequest = true;
-            }
-            if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(window))
+            // Nothing to draw, so sleep until something happens. Timing out still draws a frame.
+            if (SDL_WaitEventTimeout(&event, IDLE_REDRAW_INTERVAL_MS))
             {
-                quitRequest = true;
-            } else if (ProcessEvent == nullptr || !ProcessEvent(&event))
-            {
-                ImGui_ImplSDL3_ProcessEvent(&event);
+                HandleEvent(event, ProcessEvent);
             }
         }
+        while (SDL_PollEvent(&event))
+        {
+            HandleEvent(event, ProcessEvent);
+        }
 
         if ((SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED) != 0)
         {
-            SDL_Delay(10);
+            if (continuousRendering)
+            {
+                SDL_Delay(10);
+            } else
+            {
+                // Go idle until the window is restored
+                redrawFrames.store(0);
+            }
             continue;
         }
+        if (redrawFrames.load() > 0)
+        {
+            redrawFrames--;
+        }
 
+        Profiler::Get().BeginFrame();
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL3_NewFrame();
         ImGui::NewFrame();
 
-        Render();
-
-        SharedMgr::Get().RenderSharedUI();
-        ImGui::Render();
+        {
+            const Profiler::Scope scope("Render");
+            Render();
+        }
+        {
+            const Profiler::Scope scope("Shared UI");
+            SharedMgr::Get().RenderSharedUI();
+        }
 
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        if (!SDL_GL_SwapWindow(window))
         {
-            Logger::Error("SDL_GL_SwapWindow() failed: {}", SDL_GetError());
+            const Profiler::Scope scope("ImGui");
+            const Profiler::GpuScope gpuScope("ImGui");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        {
+            const Profiler::Scope scope("Texture uploads");
+            const Profiler::GpuScope gpuScope("Texture uploads");
+            SharedMgr::Get().textureCache.EndFrame();
         }
+        {
+            const Profiler::Scope scope("Swap");
+            if (!SDL_GL_SwapWindow(window))
+            {
+                Logger::Error("SDL_GL_SwapWindow() failed: {}", SDL_GetError());
+            }
+        }
+        Profiler::Get().EndFrame();
 
         if (quitRequest)
         {
@@ -229,6 +265,45 @@ void SDKWindow::MainLoop(const SDKWindowRenderFunction Render, const SDKWindowPr
     }
 }
 
+void SDKWindow::HandleEvent(SDL_Event &event, const SDKWindowProcessEventFunction ProcessEvent)
+{
+    if (event.type == wakeEventType)
+    {
+        return;
+    }
+    RequestRedraw();
+    if (event.type == SDL_EVENT_QUIT)
+    {
+        quitRequest = true;
+    }
+    if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(window))
+    {
+        quitRequest = true;
+    } else if (ProcessEvent == nullptr || !ProcessEvent(&event))
+    {
+        ImGui_ImplSDL3_ProcessEvent(&event);
+    }
+}
+
+void SDKWindow::RequestRedraw()
+{
+    redrawFrames.store(REDRAW_FRAMES);
+    if (!SDL_IsMainThread() && wakeEventType != 0)
+    {
+        SDL_Event event{};
+        event.type = wakeEventType;
+        if (!SDL_PushEvent(&event))
+        {
+            Logger::Error("SDL_PushEvent() failed: {}", SDL_GetError());
+        }
+    }
+}
+
+void SDKWindow::SetContinuousRendering(const bool continuous)
+{
+    continuousRendering = continuous;
+}
+
 SDL_Window *SDKWindow::GetWindow() const
 {
     assert(initDone);
@@ -298,6 +373,8 @@ void SDKWindow::MultiFileDialogCallback(void *callbackPtr, const char *const *fi
         fileList++;
     }
 
+    // The callback will change what's on screen
+    Get().RequestRedraw();
     const SDKWindowMultiFileDialogCallback Callback = reinterpret_cast<SDKWindowMultiFileDialogCallback>(callbackPtr);
     if (SDL_IsMainThread())
     {
@@ -319,6 +396,8 @@ void SDKWindow::FileDialogCallback(void *callbackPtr, const char *const *fileLis
         return;
     }
 
+    // The callback will change what's on screen
+    Get().RequestRedraw();
     const SDKWindowFileDialogCallback Callback = reinterpret_cast<SDKWindowFileDialogCallback>(callbackPtr);
     if (SDL_IsMainThread())
     {
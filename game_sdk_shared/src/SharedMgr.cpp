@@ -9,11 +9,13 @@
 #include <game_sdk/windows/MaterialBrowserWindow.h>
 #include <game_sdk/windows/ModelBrowserWindow.h>
 #include <game_sdk/windows/OptionsWindow.h>
+#include <game_sdk/windows/ProfilerWindow.h>
 #include <game_sdk/windows/SetupWindow.h>
 #include <game_sdk/windows/SoundBrowserWindow.h>
 #include <game_sdk/windows/TextureBrowserWindow.h>
 #include <imgui.h>
 #include <libassets/asset/DataAsset.h>
+#include <libassets/util/AssetCache.h>
 #include <libassets/util/Error.h>
 #include <SDL3/SDL_filesystem.h>
 #include <SDL3/SDL_misc.h>
@@ -57,6 +59,10 @@ void SharedMgr::SharedMenuUI(const std::string &programName)
         {
             OptionsWindow::Get().Show();
         }
+        if (ImGui::MenuItem("Frame Profiler"))
+        {
+            ProfilerWindow::Get().Show();
+        }
         ImGui::EndMenu();
     }
 #ifdef BUILDSTYLE_DEBUG
@@ -70,6 +76,10 @@ void SharedMgr::SharedMenuUI(const std::string &programName)
         {
             demoVisible = true;
         }
+        if (ImGui::MenuItem("Texture Cache Stats"))
+        {
+            textureCacheStatsVisible = true;
+        }
         ImGui::EndMenu();
     }
 #endif
@@ -108,6 +118,7 @@ void SharedMgr::RenderSharedUI()
     ModelBrowserWindow::Get().Render();
     SoundBrowserWindow::Get().Render();
     SetupWindow::Get().Render();
+    ProfilerWindow::Get().Render();
     if (metricsVisible)
     {
         ImGui::ShowMetricsWindow(&metricsVisible);
@@ -116,6 +127,38 @@ void SharedMgr::RenderSharedUI()
     {
         ImGui::ShowDemoWindow(&demoVisible);
     }
+    if (textureCacheStatsVisible)
+    {
+        RenderTextureCacheStats();
+    }
+}
+
+void SharedMgr::RenderTextureCacheStats()
+{
+    if (!ImGui::Begin("Texture Cache Stats", &textureCacheStatsVisible, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        ImGui::End();
+        return;
+    }
+    constexpr float MIB = 1024.0f * 1024.0f;
+    const AssetCache<GLTextureCache::GLTexture>::Stats stats = textureCache.GetStats();
+    ImGui::Text("Textures: %zu", stats.entryCount);
+    ImGui::Text("Memory: %.1f / %.1f MiB",
+                static_cast<float>(stats.bytes) / MIB,
+                static_cast<float>(stats.budgetBytes) / MIB);
+    ImGui::Text("Hits: %zu", stats.hits);
+    ImGui::Text("Misses: %zu", stats.misses);
+    ImGui::Text("Evictions: %zu", stats.evictions);
+    if (ImGui::Button("Reset Stats"))
+    {
+        textureCache.ResetStats();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear Cache"))
+    {
+        textureCache.Clear();
+    }
+    ImGui::End();
 }
 
 void SharedMgr::UpdateAssetPaths()
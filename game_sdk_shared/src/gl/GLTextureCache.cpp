@@ -2,71 +2,122 @@
 // Created by droc101 on 7/22/25.
 //
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <filesystem>
+#include <cstring>
 #include <game_sdk/gl/GLTextureCache.h>
+#include <game_sdk/Profiler.h>
+#include <game_sdk/SDKWindow.h>
 #include <game_sdk/SharedMgr.h>
 #include <imgui.h>
+#include <iterator>
 #include <libassets/asset/TextureAsset.h>
+#include <libassets/util/AssetCache.h>
 #include <libassets/util/Error.h>
-#include <ranges>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
+
+GLTextureCache::GLTexture::GLTexture(const GLuint id, const ImVec2 size): id(id), size(size) {}
+
+GLTextureCache::GLTexture::~GLTexture()
+{
+    glDeleteTextures(1, &id);
+}
 
 GLTextureCache::~GLTextureCache()
 {
-    for (const ImTextureID &textureId: textureBuffers | std::views::values)
+    frameTextures.clear();
+    registeredTextures.clear();
+    textures.Clear();
+    if (uploadBuffer != 0)
     {
-        const GLuint &tex = textureId;
-        glDeleteTextures(1, &tex);
+        glDeleteBuffers(1, &uploadBuffer);
     }
-    textureBuffers.clear();
 }
 
 void GLTextureCache::InitMissingTexture()
 {
     TextureAsset texture;
     texture.CreateMissingTexture();
-    this->missingTexture = static_cast<ImTextureID>(CreateTexture(texture));
-}
+    this->missingTexture = std::make_shared<GLTexture>(CreateTexture(texture),
+                                                       ImVec2(static_cast<float>(texture.GetWidth()),
+                                                              static_cast<float>(texture.GetHeight())));
 
+    constexpr std::array<uint8_t, 4> loadingPixel = {0x40, 0x40, 0x40, 0xFF};
+    GLuint loadingGlTexture = 0;
+    glGenTextures(1, &loadingGlTexture);
+    glBindTexture(GL_TEXTURE_2D, loadingGlTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, loadingPixel.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    this->loadingTexture = std::make_shared<GLTexture>(loadingGlTexture, ImVec2(1, 1));
+}
 
 GLuint GLTextureCache::CreateTexture(const TextureAsset &textureAsset)
 {
-    const uint8_t *pixels = textureAsset.GetPixelsRGBA();
+    return CreateTexture(textureAsset, textureAsset.GetPixelsRGBA());
+}
+
+GLuint GLTextureCache::CreateTexture(const TextureAsset &textureAsset, const void *pixels)
+{
     GLuint glTexture = 0;
     glGenTextures(1, &glTexture);
     glBindTexture(GL_TEXTURE_2D, glTexture);
-    if (textureAsset.GetFormat() == TextureAsset::PixelFormat::RGBA8)
+    const bool isHdr = textureAsset.GetFormat() == TextureAsset::PixelFormat::RGBAF16;
+    const bool isCompressed = TextureAsset::IsCompressedFormat(textureAsset.GetFormat());
+    const uint32_t levelCount = GetUploadedLevelCount(textureAsset);
+    const uintptr_t basePixels = reinterpret_cast<uintptr_t>(pixels);
+    Profiler::Get().CountUpload(GetPixelBytes(textureAsset));
+    for (uint32_t level = 0; level < levelCount; level++)
     {
+        const uintptr_t levelOffset = static_cast<uintptr_t>(textureAsset.GetLevelPixels(level) -
+                                                             textureAsset.GetPixelsRGBA());
+        if (isCompressed)
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D,
+                                   static_cast<GLint>(level),
+                                   GetCompressedInternalFormat(textureAsset.GetFormat()),
+                                   static_cast<GLsizei>(textureAsset.GetLevelWidth(level)),
+                                   static_cast<GLsizei>(textureAsset.GetLevelHeight(level)),
+                                   0,
+                                   static_cast<GLsizei>(textureAsset.GetLevelDataSize(level)),
+                                   reinterpret_cast<const void *>(basePixels + levelOffset));
+            continue;
+        }
         glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RGBA8,
-                     static_cast<GLsizei>(textureAsset.GetWidth()),
-                     static_cast<GLsizei>(textureAsset.GetHeight()),
+                     static_cast<GLint>(level),
+                     isHdr ? GL_RGBA16F : GL_RGBA8,
+                     static_cast<GLsizei>(textureAsset.GetLevelWidth(level)),
+                     static_cast<GLsizei>(textureAsset.GetLevelHeight(level)),
                      0,
                      GL_RGBA,
-                     GL_UNSIGNED_BYTE,
-                     pixels);
-    } else
-    {
-        glTexImage2D(GL_TEXTURE_2D,
-                     0,
-                     GL_RGBA16F,
-                     static_cast<GLsizei>(textureAsset.GetWidth()),
-                     static_cast<GLsizei>(textureAsset.GetHeight()),
-                     0,
-                     GL_RGBA,
-                     GL_HALF_FLOAT,
-                     pixels);
+                     isHdr ? GL_HALF_FLOAT : GL_UNSIGNED_BYTE,
+                     reinterpret_cast<const void *>(basePixels + levelOffset));
     }
     const GLint magfilter = textureAsset.filter ? GL_LINEAR : GL_NEAREST;
     GLint minFilter = magfilter;
     const GLint repeat = textureAsset.repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
-    if (textureAsset.mipmaps)
+    // Compressed textures can't have their mip chain generated by GL, so they only use the levels they store
+    if (textureAsset.mipmaps && (!isCompressed || levelCount > 1))
     {
-        glGenerateMipmap(GL_TEXTURE_2D);
+        if (levelCount == 1)
+        {
+            // Older textures don't store their mip chain
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
         minFilter = textureAsset.filter ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
     }
+    if (textureAsset.GetFormat() == TextureAsset::PixelFormat::BC4)
+    {
+        // Single channel textures are grayscale, not red
+        const std::array<GLint, 4> swizzle = {GL_RED, GL_RED, GL_RED, GL_ONE};
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle.data());
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magfilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, repeat);
@@ -75,64 +126,233 @@ GLuint GLTextureCache::CreateTexture(const TextureAsset &textureAsset)
     return glTexture;
 }
 
-Error::ErrorCode GLTextureCache::GetTextureID(const std::string &relPath, ImTextureID &outTexture)
+GLuint GLTextureCache::UploadTexture(const TextureAsset &textureAsset)
 {
-    if (textureBuffers.contains(relPath))
+    const size_t pixelBytes = GetPixelBytes(textureAsset);
+    if (uploadBuffer == 0)
     {
-        outTexture = textureBuffers.at(std::string(relPath));
-        return Error::ErrorCode::OK;
+        glGenBuffers(1, &uploadBuffer);
     }
-    const std::string texturePath = SharedMgr::Get().pathManager.GetAssetPath(relPath);
-    if (!std::filesystem::exists(texturePath))
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+    // Orphan the previous contents so the driver doesn't wait for the last upload to finish reading them
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(pixelBytes), nullptr, GL_STREAM_DRAW);
+    void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                    0,
+                                    static_cast<GLsizeiptr>(pixelBytes),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped == nullptr)
     {
-        outTexture = missingTexture;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return CreateTexture(textureAsset);
+    }
+    std::memcpy(mapped, textureAsset.GetPixelsRGBA(), pixelBytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    const GLuint glTexture = CreateTexture(textureAsset, nullptr);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return glTexture;
+}
+
+GLenum GLTextureCache::GetCompressedInternalFormat(const TextureAsset::PixelFormat format)
+{
+    switch (format)
+    {
+        case TextureAsset::PixelFormat::BC1:
+            return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case TextureAsset::PixelFormat::BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureAsset::PixelFormat::BC4:
+            return GL_COMPRESSED_RED_RGTC1;
+        case TextureAsset::PixelFormat::BC5:
+            return GL_COMPRESSED_RG_RGTC2;
+        case TextureAsset::PixelFormat::BC6H:
+            return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+        case TextureAsset::PixelFormat::BC7:
+        default:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+}
+
+uint32_t GLTextureCache::GetUploadedLevelCount(const TextureAsset &textureAsset)
+{
+    return textureAsset.mipmaps ? textureAsset.GetLevelCount() : 1;
+}
+
+size_t GLTextureCache::GetPixelBytes(const TextureAsset &textureAsset)
+{
+    size_t pixelBytes = 0;
+    for (uint32_t level = 0; level < GetUploadedLevelCount(textureAsset); level++)
+    {
+        pixelBytes += textureAsset.GetLevelDataSize(level);
+    }
+    return pixelBytes;
+}
+
+size_t GLTextureCache::GetTextureBytes(const TextureAsset &textureAsset)
+{
+    const size_t pixelBytes = GetPixelBytes(textureAsset);
+    if (textureAsset.mipmaps && textureAsset.GetLevelCount() == 1 &&
+        !TextureAsset::IsCompressedFormat(textureAsset.GetFormat()))
+    {
+        // CreateTexture has GL generate the mip chain, which adds about a third of the base level
+        return pixelBytes + (pixelBytes / 3);
+    }
+    return pixelBytes;
+}
+
+Error::ErrorCode GLTextureCache::GetTexture(const std::string &relPath, std::shared_ptr<GLTexture> &outTexture)
+{
+    if (registeredTextures.contains(relPath))
+    {
+        outTexture = registeredTextures.at(relPath);
         return Error::ErrorCode::OK;
     }
-    TextureAsset asset;
-    const Error::ErrorCode error = asset.LoadFromAsset(texturePath);
+    std::shared_ptr<GLTexture> texture = textures.Get(relPath);
+    if (texture == nullptr)
+    {
+        const std::string texturePath = SharedMgr::Get().pathManager.GetAssetPath(relPath);
+        if (texturePath.empty())
+        {
+            outTexture = missingTexture;
+            return Error::ErrorCode::OK;
+        }
+        TextureAsset asset;
+        const Error::ErrorCode error = asset.LoadFromAsset(texturePath);
+        if (error != Error::ErrorCode::OK)
+        {
+            return error;
+        }
+        texture = std::make_shared<GLTexture>(CreateTexture(asset),
+                                              ImVec2(static_cast<float>(asset.GetWidth()),
+                                                     static_cast<float>(asset.GetHeight())));
+        texture = textures.Insert(relPath, texture, GetTextureBytes(asset));
+    }
+    frameTextures.push_back(texture);
+    outTexture = texture;
+    return Error::ErrorCode::OK;
+}
+
+Error::ErrorCode GLTextureCache::GetTextureID(const std::string &relPath, ImTextureID &outTexture)
+{
+    std::shared_ptr<GLTexture> texture = nullptr;
+    const Error::ErrorCode error = GetTexture(relPath, texture);
     if (error != Error::ErrorCode::OK)
     {
         return error;
     }
-    const GLuint glTex = CreateTexture(asset);
-    textureBuffers.insert({relPath, glTex});
-    outTexture = glTex;
+    outTexture = static_cast<ImTextureID>(texture->id);
     return Error::ErrorCode::OK;
 }
 
 Error::ErrorCode GLTextureCache::GetTextureSize(const std::string &relPath, ImVec2 &outSize)
 {
-    ImTextureID texture = 0;
-    const Error::ErrorCode error = GetTextureID(relPath, texture);
+    std::shared_ptr<GLTexture> texture = nullptr;
+    const Error::ErrorCode error = GetTexture(relPath, texture);
     if (error != Error::ErrorCode::OK)
     {
         return error;
     }
-    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture));
-    int w = 0;
-    int h = 0;
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
-    outSize = {static_cast<float>(w), static_cast<float>(h)};
+    outSize = texture->size;
     return Error::ErrorCode::OK;
 }
 
 Error::ErrorCode GLTextureCache::GetTextureGLuint(const std::string &relPath, GLuint &outTexture)
 {
-    ImTextureID texture = 0;
-    const Error::ErrorCode error = GetTextureID(relPath, texture);
+    std::shared_ptr<GLTexture> texture = nullptr;
+    const Error::ErrorCode error = GetTexture(relPath, texture);
     if (error != Error::ErrorCode::OK)
     {
         return error;
     }
-    outTexture = static_cast<GLuint>(texture);
+    outTexture = texture->id;
     return Error::ErrorCode::OK;
 }
 
+bool GLTextureCache::RequestTexture(const std::string &relPath, ImTextureID &outTexture, ImVec2 &outSize)
+{
+    std::shared_ptr<GLTexture> texture = nullptr;
+    bool ready = true;
+    if (registeredTextures.contains(relPath))
+    {
+        texture = registeredTextures.at(relPath);
+    } else if (pendingTextures.contains(relPath))
+    {
+        texture = loadingTexture;
+        ready = false;
+    } else if (failedTextures.contains(relPath))
+    {
+        texture = missingTexture;
+    } else
+    {
+        texture = textures.Get(relPath);
+        if (texture != nullptr)
+        {
+            frameTextures.push_back(texture);
+        } else
+        {
+            const std::string texturePath = SharedMgr::Get().pathManager.GetAssetPath(relPath);
+            if (texturePath.empty())
+            {
+                texture = missingTexture;
+            } else
+            {
+                pendingTextures.insert(relPath);
+                SharedMgr::Get().loadPool.Submit([queue = decodeQueue, relPath, texturePath] {
+                    std::unique_ptr<TextureAsset> asset = std::make_unique<TextureAsset>();
+                    if (asset->LoadFromAsset(texturePath) != Error::ErrorCode::OK)
+                    {
+                        asset = nullptr;
+                    }
+                    const std::lock_guard lock(queue->mutex);
+                    queue->textures.push_back({
+                        .relPath = relPath,
+                        .asset = std::move(asset),
+                    });
+                    SDKWindow::Get().RequestRedraw();
+                });
+                texture = loadingTexture;
+                ready = false;
+            }
+        }
+    }
+    outTexture = static_cast<ImTextureID>(texture->id);
+    outSize = texture->size;
+    return ready;
+}
+
+void GLTextureCache::ProcessUploads()
+{
+    {
+        const std::lock_guard lock(decodeQueue->mutex);
+        std::ranges::move(decodeQueue->textures, std::back_inserter(uploadQueue));
+        decodeQueue->textures.clear();
+    }
+    size_t uploadedBytes = 0;
+    while (!uploadQueue.empty() && uploadedBytes < UPLOAD_BUDGET_BYTES_PER_FRAME)
+    {
+        const DecodedTexture decoded = std::move(uploadQueue.front());
+        uploadQueue.pop_front();
+        pendingTextures.erase(decoded.relPath);
+        if (decoded.asset == nullptr)
+        {
+            failedTextures.insert(decoded.relPath);
+            continue;
+        }
+        if (textures.Contains(decoded.relPath))
+        {
+            continue; // Loaded synchronously while this one was decoding
+        }
+        const std::shared_ptr<GLTexture> texture = std::make_shared<GLTexture>(
+                UploadTexture(*decoded.asset),
+                ImVec2(static_cast<float>(decoded.asset->GetWidth()), static_cast<float>(decoded.asset->GetHeight())));
+        textures.Insert(decoded.relPath, texture, GetTextureBytes(*decoded.asset));
+        uploadedBytes += GetPixelBytes(*decoded.asset);
+    }
+}
+
 Error::ErrorCode GLTextureCache::LoadTexture(const std::string &relPath)
 {
-    ImTextureID unused = 0;
-    return GetTextureID(relPath, unused);
+    std::shared_ptr<GLTexture> unused = nullptr;
+    return GetTexture(relPath, unused);
 }
 
 Error::ErrorCode GLTextureCache::RegisterPng(const std::string &pngPath,
@@ -150,27 +370,51 @@ Error::ErrorCode GLTextureCache::RegisterPng(const std::string &pngPath,
     tex.filter = filter;
     tex.mipmaps = mipmaps;
     tex.repeat = repeat;
-    const GLuint glTex = CreateTexture(tex);
-    textureBuffers.insert({name, glTex});
+    registeredTextures.insert({name,
+                               std::make_shared<GLTexture>(CreateTexture(tex),
+                                                           ImVec2(static_cast<float>(tex.GetWidth()),
+                                                                  static_cast<float>(tex.GetHeight())))});
     return Error::ErrorCode::OK;
 }
 
+void GLTextureCache::EndFrame()
+{
+    ProcessUploads();
+    if (!uploadQueue.empty())
+    {
+        // The rest of the textures are uploaded over the next frames
+        SDKWindow::Get().RequestRedraw();
+    }
+    frameTextures.clear();
+}
+
+void GLTextureCache::Clear()
+{
+    textures.Clear();
+    failedTextures.clear();
+}
+
+AssetCache<GLTextureCache::GLTexture>::Stats GLTextureCache::GetStats()
+{
+    return textures.GetStats();
+}
+
+void GLTextureCache::ResetStats()
+{
+    textures.ResetStats();
+}
+
 GLuint GLTextureCache::GetMissingTextureGLuint() const
 {
-    return static_cast<GLuint>(missingTexture);
+    return missingTexture->id;
 }
 
 ImTextureID GLTextureCache::GetMissingTextureID() const
 {
-    return missingTexture;
+    return static_cast<ImTextureID>(missingTexture->id);
 }
 
 ImVec2 GLTextureCache::GetMissingTextureSize() const
 {
-    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(missingTexture));
-    int w = 0;
-    int h = 0;
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
-    return {static_cast<float>(w), static_cast<float>(h)};
+    return missingTexture->size;
 }
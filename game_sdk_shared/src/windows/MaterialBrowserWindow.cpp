@@ -2,6 +2,7 @@
 // Created by droc101 on 11/16/25.
 //
 
+#include <atomic>
 #include <cfloat>
 #include <cstddef>
 #include <format>
@@ -13,6 +14,7 @@
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
 #include <libassets/util/SearchPathManager.h>
+#include <memory>
 #include <misc/cpp/imgui_stdlib.h>
 #include <string>
 #include <vector>
@@ -37,18 +39,32 @@ void MaterialBrowserWindow::Show(std::string *material)
             absMaterialPaths = SharedMgr::Get().pathManager.ScanAssetFolder("/material", ".gmtl");
     for (const SearchPathManager::AssetResult &path: absMaterialPaths)
     {
-        LevelMaterialAsset mat;
-        const Error::ErrorCode e = mat.LoadFromAsset(path.absolutePath);
-        if (e != Error::ErrorCode::OK)
-        {
-            Logger::Error("Failed to load level material asset \"{}\"", path.absolutePath.c_str());
-        }
-        materials.push_back(mat);
+        const std::shared_ptr<MaterialSlot> slot = std::make_shared<MaterialSlot>();
+        slot->absolutePath = path.absolutePath;
+        materials.push_back(slot);
         materialPaths.push_back(path.relativePath);
     }
     visible = true;
 }
 
+void MaterialBrowserWindow::RequestMaterial(const std::shared_ptr<MaterialSlot> &slot)
+{
+    if (slot->requested)
+    {
+        return;
+    }
+    slot->requested = true;
+    SharedMgr::Get().loadPool.Submit([slot] {
+        const Error::ErrorCode e = slot->material.LoadFromAsset(slot->absolutePath);
+        if (e != Error::ErrorCode::OK)
+        {
+            Logger::Error("Failed to load level material asset \"{}\"", slot->absolutePath.c_str());
+        }
+        slot->loaded.store(true, std::memory_order_release);
+        SDKWindow::Get().RequestRedraw();
+    });
+}
+
 void MaterialBrowserWindow::Render()
 {
     if (visible)
@@ -77,19 +93,6 @@ void MaterialBrowserWindow::Render()
                         continue;
                     }
 
-                    const std::string textureName = materials.at(i).texture;
-
-                    ImVec2 texSize;
-                    ImTextureID tex = 0;
-                    if (SharedMgr::Get().textureCache.GetTextureID(textureName, tex) != Error::ErrorCode::OK)
-                    {
-                        texSize = SharedMgr::Get().textureCache.GetMissingTextureSize();
-                        tex = SharedMgr::Get().textureCache.GetMissingTextureID();
-                    } else
-                    {
-                        assert(SharedMgr::Get().textureCache.GetTextureSize(textureName, texSize) == Error::ErrorCode::OK);
-                    }
-
                     ImGui::PushID(static_cast<int>(i));
 
                     const ImVec2 pos = ImGui::GetCursorScreenPos();
@@ -98,6 +101,19 @@ void MaterialBrowserWindow::Render()
                         ImGui::NewLine();
                     }
 
+                    ImVec2 texSize = {1, 1};
+                    ImTextureID tex = 0;
+                    const std::shared_ptr<MaterialSlot> &slot = materials.at(i);
+                    // Only tiles on screen are loaded, so opening a large folder doesn't queue every material at once
+                    if (ImGui::IsRectVisible(ImVec2(TILE_SIZE, TILE_SIZE)))
+                    {
+                        RequestMaterial(slot);
+                        if (slot->loaded.load(std::memory_order_acquire))
+                        {
+                            (void)SharedMgr::Get().textureCache.RequestTexture(slot->material.texture, tex, texSize);
+                        }
+                    }
+
                     const float cursor = ImGui::GetCursorPosX();
 
                     if (ImGui::Selectable("##tile",
@@ -136,7 +152,10 @@ void MaterialBrowserWindow::Render()
                     ImGui::SetCursorPos(ImVec2(cursorPos.x + (TILE_SIZE - drawWidth) * 0.5f,
                                                cursorPos.y + (TILE_SIZE - drawHeight) * 0.5f));
 
-                    ImGui::Image(tex, ImVec2(drawWidth, drawHeight));
+                    if (tex != 0)
+                    {
+                        ImGui::Image(tex, ImVec2(drawWidth, drawHeight));
+                    }
 
                     ImGui::SameLine(0.0f, spacing);
                     ImGui::SetCursorPosX(cursor + TILE_SIZE + spacing);
@@ -2,7 +2,7 @@
 // Created by droc101 on 2/17/26.
 //
 
-#include <cassert>
+#include <atomic>
 #include <cfloat>
 #include <cstddef>
 #include <game_sdk/ModelViewer.h>
@@ -12,7 +12,9 @@
 #include <imgui.h>
 #include <libassets/asset/ModelAsset.h>
 #include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
 #include <libassets/util/SearchPathManager.h>
+#include <memory>
 #include <misc/cpp/imgui_stdlib.h>
 #include <string>
 #include <utility>
@@ -42,12 +44,37 @@ void ModelBrowserWindow::Show(std::string *model)
         models.push_back(mPath.relativePath);
         modelAbsPaths.push_back(mPath.absolutePath);
     }
-    ModelAsset mdlAsset{};
-    (void)mdlAsset.LoadFromAsset(SharedMgr::Get().pathManager.GetAssetPath(*model));
-    viewer.SetModel(std::move(mdlAsset));
+    LoadPreviewModel(SharedMgr::Get().pathManager.GetAssetPath(*model));
     visible = true;
 }
 
+void ModelBrowserWindow::LoadPreviewModel(const std::string &absolutePath)
+{
+    const std::shared_ptr<PendingModel> pending = std::make_shared<PendingModel>();
+    SharedMgr::Get().loadPool.Submit([pending, absolutePath] {
+        pending->error = pending->model.LoadFromAsset(absolutePath);
+        pending->loaded.store(true, std::memory_order_release);
+        SDKWindow::Get().RequestRedraw();
+    });
+    pendingModel = pending;
+}
+
+void ModelBrowserWindow::UpdatePreviewModel()
+{
+    if (pendingModel == nullptr || !pendingModel->loaded.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    if (pendingModel->error == Error::ErrorCode::OK)
+    {
+        viewer.SetModel(std::move(pendingModel->model));
+    } else
+    {
+        Logger::Error("Failed to load model for preview: {}", pendingModel->error);
+    }
+    pendingModel = nullptr;
+}
+
 void ModelBrowserWindow::InputModel(const char *label, std::string &model)
 {
     InputModel(label, &model);
@@ -70,6 +97,7 @@ void ModelBrowserWindow::Render()
 {
     if (visible)
     {
+        UpdatePreviewModel();
         ImGui::OpenPopup("Choose Model");
         ImGui::SetNextWindowSize(ImVec2(1000, 700), ImGuiCond_Appearing);
         ImGui::SetNextWindowSizeConstraints(ImVec2(300, 192), ImVec2(FLT_MAX, FLT_MAX));
@@ -97,10 +125,7 @@ void ModelBrowserWindow::Render()
                     {
                         if (*str != "model/" + model)
                         {
-                            ModelAsset mdlAsset{};
-                            const Error::ErrorCode e = mdlAsset.LoadFromAsset(modelAbs);
-                            assert(e == Error::ErrorCode::OK);
-                            viewer.SetModel(std::move(mdlAsset));
+                            LoadPreviewModel(modelAbs);
                         }
                         *str = "model/" + model;
                     }
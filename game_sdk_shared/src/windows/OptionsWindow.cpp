@@ -2,7 +2,9 @@
 // Created by droc101 on 6/29/25.
 //
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <game_sdk/DialogFilters.h>
 #include <game_sdk/Options.h>
 #include <game_sdk/SDKWindow.h>
@@ -76,6 +78,15 @@ void OptionsWindow::Render()
         ImGui::TextUnformatted("Default Material");
         MaterialBrowserWindow::Get().InputMaterial("##defaultmatinput", Options::Get().defaultMaterial);
 
+        ImGui::SeparatorText("Map Editor");
+        ImGui::TextUnformatted("Undo history memory limit (MiB)");
+        ImGui::PushItemWidth(-1);
+        constexpr uint32_t UNDO_MEMORY_STEP = 64;
+        if (ImGui::InputScalar("##undoMemory", ImGuiDataType_U32, &Options::Get().mapUndoMemoryMiB, &UNDO_MEMORY_STEP))
+        {
+            Options::Get().mapUndoMemoryMiB = std::max(Options::Get().mapUndoMemoryMiB, 1u);
+        }
+
         ImGui::SeparatorText("Appearance");
         ImGui::TextUnformatted("Theme");
         ImGui::PushItemWidth(-1);
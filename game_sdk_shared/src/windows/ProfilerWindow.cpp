@@ -0,0 +1,176 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <game_sdk/DialogFilters.h>
+#include <game_sdk/Profiler.h>
+#include <game_sdk/SDKWindow.h>
+#include <game_sdk/SharedMgr.h>
+#include <game_sdk/windows/ProfilerWindow.h>
+#include <imgui.h>
+#include <libassets/util/AssetCache.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+ProfilerWindow &ProfilerWindow::Get()
+{
+    static ProfilerWindow profilerWindowSingleton{};
+    return profilerWindowSingleton;
+}
+
+void ProfilerWindow::Show()
+{
+    visible = true;
+}
+
+void ProfilerWindow::Hide()
+{
+    visible = false;
+}
+
+void ProfilerWindow::CaptureCallback(const std::string &path)
+{
+    Profiler::Get().StartCapture(path);
+}
+
+void ProfilerWindow::Render()
+{
+    Profiler &profiler = Profiler::Get();
+    profiler.SetEnabled(visible);
+    if (!visible)
+    {
+        if (continuousRendering)
+        {
+            continuousRendering = false;
+            SDKWindow::Get().SetContinuousRendering(false);
+        }
+        return;
+    }
+    if (profiler.IsCapturing())
+    {
+        // The main loop would otherwise go idle part way through the capture
+        SDKWindow::Get().RequestRedraw();
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(420, 560), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Frame Profiler", &visible))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const std::array<float, Profiler::FRAME_HISTORY> &frameTimes = profiler.GetFrameTimes();
+    const float maxFrameTime = *std::ranges::max_element(frameTimes);
+    const float averageFrameTime = std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0f) /
+                                   static_cast<float>(frameTimes.size());
+    ImGui::Text("CPU frame time: %.2f ms average, %.2f ms max", averageFrameTime, maxFrameTime);
+    ImGui::PlotLines("##frameTimes",
+                     frameTimes.data(),
+                     static_cast<int>(frameTimes.size()),
+                     static_cast<int>(profiler.GetFrameTimeOffset()),
+                     nullptr,
+                     0.0f,
+                     std::max(maxFrameTime, 1000.0f / 60.0f),
+                     ImVec2(-1, 80));
+    if (ImGui::Checkbox("Continuous rendering", &continuousRendering))
+    {
+        SDKWindow::Get().SetContinuousRendering(continuousRendering);
+    }
+    ImGui::SetItemTooltip("Render every frame instead of only when something changes, for steady measurements");
+
+    constexpr float KIB = 1024.0f;
+    constexpr float MIB = 1024.0f * 1024.0f;
+    const Profiler::FrameStats &frame = profiler.GetLastFrame();
+    const AssetCache<GLTextureCache::GLTexture>::Stats textureStats = SharedMgr::Get().textureCache.GetStats();
+    ImGui::SeparatorText("Frame");
+    ImGui::Text("Draw calls: %zu", frame.drawCalls);
+    ImGui::Text("Buffer uploads: %zu (%.1f KiB)", frame.uploads, static_cast<float>(frame.uploadBytes) / KIB);
+    ImGui::Text("Texture memory: %.1f / %.1f MiB (%zu textures)",
+                static_cast<float>(textureStats.bytes) / MIB,
+                static_cast<float>(textureStats.budgetBytes) / MIB,
+                textureStats.entryCount);
+
+    ImGui::SeparatorText("CPU");
+    SumScopes(frame.cpuScopes, cpuTotals);
+    RenderScopeTable("##cpuScopes", cpuTotals);
+
+    ImGui::SeparatorText("GPU");
+    if (frame.gpuScopes.empty())
+    {
+        ImGui::TextDisabled("No GPU times for this frame");
+    } else
+    {
+        SumScopes(frame.gpuScopes, gpuTotals);
+        RenderScopeTable("##gpuScopes", gpuTotals);
+    }
+
+    ImGui::Separator();
+    if (profiler.IsCapturing())
+    {
+        ImGui::BeginDisabled();
+        ImGui::Button(std::format("Capturing ({}/{})", profiler.GetCapturedFrameCount(), Profiler::CAPTURE_FRAMES)
+                              .c_str());
+        ImGui::EndDisabled();
+    } else if (ImGui::Button("Capture Trace..."))
+    {
+        SDKWindow::Get().SaveFileDialog(CaptureCallback, DialogFilters::TRACE_FILTERS);
+    }
+    ImGui::SetItemTooltip("Record the next %zu frames to a file that can be opened in Perfetto or chrome://tracing",
+                          Profiler::CAPTURE_FRAMES);
+
+    ImGui::End();
+}
+
+void ProfilerWindow::SumScopes(const std::vector<Profiler::ScopeTime> &scopes, std::vector<ScopeTotal> &outTotals)
+{
+    outTotals.clear();
+    for (const Profiler::ScopeTime &scope: scopes)
+    {
+        const auto it = std::ranges::find_if(outTotals, [&scope](const ScopeTotal &total) {
+            return total.depth == scope.depth && std::strcmp(total.name, scope.name) == 0;
+        });
+        if (it == outTotals.end())
+        {
+            outTotals.push_back({
+                .name = scope.name,
+                .depth = scope.depth,
+                .totalNs = scope.endNs - scope.startNs,
+                .calls = 1,
+            });
+        } else
+        {
+            it->totalNs += scope.endNs - scope.startNs;
+            it->calls++;
+        }
+    }
+}
+
+void ProfilerWindow::RenderScopeTable(const char *id, const std::vector<ScopeTotal> &totals)
+{
+    if (!ImGui::BeginTable(id, 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+    {
+        return;
+    }
+    ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Time", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableHeadersRow();
+    for (const ScopeTotal &total: totals)
+    {
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0);
+        ImGui::Text("%*s%s", static_cast<int>(total.depth * 2), "", total.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f ms", static_cast<double>(total.totalNs) / 1'000'000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", total.calls);
+    }
+    ImGui::EndTable();
+}
@@ -117,6 +117,11 @@ void SoundBrowserWindow::Render()
                 }
             }
             ImGui::SameLine();
+            if (previewSound.IsPlaying())
+            {
+                // Keep the stop button in sync with playback
+                SDKWindow::Get().RequestRedraw();
+            }
             ImGui::BeginDisabled(!previewSound.IsPlaying());
             if (ImGui::Button("Stop", ImVec2(60, 0)))
             {
@@ -9,7 +9,6 @@
 #include <game_sdk/SharedMgr.h>
 #include <game_sdk/windows/TextureBrowserWindow.h>
 #include <imgui.h>
-#include <libassets/util/Error.h>
 #include <misc/cpp/imgui_stdlib.h>
 #include <string>
 #include <vector>
@@ -61,17 +60,6 @@ void TextureBrowserWindow::Render()
                         continue;
                     }
 
-                    ImVec2 texSize;
-                    ImTextureID tex = 0;
-                    if (SharedMgr::Get().textureCache.GetTextureID("texture/" + textures.at(i), tex) != Error::ErrorCode::OK)
-                    {
-                        texSize = SharedMgr::Get().textureCache.GetMissingTextureSize();
-                        tex = SharedMgr::Get().textureCache.GetMissingTextureID();
-                    } else
-                    {
-                        assert(SharedMgr::Get().textureCache.GetTextureSize("texture/" + textures.at(i), texSize) == Error::ErrorCode::OK);
-                    }
-
                     ImGui::PushID(static_cast<int>(i));
 
                     const ImVec2 pos = ImGui::GetCursorScreenPos();
@@ -80,6 +68,17 @@ void TextureBrowserWindow::Render()
                         ImGui::NewLine();
                     }
 
+                    ImVec2 texSize = {1, 1};
+                    ImTextureID tex = 0;
+                    bool loaded = false;
+                    // Only tiles on screen are loaded, so opening a large folder doesn't queue every texture at once
+                    if (ImGui::IsRectVisible(ImVec2(TILE_SIZE, TILE_SIZE)))
+                    {
+                        loaded = SharedMgr::Get().textureCache.RequestTexture("texture/" + textures.at(i),
+                                                                              tex,
+                                                                              texSize);
+                    }
+
                     const float cursor = ImGui::GetCursorPosX();
 
                     if (ImGui::Selectable("##tile",
@@ -91,7 +90,9 @@ void TextureBrowserWindow::Render()
                     }
                     if (ImGui::BeginItemTooltip())
                     {
-                        const std::string tooltip = std::format("{}\n{}x{}", textures.at(i), texSize.x, texSize.y);
+                        const std::string &name = textures.at(i);
+                        const std::string tooltip = loaded ? std::format("{}\n{}x{}", name, texSize.x, texSize.y)
+                                                           : std::format("{}\nLoading...", name);
                         ImGui::PushTextWrapPos(ImGui::GetFontSize() * 35.0f);
                         ImGui::TextUnformatted(tooltip.c_str());
                         ImGui::PopTextWrapPos();
@@ -118,7 +119,10 @@ void TextureBrowserWindow::Render()
                     ImGui::SetCursorPos(ImVec2(cursorPos.x + (TILE_SIZE - drawWidth) * 0.5f,
                                                cursorPos.y + (TILE_SIZE - drawHeight) * 0.5f));
 
-                    ImGui::Image(tex, ImVec2(drawWidth, drawHeight));
+                    if (tex != 0)
+                    {
+                        ImGui::Image(tex, ImVec2(drawWidth, drawHeight));
+                    }
 
                     ImGui::SameLine(0.0f, spacing);
                     ImGui::SetCursorPosX(cursor + TILE_SIZE + spacing);
@@ -11,6 +11,7 @@
 #include <libassets/type/Material.h>
 #include <libassets/type/ModelLod.h>
 #include <libassets/type/StaticCollisionMesh.h>
+#include <libassets/util/ConvexDecomposition.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
 #include <string>
@@ -28,14 +29,41 @@ class ModelAsset final: public Asset
             DYNAMIC_MULTIPLE_CONVEX
         };
 
+        enum class VertexFormat : uint8_t
+        {
+            /// 48 bytes of floats per vertex
+            FLOAT32,
+            /// ModelVertex::QUANTIZED_VERTEX_SIZE bytes per vertex, see ModelVertex::WriteQuantized
+            QUANTIZED
+        };
+
+        struct LodGenerationStep
+        {
+                /// The fraction of the first LOD's triangles to keep
+                float ratio = 0.5f;
+                /// The largest allowed error relative to the size of the model, which can keep more triangles
+                float maxError = 1.0f;
+        };
+
+        /// The distance where an error of one unit covers about a pixel, with a 90 degree FOV and a 1080p screen
+        static constexpr float LOD_DISTANCE_PER_UNIT_ERROR = 540.0f;
+
         /**
          * Please use @c ModelAsset::Create* instead.
          */
         ModelAsset() = default;
 
+        /// How close vertices have to be to be merged when importing LODs
+        ModelLod::WeldTolerances weldTolerances{};
+
+        /// How the vertices of every LOD are stored in the asset
+        VertexFormat vertexFormat = VertexFormat::FLOAT32;
+
         [[nodiscard]] Error::ErrorCode LoadFromBuffer(DataReader &reader) override;
         [[nodiscard]] Error::ErrorCode SaveToBuffer(DataWriter &writer) const override;
 
+        [[nodiscard]] Error::ErrorCode LoadFromAsset(const std::string &filePath) override;
+
         [[nodiscard]] Error::ErrorCode Import(const std::string &filePath) override;
 
         [[nodiscard]] AssetType GetAssetType() const override;
@@ -46,6 +74,11 @@ class ModelAsset final: public Asset
          */
         [[nodiscard]] ModelLod &GetLod(uint32_t index);
 
+        /**
+         * Get a LOD by index
+         */
+        [[nodiscard]] const ModelLod &GetLod(uint32_t index) const;
+
         /**
          * Sort LODs by distance
          */
@@ -57,6 +90,34 @@ class ModelAsset final: public Asset
          */
         [[nodiscard]] bool AddLod(const std::string &path);
 
+        /**
+         * Add several LODs, importing them in parallel. No LODs are added if any of them fail to import.
+         * @param paths The paths to conventional model files to use as the LODs
+         */
+        [[nodiscard]] bool AddLods(const std::vector<std::string> &paths);
+
+        /**
+         * Replace every LOD after the first with LODs simplified from the first, in parallel. Each LOD's distance is
+         * set to where its error becomes about a pixel on screen.
+         * @param steps One step per LOD to generate, from least to most simplified
+         * @return The number of LODs generated, which is less than the number of steps when a step doesn't remove any
+         *         more triangles than the one before it
+         */
+        size_t GenerateLods(const std::vector<LodGenerationStep> &steps);
+
+        /**
+         * Simplify the first LOD like GenerateLods does, without changing the model
+         * @param steps One step per LOD to generate, from least to most simplified
+         * @return The generated LODs, to be passed to ReplaceGeneratedLods
+         */
+        [[nodiscard]] std::vector<ModelLod> SimplifyLods(const std::vector<LodGenerationStep> &steps) const;
+
+        /**
+         * Replace every LOD after the first
+         * @param generatedLods LODs returned by SimplifyLods
+         */
+        void ReplaceGeneratedLods(std::vector<ModelLod> &&generatedLods);
+
         /**
          * Remove a LOD by index
          */
@@ -121,7 +182,7 @@ class ModelAsset final: public Asset
 
 
         /**
-         * Get a vertex buffer for a LOD
+         * Get a vertex buffer for a LOD, with interleaved float positions, UVs, colors and normals
          * @param lodIndex The index of the LOD
          * @param writer The DataWriter to write the buffer to
          */
@@ -167,6 +228,13 @@ class ModelAsset final: public Asset
          */
         void RemoveHull(size_t index);
 
+        /**
+         * Replace the convex hulls with an approximate convex decomposition of the first LOD
+         * @param parameters The limits of the decomposition
+         * @return The number of hulls generated, or 0 if none could be, in which case the hulls are left unchanged
+         */
+        size_t GenerateHulls(const ConvexDecomposition::Parameters &parameters);
+
         /**
          * Get the static collision mesh
          */
@@ -178,7 +246,11 @@ class ModelAsset final: public Asset
         void SetStaticCollisionMesh(const StaticCollisionMesh &mesh);
 
     private:
-        static constexpr uint8_t MODEL_ASSET_VERSION = 1;
+        static constexpr uint8_t MODEL_ASSET_VERSION = 3;
+        /// The last version without quantized vertices, which can still be loaded
+        static constexpr uint8_t MODEL_ASSET_VERSION_NO_QUANTIZATION = 1;
+        /// The last version without convex hull mass properties, which can still be loaded
+        static constexpr uint8_t MODEL_ASSET_VERSION_NO_HULL_MASS = 2;
 
         std::vector<Material> materials{};
         std::vector<std::vector<uint32_t>> skins{};
@@ -189,5 +261,7 @@ class ModelAsset final: public Asset
         std::vector<ConvexHull> convexHulls{};
         StaticCollisionMesh staticCollisionMesh{};
 
+        [[nodiscard]] Error::ErrorCode LoadFromBuffer(DataReader &reader, uint8_t version);
+
         static bool LODSortCompare(const ModelLod &a, const ModelLod &b);
 };
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <libassets/asset/Asset.h>
+#include <libassets/util/BlockCompressor.h>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
@@ -22,6 +23,18 @@ class TextureAsset final: public Asset
             RGBA8,
             /// 16-bit float (aka half float) per channel, 8 bytes total
             RGBAF16,
+            /// RGB with 1-bit alpha in 4x4 blocks, 8 bytes per block
+            BC1,
+            /// RGBA in 4x4 blocks, 16 bytes per block
+            BC3,
+            /// Single channel in 4x4 blocks, 8 bytes per block
+            BC4,
+            /// Two channels in 4x4 blocks, 16 bytes per block
+            BC5,
+            /// High quality RGBA in 4x4 blocks, 16 bytes per block
+            BC7,
+            /// Unsigned HDR RGB in 4x4 blocks, 16 bytes per block
+            BC6H,
         };
 
         /**
@@ -47,7 +60,10 @@ class TextureAsset final: public Asset
         /// Create a TextureAsset with the "missing texture" pattern
         void CreateMissingTexture();
 
-        /// Get the pixel data in RGBA format
+        /**
+         * Get the pixel data of the base level in RGBA format, or the blocks of the base level for compressed formats.
+         * The other mip levels, if any, follow it.
+         */
         [[nodiscard]] uint8_t *GetPixelsRGBA();
         [[nodiscard]] const uint8_t *GetPixelsRGBA() const;
 
@@ -57,21 +73,88 @@ class TextureAsset final: public Asset
         /// Get the height of the texture
         [[nodiscard]] uint32_t GetHeight() const;
 
-        /// Get the size of the pixel data in bytes
+        /// Get the size of the pixel data of every stored level in bytes
         [[nodiscard]] size_t GetPixelDataSize() const;
 
+        /**
+         * Generate the mip chain from the base level, replacing any stored levels.
+         * Compressed textures keep their stored levels, decompress them first to regenerate the chain.
+         */
+        void GenerateMipmaps();
+
+        /**
+         * Block compress every stored level, generating the mip chain first if @c mipmaps is set
+         * @param format The compressed format. BC6H needs an RGBAF16 texture, the others need an RGBA8 texture.
+         * @param quality The quality/speed tradeoff of the encoder
+         * @return Error Code
+         */
+        [[nodiscard]] Error::ErrorCode Compress(PixelFormat format, BlockCompressor::Quality quality);
+
+        /**
+         * Decode a compressed texture back to RGBA8, or RGBAF16 for BC6H. Does nothing to uncompressed textures.
+         * @return Error Code
+         */
+        [[nodiscard]] Error::ErrorCode Decompress();
+
+        /// Check if a pixel format is block compressed
+        [[nodiscard]] static bool IsCompressedFormat(PixelFormat format);
+
+        /// Check if a pixel format stores HDR colors
+        [[nodiscard]] static bool IsHdrFormat(PixelFormat format);
+
+        /**
+         * Get the number of stored mip levels, including the base level.
+         * This is 1 if the mip chain has not been generated, even if @c mipmaps is set.
+         */
+        [[nodiscard]] uint32_t GetLevelCount() const;
+
+        /// Get the width of a mip level
+        [[nodiscard]] uint32_t GetLevelWidth(uint32_t level) const;
+
+        /// Get the height of a mip level
+        [[nodiscard]] uint32_t GetLevelHeight(uint32_t level) const;
+
+        /// Get the pixel data of a mip level in RGBA format, or its blocks for compressed formats
+        [[nodiscard]] const uint8_t *GetLevelPixels(uint32_t level) const;
+
+        /// Get the size of the pixel data of a mip level in bytes
+        [[nodiscard]] size_t GetLevelDataSize(uint32_t level) const;
+
+        /**
+         * Get the smallest stored level that is at least a given size on its longest side
+         * @param minSize The size in pixels
+         * @return The level, or the base level if it is smaller than minSize
+         */
+        [[nodiscard]] uint32_t GetLevelForSize(uint32_t minSize) const;
+
         /**
          * Get the pixel data format of this texture asset
          */
         [[nodiscard]] PixelFormat GetFormat() const;
 
     private:
-        static constexpr uint8_t TEXTURE_ASSET_VERSION = 2;
+        static constexpr uint8_t TEXTURE_ASSET_VERSION = 4;
+        /// The last version without stored mip levels, which can still be loaded
+        static constexpr uint8_t TEXTURE_ASSET_VERSION_NO_MIPS = 2;
+        /// The last version without compressed formats, which can still be loaded
+        static constexpr uint8_t TEXTURE_ASSET_VERSION_NO_COMPRESSION = 3;
 
-        std::vector<uint8_t> pixelData{}; // just the bytes, NOT an array of pixels
+        std::vector<uint8_t> pixelData{}; // just the bytes, NOT an array of pixels. Every level, base level first.
         size_t width{};
         size_t height{};
         PixelFormat pixelFormat{};
+        uint32_t levelCount = 1;
+
+        [[nodiscard]] Error::ErrorCode LoadFromBuffer(DataReader &reader, uint8_t version);
+
+        /// Get the size of one pixel in bytes. Only valid for uncompressed formats.
+        [[nodiscard]] size_t GetBytesPerPixel() const;
+
+        /// Get the block compressor format for a compressed pixel format
+        [[nodiscard]] static BlockCompressor::Format GetBlockFormat(PixelFormat format);
+
+        /// Get the offset of a mip level in the pixel data
+        [[nodiscard]] size_t GetLevelOffset(uint32_t level) const;
 
         /**
         * Create an SDR @c TextureAsset from a PNG image
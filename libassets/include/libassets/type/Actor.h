@@ -24,6 +24,8 @@ class Actor
         glm::vec3 position{};
         glm::vec3 rotation{};
 
+        bool operator==(const Actor &other) const = default;
+
         /**
          * Apply an ActorDefinition to this actor's params
          * @param definition The definition to apply
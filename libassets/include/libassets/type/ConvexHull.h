@@ -5,15 +5,33 @@
 #pragma once
 
 #include <assimp/mesh.h>
+#include <cstddef>
+#include <glm/mat3x3.hpp>
+#include <glm/vec3.hpp>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
+#include <libassets/util/QuickHull.h>
 #include <string>
 #include <vector>
 
 class ConvexHull
 {
     public:
+        /// The physical properties of a solid hull
+        struct MassProperties
+        {
+                float volume = 0;
+                glm::vec3 centroid{};
+                /// The inertia tensor around the centroid for a mass of 1, to be multiplied by the actual mass
+                glm::mat3 inertia{0};
+        };
+
+        /// Points closer than this to the hull are dropped on import, relative to the size of the hull
+        static constexpr float DEFAULT_TOLERANCE = 0.002f;
+        /// The most points a hull keeps on import
+        static constexpr size_t DEFAULT_MAX_POINTS = 64;
+
         /**
          * Create a ConvexHull from an OBJ file
          * @param objPath The path to the OBJ file
@@ -22,12 +40,20 @@ class ConvexHull
         ConvexHull(const std::string &objPath, Error::ErrorCode &status);
         /**
          * Read a ConvexHull from a DataReader
+         * @param reader The DataReader to read from
+         * @param hasMassProperties Whether mass properties were written, otherwise they are calculated
          */
-        explicit ConvexHull(DataReader &reader);
+        ConvexHull(DataReader &reader, bool hasMassProperties);
         /**
          * Create a ConvexHull from an Assimp aiMesh
          */
         explicit ConvexHull(const aiMesh *mesh);
+        /**
+         * Create a ConvexHull from the convex hull of a set of points
+         * @param sourcePoints The points
+         * @param maxPoints The most points to keep
+         */
+        ConvexHull(const std::vector<glm::vec3> &sourcePoints, size_t maxPoints);
 
         /**
          * Write this ConvexHull to a DataWriter
@@ -44,6 +70,18 @@ class ConvexHull
          */
         [[nodiscard]] std::vector<float> GetPointsForRender() const;
 
+        /**
+         * Get the volume, centroid and inertia of this ConvexHull
+         */
+        [[nodiscard]] const MassProperties &GetMassProperties() const;
+
+        /**
+         * Replace the points with the vertices of their convex hull, and calculate the mass properties from it
+         * @param tolerance Points closer than this to the hull are dropped, relative to the size of the hull
+         * @param maxPoints The most points to keep, the ones that add the most volume are kept
+         */
+        void Reduce(float tolerance, size_t maxPoints);
+
         /**
          * Import multiple ConvexHulls from a single OBJ file
          * @param path The OBJ file to import from
@@ -54,6 +92,9 @@ class ConvexHull
     private:
         glm::vec3 offset{};
         std::vector<glm::vec3> points{};
+        MassProperties massProperties{};
 
         void CalculateOffset();
+
+        void CalculateMassProperties(const QuickHull::Hull &hull);
 };
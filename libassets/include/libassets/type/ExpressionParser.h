@@ -4,9 +4,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <tinyexpr.h>
-#include <unordered_map>
 #include <vector>
 
 class ExpressionParser
@@ -21,10 +21,11 @@ class ExpressionParser
         /**
          * Add a variable to this ExpressionParser
          * @param variableName The name of the variable
+         * @return The index of the variable, for setting it without looking it up by name
          * @note This name will change in the compiled expression
          * @note This expression must not be compiled before calling this method
          */
-        void AddVariable(const std::string &variableName);
+        size_t AddVariable(const std::string &variableName);
 
         /**
          * Compile this expression
@@ -40,6 +41,14 @@ class ExpressionParser
          */
         void SetVariable(const std::string &variableName, double value);
 
+        /**
+         * Set a variable's value
+         * @param variableIndex The index returned when the variable was added
+         * @param value The value to assign
+         * @note This expression must be compiled before calling this method
+         */
+        void SetVariable(size_t variableIndex, double value);
+
         /**
          * Evaluate this expression
          * @note This expression must be compiled before calling this method
@@ -55,15 +64,17 @@ class ExpressionParser
 
         struct ExpressionVariable
         {
+                /// The name of this variable in the original expression
+                std::string name{};
                 /// The compiled name of this variable
                 std::string compiledName{};
-                /// The value assigned to this variable
-                double value{};
         };
 
         std::string expression{};
         te_expr *expr = nullptr;
-        std::unordered_map<std::string, ExpressionVariable> varMetadata{};
+        std::vector<ExpressionVariable> varMetadata{};
+        /// The value of each variable, by index. The compiled expression reads these directly.
+        std::vector<double> values{};
         std::vector<te_variable> vars{};
 
         static double LightFalloffFunction(double constant,
@@ -23,6 +23,8 @@ class IOConnection
         Param param{};
         size_t numRefires{};
 
+        bool operator==(const IOConnection &other) const = default;
+
         /**
          * Read an IOConnection from a DataReader
          */
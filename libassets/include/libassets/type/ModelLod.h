@@ -9,18 +9,49 @@
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
+#include <libassets/util/MeshOptimizer.h>
 #include <string>
 #include <vector>
 
 class ModelLod
 {
     public:
+        /**
+         * How far apart vertex attributes may be for vertices to be merged on import.
+         * Attributes are snapped to a grid of this size before comparing, 0 only merges exactly equal attributes.
+         */
+        struct WeldTolerances
+        {
+                float position = 1e-5f;
+                float normal = 1e-3f;
+                float uv = 1e-5f;
+                float color = 1.0f / 512.0f;
+        };
+
         ModelLod() = default;
 
-        ModelLod(DataReader &reader, uint32_t materialsPerSkin);
+        /**
+         * Read a LOD
+         * @param reader The DataReader to read from
+         * @param materialsPerSkin The number of material slots of the model
+         * @param quantized Whether the vertices were written with ModelVertex::WriteQuantized
+         */
+        ModelLod(DataReader &reader, uint32_t materialsPerSkin, bool quantized);
 
         ModelLod(const std::string &filePath, float distance, Error::ErrorCode &status);
 
+        /**
+         * Import a LOD from a conventional model file
+         * @param filePath The model file
+         * @param distance The distance the LOD is used from
+         * @param status Where to store the error code
+         * @param weldTolerances How close vertices have to be to be merged
+         */
+        ModelLod(const std::string &filePath,
+                 float distance,
+                 Error::ErrorCode &status,
+                 const WeldTolerances &weldTolerances);
+
         float distance{};
         float unitsPerLuxel{};
         glm::uvec2 lightmapSize{1};
@@ -30,7 +61,32 @@ class ModelLod
 
         void Export(const char *path) const;
 
-        void Write(DataWriter &writer) const;
+        /**
+         * Write this LOD
+         * @param writer The DataWriter to write to
+         * @param quantized Whether to write the vertices with ModelVertex::WriteQuantized
+         */
+        void Write(DataWriter &writer, bool quantized) const;
+
+        /**
+         * Reorder triangles for the post-transform vertex cache and less overdraw, then reorder vertices to be fetched
+         * in order. Unused vertices are removed. Done on import.
+         */
+        void Optimize();
+
+        /**
+         * Simulate drawing this LOD with a post-transform vertex cache
+         */
+        [[nodiscard]] MeshOptimizer::VertexCacheStats AnalyzeVertexCache() const;
+
+        /**
+         * Create a copy of this LOD with fewer triangles. UV seams, borders and the edges between materials are kept.
+         * @param targetRatio The fraction of triangles to keep
+         * @param maxError The largest allowed error relative to the size of the LOD, which can keep more triangles
+         * @param outError Where to store the error of the result, in model units
+         * @return The simplified LOD, optimized and with a distance of 0
+         */
+        [[nodiscard]] ModelLod Simplify(float targetRatio, float maxError, float &outError) const;
 
         bool CalculateLightmapUvs();
 
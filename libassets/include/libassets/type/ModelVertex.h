@@ -4,13 +4,14 @@
 
 #pragma once
 
-#include <array>
 #include <assimp/mesh.h>
 #include <cstddef>
+#include <cstdint>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <libassets/type/Color.h>
 #include <libassets/util/DataReader.h>
+#include <libassets/util/DataWriter.h>
 
 class ModelVertex
 {
@@ -21,6 +22,14 @@ class ModelVertex
 
         explicit ModelVertex(const aiMesh *mesh, uint32_t vertexIndex);
 
+        /**
+         * Read a vertex written by WriteQuantized
+         * @param reader The DataReader to read from
+         * @param uvOffset The smallest UV of the LOD
+         * @param uvScale The size of the UV range of the LOD
+         */
+        ModelVertex(DataReader &reader, const glm::vec2 &uvOffset, const glm::vec2 &uvScale);
+
         bool operator==(const ModelVertex &other) const;
 
         glm::vec3 position{};
@@ -30,33 +39,15 @@ class ModelVertex
         glm::vec2 lightmapUv{};
 
         void Write(DataWriter &writer) const;
-};
 
-template<> struct std::hash<ModelVertex>
-{
-        size_t operator()(const ModelVertex &vertex) const noexcept
-        {
-            constexpr size_t GOLDEN_RATIO = 0x9e3779b9;
-            size_t hashValue = 0;
-
-            hashValue ^= std::hash<float>()(vertex.position.x) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            hashValue ^= std::hash<float>()(vertex.position.y) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            hashValue ^= std::hash<float>()(vertex.position.z) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-
-            hashValue ^= std::hash<float>()(vertex.normal.x) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            hashValue ^= std::hash<float>()(vertex.normal.y) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            hashValue ^= std::hash<float>()(vertex.normal.z) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-
-            hashValue ^= std::hash<float>()(vertex.uv.x) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            hashValue ^= std::hash<float>()(vertex.uv.y) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-
-            for (const float color: vertex.color.CopyData())
-            {
-                hashValue ^= std::hash<float>()(color) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            }
-
-            hashValue ^= std::hash<float>()(vertex.lightmapUv.x) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            hashValue ^= std::hash<float>()(vertex.lightmapUv.y) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
-            return hashValue;
-        }
+        /**
+         * Write this vertex in QUANTIZED_VERTEX_SIZE bytes: a half float position (with a w of 1), unorm16 UVs relative
+         * to the UV range of the LOD, an 8-bit color, an octahedral snorm16 normal and unorm16 lightmap UVs
+         * @param writer The DataWriter to write to
+         * @param uvOffset The smallest UV of the LOD
+         * @param uvScale The size of the UV range of the LOD
+         */
+        void WriteQuantized(DataWriter &writer, const glm::vec2 &uvOffset, const glm::vec2 &uvScale) const;
+
+        static constexpr size_t QUANTIZED_VERTEX_SIZE = 24;
 };
@@ -27,6 +27,8 @@ class Sector
         WallMaterial floorMaterial{};
         WallMaterial ceilingMaterial{};
 
+        bool operator==(const Sector &other) const = default;
+
         /**
          * Check if this sector is valid
          */
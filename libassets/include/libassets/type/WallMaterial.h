@@ -21,5 +21,7 @@ class WallMaterial
         glm::vec2 uvScale = {1, 1};
         float unitsPerLuxel = 1.0f;
 
+        bool operator==(const WallMaterial &other) const = default;
+
         [[nodiscard]] nlohmann::ordered_json GenerateJson() const;
 };
@@ -68,9 +68,9 @@ template<typename T> class NumericDefinitionValue: public BasicDefinitionValue<T
                 {
                     return defaultValue;
                 }
-                for (ExpressionVariable &i: varMetadata)
+                for (const ExpressionVariable &i: varMetadata)
                 {
-                    expressionParser.SetVariable(i.original, ProcessExpressionVariable(i, params));
+                    expressionParser.SetVariable(i.parserIndex, ProcessExpressionVariable(i, params));
                 }
 
                 const double result = expressionParser.Evaluate();
@@ -108,6 +108,8 @@ template<typename T> class NumericDefinitionValue: public BasicDefinitionValue<T
                 std::string paramName{};
                 /// The vector component to use
                 VectorComponent vectorComponent{};
+                /// The index of this variable in the expression parser
+                size_t parserIndex{};
         };
 
         ExpressionParser expressionParser{};
@@ -231,9 +233,9 @@ template<typename T> class NumericDefinitionValue: public BasicDefinitionValue<T
                     .original = match[0].str(),
                     .paramName = match[1].str(),
                     .vectorComponent = component,
+                    .parserIndex = expressionParser.AddVariable(match[0].str()),
                 };
                 varMetadata.push_back(var);
-                expressionParser.AddVariable(var.original);
 
                 iter = match.suffix().first;
                 matchNum++;
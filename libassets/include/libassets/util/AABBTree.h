@@ -0,0 +1,113 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/**
+ * A bounding volume hierarchy that objects can be added to, moved in and removed from without rebuilding it
+ * ("Dynamic Bounding Volume Hierarchies", Catto 2019). Leaves are enlarged by a margin so small moves don't need to
+ * touch the tree, and the tree is kept balanced with rotations as leaves are inserted and removed.
+ */
+class AABBTree
+{
+    public:
+        static constexpr int32_t NULL_NODE = -1;
+
+        struct Bounds
+        {
+                glm::vec3 min{};
+                glm::vec3 max{};
+
+                [[nodiscard]] bool Overlaps(const Bounds &other) const;
+                [[nodiscard]] bool Contains(const Bounds &other) const;
+                [[nodiscard]] Bounds Union(const Bounds &other) const;
+                /// Half of the surface area, which is all the insertion cost needs
+                [[nodiscard]] float GetHalfArea() const;
+        };
+
+        /**
+         * Create an empty tree
+         * @param margin How far leaves extend past the bounds they were inserted with
+         */
+        explicit AABBTree(float margin = 1.0f);
+
+        /**
+         * Add an object
+         * @param bounds The object's bounds
+         * @param userData Returned by queries that hit the object
+         * @return The ID of the object in the tree
+         */
+        [[nodiscard]] int32_t Insert(const Bounds &bounds, uint32_t userData);
+
+        /**
+         * Remove an object
+         * @param proxy The object's ID
+         */
+        void Remove(int32_t proxy);
+
+        /**
+         * Update an object's bounds
+         * @param proxy The object's ID
+         * @param bounds The new bounds
+         * @return Whether the object had to be moved in the tree, which is not needed while it stays inside its leaf
+         */
+        bool Move(int32_t proxy, const Bounds &bounds);
+
+        [[nodiscard]] uint32_t GetUserData(int32_t proxy) const;
+
+        /**
+         * Find the objects whose leaves overlap some bounds. This may include objects that are just outside of them.
+         * @param bounds The bounds to search
+         * @param outUserData Where to append the user data of each object found
+         */
+        void Query(const Bounds &bounds, std::vector<uint32_t> &outUserData) const;
+
+        /**
+         * Remove every object
+         */
+        void Clear();
+
+    private:
+        struct Node
+        {
+                Bounds bounds{};
+                /// The parent for nodes in the tree, or the next free node for nodes in the free list
+                int32_t parent = NULL_NODE;
+                int32_t left = NULL_NODE;
+                int32_t right = NULL_NODE;
+                /// 0 for leaves, -1 for free nodes
+                int32_t height = -1;
+                uint32_t userData = 0;
+
+                [[nodiscard]] bool IsLeaf() const;
+        };
+
+        float margin;
+        std::vector<Node> nodes{};
+        int32_t root = NULL_NODE;
+        int32_t freeList = NULL_NODE;
+        /// Reused by queries to avoid allocating
+        mutable std::vector<int32_t> stack{};
+
+        [[nodiscard]] int32_t AllocateNode();
+        void FreeNode(int32_t node);
+
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+
+        /**
+         * Rotate a node's children if one side is too tall
+         * @return The node that took the place of the given node
+         */
+        [[nodiscard]] int32_t Balance(int32_t node);
+
+        /**
+         * Walk from a node to the root, balancing and refitting each ancestor
+         */
+        void Refit(int32_t node);
+};
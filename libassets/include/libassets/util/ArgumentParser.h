@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <charconv>
 #include <string>
+#include <system_error>
 #include <vector>
 
 class ArgumentParser
@@ -27,6 +29,18 @@ class ArgumentParser
          */
         [[nodiscard]] std::string GetFlagValue(const std::string &flag) const;
 
+        /**
+         * Get the whole value of a flag as a number
+         * @return False if the value is not a number or does not fit
+         */
+        template<typename T> [[nodiscard]] bool GetFlagNumber(const std::string &flag, T &outValue) const
+        {
+            const std::string value = GetFlagValue(flag);
+            const char *end = value.data() + value.size();
+            const std::from_chars_result result = std::from_chars(value.data(), end, outValue);
+            return result.ec == std::errc{} && result.ptr == end;
+        }
+
     private:
         std::vector<std::string> arguments{};
 };
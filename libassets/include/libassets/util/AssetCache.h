@@ -0,0 +1,232 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * A thread-safe cache of loaded assets with a memory budget.
+ * Entries are handed out as shared handles, so evicting an entry only drops the cache's reference and anything still
+ * holding the handle keeps it alive. When the total size of the entries goes over budget, the least recently used
+ * entries are evicted.
+ * @tparam T The type of asset to cache
+ */
+template<typename T> class AssetCache
+{
+    public:
+        using Handle = std::shared_ptr<T>;
+
+        /// A function that loads an asset for a key, returning nullptr on failure and setting the size of the asset
+        using Loader = std::function<Handle(const std::string &key, size_t &outBytes)>;
+
+        struct Stats
+        {
+                /// The number of lookups that found an entry
+                size_t hits;
+                /// The number of lookups that did not find an entry
+                size_t misses;
+                /// The number of entries removed to stay under budget
+                size_t evictions;
+                /// The number of entries in the cache
+                size_t entryCount;
+                /// The total size of the entries in the cache
+                size_t bytes;
+                /// The maximum total size of the entries in the cache
+                size_t budgetBytes;
+        };
+
+        /**
+         * @param budgetBytes The maximum total size of the cached entries
+         */
+        explicit AssetCache(const size_t budgetBytes): budgetBytes(budgetBytes) {}
+
+        /**
+         * Look up an entry, marking it as most recently used
+         * @return The entry, or nullptr if it is not cached
+         */
+        [[nodiscard]] Handle Get(const std::string &key)
+        {
+            const std::lock_guard lock(mutex);
+            const typename EntryMap::iterator it = entries.find(key);
+            if (it == entries.end())
+            {
+                misses++;
+                return nullptr;
+            }
+            hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->value;
+        }
+
+        /**
+         * Check if an entry is cached without counting a lookup or marking it as used
+         */
+        [[nodiscard]] bool Contains(const std::string &key)
+        {
+            const std::lock_guard lock(mutex);
+            return entries.contains(key);
+        }
+
+        /**
+         * Look up an entry, loading and inserting it on a miss.
+         * The loader runs without holding the cache lock, so two threads missing the same key at once may both load
+         * it. The first one to finish is kept.
+         * @param key The key to look up
+         * @param loader The function to load the asset with if it is not cached
+         * @return The entry, or nullptr if it is not cached and failed to load
+         */
+        [[nodiscard]] Handle GetOrLoad(const std::string &key, const Loader &loader)
+        {
+            Handle cached = Get(key);
+            if (cached != nullptr)
+            {
+                return cached;
+            }
+            size_t bytes = 0;
+            Handle loaded = loader(key, bytes);
+            if (loaded == nullptr)
+            {
+                return nullptr;
+            }
+            return Insert(key, std::move(loaded), bytes, false);
+        }
+
+        /**
+         * Add an entry to the cache
+         * @param key The key to store the entry as
+         * @param value The entry
+         * @param bytes The size of the entry, counted towards the budget
+         * @param replace Whether to replace an existing entry with the same key. If false, the existing entry is kept.
+         * @return The entry that is now cached under the key
+         */
+        Handle Insert(const std::string &key, Handle value, const size_t bytes, const bool replace = true)
+        {
+            const std::lock_guard lock(mutex);
+            const typename EntryMap::iterator it = entries.find(key);
+            if (it != entries.end())
+            {
+                lru.splice(lru.begin(), lru, it->second);
+                if (!replace)
+                {
+                    return it->second->value;
+                }
+                totalBytes -= it->second->bytes;
+                it->second->value = std::move(value);
+                it->second->bytes = bytes;
+            } else
+            {
+                lru.push_front({
+                    .key = key,
+                    .value = std::move(value),
+                    .bytes = bytes,
+                });
+                entries[key] = lru.begin();
+            }
+            totalBytes += bytes;
+            Handle inserted = lru.front().value;
+            EvictOverBudget();
+            return inserted;
+        }
+
+        /**
+         * Remove an entry from the cache
+         */
+        void Remove(const std::string &key)
+        {
+            const std::lock_guard lock(mutex);
+            const typename EntryMap::iterator it = entries.find(key);
+            if (it == entries.end())
+            {
+                return;
+            }
+            totalBytes -= it->second->bytes;
+            lru.erase(it->second);
+            entries.erase(it);
+        }
+
+        /**
+         * Remove every entry from the cache
+         */
+        void Clear()
+        {
+            const std::lock_guard lock(mutex);
+            lru.clear();
+            entries.clear();
+            totalBytes = 0;
+        }
+
+        /**
+         * Change the budget, evicting entries if the cache is now over it
+         */
+        void SetBudget(const size_t newBudgetBytes)
+        {
+            const std::lock_guard lock(mutex);
+            budgetBytes = newBudgetBytes;
+            EvictOverBudget();
+        }
+
+        [[nodiscard]] Stats GetStats()
+        {
+            const std::lock_guard lock(mutex);
+            return {
+                .hits = hits,
+                .misses = misses,
+                .evictions = evictions,
+                .entryCount = entries.size(),
+                .bytes = totalBytes,
+                .budgetBytes = budgetBytes,
+            };
+        }
+
+        void ResetStats()
+        {
+            const std::lock_guard lock(mutex);
+            hits = 0;
+            misses = 0;
+            evictions = 0;
+        }
+
+    private:
+        struct Entry
+        {
+                std::string key;
+                Handle value;
+                size_t bytes;
+        };
+
+        using EntryList = std::list<Entry>;
+        using EntryMap = std::unordered_map<std::string, typename EntryList::iterator>;
+
+        std::mutex mutex{};
+        /// Most recently used first
+        EntryList lru{};
+        EntryMap entries{};
+
+        size_t budgetBytes = 0;
+        size_t totalBytes = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+
+        /// Evict least recently used entries until under budget. The most recent entry is always kept.
+        void EvictOverBudget()
+        {
+            while (totalBytes > budgetBytes && lru.size() > 1)
+            {
+                const Entry &oldest = lru.back();
+                totalBytes -= oldest.bytes;
+                entries.erase(oldest.key);
+                lru.pop_back();
+                evictions++;
+            }
+        }
+};
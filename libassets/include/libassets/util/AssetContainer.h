@@ -22,8 +22,20 @@ class AssetContainer
         static constexpr uint8_t FASTEST_COMPRESSION = Z_BEST_SPEED;
         static constexpr uint8_t NO_COMPRESSION = Z_NO_COMPRESSION;
 
+        /**
+         * Load an asset file from disk or from a mounted asset pack
+         * @param filePath The file to load. Paths inside a mounted pack take the form "pack.gpak/relative/path".
+         * @param outAsset The container to load into
+         */
         [[nodiscard]] static Error::ErrorCode LoadFromFile(const std::string &filePath, AssetContainer &outAsset);
 
+        /**
+         * Check if a block of memory starts with a valid asset container header
+         * @param data The data to check
+         * @param dataSize The size of the data
+         */
+        [[nodiscard]] static bool IsAssetContainer(const uint8_t *data, size_t dataSize);
+
         /**
          * Create an asset file on disk
          * @param filePath The file to save as
@@ -49,7 +61,13 @@ class AssetContainer
         static constexpr uint32_t ASSET_CONTAINER_MAGIC = 0x454D4147; // "GAME"
         static constexpr size_t ASSET_HEADER_SIZE = sizeof(uint32_t) + (sizeof(uint8_t) * 3) + (sizeof(size_t) * 2);
 
-        [[nodiscard]] static Error::ErrorCode Decompress(std::vector<uint8_t> &asset, AssetContainer &outAsset);
+        /**
+         * Decompress an asset file that is already in memory
+         * @param asset The start of the asset file data
+         * @param assetSize The size of the asset file data
+         * @param outAsset The container to decompress into
+         */
+        [[nodiscard]] static Error::ErrorCode Decompress(const uint8_t *asset, size_t assetSize, AssetContainer &outAsset);
 
         /**
          * Create an asset given the uncompressed payload
@@ -0,0 +1,126 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <libassets/util/Error.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * A read-only archive of asset files that is memory mapped and can be mounted as a search path.
+ * Entry data is stored back to back after the header, followed by a central directory sorted by path.
+ * Entries with identical contents share a single copy of the data.
+ */
+class AssetPack
+{
+    public:
+        struct Entry
+        {
+                /// The path of the entry in the asset filesystem
+                std::string path;
+                /// The offset of the entry data from the start of the pack
+                size_t offset;
+                /// The size of the entry data
+                size_t size;
+                /// The content hash of the entry data
+                uint64_t hash;
+        };
+
+        static constexpr const char *PACK_EXTENSION = ".gpak";
+
+        AssetPack() = default;
+        ~AssetPack();
+        AssetPack(const AssetPack &) = delete;
+        AssetPack &operator=(const AssetPack &) = delete;
+
+        /**
+         * Open and memory map a pack file
+         * @param packPath The path to the pack file on disk
+         */
+        [[nodiscard]] Error::ErrorCode Open(const std::string &packPath);
+
+        /**
+         * Build a pack file from every asset file in a folder
+         * @param directoryPath The folder to pack, which becomes the root of the pack
+         * @param packPath The pack file to create
+         */
+        [[nodiscard]] static Error::ErrorCode Build(const std::string &directoryPath, const std::string &packPath);
+
+        /**
+         * Mount a pack so that AssetContainer can load files from it. Mounting the same path twice returns the existing
+         * pack.
+         * @param packPath The path to the pack file on disk
+         * @param[out] status The result of opening the pack
+         */
+        [[nodiscard]] static std::shared_ptr<AssetPack> Mount(const std::string &packPath, Error::ErrorCode &status);
+
+        /**
+         * Find the mounted pack that a path points into
+         * @param filePath A path in the form "pack.gpak/relative/path"
+         * @param[out] outPack The pack containing the path
+         * @param[out] outRelativePath The path inside the pack
+         * @return Whether the path points into a mounted pack
+         */
+        [[nodiscard]] static bool FindMounted(const std::string &filePath,
+                                              std::shared_ptr<AssetPack> &outPack,
+                                              std::string &outRelativePath);
+
+        /**
+         * Check if a path on disk refers to a pack file
+         */
+        [[nodiscard]] static bool IsPackPath(const std::string &path);
+
+        /**
+         * Find an entry by its path in the asset filesystem
+         * @return The entry, or nullptr if it is not in the pack
+         */
+        [[nodiscard]] const Entry *FindEntry(const std::string &relPath) const;
+
+        /**
+         * Check if the pack contains a file
+         */
+        [[nodiscard]] bool Contains(const std::string &relPath) const;
+
+        /**
+         * Get a pointer to the mapped data of an entry
+         */
+        [[nodiscard]] const uint8_t *GetEntryData(const Entry &entry) const;
+
+        /**
+         * Scan a folder in the pack for all files with a given extension
+         * @param assetFolder The asset folder path (e.g. "textures/level")
+         * @param extension The extension to scan for (e.g. ".gtex")
+         * @return The paths relative to the asset folder, sorted by filename like SearchPathManager::ScanFolder
+         */
+        [[nodiscard]] std::vector<std::string> ScanFolder(const std::string &assetFolder,
+                                                          const std::string &extension) const;
+
+        [[nodiscard]] const std::vector<Entry> &GetEntries() const;
+
+    private:
+        static constexpr uint32_t ASSET_PACK_MAGIC = 0x4B415047; // "GPAK"
+        static constexpr uint8_t ASSET_PACK_VERSION = 1;
+        static constexpr size_t ASSET_PACK_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint8_t) + (sizeof(size_t) * 2);
+
+        std::vector<Entry> entries{};
+
+        const uint8_t *mappedData = nullptr;
+        size_t mappedSize = 0;
+        /// Platform handles that must stay open for the lifetime of the mapping
+        void *fileHandle = nullptr;
+        void *mappingHandle = nullptr;
+
+        void Close();
+
+        /**
+         * Convert separators to forward slashes and remove duplicate and trailing separators
+         * @param path The path to normalize
+         * @param relative Whether the path is in the asset filesystem, in which case leading separators are removed
+         */
+        [[nodiscard]] static std::string NormalizePath(const std::string &path, bool relative);
+};
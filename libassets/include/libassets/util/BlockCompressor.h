@@ -0,0 +1,93 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Encodes and decodes the BCn block compressed texture formats.
+ * Every format stores 4x4 texel blocks. Images that aren't a multiple of 4 in size are padded by repeating their last
+ * row and column.
+ */
+class BlockCompressor
+{
+    public:
+        enum class Format : uint8_t
+        {
+            /// RGB with 1-bit alpha, 8 bytes per block. Encoded from sRGB RGBA8.
+            BC1,
+            /// RGBA, 16 bytes per block. Encoded from sRGB RGBA8.
+            BC3,
+            /// One channel, 8 bytes per block. Encoded from the red channel of RGBA8.
+            BC4,
+            /// Two channels, 16 bytes per block. Encoded from the red and green channels of RGBA8.
+            BC5,
+            /// High quality RGBA, 16 bytes per block. Encoded from sRGB RGBA8.
+            BC7,
+            /// Unsigned HDR RGB, 16 bytes per block. Encoded from RGBA half floats, ignoring alpha.
+            BC6H,
+        };
+
+        enum class Quality : uint8_t
+        {
+            /// Bounding box endpoints only
+            FAST,
+            /// Principal axis endpoints, refined once
+            NORMAL,
+            /// Principal axis and bounding box endpoints, refined several times, keeping whichever is closer
+            BEST,
+        };
+
+        BlockCompressor() = delete;
+
+        /**
+         * Get the size of one block in bytes
+         */
+        [[nodiscard]] static size_t GetBlockSize(Format format);
+
+        /**
+         * Get the size of an encoded image in bytes
+         */
+        [[nodiscard]] static size_t GetImageSize(Format format, uint32_t width, uint32_t height);
+
+        /**
+         * Check if a format stores half float data
+         */
+        [[nodiscard]] static bool IsHdr(Format format);
+
+        /**
+         * Encode an image
+         * @param pixels The image, in RGBA8 or (for BC6H) RGBA half float
+         * @param width The width of the image
+         * @param height The height of the image
+         * @param format The format to encode to
+         * @param quality The quality/speed tradeoff
+         * @param outBlocks Where to append the encoded blocks, row by row
+         */
+        static void Encode(const uint8_t *pixels,
+                           uint32_t width,
+                           uint32_t height,
+                           Format format,
+                           Quality quality,
+                           std::vector<uint8_t> &outBlocks);
+
+        /**
+         * Decode an image.
+         * BC7 and BC6H blocks are only decoded in the modes this encoder produces (7 mode 6 and 6H mode 11).
+         * @param blocks The encoded blocks
+         * @param width The width of the image
+         * @param height The height of the image
+         * @param format The format of the blocks
+         * @param outPixels Where to append the image, in RGBA8 or (for BC6H) RGBA half float
+         * @return False if a block uses an unsupported mode. Those blocks decode as black.
+         */
+        static bool Decode(const uint8_t *blocks,
+                           uint32_t width,
+                           uint32_t height,
+                           Format format,
+                           std::vector<uint8_t> &outPixels);
+};
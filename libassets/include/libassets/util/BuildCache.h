@@ -0,0 +1,92 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <libassets/util/Error.h>
+#include <string>
+#include <vector>
+
+/**
+ * A content-addressed cache of build outputs on disk, shared by the asset tools.
+ * Outputs are stored under a key made from the contents of every input, the build options and the tool version, so
+ * the same build on another branch or machine sharing the cache folder finds the output instead of rebuilding it.
+ * Inserts are written to a temporary file and renamed into place, so several processes can share a cache folder, even
+ * on a network filesystem. Once the cache is over its size limit, the least recently used outputs are removed.
+ */
+class BuildCache
+{
+    public:
+        /// The default size limit of the cache folder
+        static constexpr uintmax_t DEFAULT_MAX_BYTES = 4ull * 1024 * 1024 * 1024;
+
+        /// Builds a cache key from the things an output depends on
+        class KeyBuilder
+        {
+            public:
+                /**
+                 * Add the contents of a file to the key
+                 * @return False if the file can't be read, in which case the output should not be cached
+                 */
+                [[nodiscard]] bool AddFile(const std::string &path);
+
+                /**
+                 * Add a string, such as the build options or tool version, to the key
+                 */
+                void AddString(const std::string &value);
+
+                [[nodiscard]] uint64_t GetKey() const;
+
+            private:
+                /// The hashes of everything added so far, in order
+                std::vector<uint64_t> hashes{};
+        };
+
+        /**
+         * Create a cache in a folder
+         * @param directory The cache folder. If empty, the cache is disabled and never finds or stores anything.
+         * @param maxBytes The size limit enforced by CollectGarbage()
+         */
+        explicit BuildCache(const std::string &directory = "", uintmax_t maxBytes = DEFAULT_MAX_BYTES);
+
+        [[nodiscard]] bool IsEnabled() const;
+
+        /**
+         * Copy a cached output to a file
+         * @param key The key of the output
+         * @param outputPath Where to copy the output to. Replaced atomically.
+         * @return True on a cache hit
+         */
+        [[nodiscard]] bool Fetch(uint64_t key, const std::string &outputPath) const;
+
+        /**
+         * Store a copy of an output. Does nothing if the key is already stored.
+         * @param key The key of the output
+         * @param outputPath The output file to copy
+         * @return Error code
+         */
+        [[nodiscard]] Error::ErrorCode Insert(uint64_t key, const std::string &outputPath) const;
+
+        /**
+         * Remove the least recently used outputs until the cache is under its size limit, as well as temporary files
+         * left behind by interrupted inserts
+         */
+        void CollectGarbage() const;
+
+    private:
+        /// Temporary files older than this are assumed to belong to an interrupted insert
+        static constexpr int64_t STALE_TEMPORARY_FILE_SECONDS = 60 * 60;
+
+        std::string directory;
+        uintmax_t maxBytes;
+
+        [[nodiscard]] std::string GetEntryPath(uint64_t key) const;
+
+        /**
+         * Copy a file through a uniquely named temporary file next to the destination, then rename it into place
+         */
+        [[nodiscard]] static bool CopyAtomic(const std::string &sourcePath, const std::string &destinationPath);
+};
@@ -31,4 +31,11 @@ class Checksum
          * @param startOffset The start offset, defaulting to 0
          */
         static uint16_t Calculate(const std::vector<uint8_t> &bytes, size_t startOffset = 0);
+
+        /**
+         * Calculate a 64-bit FNV-1a content hash of a block of memory
+         * @param bytes The data to hash
+         * @param length The number of bytes to hash
+         */
+        static uint64_t Hash64(const uint8_t *bytes, size_t length);
 };
@@ -0,0 +1,45 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/**
+ * Splits a mesh into convex parts that approximate it, in the style of V-HACD ("Volumetric Hierarchical Approximate
+ * Convex Decomposition", Mamou 2016). The mesh is voxelized, then the part whose convex hull adds the most empty
+ * space is repeatedly cut in two along the axis aligned plane that leaves the least empty space.
+ */
+class ConvexDecomposition
+{
+    public:
+        struct Parameters
+        {
+                /// The most parts to split the mesh into
+                size_t maxHulls = 16;
+                /// Parts are split until their hull adds less empty space than this fraction of the mesh's hull
+                float maxConcavity = 0.01f;
+                /// The most vertices each part's hull can have
+                size_t maxVerticesPerHull = 32;
+                /// The number of voxels along the longest side of the mesh
+                uint32_t resolution = 64;
+        };
+
+        ConvexDecomposition() = delete;
+
+        /**
+         * Decompose a triangle mesh. Closed meshes are treated as solid, open meshes as a thin shell.
+         * Candidate cuts are evaluated on worker threads.
+         * @param positions The vertex positions
+         * @param indices The triangle list
+         * @param parameters The limits of the decomposition
+         * @return The vertices of the convex hull of each part, or nothing if the mesh has no triangles
+         */
+        [[nodiscard]] static std::vector<std::vector<glm::vec3>> Decompose(const std::vector<glm::vec3> &positions,
+                                                                           const std::vector<uint32_t> &indices,
+                                                                           const Parameters &parameters);
+};
@@ -0,0 +1,49 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * Watches a set of directories for files being created, deleted or renamed and calls a function from a background
+ * thread when that happens. Only implemented on Linux (inotify); elsewhere IsWatching() is always false and the owner
+ * must refresh explicitly.
+ */
+class DirectoryWatcher
+{
+    public:
+        /**
+         * @param onChange The function to call when a watched directory changes. Called from the watcher thread.
+         */
+        explicit DirectoryWatcher(std::function<void()> onChange);
+        ~DirectoryWatcher();
+        DirectoryWatcher(const DirectoryWatcher &) = delete;
+        DirectoryWatcher &operator=(const DirectoryWatcher &) = delete;
+
+        /**
+         * Start watching a directory (not recursive)
+         * @return Whether the directory is now being watched
+         */
+        bool AddDirectory(const std::string &directoryPath);
+
+        /**
+         * Check if changes are being reported. False if unsupported or if any directory failed to be added.
+         */
+        [[nodiscard]] bool IsWatching() const;
+
+    private:
+        static constexpr int POLL_TIMEOUT_MS = 250;
+
+        std::function<void()> onChange;
+        int inotifyFd = -1;
+        std::atomic<bool> watching = false;
+        std::atomic<bool> stopRequested = false;
+        std::thread thread{};
+
+        void ThreadMain() const;
+};
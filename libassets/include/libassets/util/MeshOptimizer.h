@@ -0,0 +1,79 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/**
+ * Reorders triangle lists to render faster, following "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw" (Sander, Nehab and Barczak 2007)
+ */
+class MeshOptimizer
+{
+    public:
+        /// The post-transform vertex cache size that is optimized for and simulated
+        static constexpr uint32_t CACHE_SIZE = 16;
+
+        struct VertexCacheStats
+        {
+                /// The number of vertices the simulated cache had to transform
+                size_t transformedVertices;
+                size_t triangleCount;
+                /// The number of distinct vertices referenced
+                size_t vertexCount;
+
+                /// Average cache miss ratio, transformed vertices per triangle. 0.5 is ideal, 3 is the worst.
+                [[nodiscard]] float GetAcmr() const;
+
+                /// Average transform to vertex ratio, transformed vertices per vertex. 1 is ideal.
+                [[nodiscard]] float GetAtvr() const;
+
+                /// Add the stats of another index list drawn after this one
+                void Add(const VertexCacheStats &other);
+        };
+
+        MeshOptimizer() = delete;
+
+        /**
+         * Reorder triangles so that their vertices are likely to still be in the post-transform cache (Tipsify)
+         * @param indices The triangle list to reorder
+         * @param vertexCount The number of vertices the indices refer to
+         * @param outClusterStarts Where to store the first index of every cluster, a run of triangles that can be
+         *                         moved as a whole without hurting cache use much
+         */
+        static void OptimizeVertexCache(std::vector<uint32_t> &indices,
+                                        size_t vertexCount,
+                                        std::vector<size_t> &outClusterStarts);
+
+        /**
+         * Reorder clusters from OptimizeVertexCache so that outward facing ones are drawn first and hide what is behind
+         * them from any direction
+         * @param indices The triangle list to reorder
+         * @param clusterStarts The first index of every cluster
+         * @param positions The vertex positions
+         */
+        static void OptimizeOverdraw(std::vector<uint32_t> &indices,
+                                     const std::vector<size_t> &clusterStarts,
+                                     const std::vector<glm::vec3> &positions);
+
+        /**
+         * Get a remap that renumbers vertices in the order they are first used, so vertex fetches are sequential
+         * @param indexLists Every index list drawn from the vertices, in draw order
+         * @param vertexCount The number of vertices
+         * @return The new index of every vertex, or UINT32_MAX for unused vertices
+         */
+        [[nodiscard]] static std::vector<uint32_t> GetVertexFetchRemap(
+                const std::vector<std::vector<uint32_t>> &indexLists,
+                size_t vertexCount);
+
+        /**
+         * Simulate a FIFO post-transform vertex cache of CACHE_SIZE entries drawing a triangle list
+         */
+        [[nodiscard]] static VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t> &indices,
+                                                                 size_t vertexCount);
+};
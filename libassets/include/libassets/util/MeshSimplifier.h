@@ -0,0 +1,41 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/**
+ * Reduces the triangle count of meshes by collapsing edges, choosing the collapses with the lowest quadric error
+ * ("Surface Simplification Using Quadric Error Metrics", Garland and Heckbert 1997)
+ */
+class MeshSimplifier
+{
+    public:
+        MeshSimplifier() = delete;
+
+        /**
+         * Simplify a triangle list. Vertices only ever move onto a neighbouring vertex, so no new vertices are created.
+         * Vertices that share a position but not other attributes form a seam, which is kept in place except for
+         * collapses along the seam itself. Open borders are kept the same way, and anything more complex is locked.
+         * @param positions The vertex positions
+         * @param indices The triangle list to simplify
+         * @param targetIndexCount The number of indices to stop at
+         * @param maxError The largest allowed error relative to the size of the mesh, which can stop simplification
+         *                 before targetIndexCount is reached
+         * @return The error of the result relative to the size of the mesh
+         */
+        [[nodiscard]] static float Simplify(const std::vector<glm::vec3> &positions,
+                                            std::vector<uint32_t> &indices,
+                                            size_t targetIndexCount,
+                                            float maxError);
+
+        /**
+         * Get the size that Simplify errors are relative to, the largest dimension of the bounding box of positions
+         */
+        [[nodiscard]] static float GetMeshScale(const std::vector<glm::vec3> &positions);
+};
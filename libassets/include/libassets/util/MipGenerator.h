@@ -0,0 +1,57 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Builds mip chains for RGBA images.
+ * Each level is a box filter of the previous one. Colors are averaged in linear space and weighted by alpha, so
+ * transparent texels don't bleed their (usually meaningless) color into the edges of opaque areas.
+ */
+class MipGenerator
+{
+    public:
+        MipGenerator() = delete;
+
+        /**
+         * Get the number of levels in a full mip chain, including the base level
+         */
+        [[nodiscard]] static uint32_t GetLevelCount(uint32_t width, uint32_t height);
+
+        /**
+         * Get the size of a mip level along one axis
+         * @param baseSize The size of the base level along that axis
+         * @param level The mip level
+         */
+        [[nodiscard]] static uint32_t GetLevelSize(uint32_t baseSize, uint32_t level);
+
+        /**
+         * Generate the levels after the base level of an sRGB RGBA8 image
+         * @param basePixels The base level
+         * @param width The width of the base level
+         * @param height The height of the base level
+         * @param outLevels Where to append the generated levels, tightly packed, smallest last. Must not contain
+         * basePixels.
+         */
+        static void GenerateRGBA8(const uint8_t *basePixels,
+                                  uint32_t width,
+                                  uint32_t height,
+                                  std::vector<uint8_t> &outLevels);
+
+        /**
+         * Generate the levels after the base level of a linear RGBA half float image
+         * @param basePixels The base level
+         * @param width The width of the base level
+         * @param height The height of the base level
+         * @param outLevels Where to append the generated levels, tightly packed, smallest last. Must not contain
+         * basePixels.
+         */
+        static void GenerateRGBAF16(const uint8_t *basePixels,
+                                    uint32_t width,
+                                    uint32_t height,
+                                    std::vector<uint8_t> &outLevels);
+};
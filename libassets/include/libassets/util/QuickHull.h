@@ -0,0 +1,46 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <vector>
+
+/**
+ * Computes the convex hull of a point cloud ("The Quickhull Algorithm for Convex Hulls", Barber, Dobkin and Huhdanpaa
+ * 1996). Points are added farthest first, so stopping early gives the best hull for the number of vertices.
+ */
+class QuickHull
+{
+    public:
+        struct Hull
+        {
+                std::vector<glm::vec3> vertices{};
+                /// Triangles, counterclockwise when seen from outside
+                std::vector<uint32_t> indices{};
+        };
+
+        QuickHull() = delete;
+
+        /**
+         * Compute the convex hull of points
+         * @param points The points
+         * @param tolerance Points closer than this to the hull are left out, and faces within this of the plane of
+         *                  a new point are merged with the faces it sees, so flat sides don't end up creased.
+         * @param maxVertices The most vertices the hull can have
+         * @param outHull Where to store the hull
+         * @return False if the points have no volume, in which case there is no hull
+         */
+        [[nodiscard]] static bool Compute(const std::vector<glm::vec3> &points,
+                                          float tolerance,
+                                          size_t maxVertices,
+                                          Hull &outHull);
+
+        /**
+         * Get the volume enclosed by a hull
+         */
+        [[nodiscard]] static float GetVolume(const Hull &hull);
+};
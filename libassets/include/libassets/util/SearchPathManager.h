@@ -5,7 +5,15 @@
 #pragma once
 
 #include <libassets/asset/DataAsset.h>
+#include <atomic>
+#include <filesystem>
+#include <libassets/util/AssetPack.h>
+#include <libassets/util/DirectoryWatcher.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class SearchPathManager
@@ -19,16 +27,16 @@ class SearchPathManager
                 std::string absolutePath;
         };
 
-        SearchPathManager() = default;
+        SearchPathManager();
         SearchPathManager(DataAsset &gameConfig,
                           const std::string &executableFolder,
                           const std::string &configParentFolder);
 
         /**
-         * Scan a real folder for all files with a given extension
+         * Scan a real folder for all files with a given extension. Subfolders are scanned in parallel.
          * @param directoryPath The path to the on-disk folder to scan
          * @param extension The extension to scan for (e.g. ".txt")
-         * @param isRoot Set this to true
+         * @param isRoot Set this to true to get paths relative to @c directoryPath sorted by filename
          */
         [[nodiscard]] static std::vector<std::string> ScanFolder(const std::string &directoryPath,
                                                                  const std::string &extension,
@@ -36,6 +44,7 @@ class SearchPathManager
 
         /**
          * Scan an asset folder for all files with a given extension
+         * @note Results are cached per folder and extension until the modification time of a scanned folder changes
          * @param assetFolder The asset folder path (e.g. "textures/level")
          * @param extension The extension to scan for (e.g. ".gtex")
          * @return a vector of AssetResult structs containing the absolute (on-disk) and relative (asset filesystem) paths
@@ -63,9 +72,102 @@ class SearchPathManager
 
         /**
          * Get the absolute (on-disk) path of a given relative (asset filesystem) path
+         * @note This is answered from an index of all search paths, which is built on first use and rebuilt after it
+         *       is invalidated
          */
         [[nodiscard]] std::string GetAssetPath(const std::string &relPath) const;
 
+        /**
+         * Rebuild the asset path index now
+         */
+        void RefreshIndex() const;
+
+        /**
+         * Mark the asset path index as stale so that it is rebuilt on the next lookup.
+         * On Linux this happens automatically when files are added to or removed from a search path.
+         */
+        void InvalidateIndex() const;
+
     private:
+        /// The index of every file in every search path, shared between copies of a SearchPathManager
+        struct PathIndex
+        {
+                std::shared_mutex mutex{};
+                /// Relative path to absolute path, where the first search path containing a file wins
+                std::unordered_map<std::string, std::string> paths{};
+                std::atomic<bool> valid = false;
+                /// Declared last so that it stops before the rest of the index is destroyed
+                std::unique_ptr<DirectoryWatcher> watcher = nullptr;
+        };
+
+        std::shared_ptr<PathIndex> pathIndex{};
+
+        struct DirectoryTime
+        {
+                /// The path to the directory on disk
+                std::string path;
+                /// The modification time of the directory, or the minimum time if it did not exist
+                std::filesystem::file_time_type time;
+        };
+
+        struct FolderListing
+        {
+                std::vector<AssetResult> results{};
+                /// Every directory the results depend on
+                std::vector<DirectoryTime> directoryTimes{};
+        };
+
+        /// Cached results of ScanAssetFolder, shared between copies of a SearchPathManager
+        struct ListingCache
+        {
+                std::mutex mutex{};
+                /// Keyed by "folder|extension"
+                std::unordered_map<std::string, FolderListing> listings{};
+        };
+
+        std::shared_ptr<ListingCache> listingCache{};
+
+        static constexpr size_t MAX_SCAN_THREADS = 8;
+
         std::vector<std::string> assetPaths{};
+        /// The mounted pack for each search path, or nullptr if the search path is a folder
+        std::vector<std::shared_ptr<AssetPack>> assetPacks{};
+
+        void AddSearchPath(const std::string &path);
+
+        void BuildIndex(PathIndex &index) const;
+
+        /**
+         * Add everything in an asset folder, and the folders leading to it, from every search path to the index
+         * @param index The index to add to
+         * @param folder The normalized asset folder, or an empty string for everything
+         */
+        void IndexFolder(PathIndex &index, const std::string &folder) const;
+
+        /**
+         * Replace the index entries of an asset folder with what is on disk now, for when there is no watcher
+         * @param folder The normalized asset folder
+         */
+        void RefreshIndexFolder(const std::string &folder) const;
+
+        [[nodiscard]] static std::string NormalizeRelativePath(const std::string &relPath);
+
+        /**
+         * Walk a folder tree on the shared thread pool
+         * @param directoryPath The folder to walk
+         * @param extension The extension to collect
+         * @param[out] files The matching files, in no particular order
+         * @param[out] directoryTimes The modification time of every directory visited
+         */
+        static void WalkFolder(const std::string &directoryPath,
+                               const std::string &extension,
+                               std::vector<std::string> &files,
+                               std::vector<DirectoryTime> &directoryTimes);
+
+        [[nodiscard]] static std::vector<std::string> ScanFolder(const std::string &directoryPath,
+                                                                 const std::string &extension,
+                                                                 bool isRoot,
+                                                                 std::vector<DirectoryTime> &directoryTimes);
+
+        [[nodiscard]] static bool IsListingCurrent(const FolderListing &listing);
 };
@@ -0,0 +1,71 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads that run submitted tasks in the order they were submitted
+ */
+class ThreadPool
+{
+    public:
+        /**
+         * @param threadCount The number of worker threads, or 0 to use one less than the number of hardware threads
+         */
+        explicit ThreadPool(size_t threadCount = 0);
+
+        /**
+         * Tasks that have not started yet are discarded. Running tasks are waited for.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * Queue a task to run on a worker thread
+         */
+        void Submit(std::function<void()> task);
+
+        /**
+         * Block until every submitted task has finished
+         */
+        void Wait();
+
+        /**
+         * Call a task once for every index from 0 to count, on the workers and the calling thread, and block until
+         * all calls finished. Unlike Wait(), this only waits for its own calls, so it can be used from any thread,
+         * including a worker of this pool. When every worker is busy the calling thread makes all the calls itself.
+         * @param count The number of calls
+         * @param task The task, which is passed the index
+         */
+        void Run(size_t count, const std::function<void(size_t index)> &task);
+
+        [[nodiscard]] size_t GetThreadCount() const;
+
+        /**
+         * Get the pool that libassets splits up work inside a single call with, such as encoding the blocks of one
+         * texture. Sharing it keeps the number of threads bounded when such calls are made from many threads at once.
+         */
+        [[nodiscard]] static ThreadPool &GetShared();
+
+    private:
+        std::mutex mutex{};
+        std::condition_variable taskAvailable{};
+        std::condition_variable tasksFinished{};
+        std::deque<std::function<void()>> tasks{};
+        size_t busyWorkers = 0;
+        bool stopRequested = false;
+        std::vector<std::thread> threads{};
+
+        void WorkerMain();
+};
@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <glm/vec3.hpp>
+#include <iterator>
 #include <libassets/asset/Asset.h>
 #include <libassets/asset/ModelAsset.h>
 #include <libassets/type/BoundingBox.h>
@@ -14,10 +17,15 @@
 #include <libassets/type/Material.h>
 #include <libassets/type/ModelLod.h>
 #include <libassets/type/ModelVertex.h>
+#include <libassets/util/AssetContainer.h>
+#include <libassets/util/ConvexDecomposition.h>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
+#include <libassets/util/ThreadPool.h>
+#include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 
 Asset::AssetType ModelAsset::GetAssetType() const
@@ -31,12 +39,22 @@ uint8_t ModelAsset::GetAssetTypeVersion() const
 }
 
 Error::ErrorCode ModelAsset::LoadFromBuffer(DataReader &reader)
+{
+    return LoadFromBuffer(reader, MODEL_ASSET_VERSION);
+}
+
+Error::ErrorCode ModelAsset::LoadFromBuffer(DataReader &reader, const uint8_t version)
 {
     const uint32_t materialCount = reader.Read<uint32_t>();
     const uint32_t materialsPerSkin = reader.Read<uint32_t>();
     const uint32_t skinCount = reader.Read<uint32_t>();
     const uint32_t lodCount = reader.Read<uint32_t>();
     collisionModelType = static_cast<CollisionModelType>(reader.Read<uint8_t>());
+    vertexFormat = VertexFormat::FLOAT32;
+    if (version > MODEL_ASSET_VERSION_NO_QUANTIZATION)
+    {
+        vertexFormat = static_cast<VertexFormat>(reader.Read<uint8_t>());
+    }
 
     materials.reserve(materialCount);
     for (uint32_t i = 0; i < materialCount; i++)
@@ -56,7 +74,7 @@ Error::ErrorCode ModelAsset::LoadFromBuffer(DataReader &reader)
 
     for (uint32_t _i = 0; _i < lodCount; _i++)
     {
-        lods.emplace_back(reader, materialsPerSkin);
+        lods.emplace_back(reader, materialsPerSkin, vertexFormat == VertexFormat::QUANTIZED);
     }
 
     boundingBox = BoundingBox(reader);
@@ -66,7 +84,7 @@ Error::ErrorCode ModelAsset::LoadFromBuffer(DataReader &reader)
         const size_t hullCount = reader.Read<size_t>();
         for (size_t i = 0; i < hullCount; i++)
         {
-            const ConvexHull hull = ConvexHull(reader);
+            const ConvexHull hull = ConvexHull(reader, version > MODEL_ASSET_VERSION_NO_HULL_MASS);
             convexHulls.push_back(hull);
         }
     } else if (collisionModelType == CollisionModelType::STATIC_SINGLE_CONCAVE)
@@ -90,6 +108,7 @@ Error::ErrorCode ModelAsset::SaveToBuffer(DataWriter &writer) const
     writer.Write<uint32_t>(skins.size());
     writer.Write<uint32_t>(lods.size());
     writer.Write<uint8_t>(static_cast<uint8_t>(collisionModelType));
+    writer.Write<uint8_t>(static_cast<uint8_t>(vertexFormat));
 
     for (const Material &material: materials)
     {
@@ -106,7 +125,7 @@ Error::ErrorCode ModelAsset::SaveToBuffer(DataWriter &writer) const
 
     for (const ModelLod &lod: lods)
     {
-        lod.Write(writer);
+        lod.Write(writer, vertexFormat == VertexFormat::QUANTIZED);
     }
 
     boundingBox.Write(writer);
@@ -126,10 +145,29 @@ Error::ErrorCode ModelAsset::SaveToBuffer(DataWriter &writer) const
     return Error::ErrorCode::OK;
 }
 
+Error::ErrorCode ModelAsset::LoadFromAsset(const std::string &filePath)
+{
+    AssetContainer asset;
+    const Error::ErrorCode error = AssetContainer::LoadFromFile(filePath, asset);
+    if (error != Error::ErrorCode::OK)
+    {
+        return error;
+    }
+    if (asset.type != GetAssetType())
+    {
+        return Error::ErrorCode::INCORRECT_FORMAT;
+    }
+    if (asset.typeVersion < MODEL_ASSET_VERSION_NO_QUANTIZATION || asset.typeVersion > GetAssetTypeVersion())
+    {
+        return Error::ErrorCode::INCORRECT_VERSION;
+    }
+    return LoadFromBuffer(asset.reader, asset.typeVersion);
+}
+
 Error::ErrorCode ModelAsset::Import(const std::string &filePath)
 {
     Error::ErrorCode lodCode = Error::ErrorCode::UNKNOWN;
-    lods.emplace_back(filePath, 0, lodCode);
+    lods.emplace_back(filePath, 0, lodCode, weldTolerances);
     if (lodCode != Error::ErrorCode::OK)
     {
         return lodCode;
@@ -146,6 +184,11 @@ ModelLod &ModelAsset::GetLod(const uint32_t index)
     return lods.at(index);
 }
 
+const ModelLod &ModelAsset::GetLod(const uint32_t index) const
+{
+    return lods.at(index);
+}
+
 std::vector<uint32_t> &ModelAsset::GetSkin(const uint32_t index)
 {
     return skins.at(index);
@@ -183,14 +226,28 @@ void ModelAsset::RemoveSkin(const uint32_t index)
 
 void ModelAsset::GetVertexBuffer(const uint32_t lodIndex, DataWriter &writer)
 {
+    constexpr size_t FLOATS_PER_VERTEX = 12;
     const ModelLod &lod = GetLod(lodIndex);
+    // Interleaved into one buffer first so the writer grows once instead of once per field
+    std::vector<float> buffer(lod.vertices.size() * FLOATS_PER_VERTEX);
+    float *vertexData = buffer.data();
     for (const ModelVertex &vertex: lod.vertices)
     {
-        writer.WriteVec3(vertex.position);
-        writer.WriteVec2(vertex.uv);
-        vertex.color.WriteFloats(writer);
-        writer.WriteVec3(vertex.normal);
+        const float *color = vertex.color.GetDataPointer();
+        *vertexData++ = vertex.position.x;
+        *vertexData++ = vertex.position.y;
+        *vertexData++ = vertex.position.z;
+        *vertexData++ = vertex.uv.x;
+        *vertexData++ = vertex.uv.y;
+        *vertexData++ = color[0];
+        *vertexData++ = color[1];
+        *vertexData++ = color[2];
+        *vertexData++ = color[3];
+        *vertexData++ = vertex.normal.x;
+        *vertexData++ = vertex.normal.y;
+        *vertexData++ = vertex.normal.z;
     }
+    writer.WriteBuffer<float>(buffer);
 }
 
 bool ModelAsset::LODSortCompare(const ModelLod &a, const ModelLod &b)
@@ -205,21 +262,84 @@ void ModelAsset::SortLODs()
 
 bool ModelAsset::AddLod(const std::string &path)
 {
-    const float dist = lods.back().distance + 5;
-    Error::ErrorCode status = Error::ErrorCode::UNKNOWN;
-    const ModelLod lod(path, dist, status);
-    if (status != Error::ErrorCode::OK)
+    return AddLods({path});
+}
+
+bool ModelAsset::AddLods(const std::vector<std::string> &paths)
+{
+    std::vector<ModelLod> newLods(paths.size());
+    std::vector<Error::ErrorCode> statuses(paths.size(), Error::ErrorCode::UNKNOWN);
+    if (paths.size() == 1)
     {
-        return false;
+        newLods.at(0) = ModelLod(paths.at(0), 0, statuses.at(0), weldTolerances);
+    } else
+    {
+        // The shared pool keeps the thread count bounded when assets are built on several threads at once
+        ThreadPool::GetShared().Run(paths.size(), [this, &paths, &newLods, &statuses](const size_t i) {
+            newLods.at(i) = ModelLod(paths.at(i), 0, statuses.at(i), weldTolerances);
+        });
     }
-    if (lod.indexCounts.size() != GetMaterialsPerSkin())
+
+    for (size_t i = 0; i < paths.size(); i++)
     {
-        return false;
+        if (statuses.at(i) != Error::ErrorCode::OK || newLods.at(i).indexCounts.size() != GetMaterialsPerSkin())
+        {
+            return false;
+        }
+    }
+    for (ModelLod &lod: newLods)
+    {
+        lod.distance = lods.back().distance + 5;
+        lods.push_back(std::move(lod));
     }
-    lods.push_back(lod);
     return true;
 }
 
+size_t ModelAsset::GenerateLods(const std::vector<LodGenerationStep> &steps)
+{
+    std::vector<ModelLod> generatedLods = SimplifyLods(steps);
+    const size_t generated = generatedLods.size();
+    ReplaceGeneratedLods(std::move(generatedLods));
+    return generated;
+}
+
+std::vector<ModelLod> ModelAsset::SimplifyLods(const std::vector<LodGenerationStep> &steps) const
+{
+    const ModelLod &baseLod = lods.at(0);
+    std::vector<ModelLod> newLods(steps.size());
+    std::vector<float> errors(steps.size());
+    ThreadPool::GetShared().Run(steps.size(), [&baseLod, &steps, &newLods, &errors](const size_t i) {
+        newLods.at(i) = baseLod.Simplify(steps.at(i).ratio, steps.at(i).maxError, errors.at(i));
+    });
+
+    std::vector<ModelLod> generatedLods{};
+    size_t previousIndexCount = std::accumulate(baseLod.indexCounts.begin(), baseLod.indexCounts.end(), 0ul);
+    float previousDistance = baseLod.distance;
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+        ModelLod &lod = newLods.at(i);
+        const size_t indexCount = std::accumulate(lod.indexCounts.begin(), lod.indexCounts.end(), 0ul);
+        if (indexCount >= previousIndexCount)
+        {
+            continue;
+        }
+        previousIndexCount = indexCount;
+        const float distance = std::round(errors.at(i) * LOD_DISTANCE_PER_UNIT_ERROR * 10.0f) / 10.0f;
+        lod.distance = std::max(distance, previousDistance + 1.0f);
+        previousDistance = lod.distance;
+        generatedLods.push_back(std::move(lod));
+    }
+    return generatedLods;
+}
+
+void ModelAsset::ReplaceGeneratedLods(std::vector<ModelLod> &&generatedLods)
+{
+    lods.resize(1);
+    lods.insert(lods.end(),
+                std::make_move_iterator(generatedLods.begin()),
+                std::make_move_iterator(generatedLods.end()));
+}
+
 void ModelAsset::RemoveLod(const uint32_t index)
 {
     lods.erase(lods.begin() + index);
@@ -316,6 +436,35 @@ void ModelAsset::RemoveHull(const size_t index)
     convexHulls.erase(convexHulls.begin() + static_cast<int64_t>(index));
 }
 
+size_t ModelAsset::GenerateHulls(const ConvexDecomposition::Parameters &parameters)
+{
+    const ModelLod &lod = lods.at(0);
+    std::vector<glm::vec3> positions{};
+    positions.reserve(lod.vertices.size());
+    for (const ModelVertex &vertex: lod.vertices)
+    {
+        positions.push_back(vertex.position);
+    }
+    std::vector<uint32_t> indices{};
+    for (const std::vector<uint32_t> &materialIndices: lod.materialIndices)
+    {
+        indices.insert(indices.end(), materialIndices.begin(), materialIndices.end());
+    }
+
+    std::vector<ConvexHull> hulls{};
+    for (const std::vector<glm::vec3> &hullPoints: ConvexDecomposition::Decompose(positions, indices, parameters))
+    {
+        hulls.emplace_back(hullPoints, parameters.maxVerticesPerHull);
+    }
+    // A failed decomposition keeps the hulls the model already has
+    if (hulls.empty())
+    {
+        return 0;
+    }
+    convexHulls = std::move(hulls);
+    return convexHulls.size();
+}
+
 StaticCollisionMesh &ModelAsset::GetStaticCollisionMesh()
 {
     return staticCollisionMesh;
@@ -2,6 +2,7 @@
 // Created by droc101 on 6/23/25.
 //
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
@@ -15,13 +16,19 @@
 #include <ImfPixelType.h>
 #include <ImfRgba.h>
 #include <ImfRgbaFile.h>
+#include <ImfThreading.h>
 #include <libassets/asset/TextureAsset.h>
 #include <libassets/util/AssetContainer.h>
+#include <libassets/util/BlockCompressor.h>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
+#include <libassets/util/MipGenerator.h>
+#include <mutex>
 #include <OpenEXRConfig.h>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -32,6 +39,18 @@
 using namespace OPENEXR_IMF_NAMESPACE;
 using namespace IMATH_NAMESPACE;
 
+namespace
+{
+    /// Let OpenEXR decode and encode chunks of scanlines in parallel
+    void EnableExrThreads()
+    {
+        static std::once_flag threadsEnabled;
+        std::call_once(threadsEnabled, [] {
+            setGlobalThreadCount(static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)));
+        });
+    }
+} // namespace
+
 Asset::AssetType TextureAsset::GetAssetType() const
 {
     return AssetType::ASSET_TYPE_TEXTURE;
@@ -43,6 +62,11 @@ uint8_t TextureAsset::GetAssetTypeVersion() const
 }
 
 Error::ErrorCode TextureAsset::LoadFromBuffer(DataReader &reader)
+{
+    return LoadFromBuffer(reader, TEXTURE_ASSET_VERSION);
+}
+
+Error::ErrorCode TextureAsset::LoadFromBuffer(DataReader &reader, const uint8_t version)
 {
     width = reader.Read<size_t>();
     height = reader.Read<size_t>();
@@ -50,27 +74,42 @@ Error::ErrorCode TextureAsset::LoadFromBuffer(DataReader &reader)
     repeat = reader.Read<uint8_t>() != 0;
     mipmaps = reader.Read<uint8_t>() != 0;
     pixelFormat = static_cast<PixelFormat>(reader.Read<uint8_t>());
-    size_t pixelDataSize = width * height;
-    if (pixelFormat == PixelFormat::RGBA8)
+    if (pixelFormat > PixelFormat::BC6H ||
+        (version <= TEXTURE_ASSET_VERSION_NO_COMPRESSION && IsCompressedFormat(pixelFormat)))
     {
-        pixelDataSize *= 4; // 4 bytes
-    } else
+        return Error::ErrorCode::INCORRECT_FORMAT;
+    }
+    levelCount = 1;
+    if (version != TEXTURE_ASSET_VERSION_NO_MIPS)
     {
-        pixelDataSize *= 4 * 2; // 4 16-bit floats
+        levelCount = reader.Read<uint8_t>();
+        if (levelCount != 1 && levelCount != MipGenerator::GetLevelCount(width, height))
+        {
+            return Error::ErrorCode::INCORRECT_FORMAT;
+        }
     }
-    reader.ReadToVector<uint8_t>(pixelData, pixelDataSize);
+    reader.ReadToVector<uint8_t>(pixelData, GetLevelOffset(levelCount));
     return Error::ErrorCode::OK;
 }
 
 Error::ErrorCode TextureAsset::SaveToBuffer(DataWriter &writer) const
 {
+    if (mipmaps && levelCount != MipGenerator::GetLevelCount(width, height) && !IsCompressedFormat(pixelFormat))
+    {
+        TextureAsset withMipmaps = *this;
+        withMipmaps.GenerateMipmaps();
+        return withMipmaps.SaveToBuffer(writer);
+    }
+    // Textures without mipmaps only need the base level
+    const uint32_t savedLevelCount = mipmaps ? levelCount : 1;
     writer.Write<size_t>(width);
     writer.Write<size_t>(height);
     writer.Write<uint8_t>(filter ? 1 : 0);
     writer.Write<uint8_t>(repeat ? 1 : 0);
     writer.Write<uint8_t>(mipmaps ? 1 : 0);
     writer.Write<uint8_t>(static_cast<uint8_t>(pixelFormat));
-    writer.WriteBuffer<uint8_t>(pixelData);
+    writer.Write<uint8_t>(savedLevelCount);
+    writer.WriteBuffer<uint8_t>(pixelData.data(), GetLevelOffset(savedLevelCount));
     return Error::ErrorCode::OK;
 }
 
@@ -93,25 +132,28 @@ Error::ErrorCode TextureAsset::CreateFromPNG(const string &imagePath)
     width = pngWidth;
     height = pngHeight;
     pixelFormat = PixelFormat::RGBA8;
-    const size_t pixelDataSize = width * height * 4;
-    pixelData = std::vector<uint8_t>(pixelDataSize);
-    for (size_t i = 0; i < pixelDataSize; i++)
-    {
-        pixelData.at(i) = data[i];
-    }
+    levelCount = 1;
+    pixelData.assign(data, data + (width * height * 4));
     stbi_image_free(data);
     return Error::ErrorCode::OK;
 }
 
 Error::ErrorCode TextureAsset::CreateFromEXR(const string &imagePath)
 {
+    EnableExrThreads();
     RgbaInputFile file = RgbaInputFile(imagePath.c_str());
     const Box2i dw = file.dataWindow();
     width = dw.max.x - dw.min.x + 1;
     height = dw.max.y - dw.min.y + 1;
-    pixelData = std::vector<uint8_t>(width * height * 4 * 2);
+    pixelData = std::vector<uint8_t>(width * height * sizeof(Rgba));
     pixelFormat = PixelFormat::RGBAF16;
-    file.setFrameBuffer(reinterpret_cast<Rgba *>(GetPixelsRGBA()), 1, width);
+    levelCount = 1;
+    // Decode straight into the pixel data. The frame buffer is addressed in data window coordinates, which don't
+    // have to start at 0.
+    Rgba *pixels = reinterpret_cast<Rgba *>(GetPixelsRGBA());
+    file.setFrameBuffer(pixels - dw.min.x - (static_cast<ptrdiff_t>(dw.min.y) * static_cast<ptrdiff_t>(width)),
+                        1,
+                        width);
     file.readPixels(dw.min.y, dw.max.y);
     return Error::ErrorCode::OK;
 }
@@ -121,6 +163,7 @@ void TextureAsset::CreateMissingTexture()
     width = 64;
     height = 64;
     pixelFormat = PixelFormat::RGBA8;
+    levelCount = 1;
     constexpr size_t PIXEL_DATA_SIZE = 64 * 64 * 4;
     pixelData = std::vector<uint8_t>(PIXEL_DATA_SIZE);
     uint32_t *pixels = reinterpret_cast<uint32_t *>(pixelData.data());
@@ -154,12 +197,12 @@ Error::ErrorCode TextureAsset::LoadFromAsset(const std::string &filePath)
         CreateMissingTexture();
         return Error::ErrorCode::OK;
     }
-    if (asset.typeVersion != GetAssetTypeVersion())
+    if (asset.typeVersion < TEXTURE_ASSET_VERSION_NO_MIPS || asset.typeVersion > GetAssetTypeVersion())
     {
         CreateMissingTexture();
         return Error::ErrorCode::OK;
     }
-    const Error::ErrorCode loadErr = LoadFromBuffer(asset.reader);
+    const Error::ErrorCode loadErr = LoadFromBuffer(asset.reader, asset.typeVersion);
     if (loadErr != Error::ErrorCode::OK)
     {
         CreateMissingTexture();
@@ -171,15 +214,19 @@ Error::ErrorCode TextureAsset::Import(const std::string &filePath)
 {
     const std::filesystem::path path = filePath;
     const std::string extension = path.extension().string();
+    Error::ErrorCode e = Error::ErrorCode::INCORRECT_FORMAT;
     if (extension == ".png")
     {
-        return CreateFromPNG(filePath.c_str());
+        e = CreateFromPNG(filePath.c_str());
+    } else if (extension == ".exr")
+    {
+        e = CreateFromEXR(filePath.c_str());
     }
-    if (extension == ".exr")
+    if (e == Error::ErrorCode::OK && mipmaps)
     {
-        return CreateFromEXR(filePath.c_str());
+        GenerateMipmaps();
     }
-    return Error::ErrorCode::INCORRECT_FORMAT;
+    return e;
 }
 
 Error::ErrorCode TextureAsset::Export(const std::string &filePath) const
@@ -190,6 +237,21 @@ Error::ErrorCode TextureAsset::Export(const std::string &filePath) const
             return SaveAsPNG(filePath.c_str());
         case PixelFormat::RGBAF16:
             return SaveAsEXR(filePath.c_str());
+        case PixelFormat::BC1:
+        case PixelFormat::BC3:
+        case PixelFormat::BC4:
+        case PixelFormat::BC5:
+        case PixelFormat::BC7:
+        case PixelFormat::BC6H:
+        {
+            TextureAsset decompressed = *this;
+            const Error::ErrorCode error = decompressed.Decompress();
+            if (error != Error::ErrorCode::OK)
+            {
+                return error;
+            }
+            return decompressed.Export(filePath);
+        }
     }
     return Error::ErrorCode::INCORRECT_FORMAT;
 }
@@ -209,6 +271,165 @@ size_t TextureAsset::GetPixelDataSize() const
     return pixelData.size();
 }
 
+void TextureAsset::GenerateMipmaps()
+{
+    if (IsCompressedFormat(pixelFormat))
+    {
+        return;
+    }
+    // Drop the old levels first, as the generator can't read from the buffer it appends to
+    std::vector<uint8_t> levels(pixelData.begin(), pixelData.begin() + static_cast<ptrdiff_t>(GetLevelOffset(1)));
+    if (pixelFormat == PixelFormat::RGBA8)
+    {
+        MipGenerator::GenerateRGBA8(GetPixelsRGBA(), width, height, levels);
+    } else
+    {
+        MipGenerator::GenerateRGBAF16(GetPixelsRGBA(), width, height, levels);
+    }
+    pixelData = std::move(levels);
+    levelCount = MipGenerator::GetLevelCount(width, height);
+}
+
+Error::ErrorCode TextureAsset::Compress(const PixelFormat format, const BlockCompressor::Quality quality)
+{
+    if (!IsCompressedFormat(format) || IsCompressedFormat(pixelFormat))
+    {
+        return Error::ErrorCode::INVALID_ARGUMENT;
+    }
+    if (IsHdrFormat(format) != IsHdrFormat(pixelFormat))
+    {
+        return Error::ErrorCode::INCORRECT_FORMAT;
+    }
+    if (mipmaps && levelCount != MipGenerator::GetLevelCount(width, height))
+    {
+        GenerateMipmaps();
+    }
+
+    std::vector<uint8_t> blocks{};
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        BlockCompressor::Encode(GetLevelPixels(level),
+                                GetLevelWidth(level),
+                                GetLevelHeight(level),
+                                GetBlockFormat(format),
+                                quality,
+                                blocks);
+    }
+    pixelData = std::move(blocks);
+    pixelFormat = format;
+    return Error::ErrorCode::OK;
+}
+
+Error::ErrorCode TextureAsset::Decompress()
+{
+    if (!IsCompressedFormat(pixelFormat))
+    {
+        return Error::ErrorCode::OK;
+    }
+
+    std::vector<uint8_t> pixels{};
+    bool supported = true;
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        supported &= BlockCompressor::Decode(GetLevelPixels(level),
+                                             GetLevelWidth(level),
+                                             GetLevelHeight(level),
+                                             GetBlockFormat(pixelFormat),
+                                             pixels);
+    }
+    if (!supported)
+    {
+        Logger::Warning("Texture contains compressed blocks in an unsupported mode, they have been left black");
+    }
+    pixelData = std::move(pixels);
+    pixelFormat = IsHdrFormat(pixelFormat) ? PixelFormat::RGBAF16 : PixelFormat::RGBA8;
+    return Error::ErrorCode::OK;
+}
+
+bool TextureAsset::IsCompressedFormat(const PixelFormat format)
+{
+    return format != PixelFormat::RGBA8 && format != PixelFormat::RGBAF16;
+}
+
+bool TextureAsset::IsHdrFormat(const PixelFormat format)
+{
+    return format == PixelFormat::RGBAF16 || format == PixelFormat::BC6H;
+}
+
+uint32_t TextureAsset::GetLevelCount() const
+{
+    return levelCount;
+}
+
+uint32_t TextureAsset::GetLevelWidth(const uint32_t level) const
+{
+    return MipGenerator::GetLevelSize(width, level);
+}
+
+uint32_t TextureAsset::GetLevelHeight(const uint32_t level) const
+{
+    return MipGenerator::GetLevelSize(height, level);
+}
+
+const uint8_t *TextureAsset::GetLevelPixels(const uint32_t level) const
+{
+    return pixelData.data() + GetLevelOffset(level);
+}
+
+size_t TextureAsset::GetLevelDataSize(const uint32_t level) const
+{
+    if (IsCompressedFormat(pixelFormat))
+    {
+        return BlockCompressor::GetImageSize(GetBlockFormat(pixelFormat), GetLevelWidth(level), GetLevelHeight(level));
+    }
+    return static_cast<size_t>(GetLevelWidth(level)) * GetLevelHeight(level) * GetBytesPerPixel();
+}
+
+uint32_t TextureAsset::GetLevelForSize(const uint32_t minSize) const
+{
+    uint32_t level = 0;
+    while (level + 1 < levelCount && std::max(GetLevelWidth(level + 1), GetLevelHeight(level + 1)) >= minSize)
+    {
+        level++;
+    }
+    return level;
+}
+
+size_t TextureAsset::GetBytesPerPixel() const
+{
+    return pixelFormat == PixelFormat::RGBA8 ? 4 : 4 * 2;
+}
+
+BlockCompressor::Format TextureAsset::GetBlockFormat(const PixelFormat format)
+{
+    switch (format)
+    {
+        case PixelFormat::BC1:
+            return BlockCompressor::Format::BC1;
+        case PixelFormat::BC3:
+            return BlockCompressor::Format::BC3;
+        case PixelFormat::BC4:
+            return BlockCompressor::Format::BC4;
+        case PixelFormat::BC5:
+            return BlockCompressor::Format::BC5;
+        case PixelFormat::BC6H:
+            return BlockCompressor::Format::BC6H;
+        case PixelFormat::BC7:
+        default:
+            return BlockCompressor::Format::BC7;
+    }
+}
+
+size_t TextureAsset::GetLevelOffset(const uint32_t level) const
+{
+    size_t offset = 0;
+    for (uint32_t i = 0; i < level; i++)
+    {
+        offset += GetLevelDataSize(i);
+    }
+    return offset;
+}
+
 Error::ErrorCode TextureAsset::SaveAsPNG(const string &imagePath) const
 {
     std::vector<uint8_t> pixelDataCopy = pixelData;
@@ -224,6 +445,7 @@ Error::ErrorCode TextureAsset::SaveAsPNG(const string &imagePath) const
 
 Error::ErrorCode TextureAsset::SaveAsEXR(const string &imagePath) const
 {
+    EnableExrThreads();
     Header header = Header(static_cast<int>(width), static_cast<int>(height));
     header.channels().insert("R", Channel(HALF));
     header.channels().insert("G", Channel(HALF));
@@ -2,6 +2,7 @@
 // Created by droc101 on 8/30/25.
 //
 
+#include <algorithm>
 #include <assimp/config.h>
 #include <assimp/Importer.hpp>
 #include <assimp/mesh.h>
@@ -10,16 +11,21 @@
 #include <assimp/vector3.h>
 #include <cstddef>
 #include <cstdint>
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec3.hpp>
 #include <libassets/type/BoundingBox.h>
 #include <libassets/type/ConvexHull.h>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
+#include <libassets/util/QuickHull.h>
 #include <string>
 #include <vector>
 
-ConvexHull::ConvexHull(DataReader &reader)
+ConvexHull::ConvexHull(DataReader &reader, const bool hasMassProperties)
 {
     const size_t numPoints = reader.Read<size_t>();
     offset = reader.ReadVec3();
@@ -27,6 +33,21 @@ ConvexHull::ConvexHull(DataReader &reader)
     {
         points.push_back(reader.ReadVec3());
     }
+    if (!hasMassProperties)
+    {
+        QuickHull::Hull hull{};
+        if (QuickHull::Compute(points, 0, points.size(), hull))
+        {
+            CalculateMassProperties(hull);
+        }
+        return;
+    }
+    massProperties.volume = reader.Read<float>();
+    massProperties.centroid = reader.ReadVec3();
+    for (int column = 0; column < 3; column++)
+    {
+        massProperties.inertia[column] = reader.ReadVec3();
+    }
 }
 
 ConvexHull::ConvexHull(const std::string &objPath, Error::ErrorCode &status)
@@ -58,6 +79,7 @@ ConvexHull::ConvexHull(const std::string &objPath, Error::ErrorCode &status)
         }
     }
 
+    Reduce(DEFAULT_TOLERANCE, DEFAULT_MAX_POINTS);
     CalculateOffset();
     status = Error::ErrorCode::OK;
 }
@@ -69,6 +91,13 @@ ConvexHull::ConvexHull(const aiMesh *mesh)
         const aiVector3d vert = mesh->mVertices[v];
         points.emplace_back(static_cast<float>(vert.x), static_cast<float>(vert.y), static_cast<float>(vert.z));
     }
+    Reduce(DEFAULT_TOLERANCE, DEFAULT_MAX_POINTS);
+    CalculateOffset();
+}
+
+ConvexHull::ConvexHull(const std::vector<glm::vec3> &sourcePoints, const size_t maxPoints): points(sourcePoints)
+{
+    Reduce(DEFAULT_TOLERANCE, maxPoints);
     CalculateOffset();
 }
 
@@ -81,6 +110,12 @@ void ConvexHull::Write(DataWriter &writer) const
     {
         writer.WriteVec3(point);
     }
+    writer.Write<float>(massProperties.volume);
+    writer.WriteVec3(massProperties.centroid);
+    for (int column = 0; column < 3; column++)
+    {
+        writer.WriteVec3(massProperties.inertia[column]);
+    }
 }
 
 std::vector<glm::vec3> &ConvexHull::GetPoints()
@@ -100,6 +135,29 @@ std::vector<float> ConvexHull::GetPointsForRender() const
     return buffer;
 }
 
+const ConvexHull::MassProperties &ConvexHull::GetMassProperties() const
+{
+    return massProperties;
+}
+
+void ConvexHull::Reduce(const float tolerance, const size_t maxPoints)
+{
+    if (points.empty())
+    {
+        return;
+    }
+    const BoundingBox bounds = BoundingBox(points);
+    const float size = std::max({bounds.extents.x, bounds.extents.y, bounds.extents.z}) * 2.0f;
+    QuickHull::Hull hull{};
+    if (!QuickHull::Compute(points, tolerance * size, maxPoints, hull))
+    {
+        Logger::Warning("Convex hull with {} points is flat", points.size());
+        return;
+    }
+    points = hull.vertices;
+    CalculateMassProperties(hull);
+}
+
 void ConvexHull::CalculateOffset()
 {
     const BoundingBox bb = BoundingBox(points);
@@ -130,3 +188,50 @@ Error::ErrorCode ConvexHull::ImportMultiple(const std::string &path, std::vector
 
     return Error::ErrorCode::OK;
 }
+
+void ConvexHull::CalculateMassProperties(const QuickHull::Hull &hull)
+{
+    // Sum the tetrahedrons between each face and a point inside, which is close to the faces to keep precision
+    glm::dvec3 reference{};
+    for (const glm::vec3 &vertex: hull.vertices)
+    {
+        reference += glm::dvec3(vertex);
+    }
+    reference /= static_cast<double>(hull.vertices.size());
+
+    double volume = 0;
+    glm::dvec3 centroid{};
+    glm::dmat3 covariance{0};
+    for (size_t i = 0; i < hull.indices.size(); i += 3)
+    {
+        const glm::dvec3 a = glm::dvec3(hull.vertices.at(hull.indices.at(i))) - reference;
+        const glm::dvec3 b = glm::dvec3(hull.vertices.at(hull.indices.at(i + 1))) - reference;
+        const glm::dvec3 c = glm::dvec3(hull.vertices.at(hull.indices.at(i + 2))) - reference;
+        // Six times the signed volume of the tetrahedron
+        const double determinant = glm::dot(a, glm::cross(b, c));
+        const glm::dvec3 sum = a + b + c;
+        volume += determinant / 6.0;
+        centroid += sum * (determinant / 24.0);
+        covariance += (glm::outerProduct(a, a) +
+                       glm::outerProduct(b, b) +
+                       glm::outerProduct(c, c) +
+                       glm::outerProduct(sum, sum)) *
+                      (determinant / 120.0);
+    }
+    if (volume <= 0)
+    {
+        massProperties = {};
+        return;
+    }
+    centroid /= volume;
+    // Move the covariance from the reference point to the centroid, then turn it into an inertia tensor
+    covariance -= glm::outerProduct(centroid, centroid) * volume;
+    const double trace = covariance[0][0] + covariance[1][1] + covariance[2][2];
+    const glm::dmat3 inertia = (glm::dmat3(trace) - covariance) / volume;
+
+    massProperties = {
+        .volume = static_cast<float>(volume),
+        .centroid = glm::vec3(centroid + reference),
+        .inertia = glm::mat3(inertia),
+    };
+}
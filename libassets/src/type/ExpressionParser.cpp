@@ -7,10 +7,9 @@
 #include <cstddef>
 #include <libassets/type/ExpressionParser.h>
 #include <libassets/util/Logger.h>
-#include <ranges>
 #include <string>
 #include <tinyexpr.h>
-#include <utility>
+#include <vector>
 
 ExpressionParser::ExpressionParser(const std::string &expression)
 {
@@ -34,13 +33,14 @@ ExpressionParser &ExpressionParser::operator=(const ExpressionParser &other)
     }
     expression = other.expression;
     varMetadata = other.varMetadata;
+    values = other.values;
     vars.clear();
-    for (const std::pair<const std::string, ExpressionVariable> &metadata: varMetadata)
+
+    if (expr != nullptr)
     {
-        vars.emplace_back(metadata.first.c_str(), &metadata.second.value, 0, nullptr);
+        te_free(expr);
+        expr = nullptr;
     }
-
-    expr = nullptr;
     if (other.expr != nullptr)
     {
         Compile();
@@ -53,7 +53,7 @@ ExpressionParser::ExpressionParser(const ExpressionParser &other)
     *this = other;
 }
 
-void ExpressionParser::AddVariable(const std::string &variableName)
+size_t ExpressionParser::AddVariable(const std::string &variableName)
 {
     assert(expr == nullptr);
 
@@ -68,13 +68,18 @@ void ExpressionParser::AddVariable(const std::string &variableName)
     }
 
     const ExpressionVariable var = {
+        .name = variableName,
         .compiledName = compiledName,
-        .value = 0,
     };
-    varMetadata[variableName] = var;
+    varMetadata.push_back(var);
+    values.push_back(0);
 
     const std::string::size_type pos = expression.find(variableName);
-    expression.replace(pos, variableName.length(), compiledName);
+    if (pos != std::string::npos)
+    {
+        expression.replace(pos, variableName.length(), compiledName);
+    }
+    return varMetadata.size() - 1;
 }
 
 bool ExpressionParser::Compile()
@@ -85,9 +90,11 @@ bool ExpressionParser::Compile()
         return false;
     }
 
-    for (const ExpressionVariable &val: varMetadata | std::views::values)
+    // Variables are bound by the address of their value, so setting one is just a store
+    vars.clear();
+    for (size_t i = 0; i < varMetadata.size(); i++)
     {
-        const te_variable var = {.name = val.compiledName.c_str(), .address = &val.value};
+        const te_variable var = {.name = varMetadata.at(i).compiledName.c_str(), .address = &values.at(i)};
         vars.push_back(var);
     }
 
@@ -112,7 +119,20 @@ bool ExpressionParser::Compile()
 void ExpressionParser::SetVariable(const std::string &variableName, const double value)
 {
     assert(expr != nullptr);
-    varMetadata.at(variableName).value = value;
+    // A variable used more than once has one slot per use
+    for (size_t i = 0; i < varMetadata.size(); i++)
+    {
+        if (varMetadata.at(i).name == variableName)
+        {
+            values.at(i) = value;
+        }
+    }
+}
+
+void ExpressionParser::SetVariable(const size_t variableIndex, const double value)
+{
+    assert(expr != nullptr);
+    values.at(variableIndex) = value;
 }
 
 double ExpressionParser::Evaluate() const
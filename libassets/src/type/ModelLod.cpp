@@ -2,11 +2,13 @@
 // Created by droc101 on 7/18/25.
 //
 
+#include <algorithm>
 #include <array>
 #include <assimp/Importer.hpp>
 #include <assimp/mesh.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <bit>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -20,13 +22,138 @@
 #include <libassets/util/Error.h>
 #include <libassets/util/LightmapHelpers.hpp>
 #include <libassets/util/Logger.h>
+#include <libassets/util/MeshOptimizer.h>
+#include <libassets/util/MeshSimplifier.h>
+#include <libassets/util/ThreadPool.h>
 #include <numeric>
 #include <stb_rect_pack.h>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
-ModelLod::ModelLod(DataReader &reader, const uint32_t materialsPerSkin)
+namespace
+{
+    /// Models with fewer vertices than this are welded on the calling thread
+    constexpr size_t MIN_VERTICES_FOR_THREADS = 65536;
+
+    /**
+     * Snap an attribute to the weld grid
+     * @param value The attribute
+     * @param tolerance The size of the grid, or 0 to keep every distinct value apart
+     */
+    int64_t Quantize(const float value, const float tolerance)
+    {
+        if (tolerance <= 0)
+        {
+            // 0 and -0 have different bits but should still weld
+            return value == 0 ? 0 : std::bit_cast<int32_t>(value);
+        }
+        return std::llround(value / tolerance);
+    }
+
+    /// The attributes of a vertex snapped to the weld grid, which are equal for vertices that should be merged
+    struct WeldKey
+    {
+            std::array<int64_t, 12> values{};
+
+            WeldKey() = default;
+
+            WeldKey(const ModelVertex &vertex, const ModelLod::WeldTolerances &tolerances)
+            {
+                const std::array<float, 4> color = vertex.color.CopyData();
+                values = {
+                    Quantize(vertex.position.x, tolerances.position),
+                    Quantize(vertex.position.y, tolerances.position),
+                    Quantize(vertex.position.z, tolerances.position),
+                    Quantize(vertex.normal.x, tolerances.normal),
+                    Quantize(vertex.normal.y, tolerances.normal),
+                    Quantize(vertex.normal.z, tolerances.normal),
+                    Quantize(vertex.uv.x, tolerances.uv),
+                    Quantize(vertex.uv.y, tolerances.uv),
+                    Quantize(color.at(0), tolerances.color),
+                    Quantize(color.at(1), tolerances.color),
+                    Quantize(color.at(2), tolerances.color),
+                    Quantize(color.at(3), tolerances.color),
+                };
+            }
+
+            bool operator==(const WeldKey &other) const = default;
+
+            [[nodiscard]] uint64_t Hash() const
+            {
+                constexpr uint64_t GOLDEN_RATIO = 0x9e3779b97f4a7c15;
+                uint64_t hashValue = 0;
+                for (const int64_t value: values)
+                {
+                    hashValue ^= static_cast<uint64_t>(value) + GOLDEN_RATIO + (hashValue << 6) + (hashValue >> 2);
+                }
+                // Linear probing uses the low bits, so mix the high bits into them
+                hashValue ^= hashValue >> 33;
+                hashValue *= 0xff51afd7ed558ccdull;
+                hashValue ^= hashValue >> 33;
+                return hashValue;
+            }
+    };
+
+    /// An open addressing hash table from weld keys to welded vertex indices
+    class VertexWeldTable
+    {
+        public:
+            explicit VertexWeldTable(const size_t maxEntries):
+                slots(std::bit_ceil(std::max<size_t>(16, maxEntries * 2)))
+            {}
+
+            /**
+             * Find the welded vertex with the same key, or add a new one
+             * @param keys The keys of every vertex
+             * @param hash The hash of the key
+             * @param keyIndex The index of the key in keys
+             * @param newIndex The index to use if there is no vertex with this key yet
+             * @return The welded vertex index
+             */
+            uint32_t Insert(const std::vector<WeldKey> &keys,
+                            const uint64_t hash,
+                            const size_t keyIndex,
+                            const uint32_t newIndex)
+            {
+                const size_t mask = slots.size() - 1;
+                const uint32_t shortHash = static_cast<uint32_t>(hash >> 32);
+                for (size_t slotIndex = hash & mask;; slotIndex = (slotIndex + 1) & mask)
+                {
+                    Slot &slot = slots[slotIndex];
+                    if (slot.weldedIndex == EMPTY)
+                    {
+                        slot = {
+                            .shortHash = shortHash,
+                            .weldedIndex = newIndex,
+                            .keyIndex = keyIndex,
+                        };
+                        return newIndex;
+                    }
+                    if (slot.shortHash == shortHash && keys[slot.keyIndex] == keys[keyIndex])
+                    {
+                        return slot.weldedIndex;
+                    }
+                }
+            }
+
+        private:
+            static constexpr uint32_t EMPTY = UINT32_MAX;
+
+            struct Slot
+            {
+                    /// The upper half of the hash, to skip most key comparisons
+                    uint32_t shortHash = 0;
+                    uint32_t weldedIndex = EMPTY;
+                    /// The index of the first vertex with this key
+                    size_t keyIndex = 0;
+            };
+
+            std::vector<Slot> slots;
+    };
+} // namespace
+
+ModelLod::ModelLod(DataReader &reader, const uint32_t materialsPerSkin, const bool quantized)
 {
     distance = reader.Read<float>();
     reader.Skip<float>();
@@ -34,9 +161,21 @@ ModelLod::ModelLod(DataReader &reader, const uint32_t materialsPerSkin)
     lightmapSize.x = reader.Read<uint32_t>();
     lightmapSize.y = reader.Read<uint32_t>();
     const size_t vertexCount = reader.Read<size_t>();
-    for (size_t _i = 0; _i < vertexCount; _i++)
+    vertices.reserve(vertexCount);
+    if (quantized)
     {
-        vertices.emplace_back(reader);
+        const glm::vec2 uvOffset = reader.ReadVec2();
+        const glm::vec2 uvScale = reader.ReadVec2();
+        for (size_t _i = 0; _i < vertexCount; _i++)
+        {
+            vertices.emplace_back(reader, uvOffset, uvScale);
+        }
+    } else
+    {
+        for (size_t _i = 0; _i < vertexCount; _i++)
+        {
+            vertices.emplace_back(reader);
+        }
     }
     reader.Skip<uint32_t>(); // Skips the total index count which is not needed for editing
     for (uint32_t _i = 0; _i < materialsPerSkin; _i++)
@@ -54,15 +193,20 @@ ModelLod::ModelLod(DataReader &reader, const uint32_t materialsPerSkin)
     }
 }
 
-ModelLod::ModelLod(const std::string &filePath, const float distance, Error::ErrorCode &status)
+ModelLod::ModelLod(const std::string &filePath, const float distance, Error::ErrorCode &status):
+    ModelLod(filePath, distance, status, WeldTolerances{})
+{}
+
+ModelLod::ModelLod(const std::string &filePath,
+                   const float distance,
+                   Error::ErrorCode &status,
+                   const WeldTolerances &weldTolerances)
 {
     this->distance = distance;
 
-    std::unordered_map<ModelVertex, uint32_t> vertexToIndex;
-
     Assimp::Importer importer{};
+    // Identical vertices are not joined by assimp, since welding below does it faster and with tolerances
     constexpr uint32_t IMPORT_FLAGS = aiProcess_Triangulate |
-                                      aiProcess_JoinIdenticalVertices |
                                       aiProcess_SortByPType |
                                       aiProcess_ValidateDataStructure |
                                       aiProcess_GenNormals;
@@ -75,6 +219,77 @@ ModelLod::ModelLod(const std::string &filePath, const float distance, Error::Err
         return;
     }
 
+    // Every mesh's vertices are stored one after another, starting at meshFirstVertex
+    std::vector<size_t> meshFirstVertex{};
+    size_t meshVertexCount = 0;
+    for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+    {
+        meshFirstVertex.push_back(meshVertexCount);
+        meshVertexCount += scene->mMeshes[i]->mNumVertices;
+    }
+
+    // Converting and quantizing is the slow part, so it is split over every mesh's vertices in parallel
+    std::vector<ModelVertex> meshVertices(meshVertexCount);
+    std::vector<WeldKey> keys(meshVertexCount);
+    std::vector<uint64_t> hashes(meshVertexCount);
+    const auto prepareVertices = [&](const uint32_t meshIndex, const uint32_t firstVertex, const uint32_t endVertex) {
+        const aiMesh *mesh = scene->mMeshes[meshIndex];
+        for (uint32_t j = firstVertex; j < endVertex; j++)
+        {
+            const size_t vertexIndex = meshFirstVertex.at(meshIndex) + j;
+            meshVertices.at(vertexIndex) = ModelVertex(mesh, j);
+            keys.at(vertexIndex) = WeldKey(meshVertices.at(vertexIndex), weldTolerances);
+            hashes.at(vertexIndex) = keys.at(vertexIndex).Hash();
+        }
+    };
+    if (meshVertexCount < MIN_VERTICES_FOR_THREADS)
+    {
+        for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+        {
+            prepareVertices(i, 0, scene->mMeshes[i]->mNumVertices);
+        }
+    } else
+    {
+        struct VertexRange
+        {
+                uint32_t meshIndex;
+                uint32_t firstVertex;
+                uint32_t endVertex;
+        };
+        ThreadPool &pool = ThreadPool::GetShared();
+        const uint32_t verticesPerTask = static_cast<uint32_t>(
+                std::max<size_t>(1024, meshVertexCount / ((pool.GetThreadCount() + 1) * 4)));
+        std::vector<VertexRange> ranges{};
+        for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+        {
+            const uint32_t vertexCount = scene->mMeshes[i]->mNumVertices;
+            for (uint32_t firstVertex = 0; firstVertex < vertexCount; firstVertex += verticesPerTask)
+            {
+                ranges.push_back({
+                    .meshIndex = i,
+                    .firstVertex = firstVertex,
+                    .endVertex = std::min(firstVertex + verticesPerTask, vertexCount),
+                });
+            }
+        }
+        pool.Run(ranges.size(), [&prepareVertices, &ranges](const size_t task) {
+            const VertexRange &range = ranges.at(task);
+            prepareVertices(range.meshIndex, range.firstVertex, range.endVertex);
+        });
+    }
+
+    // Welding across meshes as well, so meshes that share a material also share vertices
+    VertexWeldTable weldTable(meshVertexCount);
+    std::vector<uint32_t> remap(meshVertexCount);
+    for (size_t i = 0; i < meshVertexCount; i++)
+    {
+        remap.at(i) = weldTable.Insert(keys, hashes.at(i), i, static_cast<uint32_t>(vertices.size()));
+        if (remap.at(i) == vertices.size())
+        {
+            vertices.push_back(meshVertices.at(i));
+        }
+    }
+
     for (uint32_t i = 0; i < scene->mNumMeshes; i++)
     {
         const aiMesh *mesh = scene->mMeshes[i];
@@ -86,23 +301,14 @@ ModelLod::ModelLod(const std::string &filePath, const float distance, Error::Err
         }
 
         std::vector<uint32_t> &indices = materialIndices.at(materialIndex);
+        const uint32_t *meshRemap = remap.data() + meshFirstVertex.at(i);
 
         for (uint32_t j = 0; j < mesh->mNumFaces; j++)
         {
             const aiFace &face = mesh->mFaces[j];
             for (uint32_t k = 0; k < face.mNumIndices; k++)
             {
-                const uint32_t vertexIndex = face.mIndices[k];
-                const ModelVertex vertex(mesh, vertexIndex);
-                if (vertexToIndex.contains(vertex))
-                {
-                    indices.push_back(vertexToIndex.at(vertex));
-                } else
-                {
-                    indices.push_back(this->vertices.size());
-                    this->vertices.push_back(vertex);
-                    vertexToIndex[vertex] = indices.back();
-                }
+                indices.push_back(meshRemap[face.mIndices[k]]);
             }
         }
     }
@@ -124,6 +330,8 @@ ModelLod::ModelLod(const std::string &filePath, const float distance, Error::Err
         indexCounts.erase(indexCounts.begin() + index);
     }
 
+    Optimize();
+
     status = Error::ErrorCode::OK;
 }
 
@@ -164,7 +372,7 @@ void ModelLod::Export(const char *path) const
     file.close();
 }
 
-void ModelLod::Write(DataWriter &writer) const
+void ModelLod::Write(DataWriter &writer, const bool quantized) const
 {
     writer.Write<float>(distance);
     writer.Write<float>(distance * distance);
@@ -172,9 +380,36 @@ void ModelLod::Write(DataWriter &writer) const
     writer.Write<uint32_t>(lightmapSize.x);
     writer.Write<uint32_t>(lightmapSize.y);
     writer.Write<size_t>(vertices.size());
-    for (const ModelVertex &vertex: vertices)
+    if (quantized)
+    {
+        // UVs are stored relative to their range, since tiling UVs can go far outside of 0-1
+        glm::vec2 uvMin{};
+        glm::vec2 uvMax{};
+        if (!vertices.empty())
+        {
+            uvMin = vertices.at(0).uv;
+            uvMax = vertices.at(0).uv;
+        }
+        for (const ModelVertex &vertex: vertices)
+        {
+            uvMin = glm::min(uvMin, vertex.uv);
+            uvMax = glm::max(uvMax, vertex.uv);
+        }
+        glm::vec2 uvScale = uvMax - uvMin;
+        uvScale.x = uvScale.x > 0 ? uvScale.x : 1;
+        uvScale.y = uvScale.y > 0 ? uvScale.y : 1;
+        writer.WriteVec2(uvMin);
+        writer.WriteVec2(uvScale);
+        for (const ModelVertex &vertex: vertices)
+        {
+            vertex.WriteQuantized(writer, uvMin, uvScale);
+        }
+    } else
     {
-        vertex.Write(writer);
+        for (const ModelVertex &vertex: vertices)
+        {
+            vertex.Write(writer);
+        }
     }
     const uint32_t totalIndexCount = std::accumulate(indexCounts.begin(), indexCounts.end(), 0ul);
     writer.Write<uint32_t>(totalIndexCount);
@@ -185,6 +420,100 @@ void ModelLod::Write(DataWriter &writer) const
     }
 }
 
+void ModelLod::Optimize()
+{
+    std::vector<glm::vec3> positions{};
+    positions.reserve(vertices.size());
+    for (const ModelVertex &vertex: vertices)
+    {
+        positions.push_back(vertex.position);
+    }
+    std::vector<size_t> clusterStarts{};
+    for (std::vector<uint32_t> &indices: materialIndices)
+    {
+        MeshOptimizer::OptimizeVertexCache(indices, vertices.size(), clusterStarts);
+        MeshOptimizer::OptimizeOverdraw(indices, clusterStarts, positions);
+    }
+
+    const std::vector<uint32_t> remap = MeshOptimizer::GetVertexFetchRemap(materialIndices, vertices.size());
+    std::vector<ModelVertex> remappedVertices{};
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        if (remap.at(i) == UINT32_MAX)
+        {
+            continue;
+        }
+        if (remap.at(i) >= remappedVertices.size())
+        {
+            remappedVertices.resize(remap.at(i) + 1);
+        }
+        remappedVertices.at(remap.at(i)) = vertices.at(i);
+    }
+    vertices = std::move(remappedVertices);
+    for (std::vector<uint32_t> &indices: materialIndices)
+    {
+        for (uint32_t &index: indices)
+        {
+            index = remap.at(index);
+        }
+    }
+}
+
+MeshOptimizer::VertexCacheStats ModelLod::AnalyzeVertexCache() const
+{
+    MeshOptimizer::VertexCacheStats stats{};
+    for (const std::vector<uint32_t> &indices: materialIndices)
+    {
+        stats.Add(MeshOptimizer::AnalyzeVertexCache(indices, vertices.size()));
+    }
+    return stats;
+}
+
+ModelLod ModelLod::Simplify(const float targetRatio, const float maxError, float &outError) const
+{
+    // Every material gets its own copy of the vertices it uses, so the edges between materials become seams
+    std::vector<glm::vec3> positions{};
+    std::vector<uint32_t> sourceVertices{};
+    std::vector<uint32_t> vertexMaterials{};
+    std::vector<uint32_t> indices{};
+    std::vector<uint32_t> splitVertices(vertices.size());
+    for (size_t material = 0; material < materialIndices.size(); material++)
+    {
+        std::ranges::fill(splitVertices, UINT32_MAX);
+        for (const uint32_t index: materialIndices.at(material))
+        {
+            if (splitVertices.at(index) == UINT32_MAX)
+            {
+                splitVertices.at(index) = static_cast<uint32_t>(positions.size());
+                positions.push_back(vertices.at(index).position);
+                sourceVertices.push_back(index);
+                vertexMaterials.push_back(static_cast<uint32_t>(material));
+            }
+            indices.push_back(splitVertices.at(index));
+        }
+    }
+
+    const size_t targetIndexCount = static_cast<size_t>(static_cast<float>(indices.size() / 3) * targetRatio) * 3;
+    const float relativeError = MeshSimplifier::Simplify(positions, indices, targetIndexCount, maxError);
+    outError = relativeError * MeshSimplifier::GetMeshScale(positions);
+
+    ModelLod lod{};
+    lod.unitsPerLuxel = unitsPerLuxel;
+    lod.lightmapSize = lightmapSize;
+    lod.vertices = vertices;
+    lod.materialIndices.resize(materialIndices.size());
+    for (const uint32_t index: indices)
+    {
+        lod.materialIndices.at(vertexMaterials.at(index)).push_back(sourceVertices.at(index));
+    }
+    for (const std::vector<uint32_t> &lodIndices: lod.materialIndices)
+    {
+        lod.indexCounts.push_back(lodIndices.size());
+    }
+    lod.Optimize();
+    return lod;
+}
+
 bool ModelLod::CalculateLightmapUvs()
 {
     std::vector<stbrp_rect> rects{};
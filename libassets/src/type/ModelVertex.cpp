@@ -5,12 +5,71 @@
 #include <assimp/color4.h>
 #include <assimp/mesh.h>
 #include <assimp/vector3.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <half.h>
 #include <libassets/type/Color.h>
 #include <libassets/type/ModelVertex.h>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 
+namespace
+{
+    uint16_t PackUnorm16(const float value)
+    {
+        return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    float UnpackUnorm16(const uint16_t value)
+    {
+        return static_cast<float>(value) / 65535.0f;
+    }
+
+    int16_t PackSnorm16(const float value)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    float UnpackSnorm16(const int16_t value)
+    {
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    /// Map a unit vector onto an octahedron, then unfold the lower half of it over the corners of the upper half
+    glm::vec2 EncodeOctahedral(const glm::vec3 &normal)
+    {
+        const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length == 0)
+        {
+            return {0, 0};
+        }
+        const glm::vec3 octahedron = normal / length;
+        if (octahedron.z >= 0)
+        {
+            return {octahedron.x, octahedron.y};
+        }
+        return {
+            (1.0f - std::abs(octahedron.y)) * (octahedron.x >= 0 ? 1.0f : -1.0f),
+            (1.0f - std::abs(octahedron.x)) * (octahedron.y >= 0 ? 1.0f : -1.0f),
+        };
+    }
+
+    glm::vec3 DecodeOctahedral(const glm::vec2 &encoded)
+    {
+        glm::vec3 normal{encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+        if (normal.z < 0)
+        {
+            normal.x = (1.0f - std::abs(encoded.y)) * (encoded.x >= 0 ? 1.0f : -1.0f);
+            normal.y = (1.0f - std::abs(encoded.x)) * (encoded.y >= 0 ? 1.0f : -1.0f);
+        }
+        return glm::normalize(normal);
+    }
+} // namespace
+
 ModelVertex::ModelVertex(DataReader &reader)
 {
     position = reader.ReadVec3();
@@ -32,6 +91,25 @@ ModelVertex::ModelVertex(const aiMesh *mesh, const uint32_t vertexIndex)
     this->color = Color(color.r, color.g, color.b, color.a);
 }
 
+ModelVertex::ModelVertex(DataReader &reader, const glm::vec2 &uvOffset, const glm::vec2 &uvScale)
+{
+    IMATH_NAMESPACE::half component{};
+    for (int i = 0; i < 3; i++)
+    {
+        component.setBits(reader.Read<uint16_t>());
+        position[i] = static_cast<float>(component);
+    }
+    reader.Skip<uint16_t>(); // w
+    uv.x = uvOffset.x + (UnpackUnorm16(reader.Read<uint16_t>()) * uvScale.x);
+    uv.y = uvOffset.y + (UnpackUnorm16(reader.Read<uint16_t>()) * uvScale.y);
+    color = Color(reader);
+    const float normalX = UnpackSnorm16(reader.Read<int16_t>());
+    const float normalY = UnpackSnorm16(reader.Read<int16_t>());
+    normal = DecodeOctahedral({normalX, normalY});
+    lightmapUv.x = UnpackUnorm16(reader.Read<uint16_t>());
+    lightmapUv.y = UnpackUnorm16(reader.Read<uint16_t>());
+}
+
 bool ModelVertex::operator==(const ModelVertex &other) const
 {
     return this->normal == other.normal &&
@@ -49,3 +127,19 @@ void ModelVertex::Write(DataWriter &writer) const
     writer.WriteVec3(normal);
     writer.WriteVec2(lightmapUv);
 }
+
+void ModelVertex::WriteQuantized(DataWriter &writer, const glm::vec2 &uvOffset, const glm::vec2 &uvScale) const
+{
+    writer.Write<uint16_t>(IMATH_NAMESPACE::half(position.x).bits());
+    writer.Write<uint16_t>(IMATH_NAMESPACE::half(position.y).bits());
+    writer.Write<uint16_t>(IMATH_NAMESPACE::half(position.z).bits());
+    writer.Write<uint16_t>(IMATH_NAMESPACE::half(1.0f).bits());
+    writer.Write<uint16_t>(PackUnorm16((uv.x - uvOffset.x) / uvScale.x));
+    writer.Write<uint16_t>(PackUnorm16((uv.y - uvOffset.y) / uvScale.y));
+    color.WriteUint32(writer);
+    const glm::vec2 octahedral = EncodeOctahedral(normal);
+    writer.Write<int16_t>(PackSnorm16(octahedral.x));
+    writer.Write<int16_t>(PackSnorm16(octahedral.y));
+    writer.Write<uint16_t>(PackUnorm16(lightmapUv.x));
+    writer.Write<uint16_t>(PackUnorm16(lightmapUv.y));
+}
@@ -0,0 +1,335 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+#include <libassets/util/AABBTree.h>
+#include <vector>
+
+bool AABBTree::Bounds::Overlaps(const Bounds &other) const
+{
+    return min.x <= other.max.x &&
+           max.x >= other.min.x &&
+           min.y <= other.max.y &&
+           max.y >= other.min.y &&
+           min.z <= other.max.z &&
+           max.z >= other.min.z;
+}
+
+bool AABBTree::Bounds::Contains(const Bounds &other) const
+{
+    return min.x <= other.min.x &&
+           min.y <= other.min.y &&
+           min.z <= other.min.z &&
+           max.x >= other.max.x &&
+           max.y >= other.max.y &&
+           max.z >= other.max.z;
+}
+
+AABBTree::Bounds AABBTree::Bounds::Union(const Bounds &other) const
+{
+    return {
+        .min = glm::min(min, other.min),
+        .max = glm::max(max, other.max),
+    };
+}
+
+float AABBTree::Bounds::GetHalfArea() const
+{
+    const glm::vec3 size = max - min;
+    return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+}
+
+bool AABBTree::Node::IsLeaf() const
+{
+    return left == NULL_NODE;
+}
+
+AABBTree::AABBTree(const float margin): margin(margin) {}
+
+int32_t AABBTree::Insert(const Bounds &bounds, const uint32_t userData)
+{
+    const int32_t leaf = AllocateNode();
+    Node &node = nodes.at(leaf);
+    node.bounds = {
+        .min = bounds.min - glm::vec3(margin),
+        .max = bounds.max + glm::vec3(margin),
+    };
+    node.height = 0;
+    node.userData = userData;
+    InsertLeaf(leaf);
+    return leaf;
+}
+
+void AABBTree::Remove(const int32_t proxy)
+{
+    assert(nodes.at(proxy).IsLeaf());
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+}
+
+bool AABBTree::Move(const int32_t proxy, const Bounds &bounds)
+{
+    assert(nodes.at(proxy).IsLeaf());
+    const Bounds fatBounds = {
+        .min = bounds.min - glm::vec3(margin),
+        .max = bounds.max + glm::vec3(margin),
+    };
+    // Leaves that have become much larger than their object are shrunk, so they don't keep showing up in queries
+    const Bounds looseBounds = {
+        .min = bounds.min - glm::vec3(margin * 4),
+        .max = bounds.max + glm::vec3(margin * 4),
+    };
+    const Bounds &leafBounds = nodes.at(proxy).bounds;
+    if (leafBounds.Contains(bounds) && looseBounds.Contains(leafBounds))
+    {
+        return false;
+    }
+
+    RemoveLeaf(proxy);
+    nodes.at(proxy).bounds = fatBounds;
+    InsertLeaf(proxy);
+    return true;
+}
+
+uint32_t AABBTree::GetUserData(const int32_t proxy) const
+{
+    return nodes.at(proxy).userData;
+}
+
+void AABBTree::Query(const Bounds &bounds, std::vector<uint32_t> &outUserData) const
+{
+    if (root == NULL_NODE)
+    {
+        return;
+    }
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        const Node &node = nodes.at(stack.back());
+        stack.pop_back();
+        if (!node.bounds.Overlaps(bounds))
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            outUserData.push_back(node.userData);
+        } else
+        {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void AABBTree::Clear()
+{
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+}
+
+int32_t AABBTree::AllocateNode()
+{
+    if (freeList == NULL_NODE)
+    {
+        nodes.emplace_back();
+        return static_cast<int32_t>(nodes.size() - 1);
+    }
+    const int32_t node = freeList;
+    freeList = nodes.at(node).parent;
+    nodes.at(node) = Node{};
+    return node;
+}
+
+void AABBTree::FreeNode(const int32_t node)
+{
+    nodes.at(node).parent = freeList;
+    nodes.at(node).height = -1;
+    freeList = node;
+}
+
+void AABBTree::InsertLeaf(const int32_t leaf)
+{
+    if (root == NULL_NODE)
+    {
+        root = leaf;
+        nodes.at(leaf).parent = NULL_NODE;
+        return;
+    }
+
+    // Walk down the tree, picking the child that the leaf would enlarge the least
+    const Bounds leafBounds = nodes.at(leaf).bounds;
+    int32_t sibling = root;
+    while (!nodes.at(sibling).IsLeaf())
+    {
+        const Node &node = nodes.at(sibling);
+        const float area = node.bounds.GetHalfArea();
+        const float combinedArea = node.bounds.Union(leafBounds).GetHalfArea();
+
+        // Cost of making a new parent for this node and the leaf
+        const float cost = 2 * combinedArea;
+        // Minimum cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2 * (combinedArea - area);
+
+        const auto childCost = [&](const int32_t child) {
+            const Node &childNode = nodes.at(child);
+            const float unionArea = childNode.bounds.Union(leafBounds).GetHalfArea();
+            if (childNode.IsLeaf())
+            {
+                return unionArea + inheritanceCost;
+            }
+            return unionArea - childNode.bounds.GetHalfArea() + inheritanceCost;
+        };
+        const float leftCost = childCost(node.left);
+        const float rightCost = childCost(node.right);
+
+        if (cost < leftCost && cost < rightCost)
+        {
+            break;
+        }
+        sibling = leftCost < rightCost ? node.left : node.right;
+    }
+
+    const int32_t oldParent = nodes.at(sibling).parent;
+    const int32_t newParent = AllocateNode();
+    Node &parentNode = nodes.at(newParent);
+    parentNode.parent = oldParent;
+    parentNode.bounds = nodes.at(sibling).bounds.Union(leafBounds);
+    parentNode.height = nodes.at(sibling).height + 1;
+    parentNode.left = sibling;
+    parentNode.right = leaf;
+    nodes.at(sibling).parent = newParent;
+    nodes.at(leaf).parent = newParent;
+
+    if (oldParent == NULL_NODE)
+    {
+        root = newParent;
+    } else if (nodes.at(oldParent).left == sibling)
+    {
+        nodes.at(oldParent).left = newParent;
+    } else
+    {
+        nodes.at(oldParent).right = newParent;
+    }
+
+    Refit(newParent);
+}
+
+void AABBTree::RemoveLeaf(const int32_t leaf)
+{
+    if (leaf == root)
+    {
+        root = NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = nodes.at(leaf).parent;
+    const int32_t grandParent = nodes.at(parent).parent;
+    const int32_t sibling = nodes.at(parent).left == leaf ? nodes.at(parent).right : nodes.at(parent).left;
+
+    FreeNode(parent);
+    nodes.at(sibling).parent = grandParent;
+    if (grandParent == NULL_NODE)
+    {
+        root = sibling;
+        return;
+    }
+    if (nodes.at(grandParent).left == parent)
+    {
+        nodes.at(grandParent).left = sibling;
+    } else
+    {
+        nodes.at(grandParent).right = sibling;
+    }
+    Refit(grandParent);
+}
+
+int32_t AABBTree::Balance(const int32_t node)
+{
+    Node &a = nodes.at(node);
+    if (a.IsLeaf() || a.height < 2)
+    {
+        return node;
+    }
+
+    const int32_t leftIndex = a.left;
+    const int32_t rightIndex = a.right;
+    Node &left = nodes.at(leftIndex);
+    Node &right = nodes.at(rightIndex);
+    const int32_t balance = right.height - left.height;
+
+    // Rotate the taller child up into this node's place, and move its shorter child down to this node
+    const auto rotateUp = [&](const int32_t upIndex, Node &up, Node &other, const bool upIsRight) {
+        const int32_t firstIndex = up.left;
+        const int32_t secondIndex = up.right;
+        Node &first = nodes.at(firstIndex);
+        Node &second = nodes.at(secondIndex);
+
+        up.left = node;
+        up.parent = a.parent;
+        a.parent = upIndex;
+        if (up.parent == NULL_NODE)
+        {
+            root = upIndex;
+        } else if (nodes.at(up.parent).left == node)
+        {
+            nodes.at(up.parent).left = upIndex;
+        } else
+        {
+            nodes.at(up.parent).right = upIndex;
+        }
+
+        const bool firstIsTaller = first.height > second.height;
+        const int32_t keptIndex = firstIsTaller ? firstIndex : secondIndex;
+        const int32_t movedIndex = firstIsTaller ? secondIndex : firstIndex;
+        Node &kept = nodes.at(keptIndex);
+        Node &moved = nodes.at(movedIndex);
+
+        up.right = keptIndex;
+        if (upIsRight)
+        {
+            a.right = movedIndex;
+        } else
+        {
+            a.left = movedIndex;
+        }
+        moved.parent = node;
+
+        a.bounds = other.bounds.Union(moved.bounds);
+        a.height = 1 + std::max(other.height, moved.height);
+        up.bounds = a.bounds.Union(kept.bounds);
+        up.height = 1 + std::max(a.height, kept.height);
+        return upIndex;
+    };
+
+    if (balance > 1)
+    {
+        return rotateUp(rightIndex, right, left, true);
+    }
+    if (balance < -1)
+    {
+        return rotateUp(leftIndex, left, right, false);
+    }
+    return node;
+}
+
+void AABBTree::Refit(int32_t node)
+{
+    while (node != NULL_NODE)
+    {
+        node = Balance(node);
+        Node &current = nodes.at(node);
+        const Node &left = nodes.at(current.left);
+        const Node &right = nodes.at(current.right);
+        current.height = 1 + std::max(left.height, right.height);
+        current.bounds = left.bounds.Union(right.bounds);
+        node = current.parent;
+    }
+}
@@ -7,27 +7,30 @@
 #include <cstdio>
 #include <libassets/asset/Asset.h>
 #include <libassets/util/AssetContainer.h>
+#include <libassets/util/AssetPack.h>
 #include <libassets/util/DataReader.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
+#include <memory>
+#include <string>
 #include <vector>
 #include <zconf.h>
 #include <zlib.h>
 
-Error::ErrorCode AssetContainer::Decompress(std::vector<uint8_t> &asset, AssetContainer &outAsset)
+Error::ErrorCode AssetContainer::Decompress(const uint8_t *asset, const size_t assetSize, AssetContainer &outAsset)
 {
     if (!outAsset.reader.bytes.empty())
     {
         return Error::ErrorCode::INVALID_ARGUMENT;
     }
     outAsset.reader.offset = 0;
-    if (ASSET_HEADER_SIZE > asset.size())
+    if (ASSET_HEADER_SIZE > assetSize)
     {
         return Error::ErrorCode::INVALID_HEADER;
     }
 
-    DataReader reader = DataReader(asset);
+    DataReader reader = DataReader(std::vector<uint8_t>(asset, asset + ASSET_HEADER_SIZE));
     const uint32_t magic = reader.Read<uint32_t>();
     if (magic != ASSET_CONTAINER_MAGIC)
     {
@@ -42,6 +45,10 @@ Error::ErrorCode AssetContainer::Decompress(std::vector<uint8_t> &asset, AssetCo
     outAsset.typeVersion = reader.Read<uint8_t>();
     const size_t decompressedSize = reader.Read<size_t>();
     const size_t compressedSize = reader.Read<size_t>();
+    if (ASSET_HEADER_SIZE + compressedSize > assetSize)
+    {
+        return Error::ErrorCode::INVALID_BODY;
+    }
 
     outAsset.reader.size = decompressedSize;
 
@@ -49,7 +56,7 @@ Error::ErrorCode AssetContainer::Decompress(std::vector<uint8_t> &asset, AssetCo
 
     z_stream zStream{};
 
-    zStream.next_in = asset.data() + ASSET_HEADER_SIZE;
+    zStream.next_in = const_cast<uint8_t *>(asset + ASSET_HEADER_SIZE);
     zStream.avail_in = compressedSize;
     zStream.next_out = outAsset.reader.bytes.data();
     zStream.avail_out = outAsset.reader.size;
@@ -162,8 +169,30 @@ Error::ErrorCode AssetContainer::SaveToFile(const std::string &filePath,
     return e;
 }
 
+bool AssetContainer::IsAssetContainer(const uint8_t *data, const size_t dataSize)
+{
+    if (dataSize < ASSET_HEADER_SIZE)
+    {
+        return false;
+    }
+    DataReader reader = DataReader(std::vector<uint8_t>(data, data + ASSET_HEADER_SIZE));
+    return reader.Read<uint32_t>() == ASSET_CONTAINER_MAGIC && reader.Read<uint8_t>() == ASSET_CONTAINER_VERSION;
+}
+
 Error::ErrorCode AssetContainer::LoadFromFile(const std::string &filePath, AssetContainer &outAsset)
 {
+    std::shared_ptr<AssetPack> pack = nullptr;
+    std::string packRelativePath{};
+    if (AssetPack::FindMounted(filePath, pack, packRelativePath))
+    {
+        const AssetPack::Entry *entry = pack->FindEntry(packRelativePath);
+        if (entry == nullptr)
+        {
+            return Error::ErrorCode::FILE_NOT_FOUND;
+        }
+        return Decompress(pack->GetEntryData(*entry), entry->size, outAsset);
+    }
+
     std::FILE *file = std::fopen(filePath.c_str(), "rb");
     if (file == nullptr)
     {
@@ -179,5 +208,5 @@ Error::ErrorCode AssetContainer::LoadFromFile(const std::string &filePath, Asset
     fseek(file, 0, SEEK_SET);
     fread(compressedData.data(), 1, dataSize, file);
     fclose(file);
-    return Decompress(compressedData, outAsset);
+    return Decompress(compressedData.data(), compressedData.size(), outAsset);
 }
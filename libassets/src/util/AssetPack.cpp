@@ -0,0 +1,423 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <libassets/util/AssetContainer.h>
+#include <libassets/util/AssetPack.h>
+#include <libassets/util/Checksum.h>
+#include <libassets/util/DataReader.h>
+#include <libassets/util/DataWriter.h>
+#include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::mutex mountedPacksMutex{};
+    std::unordered_map<std::string, std::shared_ptr<AssetPack>> mountedPacks{};
+} // namespace
+
+AssetPack::~AssetPack()
+{
+    Close();
+}
+
+void AssetPack::Close()
+{
+    entries.clear();
+#ifdef WIN32
+    if (mappedData != nullptr)
+    {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+    }
+#else
+    if (mappedData != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(mappedData), mappedSize);
+    }
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+Error::ErrorCode AssetPack::Open(const std::string &packPath)
+{
+    Close();
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(packPath.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return Error::ErrorCode::FILE_NOT_FOUND;
+    }
+    fileHandle = file;
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    if (mappedSize < ASSET_PACK_HEADER_SIZE)
+    {
+        Close();
+        return Error::ErrorCode::INVALID_HEADER;
+    }
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        Close();
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    mappedData = static_cast<const uint8_t *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mappedData == nullptr)
+    {
+        Close();
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+#else
+    const int file = open(packPath.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return Error::ErrorCode::FILE_NOT_FOUND;
+    }
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < ASSET_PACK_HEADER_SIZE)
+    {
+        close(file);
+        return Error::ErrorCode::INVALID_HEADER;
+    }
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+    void *mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED)
+    {
+        mappedSize = 0;
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    mappedData = static_cast<const uint8_t *>(mapping);
+#endif
+
+    DataReader header = DataReader(std::vector<uint8_t>(mappedData, mappedData + ASSET_PACK_HEADER_SIZE));
+    if (header.Read<uint32_t>() != ASSET_PACK_MAGIC)
+    {
+        Close();
+        return Error::ErrorCode::INVALID_HEADER;
+    }
+    if (header.Read<uint8_t>() != ASSET_PACK_VERSION)
+    {
+        Close();
+        return Error::ErrorCode::INCORRECT_VERSION;
+    }
+    const size_t entryCount = header.Read<size_t>();
+    const size_t directoryOffset = header.Read<size_t>();
+    if (directoryOffset < ASSET_PACK_HEADER_SIZE || directoryOffset > mappedSize)
+    {
+        Close();
+        return Error::ErrorCode::INVALID_HEADER;
+    }
+
+    DataReader directory = DataReader(std::vector<uint8_t>(mappedData + directoryOffset, mappedData + mappedSize));
+    try
+    {
+        entries.reserve(entryCount);
+        for (size_t i = 0; i < entryCount; i++)
+        {
+            Entry entry{};
+            directory.ReadStringWithSize(entry.path);
+            entry.offset = directory.Read<size_t>();
+            entry.size = directory.Read<size_t>();
+            entry.hash = directory.Read<uint64_t>();
+            // Written so that a huge offset or size can't wrap around and pass
+            if (entry.offset < ASSET_PACK_HEADER_SIZE ||
+                entry.offset > directoryOffset ||
+                entry.size > directoryOffset - entry.offset)
+            {
+                Close();
+                return Error::ErrorCode::INVALID_BODY;
+            }
+            entries.push_back(entry);
+        }
+    } catch (const std::runtime_error &exception)
+    {
+        Logger::Error("Failed to read pack directory: {}", exception.what());
+        Close();
+        return Error::ErrorCode::INVALID_BODY;
+    }
+
+    if (!std::ranges::is_sorted(entries, {}, &Entry::path))
+    {
+        Close();
+        return Error::ErrorCode::INVALID_BODY;
+    }
+
+    return Error::ErrorCode::OK;
+}
+
+Error::ErrorCode AssetPack::Build(const std::string &directoryPath, const std::string &packPath)
+{
+    if (!std::filesystem::is_directory(directoryPath))
+    {
+        return Error::ErrorCode::INVALID_DIRECTORY;
+    }
+
+    std::vector<std::filesystem::path> files{};
+    try
+    {
+        for (const std::filesystem::directory_entry &entry:
+             std::filesystem::recursive_directory_iterator(directoryPath))
+        {
+            if (entry.is_regular_file())
+            {
+                files.push_back(entry.path());
+            }
+        }
+    } catch (const std::filesystem::filesystem_error &exception)
+    {
+        Logger::Error("std::filesystem_error: {}", exception.what());
+        return Error::ErrorCode::INVALID_DIRECTORY;
+    }
+
+    std::vector<uint8_t> data{};
+    std::vector<Entry> newEntries{};
+    std::unordered_map<uint64_t, std::vector<size_t>> entriesByHash{};
+    size_t dedupedFiles = 0;
+    for (const std::filesystem::path &file: files)
+    {
+        std::FILE *f = std::fopen(file.string().c_str(), "rb");
+        if (f == nullptr)
+        {
+            Logger::Error("Failed to open \"{}\"", file.string());
+            return Error::ErrorCode::CANT_OPEN_FILE;
+        }
+        fseek(f, 0, SEEK_END);
+        const size_t fileSize = ftell(f);
+        std::vector<uint8_t> fileData(fileSize);
+        fseek(f, 0, SEEK_SET);
+        fread(fileData.data(), 1, fileSize, f);
+        fclose(f);
+
+        const std::string relPath = std::filesystem::relative(file, directoryPath).generic_string();
+        if (!AssetContainer::IsAssetContainer(fileData.data(), fileData.size()))
+        {
+            Logger::Verbose("Skipping \"{}\" as it is not an asset file", relPath);
+            continue;
+        }
+
+        Entry entry = {
+            .path = relPath,
+            .offset = 0,
+            .size = fileData.size(),
+            .hash = Checksum::Hash64(fileData.data(), fileData.size()),
+        };
+
+        bool deduplicated = false;
+        std::vector<size_t> &sameHash = entriesByHash[entry.hash];
+        for (const size_t index: sameHash)
+        {
+            const Entry &existing = newEntries.at(index);
+            if (existing.size == entry.size &&
+                std::memcmp(data.data() + (existing.offset - ASSET_PACK_HEADER_SIZE),
+                            fileData.data(),
+                            fileData.size()) == 0)
+            {
+                entry.offset = existing.offset;
+                deduplicated = true;
+                dedupedFiles++;
+                break;
+            }
+        }
+        if (!deduplicated)
+        {
+            entry.offset = ASSET_PACK_HEADER_SIZE + data.size();
+            data.insert(data.end(), fileData.begin(), fileData.end());
+        }
+        sameHash.push_back(newEntries.size());
+        newEntries.push_back(entry);
+    }
+
+    std::ranges::sort(newEntries, {}, &Entry::path);
+
+    DataWriter writer{};
+    writer.Write<uint32_t>(ASSET_PACK_MAGIC);
+    writer.Write<uint8_t>(ASSET_PACK_VERSION);
+    writer.Write<size_t>(newEntries.size());
+    writer.Write<size_t>(ASSET_PACK_HEADER_SIZE + data.size());
+    writer.WriteBuffer<uint8_t>(data);
+    for (const Entry &entry: newEntries)
+    {
+        writer.WriteString(entry.path);
+        writer.Write<size_t>(entry.offset);
+        writer.Write<size_t>(entry.size);
+        writer.Write<uint64_t>(entry.hash);
+    }
+
+    std::vector<uint8_t> packData{};
+    writer.CopyToVector(packData);
+    FILE *file = fopen(packPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        Logger::Error("Unable to open file for writing");
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    fwrite(packData.data(), 1, packData.size(), file);
+    fclose(file);
+
+    Logger::Info("Packed {} files ({} deduplicated) into {} bytes", newEntries.size(), dedupedFiles, packData.size());
+    return Error::ErrorCode::OK;
+}
+
+std::shared_ptr<AssetPack> AssetPack::Mount(const std::string &packPath, Error::ErrorCode &status)
+{
+    const std::lock_guard lock(mountedPacksMutex);
+    const std::string key = NormalizePath(packPath, false);
+    if (mountedPacks.contains(key))
+    {
+        status = Error::ErrorCode::OK;
+        return mountedPacks.at(key);
+    }
+    std::shared_ptr<AssetPack> pack = std::make_shared<AssetPack>();
+    status = pack->Open(packPath);
+    if (status != Error::ErrorCode::OK)
+    {
+        Logger::Error("Failed to mount asset pack \"{}\": {}", packPath, status);
+        return nullptr;
+    }
+    Logger::Verbose("Mounted asset pack \"{}\" with {} entries", packPath, pack->entries.size());
+    mountedPacks[key] = pack;
+    return pack;
+}
+
+bool AssetPack::FindMounted(const std::string &filePath,
+                            std::shared_ptr<AssetPack> &outPack,
+                            std::string &outRelativePath)
+{
+    const std::lock_guard lock(mountedPacksMutex);
+    if (mountedPacks.empty())
+    {
+        return false;
+    }
+    const std::string normalized = NormalizePath(filePath, false);
+    for (const std::pair<const std::string, std::shared_ptr<AssetPack>> &pack: mountedPacks)
+    {
+        if (normalized.size() > pack.first.size() + 1 && normalized.starts_with(pack.first) &&
+            normalized.at(pack.first.size()) == '/')
+        {
+            outPack = pack.second;
+            outRelativePath = normalized.substr(pack.first.size() + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetPack::IsPackPath(const std::string &path)
+{
+    return std::filesystem::path(path).extension() == PACK_EXTENSION;
+}
+
+const AssetPack::Entry *AssetPack::FindEntry(const std::string &relPath) const
+{
+    const std::string path = NormalizePath(relPath, true);
+    const std::vector<Entry>::const_iterator it = std::ranges::lower_bound(entries, path, {}, &Entry::path);
+    if (it == entries.end() || it->path != path)
+    {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool AssetPack::Contains(const std::string &relPath) const
+{
+    return FindEntry(relPath) != nullptr;
+}
+
+const uint8_t *AssetPack::GetEntryData(const Entry &entry) const
+{
+    return mappedData + entry.offset;
+}
+
+std::vector<std::string> AssetPack::ScanFolder(const std::string &assetFolder, const std::string &extension) const
+{
+    std::string prefix = NormalizePath(assetFolder, true);
+    if (!prefix.empty())
+    {
+        prefix += '/';
+    }
+    std::vector<std::string> files{};
+    for (std::vector<Entry>::const_iterator it = std::ranges::lower_bound(entries, prefix, {}, &Entry::path);
+         it != entries.end() && it->path.starts_with(prefix);
+         ++it)
+    {
+        if (std::filesystem::path(it->path).extension() == extension)
+        {
+            files.push_back(it->path.substr(prefix.size()));
+        }
+    }
+    std::ranges::sort(files, [](const std::string &a, const std::string &b) {
+        return std::filesystem::path(a).filename().string() < std::filesystem::path(b).filename().string();
+    });
+    return files;
+}
+
+const std::vector<AssetPack::Entry> &AssetPack::GetEntries() const
+{
+    return entries;
+}
+
+std::string AssetPack::NormalizePath(const std::string &path, const bool relative)
+{
+    std::string normalized{};
+    normalized.reserve(path.size());
+    for (const char c: path)
+    {
+        const char separated = c == '\\' ? '/' : c;
+        if (separated == '/' && !normalized.empty() && normalized.back() == '/')
+        {
+            continue;
+        }
+        normalized += separated;
+    }
+    if (relative && normalized.starts_with('/'))
+    {
+        normalized.erase(0, 1);
+    }
+    if (normalized.size() > 1 && normalized.ends_with('/'))
+    {
+        normalized.pop_back();
+    }
+    return normalized;
+}
@@ -0,0 +1,1099 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <libassets/util/BlockCompressor.h>
+#include <libassets/util/ThreadPool.h>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /// Images with fewer blocks than this are encoded on the calling thread
+    constexpr size_t MIN_BLOCKS_FOR_THREADS = 1024;
+    constexpr uint32_t BLOCK_SIZE = 4;
+    constexpr size_t BLOCK_TEXELS = BLOCK_SIZE * BLOCK_SIZE;
+    constexpr size_t POWER_ITERATIONS = 8;
+    /// Interpolation weights shared by BC7 and BC6H for 4-bit indices, out of 64
+    constexpr std::array<uint32_t, 16> WEIGHTS_4BIT = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    /// The largest finite half float, as bits
+    constexpr uint16_t HALF_MAX_BITS = 0x7BFF;
+    constexpr uint16_t HALF_ONE_BITS = 0x3C00;
+    constexpr uint32_t BC7_MODE_6 = 6;
+    constexpr uint32_t BC6H_MODE_11 = 0x03;
+
+    template<size_t N> using Vec = std::array<float, N>;
+    using Rgba8Block = std::array<std::array<uint8_t, 4>, BLOCK_TEXELS>;
+    /// Half floats as their raw bits
+    using RgbaF16Block = std::array<std::array<uint16_t, 4>, BLOCK_TEXELS>;
+    using ChannelBlock = std::array<uint8_t, BLOCK_TEXELS>;
+
+    /// Reads and writes blocks one field at a time, least significant bit first
+    struct BitStream
+    {
+            std::array<uint8_t, 16> bytes{};
+            size_t offset = 0;
+
+            void Write(const uint32_t value, const size_t bitCount)
+            {
+                for (size_t bit = 0; bit < bitCount; bit++)
+                {
+                    if (((value >> bit) & 1u) != 0)
+                    {
+                        bytes.at(offset / 8) |= static_cast<uint8_t>(1u << (offset % 8));
+                    }
+                    offset++;
+                }
+            }
+
+            uint32_t Read(const size_t bitCount)
+            {
+                uint32_t value = 0;
+                for (size_t bit = 0; bit < bitCount; bit++)
+                {
+                    value |= static_cast<uint32_t>((bytes.at(offset / 8) >> (offset % 8)) & 1u) << bit;
+                    offset++;
+                }
+                return value;
+            }
+    };
+
+    template<size_t N> float DistanceSquared(const Vec<N> &a, const Vec<N> &b)
+    {
+        float distance = 0;
+        for (size_t channel = 0; channel < N; channel++)
+        {
+            const float delta = a[channel] - b[channel];
+            distance += delta * delta;
+        }
+        return distance;
+    }
+
+    size_t GetRefineIterations(const BlockCompressor::Quality quality)
+    {
+        switch (quality)
+        {
+            case BlockCompressor::Quality::FAST:
+                return 0;
+            case BlockCompressor::Quality::NORMAL:
+                return 1;
+            case BlockCompressor::Quality::BEST:
+            default:
+                return 4;
+        }
+    }
+
+    /**
+     * Pick a starting line through the texels.
+     * The fast path uses the bounding box diagonal. Otherwise the line follows the principal axis of the texels, which
+     * handles channels that are anti-correlated.
+     */
+    template<size_t N> void FitEndpoints(const Vec<N> *texels,
+                                         const size_t count,
+                                         const bool principalAxis,
+                                         Vec<N> &outA,
+                                         Vec<N> &outB)
+    {
+        Vec<N> minimum = texels[0];
+        Vec<N> maximum = texels[0];
+        Vec<N> mean{};
+        for (size_t i = 0; i < count; i++)
+        {
+            for (size_t channel = 0; channel < N; channel++)
+            {
+                minimum[channel] = std::min(minimum[channel], texels[i][channel]);
+                maximum[channel] = std::max(maximum[channel], texels[i][channel]);
+                mean[channel] += texels[i][channel] / static_cast<float>(count);
+            }
+        }
+        if (!principalAxis)
+        {
+            outA = minimum;
+            outB = maximum;
+            return;
+        }
+
+        std::array<float, N * N> covariance{};
+        for (size_t i = 0; i < count; i++)
+        {
+            for (size_t row = 0; row < N; row++)
+            {
+                for (size_t column = 0; column < N; column++)
+                {
+                    covariance[(row * N) + column] += (texels[i][row] - mean[row]) *
+                                                      (texels[i][column] - mean[column]);
+                }
+            }
+        }
+
+        Vec<N> axis{};
+        for (size_t channel = 0; channel < N; channel++)
+        {
+            axis[channel] = maximum[channel] - minimum[channel];
+        }
+        for (size_t iteration = 0; iteration < POWER_ITERATIONS; iteration++)
+        {
+            Vec<N> next{};
+            float largest = 0;
+            for (size_t row = 0; row < N; row++)
+            {
+                for (size_t column = 0; column < N; column++)
+                {
+                    next[row] += covariance[(row * N) + column] * axis[column];
+                }
+                largest = std::max(largest, std::abs(next[row]));
+            }
+            if (largest <= 0.0f)
+            {
+                break;
+            }
+            for (size_t channel = 0; channel < N; channel++)
+            {
+                axis[channel] = next[channel] / largest;
+            }
+        }
+
+        float length = 0;
+        for (const float value: axis)
+        {
+            length += value * value;
+        }
+        length = std::sqrt(length);
+        if (length <= 0.0f)
+        {
+            outA = mean;
+            outB = mean;
+            return;
+        }
+
+        float minimumProjection = std::numeric_limits<float>::max();
+        float maximumProjection = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < count; i++)
+        {
+            float projection = 0;
+            for (size_t channel = 0; channel < N; channel++)
+            {
+                projection += (texels[i][channel] - mean[channel]) * axis[channel] / length;
+            }
+            minimumProjection = std::min(minimumProjection, projection);
+            maximumProjection = std::max(maximumProjection, projection);
+        }
+        for (size_t channel = 0; channel < N; channel++)
+        {
+            outA[channel] = mean[channel] + (axis[channel] / length * minimumProjection);
+            outB[channel] = mean[channel] + (axis[channel] / length * maximumProjection);
+        }
+    }
+
+    /**
+     * Find the endpoints that minimize the squared error for a fixed set of interpolation weights
+     * @return False if the weights don't determine a unique pair of endpoints
+     */
+    template<size_t N> bool SolveEndpoints(const Vec<N> *texels,
+                                           const float *weights,
+                                           const size_t count,
+                                           Vec<N> &outA,
+                                           Vec<N> &outB)
+    {
+        float aa = 0;
+        float ab = 0;
+        float bb = 0;
+        Vec<N> ax{};
+        Vec<N> bx{};
+        for (size_t i = 0; i < count; i++)
+        {
+            const float t = weights[i];
+            const float s = 1.0f - t;
+            aa += s * s;
+            ab += s * t;
+            bb += t * t;
+            for (size_t channel = 0; channel < N; channel++)
+            {
+                ax[channel] += s * texels[i][channel];
+                bx[channel] += t * texels[i][channel];
+            }
+        }
+        const float determinant = (aa * bb) - (ab * ab);
+        if (std::abs(determinant) < 1e-6f)
+        {
+            return false;
+        }
+        for (size_t channel = 0; channel < N; channel++)
+        {
+            outA[channel] = ((bb * ax[channel]) - (ab * bx[channel])) / determinant;
+            outB[channel] = ((aa * bx[channel]) - (ab * ax[channel])) / determinant;
+        }
+        return true;
+    }
+
+    template<typename Mode> struct SubsetFit
+    {
+            typename Mode::Endpoints endpoints{};
+            std::array<uint8_t, BLOCK_TEXELS> indices{};
+            float error = std::numeric_limits<float>::max();
+    };
+
+    /**
+     * Fit a pair of endpoints and an index per texel, starting from the given line.
+     * Each refinement pass solves for new endpoints from the previous indices. The best quantized result is kept, as
+     * quantization can make a pass worse.
+     */
+    template<typename Mode> void RefineSubset(const Vec<Mode::CHANNELS> *texels,
+                                              const size_t count,
+                                              const size_t refineIterations,
+                                              const Mode &mode,
+                                              Vec<Mode::CHANNELS> a,
+                                              Vec<Mode::CHANNELS> b,
+                                              SubsetFit<Mode> &best)
+    {
+        for (size_t iteration = 0;; iteration++)
+        {
+            SubsetFit<Mode> fit{
+                .endpoints = mode.Quantize(a, b),
+                .error = 0,
+            };
+            const std::array<Vec<Mode::CHANNELS>, Mode::MAX_PALETTE_SIZE> palette = mode.BuildPalette(fit.endpoints);
+            std::array<float, BLOCK_TEXELS> weights{};
+            for (size_t i = 0; i < count; i++)
+            {
+                float bestDistance = std::numeric_limits<float>::max();
+                for (size_t entry = 0; entry < mode.GetPaletteSize(); entry++)
+                {
+                    const float distance = DistanceSquared(texels[i], palette.at(entry));
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        fit.indices.at(i) = static_cast<uint8_t>(entry);
+                    }
+                }
+                fit.error += bestDistance;
+                weights.at(i) = mode.GetWeight(fit.indices.at(i));
+            }
+            if (fit.error < best.error)
+            {
+                best = fit;
+            }
+            if (iteration == refineIterations ||
+                best.error == 0.0f ||
+                !SolveEndpoints<Mode::CHANNELS>(texels, weights.data(), count, a, b))
+            {
+                break;
+            }
+        }
+    }
+
+    /// Fit one line through all the texels of a block
+    template<typename Mode> SubsetFit<Mode> FitSubset(const Vec<Mode::CHANNELS> *texels,
+                                                      const size_t count,
+                                                      const BlockCompressor::Quality quality,
+                                                      const Mode &mode)
+    {
+        const size_t refineIterations = GetRefineIterations(quality);
+        SubsetFit<Mode> best{};
+        Vec<Mode::CHANNELS> a{};
+        Vec<Mode::CHANNELS> b{};
+        FitEndpoints<Mode::CHANNELS>(texels, count, quality != BlockCompressor::Quality::FAST, a, b);
+        RefineSubset(texels, count, refineIterations, mode, a, b, best);
+        if (quality == BlockCompressor::Quality::BEST && best.error != 0.0f)
+        {
+            // The principal axis isn't always the better start, smooth gradients often quantize better along the
+            // bounding box diagonal
+            FitEndpoints<Mode::CHANNELS>(texels, count, false, a, b);
+            RefineSubset(texels, count, refineIterations, mode, a, b, best);
+        }
+        return best;
+    }
+
+    std::array<int, 3> Expand565(const uint16_t color)
+    {
+        const int red = (color >> 11) & 0x1F;
+        const int green = (color >> 5) & 0x3F;
+        const int blue = color & 0x1F;
+        return {(red << 3) | (red >> 2), (green << 2) | (green >> 4), (blue << 3) | (blue >> 2)};
+    }
+
+    uint16_t Pack565(const Vec<3> &color)
+    {
+        const auto quantize = [](const float value, const float maximum) {
+            return static_cast<uint16_t>(std::lround(std::clamp(value / 255.0f, 0.0f, 1.0f) * maximum));
+        };
+        return static_cast<uint16_t>((quantize(color[0], 31) << 11) |
+                                     (quantize(color[1], 63) << 5) |
+                                     quantize(color[2], 31));
+    }
+
+    /// The 4 color (opaque) and 3 color (1-bit alpha) modes of a BC1 color block
+    struct Bc1Mode
+    {
+            static constexpr size_t CHANNELS = 3;
+            static constexpr size_t MAX_PALETTE_SIZE = 4;
+            using Endpoints = std::array<uint16_t, 2>;
+
+            bool threeColor = false;
+
+            [[nodiscard]] Endpoints Quantize(const Vec<3> &a, const Vec<3> &b) const
+            {
+                return {Pack565(a), Pack565(b)};
+            }
+
+            [[nodiscard]] std::array<Vec<3>, MAX_PALETTE_SIZE> BuildPalette(const Endpoints &endpoints) const
+            {
+                const std::array<int, 3> color0 = Expand565(endpoints[0]);
+                const std::array<int, 3> color1 = Expand565(endpoints[1]);
+                std::array<Vec<3>, MAX_PALETTE_SIZE> palette{};
+                for (size_t channel = 0; channel < CHANNELS; channel++)
+                {
+                    palette[0][channel] = static_cast<float>(color0[channel]);
+                    palette[1][channel] = static_cast<float>(color1[channel]);
+                    if (threeColor)
+                    {
+                        palette[2][channel] = static_cast<float>((color0[channel] + color1[channel]) / 2);
+                    } else
+                    {
+                        palette[2][channel] = static_cast<float>(((2 * color0[channel]) + color1[channel]) / 3);
+                        palette[3][channel] = static_cast<float>((color0[channel] + (2 * color1[channel])) / 3);
+                    }
+                }
+                return palette;
+            }
+
+            [[nodiscard]] size_t GetPaletteSize() const
+            {
+                return threeColor ? 3 : 4;
+            }
+
+            [[nodiscard]] float GetWeight(const uint8_t index) const
+            {
+                static constexpr std::array<float, 4> FOUR_COLOR_WEIGHTS = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+                static constexpr std::array<float, 3> THREE_COLOR_WEIGHTS = {0.0f, 1.0f, 0.5f};
+                return threeColor ? THREE_COLOR_WEIGHTS.at(index) : FOUR_COLOR_WEIGHTS.at(index);
+            }
+    };
+
+    /// BC7 mode 6: one subset, RGBA endpoints with 7 bits per channel plus a shared bit each, 4-bit indices
+    struct Bc7Mode6
+    {
+            static constexpr size_t CHANNELS = 4;
+            static constexpr size_t MAX_PALETTE_SIZE = 16;
+
+            struct Endpoints
+            {
+                    std::array<std::array<uint8_t, 4>, 2> values;
+                    std::array<uint8_t, 2> pBits;
+            };
+
+            [[nodiscard]] static Endpoints Quantize(const Vec<4> &a, const Vec<4> &b)
+            {
+                Endpoints endpoints{};
+                const std::array<const Vec<4> *, 2> targets = {&a, &b};
+                for (size_t endpoint = 0; endpoint < 2; endpoint++)
+                {
+                    float bestError = std::numeric_limits<float>::max();
+                    for (uint8_t pBit = 0; pBit < 2; pBit++)
+                    {
+                        std::array<uint8_t, 4> values{};
+                        float error = 0;
+                        for (size_t channel = 0; channel < CHANNELS; channel++)
+                        {
+                            const float target = std::clamp((*targets.at(endpoint))[channel], 0.0f, 255.0f);
+                            values.at(channel) = static_cast<uint8_t>(
+                                    std::clamp<long>(std::lround((target - pBit) / 2.0f), 0, 127));
+                            const float delta = static_cast<float>((values.at(channel) << 1) | pBit) - target;
+                            error += delta * delta;
+                        }
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            endpoints.values.at(endpoint) = values;
+                            endpoints.pBits.at(endpoint) = pBit;
+                        }
+                    }
+                }
+                return endpoints;
+            }
+
+            [[nodiscard]] static std::array<Vec<4>, MAX_PALETTE_SIZE> BuildPalette(const Endpoints &endpoints)
+            {
+                std::array<Vec<4>, MAX_PALETTE_SIZE> palette{};
+                for (size_t channel = 0; channel < CHANNELS; channel++)
+                {
+                    const uint32_t value0 = static_cast<uint32_t>(endpoints.values[0][channel] << 1) |
+                                            endpoints.pBits[0];
+                    const uint32_t value1 = static_cast<uint32_t>(endpoints.values[1][channel] << 1) |
+                                            endpoints.pBits[1];
+                    for (size_t index = 0; index < MAX_PALETTE_SIZE; index++)
+                    {
+                        const uint32_t weight = WEIGHTS_4BIT.at(index);
+                        palette.at(index)[channel] = static_cast<float>((((64 - weight) * value0) +
+                                                                         (weight * value1) +
+                                                                         32) >>
+                                                                        6);
+                    }
+                }
+                return palette;
+            }
+
+            [[nodiscard]] static size_t GetPaletteSize()
+            {
+                return MAX_PALETTE_SIZE;
+            }
+
+            [[nodiscard]] static float GetWeight(const uint8_t index)
+            {
+                return static_cast<float>(WEIGHTS_4BIT.at(index)) / 64.0f;
+            }
+    };
+
+    /**
+     * BC6H mode 11: one region, unsigned RGB endpoints with 10 bits per channel, 4-bit indices.
+     * BC6H interpolates the bits of the half floats rather than their values, so texels are fitted in that space,
+     * scaled to match the 16-bit range endpoints are unquantized to.
+     */
+    struct Bc6hMode11
+    {
+            static constexpr size_t CHANNELS = 3;
+            static constexpr size_t MAX_PALETTE_SIZE = 16;
+            using Endpoints = std::array<std::array<uint16_t, 3>, 2>;
+
+            static uint32_t Unquantize(const uint16_t value)
+            {
+                if (value == 0)
+                {
+                    return 0;
+                }
+                if (value == 1023)
+                {
+                    return 0xFFFF;
+                }
+                return ((static_cast<uint32_t>(value) << 16) + 0x8000) >> 10;
+            }
+
+            /// Turn interpolated endpoints into the bits of a half float
+            static uint16_t FinishUnquantize(const uint32_t value)
+            {
+                return static_cast<uint16_t>((value * 31) >> 6);
+            }
+
+            static float ToFitSpace(const uint16_t halfBits)
+            {
+                return static_cast<float>(halfBits) * 64.0f / 31.0f;
+            }
+
+            [[nodiscard]] static Endpoints Quantize(const Vec<3> &a, const Vec<3> &b)
+            {
+                Endpoints endpoints{};
+                for (size_t channel = 0; channel < CHANNELS; channel++)
+                {
+                    endpoints[0][channel] = static_cast<uint16_t>(
+                            std::clamp<long>(std::lround((a[channel] - 32.0f) / 64.0f), 0, 1023));
+                    endpoints[1][channel] = static_cast<uint16_t>(
+                            std::clamp<long>(std::lround((b[channel] - 32.0f) / 64.0f), 0, 1023));
+                }
+                return endpoints;
+            }
+
+            [[nodiscard]] static std::array<Vec<3>, MAX_PALETTE_SIZE> BuildPalette(const Endpoints &endpoints)
+            {
+                std::array<Vec<3>, MAX_PALETTE_SIZE> palette{};
+                for (size_t channel = 0; channel < CHANNELS; channel++)
+                {
+                    const uint32_t value0 = Unquantize(endpoints[0][channel]);
+                    const uint32_t value1 = Unquantize(endpoints[1][channel]);
+                    for (size_t index = 0; index < MAX_PALETTE_SIZE; index++)
+                    {
+                        const uint32_t weight = WEIGHTS_4BIT.at(index);
+                        const uint32_t value = (((64 - weight) * value0) + (weight * value1) + 32) >> 6;
+                        palette.at(index)[channel] = ToFitSpace(FinishUnquantize(value));
+                    }
+                }
+                return palette;
+            }
+
+            [[nodiscard]] static size_t GetPaletteSize()
+            {
+                return MAX_PALETTE_SIZE;
+            }
+
+            [[nodiscard]] static float GetWeight(const uint8_t index)
+            {
+                return static_cast<float>(WEIGHTS_4BIT.at(index)) / 64.0f;
+            }
+    };
+
+    /// Make sure the first texel's index fits in the 3 bits BC7 and BC6H store it in
+    template<typename Endpoints> void FixAnchorIndex(Endpoints &endpoints, std::array<uint8_t, BLOCK_TEXELS> &indices)
+    {
+        if (indices[0] < 8)
+        {
+            return;
+        }
+        std::swap(endpoints[0], endpoints[1]);
+        for (uint8_t &index: indices)
+        {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    template<typename T> std::array<std::array<T, 4>, BLOCK_TEXELS> LoadBlock(const uint8_t *pixels,
+                                                                             const uint32_t width,
+                                                                             const uint32_t height,
+                                                                             const uint32_t blockX,
+                                                                             const uint32_t blockY)
+    {
+        std::array<std::array<T, 4>, BLOCK_TEXELS> block{};
+        for (uint32_t y = 0; y < BLOCK_SIZE; y++)
+        {
+            const uint32_t sourceY = std::min((blockY * BLOCK_SIZE) + y, height - 1);
+            for (uint32_t x = 0; x < BLOCK_SIZE; x++)
+            {
+                const uint32_t sourceX = std::min((blockX * BLOCK_SIZE) + x, width - 1);
+                std::memcpy(block.at((y * BLOCK_SIZE) + x).data(),
+                            pixels + ((static_cast<size_t>(sourceY) * width + sourceX) * sizeof(T) * 4),
+                            sizeof(T) * 4);
+            }
+        }
+        return block;
+    }
+
+    template<typename T> void StoreBlock(const std::array<std::array<T, 4>, BLOCK_TEXELS> &block,
+                                         uint8_t *pixels,
+                                         const uint32_t width,
+                                         const uint32_t height,
+                                         const uint32_t blockX,
+                                         const uint32_t blockY)
+    {
+        for (uint32_t y = 0; y < BLOCK_SIZE && (blockY * BLOCK_SIZE) + y < height; y++)
+        {
+            for (uint32_t x = 0; x < BLOCK_SIZE && (blockX * BLOCK_SIZE) + x < width; x++)
+            {
+                const size_t texel = (static_cast<size_t>((blockY * BLOCK_SIZE) + y) * width) +
+                                     (blockX * BLOCK_SIZE) +
+                                     x;
+                std::memcpy(pixels + (texel * sizeof(T) * 4), block.at((y * BLOCK_SIZE) + x).data(), sizeof(T) * 4);
+            }
+        }
+    }
+
+    ChannelBlock GetChannel(const Rgba8Block &block, const size_t channel)
+    {
+        ChannelBlock values{};
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            values.at(i) = block.at(i).at(channel);
+        }
+        return values;
+    }
+
+    void EncodeBc1Block(const Rgba8Block &block,
+                        const bool allowTransparency,
+                        const BlockCompressor::Quality quality,
+                        uint8_t *out)
+    {
+        std::array<Vec<3>, BLOCK_TEXELS> colors{};
+        std::array<bool, BLOCK_TEXELS> transparent{};
+        size_t colorCount = 0;
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            transparent.at(i) = allowTransparency && block.at(i)[3] < 128;
+            if (!transparent.at(i))
+            {
+                colors.at(colorCount++) = {
+                    static_cast<float>(block.at(i)[0]),
+                    static_cast<float>(block.at(i)[1]),
+                    static_cast<float>(block.at(i)[2]),
+                };
+            }
+        }
+
+        BitStream stream{};
+        if (colorCount == 0)
+        {
+            // Equal endpoints select the 3 color mode, where index 3 is transparent
+            stream.Write(0, 16);
+            stream.Write(0, 16);
+            stream.Write(0xFFFFFFFF, 32);
+            std::memcpy(out, stream.bytes.data(), 8);
+            return;
+        }
+
+        const Bc1Mode mode{.threeColor = colorCount != BLOCK_TEXELS};
+        SubsetFit<Bc1Mode> fit = FitSubset(colors.data(), colorCount, quality, mode);
+        if (fit.endpoints[0] == fit.endpoints[1])
+        {
+            // Every palette entry is the same color, and equal endpoints mean 3 color mode to the decoder
+            fit.indices.fill(0);
+        } else if ((fit.endpoints[0] < fit.endpoints[1]) != mode.threeColor)
+        {
+            // The endpoint order is what tells the decoder which mode the block is in
+            std::swap(fit.endpoints[0], fit.endpoints[1]);
+            for (uint8_t &index: fit.indices)
+            {
+                index = mode.threeColor && index == 2 ? 2 : index ^ 1u;
+            }
+        }
+
+        stream.Write(fit.endpoints[0], 16);
+        stream.Write(fit.endpoints[1], 16);
+        size_t colorIndex = 0;
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            stream.Write(transparent.at(i) ? 3 : fit.indices.at(colorIndex++), 2);
+        }
+        std::memcpy(out, stream.bytes.data(), 8);
+    }
+
+    std::array<int, 8> BuildBc4Palette(const int value0, const int value1)
+    {
+        std::array<int, 8> palette{value0, value1};
+        if (value0 > value1)
+        {
+            for (int i = 2; i < 8; i++)
+            {
+                palette.at(static_cast<size_t>(i)) = (((8 - i) * value0) + ((i - 1) * value1)) / 7;
+            }
+        } else
+        {
+            for (int i = 2; i < 6; i++)
+            {
+                palette.at(static_cast<size_t>(i)) = (((6 - i) * value0) + ((i - 1) * value1)) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+        return palette;
+    }
+
+    int FindBc4Indices(const ChannelBlock &values,
+                       const int value0,
+                       const int value1,
+                       std::array<uint8_t, BLOCK_TEXELS> &outIndices)
+    {
+        const std::array<int, 8> palette = BuildBc4Palette(value0, value1);
+        int error = 0;
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            int bestDistance = std::numeric_limits<int>::max();
+            for (size_t entry = 0; entry < palette.size(); entry++)
+            {
+                const int distance = std::abs(palette.at(entry) - values.at(i));
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    outIndices.at(i) = static_cast<uint8_t>(entry);
+                }
+            }
+            error += bestDistance * bestDistance;
+        }
+        return error;
+    }
+
+    void EncodeBc4Block(const ChannelBlock &values, const BlockCompressor::Quality quality, uint8_t *out)
+    {
+        const auto [minimum, maximum] = std::ranges::minmax(values);
+        // The 8 value mode spans the whole range of the block
+        int value0 = maximum;
+        int value1 = minimum;
+        std::array<uint8_t, BLOCK_TEXELS> indices{};
+        const int error = FindBc4Indices(values, value0, value1, indices);
+
+        if (quality == BlockCompressor::Quality::BEST && error != 0)
+        {
+            // The 6 value mode has exact 0 and 255 entries, so only the values between them need to be spanned
+            int innerMinimum = 255;
+            int innerMaximum = 0;
+            for (const uint8_t value: values)
+            {
+                if (value != 0 && value != 255)
+                {
+                    innerMinimum = std::min<int>(innerMinimum, value);
+                    innerMaximum = std::max<int>(innerMaximum, value);
+                }
+            }
+            if (innerMinimum <= innerMaximum)
+            {
+                std::array<uint8_t, BLOCK_TEXELS> innerIndices{};
+                if (FindBc4Indices(values, innerMinimum, innerMaximum, innerIndices) < error)
+                {
+                    value0 = innerMinimum;
+                    value1 = innerMaximum;
+                    indices = innerIndices;
+                }
+            }
+        }
+
+        BitStream stream{};
+        stream.Write(static_cast<uint32_t>(value0), 8);
+        stream.Write(static_cast<uint32_t>(value1), 8);
+        for (const uint8_t index: indices)
+        {
+            stream.Write(index, 3);
+        }
+        std::memcpy(out, stream.bytes.data(), 8);
+    }
+
+    void EncodeBc7Block(const Rgba8Block &block, const BlockCompressor::Quality quality, uint8_t *out)
+    {
+        std::array<Vec<4>, BLOCK_TEXELS> texels{};
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            for (size_t channel = 0; channel < Bc7Mode6::CHANNELS; channel++)
+            {
+                texels.at(i)[channel] = static_cast<float>(block.at(i).at(channel));
+            }
+        }
+        SubsetFit<Bc7Mode6> fit = FitSubset(texels.data(), BLOCK_TEXELS, quality, Bc7Mode6{});
+        if (fit.indices[0] >= 8)
+        {
+            std::swap(fit.endpoints.pBits[0], fit.endpoints.pBits[1]);
+        }
+        FixAnchorIndex(fit.endpoints.values, fit.indices);
+
+        BitStream stream{};
+        stream.Write(1u << BC7_MODE_6, BC7_MODE_6 + 1);
+        for (size_t channel = 0; channel < Bc7Mode6::CHANNELS; channel++)
+        {
+            stream.Write(fit.endpoints.values[0][channel], 7);
+            stream.Write(fit.endpoints.values[1][channel], 7);
+        }
+        stream.Write(fit.endpoints.pBits[0], 1);
+        stream.Write(fit.endpoints.pBits[1], 1);
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            stream.Write(fit.indices.at(i), i == 0 ? 3 : 4);
+        }
+        std::memcpy(out, stream.bytes.data(), stream.bytes.size());
+    }
+
+    /// Clamp a half float to the range BC6H can store without a sign
+    uint16_t ClampUnsignedHalf(const uint16_t bits)
+    {
+        if ((bits & 0x8000u) != 0)
+        {
+            return 0;
+        }
+        return std::min(bits, HALF_MAX_BITS);
+    }
+
+    void EncodeBc6hBlock(const RgbaF16Block &block, const BlockCompressor::Quality quality, uint8_t *out)
+    {
+        std::array<Vec<3>, BLOCK_TEXELS> texels{};
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            for (size_t channel = 0; channel < Bc6hMode11::CHANNELS; channel++)
+            {
+                texels.at(i)[channel] = Bc6hMode11::ToFitSpace(ClampUnsignedHalf(block.at(i).at(channel)));
+            }
+        }
+        SubsetFit<Bc6hMode11> fit = FitSubset(texels.data(), BLOCK_TEXELS, quality, Bc6hMode11{});
+        FixAnchorIndex(fit.endpoints, fit.indices);
+
+        BitStream stream{};
+        stream.Write(BC6H_MODE_11, 5);
+        for (const std::array<uint16_t, 3> &endpoint: fit.endpoints)
+        {
+            for (const uint16_t value: endpoint)
+            {
+                stream.Write(value, 10);
+            }
+        }
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            stream.Write(fit.indices.at(i), i == 0 ? 3 : 4);
+        }
+        std::memcpy(out, stream.bytes.data(), stream.bytes.size());
+    }
+
+    void DecodeBc1Block(const uint8_t *in, const bool forceFourColor, Rgba8Block &outBlock)
+    {
+        BitStream stream{};
+        std::memcpy(stream.bytes.data(), in, 8);
+        const uint16_t endpoint0 = static_cast<uint16_t>(stream.Read(16));
+        const uint16_t endpoint1 = static_cast<uint16_t>(stream.Read(16));
+        const Bc1Mode mode{.threeColor = !forceFourColor && endpoint0 <= endpoint1};
+        const std::array<Vec<3>, Bc1Mode::MAX_PALETTE_SIZE> palette = mode.BuildPalette({endpoint0, endpoint1});
+        for (std::array<uint8_t, 4> &texel: outBlock)
+        {
+            const uint32_t index = stream.Read(2);
+            if (mode.threeColor && index == 3)
+            {
+                texel = {0, 0, 0, 0};
+                continue;
+            }
+            texel = {
+                static_cast<uint8_t>(palette.at(index)[0]),
+                static_cast<uint8_t>(palette.at(index)[1]),
+                static_cast<uint8_t>(palette.at(index)[2]),
+                255,
+            };
+        }
+    }
+
+    void DecodeBc4Block(const uint8_t *in, ChannelBlock &outValues)
+    {
+        BitStream stream{};
+        std::memcpy(stream.bytes.data(), in, 8);
+        const int value0 = static_cast<int>(stream.Read(8));
+        const int value1 = static_cast<int>(stream.Read(8));
+        const std::array<int, 8> palette = BuildBc4Palette(value0, value1);
+        for (uint8_t &value: outValues)
+        {
+            value = static_cast<uint8_t>(palette.at(stream.Read(3)));
+        }
+    }
+
+    bool DecodeBc7Block(const uint8_t *in, Rgba8Block &outBlock)
+    {
+        BitStream stream{};
+        std::memcpy(stream.bytes.data(), in, stream.bytes.size());
+        if (stream.Read(BC7_MODE_6 + 1) != 1u << BC7_MODE_6)
+        {
+            outBlock.fill({0, 0, 0, 0});
+            return false;
+        }
+        Bc7Mode6::Endpoints endpoints{};
+        for (size_t channel = 0; channel < Bc7Mode6::CHANNELS; channel++)
+        {
+            endpoints.values[0][channel] = static_cast<uint8_t>(stream.Read(7));
+            endpoints.values[1][channel] = static_cast<uint8_t>(stream.Read(7));
+        }
+        endpoints.pBits[0] = static_cast<uint8_t>(stream.Read(1));
+        endpoints.pBits[1] = static_cast<uint8_t>(stream.Read(1));
+        const std::array<Vec<4>, Bc7Mode6::MAX_PALETTE_SIZE> palette = Bc7Mode6::BuildPalette(endpoints);
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            const Vec<4> &color = palette.at(stream.Read(i == 0 ? 3 : 4));
+            outBlock.at(i) = {
+                static_cast<uint8_t>(color[0]),
+                static_cast<uint8_t>(color[1]),
+                static_cast<uint8_t>(color[2]),
+                static_cast<uint8_t>(color[3]),
+            };
+        }
+        return true;
+    }
+
+    bool DecodeBc6hBlock(const uint8_t *in, RgbaF16Block &outBlock)
+    {
+        BitStream stream{};
+        std::memcpy(stream.bytes.data(), in, stream.bytes.size());
+        if (stream.Read(5) != BC6H_MODE_11)
+        {
+            outBlock.fill({0, 0, 0, HALF_ONE_BITS});
+            return false;
+        }
+        Bc6hMode11::Endpoints endpoints{};
+        for (std::array<uint16_t, 3> &endpoint: endpoints)
+        {
+            for (uint16_t &value: endpoint)
+            {
+                value = static_cast<uint16_t>(stream.Read(10));
+            }
+        }
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        {
+            const uint32_t weight = WEIGHTS_4BIT.at(stream.Read(i == 0 ? 3 : 4));
+            for (size_t channel = 0; channel < Bc6hMode11::CHANNELS; channel++)
+            {
+                const uint32_t value = (((64 - weight) * Bc6hMode11::Unquantize(endpoints[0][channel])) +
+                                        (weight * Bc6hMode11::Unquantize(endpoints[1][channel])) +
+                                        32) >>
+                                       6;
+                outBlock.at(i).at(channel) = Bc6hMode11::FinishUnquantize(value);
+            }
+            outBlock.at(i)[3] = HALF_ONE_BITS;
+        }
+        return true;
+    }
+
+    void EncodeBlock(const uint8_t *pixels,
+                     const uint32_t width,
+                     const uint32_t height,
+                     const uint32_t blockX,
+                     const uint32_t blockY,
+                     const BlockCompressor::Format format,
+                     const BlockCompressor::Quality quality,
+                     uint8_t *out)
+    {
+        if (format == BlockCompressor::Format::BC6H)
+        {
+            EncodeBc6hBlock(LoadBlock<uint16_t>(pixels, width, height, blockX, blockY), quality, out);
+            return;
+        }
+        const Rgba8Block block = LoadBlock<uint8_t>(pixels, width, height, blockX, blockY);
+        switch (format)
+        {
+            case BlockCompressor::Format::BC1:
+                EncodeBc1Block(block, true, quality, out);
+                break;
+            case BlockCompressor::Format::BC3:
+                EncodeBc4Block(GetChannel(block, 3), quality, out);
+                EncodeBc1Block(block, false, quality, out + 8);
+                break;
+            case BlockCompressor::Format::BC4:
+                EncodeBc4Block(GetChannel(block, 0), quality, out);
+                break;
+            case BlockCompressor::Format::BC5:
+                EncodeBc4Block(GetChannel(block, 0), quality, out);
+                EncodeBc4Block(GetChannel(block, 1), quality, out + 8);
+                break;
+            case BlockCompressor::Format::BC7:
+            default:
+                EncodeBc7Block(block, quality, out);
+                break;
+        }
+    }
+
+    bool DecodeBlock(const uint8_t *in,
+                     const uint32_t width,
+                     const uint32_t height,
+                     const uint32_t blockX,
+                     const uint32_t blockY,
+                     const BlockCompressor::Format format,
+                     uint8_t *pixels)
+    {
+        if (format == BlockCompressor::Format::BC6H)
+        {
+            RgbaF16Block block{};
+            const bool supported = DecodeBc6hBlock(in, block);
+            StoreBlock(block, pixels, width, height, blockX, blockY);
+            return supported;
+        }
+
+        Rgba8Block block{};
+        bool supported = true;
+        ChannelBlock channel0{};
+        ChannelBlock channel1{};
+        switch (format)
+        {
+            case BlockCompressor::Format::BC1:
+                DecodeBc1Block(in, false, block);
+                break;
+            case BlockCompressor::Format::BC3:
+                DecodeBc1Block(in + 8, true, block);
+                DecodeBc4Block(in, channel0);
+                for (size_t i = 0; i < BLOCK_TEXELS; i++)
+                {
+                    block.at(i)[3] = channel0.at(i);
+                }
+                break;
+            case BlockCompressor::Format::BC4:
+                DecodeBc4Block(in, channel0);
+                for (size_t i = 0; i < BLOCK_TEXELS; i++)
+                {
+                    block.at(i) = {channel0.at(i), channel0.at(i), channel0.at(i), 255};
+                }
+                break;
+            case BlockCompressor::Format::BC5:
+                DecodeBc4Block(in, channel0);
+                DecodeBc4Block(in + 8, channel1);
+                for (size_t i = 0; i < BLOCK_TEXELS; i++)
+                {
+                    block.at(i) = {channel0.at(i), channel1.at(i), 0, 255};
+                }
+                break;
+            case BlockCompressor::Format::BC7:
+            default:
+                supported = DecodeBc7Block(in, block);
+                break;
+        }
+        StoreBlock(block, pixels, width, height, blockX, blockY);
+        return supported;
+    }
+} // namespace
+
+size_t BlockCompressor::GetBlockSize(const Format format)
+{
+    return format == Format::BC1 || format == Format::BC4 ? 8 : 16;
+}
+
+size_t BlockCompressor::GetImageSize(const Format format, const uint32_t width, const uint32_t height)
+{
+    const size_t blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const size_t blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    return blocksX * blocksY * GetBlockSize(format);
+}
+
+bool BlockCompressor::IsHdr(const Format format)
+{
+    return format == Format::BC6H;
+}
+
+void BlockCompressor::Encode(const uint8_t *pixels,
+                             const uint32_t width,
+                             const uint32_t height,
+                             const Format format,
+                             const Quality quality,
+                             std::vector<uint8_t> &outBlocks)
+{
+    const uint32_t blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint32_t blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const size_t blockSize = GetBlockSize(format);
+    const size_t offset = outBlocks.size();
+    outBlocks.resize(offset + GetImageSize(format, width, height));
+    uint8_t *blocks = outBlocks.data() + offset;
+
+    const auto encodeRows = [=](const uint32_t firstRow, const uint32_t endRow) {
+        for (uint32_t blockY = firstRow; blockY < endRow; blockY++)
+        {
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                EncodeBlock(pixels,
+                            width,
+                            height,
+                            blockX,
+                            blockY,
+                            format,
+                            quality,
+                            blocks + ((static_cast<size_t>(blockY) * blocksX + blockX) * blockSize));
+            }
+        }
+    };
+
+    if (static_cast<size_t>(blocksX) * blocksY < MIN_BLOCKS_FOR_THREADS)
+    {
+        encodeRows(0, blocksY);
+        return;
+    }
+    ThreadPool &pool = ThreadPool::GetShared();
+    // The calling thread encodes rows as well
+    const uint32_t rowsPerTask = std::max<uint32_t>(1,
+                                                    blocksY /
+                                                            static_cast<uint32_t>((pool.GetThreadCount() + 1) * 4));
+    const size_t taskCount = (blocksY + rowsPerTask - 1) / rowsPerTask;
+    pool.Run(taskCount, [&encodeRows, rowsPerTask, blocksY](const size_t task) {
+        const uint32_t firstRow = static_cast<uint32_t>(task) * rowsPerTask;
+        encodeRows(firstRow, std::min(firstRow + rowsPerTask, blocksY));
+    });
+}
+
+bool BlockCompressor::Decode(const uint8_t *blocks,
+                             const uint32_t width,
+                             const uint32_t height,
+                             const Format format,
+                             std::vector<uint8_t> &outPixels)
+{
+    const uint32_t blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint32_t blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const size_t blockSize = GetBlockSize(format);
+    const size_t texelSize = IsHdr(format) ? sizeof(uint16_t) * 4 : 4;
+    const size_t offset = outPixels.size();
+    outPixels.resize(offset + (static_cast<size_t>(width) * height * texelSize));
+
+    bool supported = true;
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++)
+    {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+        {
+            const uint8_t *block = blocks + ((static_cast<size_t>(blockY) * blocksX + blockX) * blockSize);
+            supported &= DecodeBlock(block, width, height, blockX, blockY, format, outPixels.data() + offset);
+        }
+    }
+    return supported;
+}
@@ -0,0 +1,187 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <libassets/util/BuildCache.h>
+#include <libassets/util/Checksum.h>
+#include <libassets/util/Error.h>
+#include <libassets/util/Logger.h>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+bool BuildCache::KeyBuilder::AddFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    const std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    hashes.push_back(Checksum::Hash64(bytes.data(), bytes.size()));
+    return true;
+}
+
+void BuildCache::KeyBuilder::AddString(const std::string &value)
+{
+    hashes.push_back(Checksum::Hash64(reinterpret_cast<const uint8_t *>(value.data()), value.size()));
+}
+
+uint64_t BuildCache::KeyBuilder::GetKey() const
+{
+    return Checksum::Hash64(reinterpret_cast<const uint8_t *>(hashes.data()), hashes.size() * sizeof(uint64_t));
+}
+
+BuildCache::BuildCache(const std::string &directory, const uintmax_t maxBytes)
+{
+    this->directory = directory;
+    this->maxBytes = maxBytes;
+}
+
+bool BuildCache::IsEnabled() const
+{
+    return !directory.empty();
+}
+
+bool BuildCache::Fetch(const uint64_t key, const std::string &outputPath) const
+{
+    if (!IsEnabled())
+    {
+        return false;
+    }
+    const std::string entryPath = GetEntryPath(key);
+    if (!std::filesystem::exists(entryPath) || !CopyAtomic(entryPath, outputPath))
+    {
+        return false;
+    }
+    // The modification time is the last use time that garbage collection goes by
+    std::error_code error{};
+    std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+    return true;
+}
+
+Error::ErrorCode BuildCache::Insert(const uint64_t key, const std::string &outputPath) const
+{
+    if (!IsEnabled())
+    {
+        return Error::ErrorCode::OK;
+    }
+    const std::string entryPath = GetEntryPath(key);
+    if (std::filesystem::exists(entryPath))
+    {
+        return Error::ErrorCode::OK;
+    }
+    std::error_code error{};
+    std::filesystem::create_directories(std::filesystem::path(entryPath).parent_path(), error);
+    if (error || !CopyAtomic(outputPath, entryPath))
+    {
+        return Error::ErrorCode::CANT_OPEN_FILE;
+    }
+    return Error::ErrorCode::OK;
+}
+
+void BuildCache::CollectGarbage() const
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+    struct CacheFile
+    {
+            std::filesystem::path path;
+            uintmax_t size;
+            std::filesystem::file_time_type time;
+    };
+    std::vector<CacheFile> files{};
+    uintmax_t totalBytes = 0;
+    const std::filesystem::file_time_type staleTime = std::filesystem::file_time_type::clock::now() -
+                                                      std::chrono::seconds(STALE_TEMPORARY_FILE_SECONDS);
+    std::error_code error{};
+    for (const std::filesystem::directory_entry &file: std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        std::error_code fileError{};
+        if (!file.is_regular_file(fileError))
+        {
+            continue;
+        }
+        const std::filesystem::file_time_type time = file.last_write_time(fileError);
+        const uintmax_t size = file.file_size(fileError);
+        if (fileError)
+        {
+            // Removed by another process while scanning
+            continue;
+        }
+        if (file.path().extension() == ".tmp")
+        {
+            if (time < staleTime)
+            {
+                std::filesystem::remove(file.path(), fileError);
+            }
+            continue;
+        }
+        files.push_back({
+            .path = file.path(),
+            .size = size,
+            .time = time,
+        });
+        totalBytes += size;
+    }
+    if (totalBytes <= maxBytes)
+    {
+        return;
+    }
+
+    std::ranges::sort(files, [](const CacheFile &a, const CacheFile &b) { return a.time < b.time; });
+    size_t removedCount = 0;
+    for (const CacheFile &file: files)
+    {
+        if (totalBytes <= maxBytes)
+        {
+            break;
+        }
+        std::error_code removeError{};
+        if (std::filesystem::remove(file.path, removeError))
+        {
+            removedCount++;
+        }
+        totalBytes -= file.size;
+    }
+    Logger::Verbose("Removed {} outputs from the build cache", removedCount);
+}
+
+std::string BuildCache::GetEntryPath(const uint64_t key) const
+{
+    // Spread entries over 256 folders so that no single folder gets huge
+    const std::string name = std::format("{:016x}", key);
+    return (std::filesystem::path(directory) / name.substr(0, 2) / name).string();
+}
+
+bool BuildCache::CopyAtomic(const std::string &sourcePath, const std::string &destinationPath)
+{
+    // The name has to be unique across processes and machines sharing the folder, not just threads
+    std::random_device random{};
+    const uint64_t suffix = (static_cast<uint64_t>(random()) << 32) | random();
+    const std::string temporaryPath = std::format("{}.{:016x}.tmp", destinationPath, suffix);
+    std::error_code error{};
+    std::filesystem::copy_file(sourcePath, temporaryPath, std::filesystem::copy_options::overwrite_existing, error);
+    if (!error)
+    {
+        std::filesystem::rename(temporaryPath, destinationPath, error);
+    }
+    if (error)
+    {
+        std::error_code removeError{};
+        std::filesystem::remove(temporaryPath, removeError);
+        return false;
+    }
+    return true;
+}
@@ -30,3 +30,14 @@ uint16_t Checksum::Calculate(const DataReader &reader, const size_t startOffset)
 {
     return Calculate(reader.bytes, startOffset);
 }
+
+uint64_t Checksum::Hash64(const uint8_t *bytes, const size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
@@ -0,0 +1,490 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <libassets/util/ConvexDecomposition.h>
+#include <libassets/util/QuickHull.h>
+#include <libassets/util/ThreadPool.h>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /// How much an uneven cut costs, per voxel of difference between the two sides
+    constexpr double BALANCE_WEIGHT = 0.05;
+    /// The most cuts tried along each axis, before trying every cut next to the best one
+    constexpr int COARSE_CUTS_PER_AXIS = 16;
+    /// Points closer than this to a part's final hull are left out, in voxels
+    constexpr float HULL_TOLERANCE = 0.05f;
+
+    enum class VoxelState : uint8_t
+    {
+        /// Not reached from outside the mesh, so inside once the flood fill is done
+        UNKNOWN,
+        OUTSIDE,
+        SURFACE,
+        INSIDE
+    };
+
+    /// A voxelized mesh, with a layer of outside voxels around it. Grid coordinates are in voxels from origin.
+    struct VoxelGrid
+    {
+            glm::vec3 origin{};
+            float voxelSize = 1;
+            glm::ivec3 size{};
+            std::vector<VoxelState> voxels{};
+
+            [[nodiscard]] bool Contains(const glm::ivec3 &voxel) const
+            {
+                return voxel.x >= 0 &&
+                       voxel.y >= 0 &&
+                       voxel.z >= 0 &&
+                       voxel.x < size.x &&
+                       voxel.y < size.y &&
+                       voxel.z < size.z;
+            }
+
+            [[nodiscard]] size_t GetIndex(const glm::ivec3 &voxel) const
+            {
+                return (((static_cast<size_t>(voxel.z) * static_cast<size_t>(size.y)) + static_cast<size_t>(voxel.y)) *
+                        static_cast<size_t>(size.x)) +
+                       static_cast<size_t>(voxel.x);
+            }
+
+            [[nodiscard]] glm::vec3 ToGrid(const glm::vec3 &position) const
+            {
+                return (position - origin) / voxelSize;
+            }
+    };
+
+    struct Part
+    {
+            std::vector<glm::ivec3> voxels{};
+            glm::ivec3 min{};
+            glm::ivec3 max{};
+            /// The box the part was cut from, in mesh coordinates
+            glm::vec3 regionMin{};
+            glm::vec3 regionMax{};
+            /// The volume of the part's convex hull, in voxels
+            double hullVolume = 0;
+
+            /// The empty space the hull adds to the part, in voxels
+            [[nodiscard]] double GetConcavity() const
+            {
+                return hullVolume - static_cast<double>(voxels.size());
+            }
+    };
+
+    /// A cut of a part by an axis aligned plane
+    struct Cut
+    {
+            int axis = 0;
+            /// Voxels below this coordinate on the axis go to the first part
+            int position = 0;
+            double cost = std::numeric_limits<double>::max();
+            double belowHullVolume = 0;
+            double aboveHullVolume = 0;
+    };
+
+    /**
+     * Separating axis test between a triangle and the unit box at the origin, for the axes not already covered by the
+     * bounds of the triangle ("Fast 3D Triangle-Box Overlap Testing", Akenine-Möller 2001)
+     */
+    bool TriangleOverlapsVoxel(const std::array<glm::vec3, 3> &triangle)
+    {
+        const auto separated = [&triangle](const glm::vec3 &axis) {
+            float min = std::numeric_limits<float>::max();
+            float max = std::numeric_limits<float>::lowest();
+            for (const glm::vec3 &corner: triangle)
+            {
+                const float distance = glm::dot(axis, corner);
+                min = std::min(min, distance);
+                max = std::max(max, distance);
+            }
+            const float radius = 0.5f * (std::abs(axis.x) + std::abs(axis.y) + std::abs(axis.z));
+            return min > radius || max < -radius;
+        };
+        const std::array<glm::vec3, 3> edges = {
+            triangle.at(1) - triangle.at(0),
+            triangle.at(2) - triangle.at(1),
+            triangle.at(0) - triangle.at(2),
+        };
+        if (separated(glm::cross(edges.at(0), edges.at(1))))
+        {
+            return false;
+        }
+        for (const glm::vec3 &edge: edges)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                glm::vec3 boxAxis{};
+                boxAxis[axis] = 1;
+                if (separated(glm::cross(edge, boxAxis)))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    VoxelGrid Voxelize(const std::vector<glm::vec3> &positions,
+                       const std::vector<uint32_t> &indices,
+                       const uint32_t resolution)
+    {
+        glm::vec3 min = positions.at(indices.at(0));
+        glm::vec3 max = min;
+        for (const uint32_t index: indices)
+        {
+            min = glm::min(min, positions.at(index));
+            max = glm::max(max, positions.at(index));
+        }
+        const glm::vec3 extents = max - min;
+        const float longestSide = std::max({extents.x, extents.y, extents.z});
+
+        VoxelGrid grid{};
+        if (longestSide > 0)
+        {
+            grid.voxelSize = longestSide / static_cast<float>(std::max(resolution, 1u));
+        }
+        grid.origin = min - glm::vec3(grid.voxelSize);
+        // Faces on the far side of the bounds can touch one more voxel, then there is a layer of outside voxels
+        for (int axis = 0; axis < 3; axis++)
+        {
+            grid.size[axis] = static_cast<int>(std::floor(extents[axis] / grid.voxelSize)) + 3;
+        }
+        grid.voxels.resize(static_cast<size_t>(grid.size.x) *
+                                   static_cast<size_t>(grid.size.y) *
+                                   static_cast<size_t>(grid.size.z),
+                           VoxelState::UNKNOWN);
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const std::array<glm::vec3, 3> triangle = {
+                grid.ToGrid(positions.at(indices.at(i))),
+                grid.ToGrid(positions.at(indices.at(i + 1))),
+                grid.ToGrid(positions.at(indices.at(i + 2))),
+            };
+            const glm::vec3 triangleMin = glm::min(glm::min(triangle.at(0), triangle.at(1)), triangle.at(2));
+            const glm::vec3 triangleMax = glm::max(glm::max(triangle.at(0), triangle.at(1)), triangle.at(2));
+            const glm::ivec3 first = glm::max(glm::ivec3(glm::floor(triangleMin)), glm::ivec3(0));
+            const glm::ivec3 last = glm::min(glm::ivec3(glm::floor(triangleMax)), grid.size - 1);
+            glm::ivec3 voxel{};
+            for (voxel.z = first.z; voxel.z <= last.z; voxel.z++)
+            {
+                for (voxel.y = first.y; voxel.y <= last.y; voxel.y++)
+                {
+                    for (voxel.x = first.x; voxel.x <= last.x; voxel.x++)
+                    {
+                        VoxelState &state = grid.voxels.at(grid.GetIndex(voxel));
+                        if (state == VoxelState::SURFACE)
+                        {
+                            continue;
+                        }
+                        const glm::vec3 center = glm::vec3(voxel) + 0.5f;
+                        if (TriangleOverlapsVoxel({
+                                    triangle.at(0) - center,
+                                    triangle.at(1) - center,
+                                    triangle.at(2) - center,
+                            }))
+                        {
+                            state = VoxelState::SURFACE;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Flood fill from the empty layer around the mesh, anything the fill can't reach is inside
+        constexpr std::array<glm::ivec3, 6> NEIGHBOURS = {{
+            {1, 0, 0},
+            {-1, 0, 0},
+            {0, 1, 0},
+            {0, -1, 0},
+            {0, 0, 1},
+            {0, 0, -1},
+        }};
+        std::vector<glm::ivec3> stack = {glm::ivec3(0)};
+        grid.voxels.at(0) = VoxelState::OUTSIDE;
+        while (!stack.empty())
+        {
+            const glm::ivec3 voxel = stack.back();
+            stack.pop_back();
+            for (const glm::ivec3 &offset: NEIGHBOURS)
+            {
+                const glm::ivec3 neighbour = voxel + offset;
+                if (grid.Contains(neighbour) && grid.voxels.at(grid.GetIndex(neighbour)) == VoxelState::UNKNOWN)
+                {
+                    grid.voxels.at(grid.GetIndex(neighbour)) = VoxelState::OUTSIDE;
+                    stack.push_back(neighbour);
+                }
+            }
+        }
+        std::ranges::replace(grid.voxels, VoxelState::UNKNOWN, VoxelState::INSIDE);
+        return grid;
+    }
+
+    /**
+     * Get the corners of the first and last voxel in each row along z, which have the same convex hull as the corners
+     * of every voxel in the part that passes the filter
+     */
+    template<typename Filter> std::vector<glm::vec3> GetHullPoints(const Part &part, const Filter &filter)
+    {
+        const int rowsX = part.max.x - part.min.x + 1;
+        const int rowsY = part.max.y - part.min.y + 1;
+        std::vector<int> rowStarts(static_cast<size_t>(rowsX) * static_cast<size_t>(rowsY), INT_MAX);
+        std::vector<int> rowEnds(rowStarts.size(), INT_MIN);
+        for (const glm::ivec3 &voxel: part.voxels)
+        {
+            if (!filter(voxel))
+            {
+                continue;
+            }
+            const size_t row = (static_cast<size_t>(voxel.y - part.min.y) * static_cast<size_t>(rowsX)) +
+                               static_cast<size_t>(voxel.x - part.min.x);
+            rowStarts.at(row) = std::min(rowStarts.at(row), voxel.z);
+            rowEnds.at(row) = std::max(rowEnds.at(row), voxel.z + 1);
+        }
+
+        std::vector<glm::vec3> points{};
+        for (int y = 0; y < rowsY; y++)
+        {
+            for (int x = 0; x < rowsX; x++)
+            {
+                const size_t row = (static_cast<size_t>(y) * static_cast<size_t>(rowsX)) + static_cast<size_t>(x);
+                if (rowStarts.at(row) == INT_MAX)
+                {
+                    continue;
+                }
+                for (const int z: {rowStarts.at(row), rowEnds.at(row)})
+                {
+                    for (int corner = 0; corner < 4; corner++)
+                    {
+                        points.emplace_back(static_cast<float>(part.min.x + x + (corner & 1)),
+                                            static_cast<float>(part.min.y + y + (corner >> 1)),
+                                            static_cast<float>(z));
+                    }
+                }
+            }
+        }
+        return points;
+    }
+
+    double GetHullVolume(const std::vector<glm::vec3> &points)
+    {
+        QuickHull::Hull hull{};
+        if (!QuickHull::Compute(points, 0, points.size(), hull))
+        {
+            return 0;
+        }
+        return QuickHull::GetVolume(hull);
+    }
+
+    Part CreatePart(std::vector<glm::ivec3> &&voxels, const double hullVolume)
+    {
+        Part part{};
+        part.voxels = std::move(voxels);
+        part.min = part.voxels.at(0);
+        part.max = part.voxels.at(0);
+        for (const glm::ivec3 &voxel: part.voxels)
+        {
+            part.min = glm::min(part.min, voxel);
+            part.max = glm::max(part.max, voxel);
+        }
+        part.hullVolume = hullVolume;
+        return part;
+    }
+
+    void EvaluateCuts(const Part &part, std::vector<Cut> &cuts)
+    {
+        ThreadPool::GetShared().Run(cuts.size(), [&part, &cuts](const size_t i) {
+            Cut &cut = cuts.at(i);
+            const auto below = [&cut](const glm::ivec3 &voxel) { return voxel[cut.axis] < cut.position; };
+            const auto above = [&cut](const glm::ivec3 &voxel) { return voxel[cut.axis] >= cut.position; };
+            const double belowCount = static_cast<double>(std::ranges::count_if(part.voxels, below));
+            const double aboveCount = static_cast<double>(part.voxels.size()) - belowCount;
+            cut.belowHullVolume = GetHullVolume(GetHullPoints(part, below));
+            cut.aboveHullVolume = GetHullVolume(GetHullPoints(part, above));
+            cut.cost = (cut.belowHullVolume - belowCount) +
+                       (cut.aboveHullVolume - aboveCount) +
+                       (BALANCE_WEIGHT * std::abs(belowCount - aboveCount));
+        });
+    }
+
+    /// Find the cut that leaves the least empty space in the hulls of the two new parts
+    Cut FindCut(const Part &part)
+    {
+        std::array<int, 3> steps{};
+        std::vector<Cut> cuts{};
+        for (int axis = 0; axis < 3; axis++)
+        {
+            steps.at(axis) = std::max((part.max[axis] - part.min[axis] + 1) / COARSE_CUTS_PER_AXIS, 1);
+            for (int position = part.min[axis] + steps.at(axis); position <= part.max[axis]; position += steps.at(axis))
+            {
+                cuts.push_back({.axis = axis, .position = position});
+            }
+        }
+        EvaluateCuts(part, cuts);
+        Cut best = *std::ranges::min_element(cuts, {}, &Cut::cost);
+
+        const int step = steps.at(best.axis);
+        cuts.clear();
+        for (int position = std::max(best.position - step + 1, part.min[best.axis] + 1);
+             position < best.position + step && position <= part.max[best.axis];
+             position++)
+        {
+            if (position != best.position)
+            {
+                cuts.push_back({.axis = best.axis, .position = position});
+            }
+        }
+        EvaluateCuts(part, cuts);
+        for (const Cut &cut: cuts)
+        {
+            if (cut.cost < best.cost)
+            {
+                best = cut;
+            }
+        }
+        return best;
+    }
+
+    /// Clip a polygon to the side of an axis aligned plane where side * (coordinate - position) is at least 0
+    void ClipPolygon(std::vector<glm::vec3> &polygon, const int axis, const float position, const float side)
+    {
+        std::vector<glm::vec3> clipped{};
+        for (size_t i = 0; i < polygon.size(); i++)
+        {
+            const glm::vec3 &current = polygon.at(i);
+            const glm::vec3 &next = polygon.at((i + 1) % polygon.size());
+            const float currentDistance = (current[axis] - position) * side;
+            const float nextDistance = (next[axis] - position) * side;
+            if (currentDistance >= 0)
+            {
+                clipped.push_back(current);
+            }
+            if ((currentDistance < 0) != (nextDistance < 0))
+            {
+                const float fraction = currentDistance / (currentDistance - nextDistance);
+                glm::vec3 intersection = current + ((next - current) * fraction);
+                intersection[axis] = position;
+                clipped.push_back(intersection);
+            }
+        }
+        polygon = std::move(clipped);
+    }
+
+    /**
+     * Get the pieces of the mesh's surface inside a part's region. For a closed mesh these have the same convex hull
+     * as the solid inside the region, without the error of the voxels.
+     */
+    std::vector<glm::vec3> GetPartPoints(const std::vector<glm::vec3> &positions,
+                                         const std::vector<uint32_t> &indices,
+                                         const Part &part)
+    {
+        std::vector<glm::vec3> points{};
+        std::vector<glm::vec3> polygon{};
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            polygon = {positions.at(indices.at(i)), positions.at(indices.at(i + 1)), positions.at(indices.at(i + 2))};
+            for (int axis = 0; axis < 3 && !polygon.empty(); axis++)
+            {
+                ClipPolygon(polygon, axis, part.regionMin[axis], 1.0f);
+                ClipPolygon(polygon, axis, part.regionMax[axis], -1.0f);
+            }
+            points.insert(points.end(), polygon.begin(), polygon.end());
+        }
+        return points;
+    }
+} // namespace
+
+std::vector<std::vector<glm::vec3>> ConvexDecomposition::Decompose(const std::vector<glm::vec3> &positions,
+                                                                   const std::vector<uint32_t> &indices,
+                                                                   const Parameters &parameters)
+{
+    if (indices.size() < 3)
+    {
+        return {};
+    }
+    const VoxelGrid grid = Voxelize(positions, indices, parameters.resolution);
+    std::vector<glm::ivec3> solidVoxels{};
+    glm::ivec3 voxel{};
+    for (voxel.z = 0; voxel.z < grid.size.z; voxel.z++)
+    {
+        for (voxel.y = 0; voxel.y < grid.size.y; voxel.y++)
+        {
+            for (voxel.x = 0; voxel.x < grid.size.x; voxel.x++)
+            {
+                const VoxelState state = grid.voxels.at(grid.GetIndex(voxel));
+                if (state == VoxelState::SURFACE || state == VoxelState::INSIDE)
+                {
+                    solidVoxels.push_back(voxel);
+                }
+            }
+        }
+    }
+
+    if (solidVoxels.empty())
+    {
+        return {};
+    }
+
+    Part root = CreatePart(std::move(solidVoxels), 0);
+    root.regionMin = grid.origin;
+    root.regionMax = grid.origin + (glm::vec3(grid.size) * grid.voxelSize);
+    root.hullVolume = GetHullVolume(GetHullPoints(root, [](const glm::ivec3 &) { return true; }));
+    const double maxConcavity = parameters.maxConcavity * root.hullVolume;
+    std::vector<Part> parts{};
+    parts.push_back(std::move(root));
+    while (parts.size() < std::max<size_t>(parameters.maxHulls, 1))
+    {
+        const auto worst = std::ranges::max_element(parts, {}, &Part::GetConcavity);
+        if (worst->GetConcavity() <= maxConcavity || worst->voxels.size() < 2)
+        {
+            break;
+        }
+        const Cut cut = FindCut(*worst);
+        std::vector<glm::ivec3> belowVoxels{};
+        std::vector<glm::ivec3> aboveVoxels{};
+        for (const glm::ivec3 &partVoxel: worst->voxels)
+        {
+            (partVoxel[cut.axis] < cut.position ? belowVoxels : aboveVoxels).push_back(partVoxel);
+        }
+        Part below = CreatePart(std::move(belowVoxels), cut.belowHullVolume);
+        Part above = CreatePart(std::move(aboveVoxels), cut.aboveHullVolume);
+        below.regionMin = worst->regionMin;
+        below.regionMax = worst->regionMax;
+        above.regionMin = worst->regionMin;
+        above.regionMax = worst->regionMax;
+        const float cutPosition = grid.origin[cut.axis] + (static_cast<float>(cut.position) * grid.voxelSize);
+        below.regionMax[cut.axis] = cutPosition;
+        above.regionMin[cut.axis] = cutPosition;
+        *worst = std::move(below);
+        parts.push_back(std::move(above));
+    }
+
+    std::vector<std::vector<glm::vec3>> hulls(parts.size());
+    const auto computeHull = [&positions, &indices, &parameters, &grid, &parts, &hulls](const size_t i) {
+        QuickHull::Hull hull{};
+        if (QuickHull::Compute(GetPartPoints(positions, indices, parts.at(i)),
+                               HULL_TOLERANCE * grid.voxelSize,
+                               parameters.maxVerticesPerHull,
+                               hull))
+        {
+            hulls.at(i) = std::move(hull.vertices);
+        }
+    };
+    ThreadPool::GetShared().Run(parts.size(), computeHull);
+    std::erase_if(hulls, [](const std::vector<glm::vec3> &hull) { return hull.empty(); });
+    return hulls;
+}
@@ -0,0 +1,103 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <libassets/util/DirectoryWatcher.h>
+#include <libassets/util/Logger.h>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+DirectoryWatcher::DirectoryWatcher(std::function<void()> onChange): onChange(std::move(onChange))
+{
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+    {
+        Logger::Warning("inotify_init1() failed: {}", strerror(errno));
+        return;
+    }
+    watching = true;
+    thread = std::thread(&DirectoryWatcher::ThreadMain, this);
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    stopRequested = true;
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+#ifdef __linux__
+    if (inotifyFd >= 0)
+    {
+        close(inotifyFd);
+    }
+#endif
+}
+
+bool DirectoryWatcher::AddDirectory(const std::string &directoryPath)
+{
+#ifdef __linux__
+    if (!watching)
+    {
+        return false;
+    }
+    constexpr uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+    if (inotify_add_watch(inotifyFd, directoryPath.c_str(), mask) < 0)
+    {
+        // Most likely the user's watch limit. A partial watch would miss changes, so report nothing instead.
+        Logger::Warning("Unable to watch \"{}\" for changes: {}", directoryPath, strerror(errno));
+        watching = false;
+        return false;
+    }
+    return true;
+#else
+    (void)directoryPath;
+    return false;
+#endif
+}
+
+bool DirectoryWatcher::IsWatching() const
+{
+    return watching;
+}
+
+void DirectoryWatcher::ThreadMain() const
+{
+#ifdef __linux__
+    std::array<char, 4096> eventBuffer{};
+    while (!stopRequested)
+    {
+        pollfd pfd = {
+            .fd = inotifyFd,
+            .events = POLLIN,
+            .revents = 0,
+        };
+        if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0 || (pfd.revents & POLLIN) == 0)
+        {
+            continue;
+        }
+        bool changed = false;
+        while (read(inotifyFd, eventBuffer.data(), eventBuffer.size()) > 0)
+        {
+            changed = true; // Every event we asked for means the set of files may have changed
+        }
+        if (changed)
+        {
+            onChange();
+        }
+    }
+#endif
+}
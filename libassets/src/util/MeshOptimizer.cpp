@@ -0,0 +1,272 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <libassets/util/MeshOptimizer.h>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t NO_VERTEX = UINT32_MAX;
+
+    /// The triangles that use each vertex
+    struct VertexAdjacency
+    {
+            /// Where each vertex's triangles start in triangles, with one extra entry at the end
+            std::vector<size_t> offsets;
+            std::vector<uint32_t> triangles;
+
+            VertexAdjacency(const std::vector<uint32_t> &indices, const size_t vertexCount):
+                offsets(vertexCount + 1, 0),
+                triangles(indices.size())
+            {
+                for (const uint32_t index: indices)
+                {
+                    offsets.at(index + 1)++;
+                }
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indices.size(); i++)
+                {
+                    triangles.at(cursors.at(indices.at(i))++) = static_cast<uint32_t>(i / 3);
+                }
+            }
+    };
+} // namespace
+
+float MeshOptimizer::VertexCacheStats::GetAcmr() const
+{
+    return triangleCount == 0 ? 0 : static_cast<float>(transformedVertices) / static_cast<float>(triangleCount);
+}
+
+float MeshOptimizer::VertexCacheStats::GetAtvr() const
+{
+    return vertexCount == 0 ? 0 : static_cast<float>(transformedVertices) / static_cast<float>(vertexCount);
+}
+
+void MeshOptimizer::VertexCacheStats::Add(const VertexCacheStats &other)
+{
+    transformedVertices += other.transformedVertices;
+    triangleCount += other.triangleCount;
+    vertexCount += other.vertexCount;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t> &indices,
+                                        const size_t vertexCount,
+                                        std::vector<size_t> &outClusterStarts)
+{
+    outClusterStarts.clear();
+    if (indices.size() < 3)
+    {
+        return;
+    }
+    const VertexAdjacency adjacency(indices, vertexCount);
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        liveTriangles.at(vertex) = static_cast<uint32_t>(adjacency.offsets.at(vertex + 1) -
+                                                         adjacency.offsets.at(vertex));
+    }
+    // A vertex is in the cache if it was last transformed less than CACHE_SIZE transforms ago
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    size_t time = CACHE_SIZE + 1;
+    std::vector<bool> emitted(indices.size() / 3, false);
+    std::vector<uint32_t> deadEndStack{};
+    std::vector<uint32_t> candidates{};
+    std::vector<uint32_t> output{};
+    output.reserve(indices.size());
+    uint32_t nextUnvisited = 0;
+
+    // Fan around a vertex, then move to the best vertex just emitted, or jump when there is none (a new cluster)
+    uint32_t fanVertex = indices.at(0);
+    outClusterStarts.push_back(0);
+    while (fanVertex != NO_VERTEX)
+    {
+        candidates.clear();
+        for (size_t i = adjacency.offsets.at(fanVertex); i < adjacency.offsets.at(fanVertex + 1); i++)
+        {
+            const uint32_t triangle = adjacency.triangles.at(i);
+            if (emitted.at(triangle))
+            {
+                continue;
+            }
+            emitted.at(triangle) = true;
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = indices.at((triangle * 3) + corner);
+                output.push_back(vertex);
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles.at(vertex)--;
+                if (time - cacheTime.at(vertex) > CACHE_SIZE)
+                {
+                    cacheTime.at(vertex) = time;
+                    time++;
+                }
+            }
+        }
+
+        // Prefer the candidate that stays in the cache the longest while all its triangles are fanned
+        uint32_t bestVertex = NO_VERTEX;
+        int64_t bestPriority = -1;
+        for (const uint32_t vertex: candidates)
+        {
+            if (liveTriangles.at(vertex) == 0)
+            {
+                continue;
+            }
+            int64_t priority = 0;
+            if (time - cacheTime.at(vertex) + (2 * liveTriangles.at(vertex)) <= CACHE_SIZE)
+            {
+                priority = static_cast<int64_t>(time - cacheTime.at(vertex));
+            }
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                bestVertex = vertex;
+            }
+        }
+        if (bestVertex != NO_VERTEX)
+        {
+            fanVertex = bestVertex;
+            continue;
+        }
+
+        // Dead end, resume from a recently used vertex, or failing that the next vertex with triangles left
+        fanVertex = NO_VERTEX;
+        while (!deadEndStack.empty() && fanVertex == NO_VERTEX)
+        {
+            const uint32_t vertex = deadEndStack.back();
+            deadEndStack.pop_back();
+            if (liveTriangles.at(vertex) > 0)
+            {
+                fanVertex = vertex;
+            }
+        }
+        while (fanVertex == NO_VERTEX && nextUnvisited < vertexCount)
+        {
+            if (liveTriangles.at(nextUnvisited) > 0)
+            {
+                fanVertex = nextUnvisited;
+            }
+            nextUnvisited++;
+        }
+        if (fanVertex != NO_VERTEX)
+        {
+            outClusterStarts.push_back(output.size());
+        }
+    }
+    indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t> &indices,
+                                     const std::vector<size_t> &clusterStarts,
+                                     const std::vector<glm::vec3> &positions)
+{
+    if (clusterStarts.size() < 2)
+    {
+        return;
+    }
+    struct Cluster
+    {
+            size_t start;
+            size_t end;
+            float sortKey;
+    };
+    std::vector<Cluster> clusters{};
+    glm::vec3 meshCentroid{};
+    for (const uint32_t index: indices)
+    {
+        meshCentroid += positions.at(index);
+    }
+    meshCentroid /= static_cast<float>(indices.size());
+
+    for (size_t i = 0; i < clusterStarts.size(); i++)
+    {
+        const size_t start = clusterStarts.at(i);
+        const size_t end = i + 1 < clusterStarts.size() ? clusterStarts.at(i + 1) : indices.size();
+        glm::vec3 centroid{};
+        glm::vec3 normal{};
+        for (size_t index = start; index < end; index += 3)
+        {
+            const glm::vec3 &a = positions.at(indices.at(index));
+            const glm::vec3 &b = positions.at(indices.at(index + 1));
+            const glm::vec3 &c = positions.at(indices.at(index + 2));
+            centroid += a + b + c;
+            // Not normalized, so that larger triangles count for more
+            normal += glm::cross(b - a, c - a);
+        }
+        centroid /= static_cast<float>(end - start);
+        const float normalLength = glm::length(normal);
+        // Clusters facing away from the center are likely in front of the rest of the mesh
+        const float sortKey = normalLength > 0 ? glm::dot(centroid - meshCentroid, normal / normalLength) : 0;
+        clusters.push_back({
+            .start = start,
+            .end = end,
+            .sortKey = sortKey,
+        });
+    }
+
+    std::ranges::stable_sort(clusters, [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+    std::vector<uint32_t> output{};
+    output.reserve(indices.size());
+    for (const Cluster &cluster: clusters)
+    {
+        output.insert(output.end(), indices.begin() + cluster.start, indices.begin() + cluster.end);
+    }
+    indices = std::move(output);
+}
+
+std::vector<uint32_t> MeshOptimizer::GetVertexFetchRemap(const std::vector<std::vector<uint32_t>> &indexLists,
+                                                         const size_t vertexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, NO_VERTEX);
+    uint32_t nextVertex = 0;
+    for (const std::vector<uint32_t> &indices: indexLists)
+    {
+        for (const uint32_t index: indices)
+        {
+            if (remap.at(index) == NO_VERTEX)
+            {
+                remap.at(index) = nextVertex;
+                nextVertex++;
+            }
+        }
+    }
+    return remap;
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t> &indices,
+                                                                   const size_t vertexCount)
+{
+    VertexCacheStats stats{
+        .transformedVertices = 0,
+        .triangleCount = indices.size() / 3,
+        .vertexCount = 0,
+    };
+    // Same timestamp scheme as OptimizeVertexCache, which behaves like a FIFO cache
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    std::vector<bool> used(vertexCount, false);
+    size_t time = CACHE_SIZE + 1;
+    for (const uint32_t index: indices)
+    {
+        if (!used.at(index))
+        {
+            used.at(index) = true;
+            stats.vertexCount++;
+        }
+        if (time - cacheTime.at(index) > CACHE_SIZE)
+        {
+            cacheTime.at(index) = time;
+            time++;
+            stats.transformedVertices++;
+        }
+    }
+    return stats;
+}
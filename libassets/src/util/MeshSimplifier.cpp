@@ -0,0 +1,591 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <libassets/util/MeshSimplifier.h>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t NO_VERTEX = UINT32_MAX;
+    /// Stored instead of a vertex when there is more than one
+    constexpr uint32_t MANY_VERTICES = UINT32_MAX - 1;
+    /// How much more an open border resists moving away from itself than a surface does
+    constexpr double BORDER_WEIGHT = 10.0;
+
+    enum class VertexKind : uint8_t
+    {
+        /// Every edge is shared with another triangle
+        MANIFOLD,
+        /// On a single open border
+        BORDER,
+        /// One of two vertices at the same position, on a single seam between them
+        SEAM,
+        /// Anything more complex, which never moves
+        LOCKED
+    };
+
+    /// Whether a vertex of the first kind may move onto a vertex of the second kind
+    constexpr std::array<std::array<bool, 4>, 4> CAN_COLLAPSE = {{
+        {true, true, true, true},
+        {false, true, false, true},
+        {false, false, true, true},
+        {false, false, false, false},
+    }};
+
+    /// The sum of weighted squared distances to a set of planes
+    struct Quadric
+    {
+            double a00 = 0;
+            double a11 = 0;
+            double a22 = 0;
+            double a10 = 0;
+            double a20 = 0;
+            double a21 = 0;
+            double b0 = 0;
+            double b1 = 0;
+            double b2 = 0;
+            double c = 0;
+            double weight = 0;
+
+            void AddPlane(const glm::dvec3 &normal, const double distance, const double planeWeight)
+            {
+                a00 += planeWeight * normal.x * normal.x;
+                a11 += planeWeight * normal.y * normal.y;
+                a22 += planeWeight * normal.z * normal.z;
+                a10 += planeWeight * normal.y * normal.x;
+                a20 += planeWeight * normal.z * normal.x;
+                a21 += planeWeight * normal.z * normal.y;
+                b0 += planeWeight * normal.x * distance;
+                b1 += planeWeight * normal.y * distance;
+                b2 += planeWeight * normal.z * distance;
+                c += planeWeight * distance * distance;
+                weight += planeWeight;
+            }
+
+            void Add(const Quadric &other)
+            {
+                a00 += other.a00;
+                a11 += other.a11;
+                a22 += other.a22;
+                a10 += other.a10;
+                a20 += other.a20;
+                a21 += other.a21;
+                b0 += other.b0;
+                b1 += other.b1;
+                b2 += other.b2;
+                c += other.c;
+                weight += other.weight;
+            }
+
+            /// Get the weighted mean squared distance from a point to the planes
+            [[nodiscard]] double GetError(const glm::dvec3 &point) const
+            {
+                const double error = (a00 * point.x * point.x) +
+                                     (a11 * point.y * point.y) +
+                                     (a22 * point.z * point.z) +
+                                     (2 * ((a10 * point.x * point.y) +
+                                           (a20 * point.x * point.z) +
+                                           (a21 * point.y * point.z))) +
+                                     (2 * ((b0 * point.x) + (b1 * point.y) + (b2 * point.z))) +
+                                     c;
+                return weight == 0 ? 0 : std::abs(error) / weight;
+            }
+    };
+
+    /// Moving the vertex from onto the vertex to
+    struct Collapse
+    {
+            uint32_t from;
+            uint32_t to;
+            double error;
+    };
+
+    uint64_t GetHalfEdgeKey(const uint32_t from, const uint32_t to)
+    {
+        return (static_cast<uint64_t>(from) << 32) | to;
+    }
+
+    /// Record a vertex in a slot that holds one vertex, or MANY_VERTICES once a second one is recorded
+    void RecordVertex(uint32_t &slot, const uint32_t vertex)
+    {
+        slot = slot == NO_VERTEX ? vertex : MANY_VERTICES;
+    }
+
+    /// Everything Simplify knows about the mesh, which stays the same while it is simplified
+    class SimplifyState
+    {
+        public:
+            /// Positions scaled into a unit cube, so errors are relative to the size of the mesh
+            std::vector<glm::dvec3> positions{};
+            /// The first vertex at the same position as each vertex
+            std::vector<uint32_t> positionVertex{};
+            /// The next vertex at the same position as each vertex, forming a ring
+            std::vector<uint32_t> wedge{};
+            std::vector<VertexKind> kinds{};
+            /// The vertex at the other end of each vertex's outgoing open edge
+            std::vector<uint32_t> loop{};
+            /// The vertex at the other end of each vertex's incoming open edge
+            std::vector<uint32_t> loopBack{};
+            /// Indexed by positionVertex
+            std::vector<Quadric> quadrics{};
+
+            SimplifyState(const std::vector<glm::vec3> &sourcePositions, const std::vector<uint32_t> &indices)
+            {
+                const size_t vertexCount = sourcePositions.size();
+                glm::vec3 minPosition = vertexCount == 0 ? glm::vec3{} : sourcePositions.at(0);
+                for (const glm::vec3 &position: sourcePositions)
+                {
+                    minPosition = glm::min(minPosition, position);
+                }
+                const float scale = MeshSimplifier::GetMeshScale(sourcePositions);
+                const double inverseScale = scale > 0 ? 1.0 / scale : 1.0;
+                positions.reserve(vertexCount);
+                for (const glm::vec3 &position: sourcePositions)
+                {
+                    positions.emplace_back(glm::dvec3(position - minPosition) * inverseScale);
+                }
+
+                std::vector<uint64_t> halfEdges{};
+                halfEdges.reserve(indices.size());
+                for (size_t i = 0; i < indices.size(); i += 3)
+                {
+                    for (size_t corner = 0; corner < 3; corner++)
+                    {
+                        halfEdges.push_back(GetHalfEdgeKey(indices.at(i + corner), indices.at(i + ((corner + 1) % 3))));
+                    }
+                }
+                std::ranges::sort(halfEdges);
+
+                FindWedges(sourcePositions);
+                Classify(halfEdges);
+                AddQuadrics(indices, halfEdges);
+            }
+
+            [[nodiscard]] bool CanCollapse(const uint32_t from, const uint32_t to) const
+            {
+                const VertexKind fromKind = kinds.at(from);
+                if (!CAN_COLLAPSE.at(static_cast<size_t>(fromKind)).at(static_cast<size_t>(kinds.at(to))))
+                {
+                    return false;
+                }
+                // Borders and seams may only move along themselves
+                if (fromKind == VertexKind::BORDER || fromKind == VertexKind::SEAM)
+                {
+                    return loop.at(from) == to || loopBack.at(from) == to;
+                }
+                return true;
+            }
+
+            /**
+             * Get the vertex the other side of a seam vertex moves onto when it collapses
+             * @return The vertex, or NO_VERTEX if the other side has no matching edge
+             */
+            [[nodiscard]] uint32_t GetSeamTarget(const uint32_t from, const uint32_t to) const
+            {
+                const uint32_t otherFrom = wedge.at(from);
+                // The other side of the seam runs the opposite way
+                const uint32_t otherTo = loop.at(from) == to ? loopBack.at(otherFrom) : loop.at(otherFrom);
+                if (otherTo >= MANY_VERTICES || positionVertex.at(otherTo) != positionVertex.at(to))
+                {
+                    return NO_VERTEX;
+                }
+                return otherTo;
+            }
+
+            /// Point loop and loopBack past vertices that were collapsed
+            void RemapLoops(const std::vector<uint32_t> &collapseRemap)
+            {
+                for (std::vector<uint32_t> *loops: {&loop, &loopBack})
+                {
+                    for (size_t vertex = 0; vertex < loops->size(); vertex++)
+                    {
+                        const uint32_t next = loops->at(vertex);
+                        if (next >= MANY_VERTICES)
+                        {
+                            continue;
+                        }
+                        const uint32_t remapped = collapseRemap.at(next);
+                        // The edge itself collapsed onto this vertex, so the loop continues from where it went
+                        loops->at(vertex) = remapped == vertex ? loops->at(next) : remapped;
+                    }
+                }
+            }
+
+        private:
+            void FindWedges(const std::vector<glm::vec3> &sourcePositions)
+            {
+                const size_t vertexCount = sourcePositions.size();
+                std::vector<uint32_t> order(vertexCount);
+                std::iota(order.begin(), order.end(), 0);
+                const auto lessPosition = [&sourcePositions](const uint32_t a, const uint32_t b) {
+                    const glm::vec3 &positionA = sourcePositions.at(a);
+                    const glm::vec3 &positionB = sourcePositions.at(b);
+                    if (positionA.x != positionB.x)
+                    {
+                        return positionA.x < positionB.x;
+                    }
+                    if (positionA.y != positionB.y)
+                    {
+                        return positionA.y < positionB.y;
+                    }
+                    return positionA.z < positionB.z;
+                };
+                std::ranges::stable_sort(order, lessPosition);
+
+                positionVertex.resize(vertexCount);
+                wedge.resize(vertexCount);
+                std::iota(wedge.begin(), wedge.end(), 0);
+                for (size_t i = 0; i < vertexCount; i++)
+                {
+                    const uint32_t vertex = order.at(i);
+                    if (i > 0 && sourcePositions.at(order.at(i - 1)) == sourcePositions.at(vertex))
+                    {
+                        const uint32_t first = positionVertex.at(order.at(i - 1));
+                        positionVertex.at(vertex) = first;
+                        wedge.at(vertex) = wedge.at(first);
+                        wedge.at(first) = vertex;
+                    } else
+                    {
+                        positionVertex.at(vertex) = vertex;
+                    }
+                }
+            }
+
+            /// @param halfEdges Every edge of every triangle in winding order from GetHalfEdgeKey, sorted
+            void Classify(const std::vector<uint64_t> &halfEdges)
+            {
+                const size_t vertexCount = positions.size();
+                // An edge is open if no triangle has it the other way around with the same vertices
+                loop.assign(vertexCount, NO_VERTEX);
+                loopBack.assign(vertexCount, NO_VERTEX);
+                for (const uint64_t halfEdge: halfEdges)
+                {
+                    const uint32_t from = static_cast<uint32_t>(halfEdge >> 32);
+                    const uint32_t to = static_cast<uint32_t>(halfEdge);
+                    if (!std::ranges::binary_search(halfEdges, GetHalfEdgeKey(to, from)))
+                    {
+                        RecordVertex(loop.at(from), to);
+                        RecordVertex(loopBack.at(to), from);
+                    }
+                }
+
+                kinds.resize(vertexCount);
+                for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+                {
+                    kinds.at(vertex) = Classify(vertex);
+                }
+            }
+
+            [[nodiscard]] VertexKind Classify(const uint32_t vertex) const
+            {
+                const uint32_t in = loopBack.at(vertex);
+                const uint32_t out = loop.at(vertex);
+                if (wedge.at(vertex) == vertex)
+                {
+                    if (in == NO_VERTEX && out == NO_VERTEX)
+                    {
+                        return VertexKind::MANIFOLD;
+                    }
+                    // A seam that ends here has both open edges go to the same position, which can't move
+                    if (in < MANY_VERTICES && out < MANY_VERTICES && positionVertex.at(in) != positionVertex.at(out))
+                    {
+                        return VertexKind::BORDER;
+                    }
+                    return VertexKind::LOCKED;
+                }
+                const uint32_t other = wedge.at(vertex);
+                if (wedge.at(other) != vertex)
+                {
+                    return VertexKind::LOCKED;
+                }
+                const uint32_t otherIn = loopBack.at(other);
+                const uint32_t otherOut = loop.at(other);
+                if (in >= MANY_VERTICES || out >= MANY_VERTICES || otherIn >= MANY_VERTICES ||
+                    otherOut >= MANY_VERTICES)
+                {
+                    return VertexKind::LOCKED;
+                }
+                if (positionVertex.at(in) == positionVertex.at(otherOut) &&
+                    positionVertex.at(out) == positionVertex.at(otherIn) &&
+                    positionVertex.at(in) != positionVertex.at(out))
+                {
+                    return VertexKind::SEAM;
+                }
+                return VertexKind::LOCKED;
+            }
+
+            void AddQuadrics(const std::vector<uint32_t> &indices, const std::vector<uint64_t> &halfEdges)
+            {
+                quadrics.resize(positions.size());
+                for (size_t i = 0; i < indices.size(); i += 3)
+                {
+                    const std::array<uint32_t, 3> corners = {indices.at(i), indices.at(i + 1), indices.at(i + 2)};
+                    const glm::dvec3 &position0 = positions.at(corners.at(0));
+                    const glm::dvec3 normal = glm::cross(positions.at(corners.at(1)) - position0,
+                                                         positions.at(corners.at(2)) - position0);
+                    const double normalLength = glm::length(normal);
+                    if (normalLength == 0)
+                    {
+                        continue;
+                    }
+                    const glm::dvec3 unitNormal = normal / normalLength;
+                    Quadric triangle{};
+                    triangle.AddPlane(unitNormal, -glm::dot(unitNormal, position0), normalLength * 0.5);
+                    for (const uint32_t corner: corners)
+                    {
+                        quadrics.at(positionVertex.at(corner)).Add(triangle);
+                    }
+
+                    // Open edges get a plane perpendicular to the triangle, which keeps borders and seams in place
+                    for (size_t corner = 0; corner < 3; corner++)
+                    {
+                        const uint32_t from = corners.at(corner);
+                        const uint32_t to = corners.at((corner + 1) % 3);
+                        if (std::ranges::binary_search(halfEdges, GetHalfEdgeKey(to, from)))
+                        {
+                            continue;
+                        }
+                        const glm::dvec3 edge = positions.at(to) - positions.at(from);
+                        const double edgeLength = glm::length(edge);
+                        if (edgeLength == 0)
+                        {
+                            continue;
+                        }
+                        const glm::dvec3 edgeNormal = glm::normalize(glm::cross(edge, unitNormal));
+                        const bool seam = kinds.at(from) == VertexKind::SEAM || kinds.at(to) == VertexKind::SEAM;
+                        Quadric edgeQuadric{};
+                        edgeQuadric.AddPlane(edgeNormal,
+                                             -glm::dot(edgeNormal, positions.at(from)),
+                                             edgeLength * edgeLength * (seam ? 1.0 : BORDER_WEIGHT));
+                        quadrics.at(positionVertex.at(from)).Add(edgeQuadric);
+                        quadrics.at(positionVertex.at(to)).Add(edgeQuadric);
+                    }
+                }
+            }
+    };
+
+    /// The triangles around each position
+    struct PositionAdjacency
+    {
+            std::vector<size_t> offsets;
+            std::vector<uint32_t> triangles;
+
+            PositionAdjacency(const std::vector<uint32_t> &indices, const std::vector<uint32_t> &positionVertex):
+                offsets(positionVertex.size() + 1, 0),
+                triangles(indices.size())
+            {
+                for (const uint32_t index: indices)
+                {
+                    offsets.at(positionVertex.at(index) + 1)++;
+                }
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indices.size(); i++)
+                {
+                    triangles.at(cursors.at(positionVertex.at(indices.at(i)))++) = static_cast<uint32_t>(i / 3);
+                }
+            }
+    };
+
+    /// Whether moving a position onto another would turn any of the surrounding triangles over
+    bool HasTriangleFlips(const SimplifyState &state,
+                          const PositionAdjacency &adjacency,
+                          const std::vector<uint32_t> &indices,
+                          const std::vector<uint32_t> &collapseRemap,
+                          const uint32_t fromPosition,
+                          const uint32_t toPosition)
+    {
+        const glm::dvec3 &newPosition = state.positions.at(toPosition);
+        for (size_t i = adjacency.offsets.at(fromPosition); i < adjacency.offsets.at(fromPosition + 1); i++)
+        {
+            const size_t firstIndex = static_cast<size_t>(adjacency.triangles.at(i)) * 3;
+            std::array<uint32_t, 3> cornerPositions{};
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                cornerPositions.at(corner) = state.positionVertex.at(collapseRemap.at(indices.at(firstIndex + corner)));
+            }
+            // Triangles on the collapsed edge disappear, and ones made degenerate earlier this pass don't matter
+            if (cornerPositions.at(0) == cornerPositions.at(1) ||
+                cornerPositions.at(1) == cornerPositions.at(2) ||
+                cornerPositions.at(0) == cornerPositions.at(2) ||
+                std::ranges::find(cornerPositions, toPosition) != cornerPositions.end())
+            {
+                continue;
+            }
+            std::array<glm::dvec3, 3> oldCorners{};
+            std::array<glm::dvec3, 3> newCorners{};
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                oldCorners.at(corner) = state.positions.at(cornerPositions.at(corner));
+                newCorners.at(corner) = cornerPositions.at(corner) == fromPosition ? newPosition
+                                                                                   : oldCorners.at(corner);
+            }
+            const glm::dvec3 oldNormal = glm::cross(oldCorners.at(1) - oldCorners.at(0),
+                                                    oldCorners.at(2) - oldCorners.at(0));
+            const glm::dvec3 newNormal = glm::cross(newCorners.at(1) - newCorners.at(0),
+                                                    newCorners.at(2) - newCorners.at(0));
+            if (glm::dot(oldNormal, newNormal) <= 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+float MeshSimplifier::Simplify(const std::vector<glm::vec3> &positions,
+                               std::vector<uint32_t> &indices,
+                               const size_t targetIndexCount,
+                               const float maxError)
+{
+    SimplifyState state(positions, indices);
+    const double errorLimit = static_cast<double>(maxError) * static_cast<double>(maxError);
+    double resultError = 0;
+    std::vector<Collapse> collapses{};
+    std::vector<uint32_t> collapseRemap(positions.size());
+    std::vector<bool> collapseLocked(positions.size());
+
+    // Each pass collapses as many edges as it can without two collapses touching the same vertex, cheapest first
+    while (indices.size() > targetIndexCount)
+    {
+        collapses.clear();
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t a = indices.at(i + corner);
+                const uint32_t b = indices.at(i + ((corner + 1) % 3));
+                Collapse best{
+                    .from = NO_VERTEX,
+                    .to = NO_VERTEX,
+                    .error = 0,
+                };
+                for (const auto &[from, to]: {std::pair{a, b}, std::pair{b, a}})
+                {
+                    if (!state.CanCollapse(from, to))
+                    {
+                        continue;
+                    }
+                    const double error = state.quadrics.at(state.positionVertex.at(from))
+                                                 .GetError(state.positions.at(to));
+                    if (best.from == NO_VERTEX || error < best.error)
+                    {
+                        best = {
+                            .from = from,
+                            .to = to,
+                            .error = error,
+                        };
+                    }
+                }
+                if (best.from != NO_VERTEX)
+                {
+                    collapses.push_back(best);
+                }
+            }
+        }
+        if (collapses.empty())
+        {
+            break;
+        }
+        std::ranges::sort(collapses, [](const Collapse &a, const Collapse &b) { return a.error < b.error; });
+
+        const PositionAdjacency adjacency(indices, state.positionVertex);
+        std::iota(collapseRemap.begin(), collapseRemap.end(), 0);
+        std::fill(collapseLocked.begin(), collapseLocked.end(), false);
+        const size_t triangleGoal = (indices.size() - targetIndexCount) / 3;
+        size_t collapsedTriangles = 0;
+        for (const Collapse &collapse: collapses)
+        {
+            if (collapse.error > errorLimit || collapsedTriangles >= triangleGoal)
+            {
+                break;
+            }
+            const uint32_t fromPosition = state.positionVertex.at(collapse.from);
+            const uint32_t toPosition = state.positionVertex.at(collapse.to);
+            if (collapseLocked.at(fromPosition) || collapseLocked.at(toPosition))
+            {
+                continue;
+            }
+            uint32_t seamFrom = NO_VERTEX;
+            uint32_t seamTo = NO_VERTEX;
+            if (state.kinds.at(collapse.from) == VertexKind::SEAM)
+            {
+                seamFrom = state.wedge.at(collapse.from);
+                seamTo = state.GetSeamTarget(collapse.from, collapse.to);
+                if (seamTo == NO_VERTEX)
+                {
+                    continue;
+                }
+            }
+            if (HasTriangleFlips(state, adjacency, indices, collapseRemap, fromPosition, toPosition))
+            {
+                continue;
+            }
+
+            collapseRemap.at(collapse.from) = collapse.to;
+            if (seamFrom != NO_VERTEX)
+            {
+                collapseRemap.at(seamFrom) = seamTo;
+            }
+            collapseLocked.at(fromPosition) = true;
+            collapseLocked.at(toPosition) = true;
+            state.quadrics.at(toPosition).Add(state.quadrics.at(fromPosition));
+            // Collapsing an edge removes the triangle on each side of it, and a border edge only has one
+            collapsedTriangles += state.kinds.at(collapse.from) == VertexKind::BORDER ? 1 : 2;
+            resultError = std::max(resultError, collapse.error);
+        }
+        if (collapsedTriangles == 0)
+        {
+            break;
+        }
+
+        state.RemapLoops(collapseRemap);
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            const uint32_t a = collapseRemap.at(indices.at(i));
+            const uint32_t b = collapseRemap.at(indices.at(i + 1));
+            const uint32_t c = collapseRemap.at(indices.at(i + 2));
+            const uint32_t positionA = state.positionVertex.at(a);
+            const uint32_t positionB = state.positionVertex.at(b);
+            const uint32_t positionC = state.positionVertex.at(c);
+            if (positionA == positionB || positionB == positionC || positionA == positionC)
+            {
+                continue;
+            }
+            indices.at(writeIndex) = a;
+            indices.at(writeIndex + 1) = b;
+            indices.at(writeIndex + 2) = c;
+            writeIndex += 3;
+        }
+        indices.resize(writeIndex);
+    }
+
+    return static_cast<float>(std::sqrt(resultError));
+}
+
+float MeshSimplifier::GetMeshScale(const std::vector<glm::vec3> &positions)
+{
+    if (positions.empty())
+    {
+        return 0;
+    }
+    glm::vec3 minPosition = positions.at(0);
+    glm::vec3 maxPosition = positions.at(0);
+    for (const glm::vec3 &position: positions)
+    {
+        minPosition = glm::min(minPosition, position);
+        maxPosition = glm::max(maxPosition, position);
+    }
+    const glm::vec3 size = maxPosition - minPosition;
+    return std::max({size.x, size.y, size.z});
+}
@@ -0,0 +1,267 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <half.h>
+#include <ImathConfig.h>
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+#include <libassets/util/MipGenerator.h>
+#include <libassets/util/ThreadPool.h>
+#include <vector>
+
+namespace
+{
+    /// Levels with fewer texels than this are filtered on the calling thread
+    constexpr size_t MIN_TEXELS_FOR_THREADS = 64 * 1024;
+    /// Number of entries in the linear to sRGB table, enough to stay well under one 8-bit step of error
+    constexpr size_t LINEAR_TO_SRGB_TABLE_SIZE = 16384;
+
+    using Texel = std::array<float, 4>;
+
+    struct SrgbTables
+    {
+            std::array<float, 256> toLinear;
+            std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE> fromLinear;
+    };
+
+    const SrgbTables &GetSrgbTables()
+    {
+        static const SrgbTables tables = [] {
+            SrgbTables newTables{};
+            for (size_t i = 0; i < newTables.toLinear.size(); i++)
+            {
+                const float srgb = static_cast<float>(i) / 255.0f;
+                newTables.toLinear.at(i) = srgb <= 0.04045f ? srgb / 12.92f
+                                                            : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+            }
+            for (size_t i = 0; i < newTables.fromLinear.size(); i++)
+            {
+                const float linear = static_cast<float>(i) / static_cast<float>(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+                const float srgb = linear <= 0.0031308f ? linear * 12.92f
+                                                        : (1.055f * std::pow(linear, 1.0f / 2.4f)) - 0.055f;
+                newTables.fromLinear.at(i) = static_cast<uint8_t>(std::lround(std::clamp(srgb, 0.0f, 1.0f) * 255.0f));
+            }
+            return newTables;
+        }();
+        return tables;
+    }
+
+    /// sRGB color with linear alpha, 8 bits per channel
+    struct Rgba8Format
+    {
+            static constexpr size_t TEXEL_SIZE = 4;
+
+            static Texel Load(const uint8_t *texel)
+            {
+                const SrgbTables &tables = GetSrgbTables();
+                return {
+                    tables.toLinear[texel[0]],
+                    tables.toLinear[texel[1]],
+                    tables.toLinear[texel[2]],
+                    static_cast<float>(texel[3]) / 255.0f,
+                };
+            }
+
+            static void Store(const Texel &value, uint8_t *texel)
+            {
+                const SrgbTables &tables = GetSrgbTables();
+                for (size_t channel = 0; channel < 3; channel++)
+                {
+                    const float index = std::clamp(value[channel], 0.0f, 1.0f) *
+                                        static_cast<float>(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+                    texel[channel] = tables.fromLinear[static_cast<size_t>(index + 0.5f)];
+                }
+                texel[3] = static_cast<uint8_t>(std::lround(std::clamp(value[3], 0.0f, 1.0f) * 255.0f));
+            }
+    };
+
+    /// Linear color and alpha, one half float per channel
+    struct RgbaF16Format
+    {
+            static constexpr size_t TEXEL_SIZE = 4 * sizeof(IMATH_NAMESPACE::half);
+
+            static Texel Load(const uint8_t *texel)
+            {
+#ifdef __F16C__
+                // Convert all 4 channels in one instruction
+                Texel value{};
+                _mm_storeu_ps(value.data(), _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(texel))));
+                return value;
+#else
+                std::array<IMATH_NAMESPACE::half, 4> channels{};
+                std::memcpy(channels.data(), texel, TEXEL_SIZE);
+                return {channels[0], channels[1], channels[2], channels[3]};
+#endif
+            }
+
+            static void Store(const Texel &value, uint8_t *texel)
+            {
+#ifdef __F16C__
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(texel),
+                                 _mm_cvtps_ph(_mm_loadu_ps(value.data()), _MM_FROUND_TO_NEAREST_INT));
+#else
+                const std::array<IMATH_NAMESPACE::half, 4> channels = {
+                    IMATH_NAMESPACE::half(value[0]),
+                    IMATH_NAMESPACE::half(value[1]),
+                    IMATH_NAMESPACE::half(value[2]),
+                    IMATH_NAMESPACE::half(value[3]),
+                };
+                std::memcpy(texel, channels.data(), TEXEL_SIZE);
+#endif
+            }
+    };
+
+    /**
+     * Box filter a range of rows of the destination level.
+     * Each destination texel covers a whole number of source texels, so odd sizes spread the extra row or column over
+     * the neighboring texels instead of dropping it.
+     */
+    template<typename Format> void DownsampleRows(const uint8_t *source,
+                                                  const uint32_t sourceWidth,
+                                                  const uint32_t sourceHeight,
+                                                  uint8_t *destination,
+                                                  const uint32_t destinationWidth,
+                                                  const uint32_t destinationHeight,
+                                                  const uint32_t firstRow,
+                                                  const uint32_t endRow)
+    {
+        for (uint32_t y = firstRow; y < endRow; y++)
+        {
+            const uint32_t sourceY0 = y * sourceHeight / destinationHeight;
+            const uint32_t sourceY1 = std::max(sourceY0 + 1, (y + 1) * sourceHeight / destinationHeight);
+            for (uint32_t x = 0; x < destinationWidth; x++)
+            {
+                const uint32_t sourceX0 = x * sourceWidth / destinationWidth;
+                const uint32_t sourceX1 = std::max(sourceX0 + 1, (x + 1) * sourceWidth / destinationWidth);
+
+                Texel weightedSum{};
+                Texel plainSum{};
+                for (uint32_t sourceY = sourceY0; sourceY < sourceY1; sourceY++)
+                {
+                    const uint8_t *row = source + (static_cast<size_t>(sourceY) * sourceWidth * Format::TEXEL_SIZE);
+                    for (uint32_t sourceX = sourceX0; sourceX < sourceX1; sourceX++)
+                    {
+                        const Texel texel = Format::Load(row + (sourceX * Format::TEXEL_SIZE));
+                        for (size_t channel = 0; channel < 3; channel++)
+                        {
+                            weightedSum[channel] += texel[channel] * texel[3];
+                            plainSum[channel] += texel[channel];
+                        }
+                        weightedSum[3] += texel[3];
+                    }
+                }
+
+                const float texelCount = static_cast<float>((sourceX1 - sourceX0) * (sourceY1 - sourceY0));
+                Texel result{};
+                for (size_t channel = 0; channel < 3; channel++)
+                {
+                    // Fully transparent areas keep their plain average so that the color is still sensible
+                    result[channel] = weightedSum[3] > 0.0f ? weightedSum[channel] / weightedSum[3]
+                                                            : plainSum[channel] / texelCount;
+                }
+                result[3] = weightedSum[3] / texelCount;
+                Format::Store(result,
+                              destination +
+                                      ((static_cast<size_t>(y) * destinationWidth + x) * Format::TEXEL_SIZE));
+            }
+        }
+    }
+
+    template<typename Format> void GenerateLevels(const uint8_t *basePixels,
+                                                  const uint32_t width,
+                                                  const uint32_t height,
+                                                  std::vector<uint8_t> &outLevels)
+    {
+        const uint32_t levelCount = MipGenerator::GetLevelCount(width, height);
+        size_t levelsSize = 0;
+        for (uint32_t level = 1; level < levelCount; level++)
+        {
+            levelsSize += static_cast<size_t>(MipGenerator::GetLevelSize(width, level)) *
+                          MipGenerator::GetLevelSize(height, level) *
+                          Format::TEXEL_SIZE;
+        }
+        // Size the output up front so that the previous level stays put while the next one is written
+        size_t offset = outLevels.size();
+        outLevels.resize(offset + levelsSize);
+
+        const uint8_t *source = basePixels;
+        uint32_t sourceWidth = width;
+        uint32_t sourceHeight = height;
+        for (uint32_t level = 1; level < levelCount; level++)
+        {
+            const uint32_t levelWidth = MipGenerator::GetLevelSize(width, level);
+            const uint32_t levelHeight = MipGenerator::GetLevelSize(height, level);
+            uint8_t *destination = outLevels.data() + offset;
+            const size_t texelCount = static_cast<size_t>(levelWidth) * levelHeight;
+            if (texelCount < MIN_TEXELS_FOR_THREADS)
+            {
+                DownsampleRows<Format>(source,
+                                       sourceWidth,
+                                       sourceHeight,
+                                       destination,
+                                       levelWidth,
+                                       levelHeight,
+                                       0,
+                                       levelHeight);
+            } else
+            {
+                ThreadPool &pool = ThreadPool::GetShared();
+                // The calling thread works on the level as well
+                const uint32_t rowsPerTask = std::max<uint32_t>(
+                        1,
+                        levelHeight / static_cast<uint32_t>((pool.GetThreadCount() + 1) * 4));
+                const size_t taskCount = (levelHeight + rowsPerTask - 1) / rowsPerTask;
+                pool.Run(taskCount, [=](const size_t task) {
+                    const uint32_t firstRow = static_cast<uint32_t>(task) * rowsPerTask;
+                    DownsampleRows<Format>(source,
+                                           sourceWidth,
+                                           sourceHeight,
+                                           destination,
+                                           levelWidth,
+                                           levelHeight,
+                                           firstRow,
+                                           std::min(firstRow + rowsPerTask, levelHeight));
+                });
+            }
+            source = destination;
+            sourceWidth = levelWidth;
+            sourceHeight = levelHeight;
+            offset += texelCount * Format::TEXEL_SIZE;
+        }
+    }
+} // namespace
+
+uint32_t MipGenerator::GetLevelCount(const uint32_t width, const uint32_t height)
+{
+    return std::bit_width(std::max({width, height, 1u}));
+}
+
+uint32_t MipGenerator::GetLevelSize(const uint32_t baseSize, const uint32_t level)
+{
+    return std::max(baseSize >> level, 1u);
+}
+
+void MipGenerator::GenerateRGBA8(const uint8_t *basePixels,
+                                 const uint32_t width,
+                                 const uint32_t height,
+                                 std::vector<uint8_t> &outLevels)
+{
+    GenerateLevels<Rgba8Format>(basePixels, width, height, outLevels);
+}
+
+void MipGenerator::GenerateRGBAF16(const uint8_t *basePixels,
+                                   const uint32_t width,
+                                   const uint32_t height,
+                                   std::vector<uint8_t> &outLevels)
+{
+    GenerateLevels<RgbaF16Format>(basePixels, width, height, outLevels);
+}
@@ -0,0 +1,409 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <libassets/util/QuickHull.h>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t NO_POINT = UINT32_MAX;
+
+    struct Face
+    {
+            std::array<uint32_t, 3> vertices{};
+            glm::dvec3 normal{};
+            /// The distance of the plane from the origin along normal
+            double offset = 0;
+            /// The points outside of this face, which it is the nearest face to
+            std::vector<uint32_t> outside{};
+            uint32_t farthestPoint = NO_POINT;
+            double farthestDistance = 0;
+            bool removed = false;
+
+            [[nodiscard]] double GetDistance(const glm::dvec3 &point) const
+            {
+                return glm::dot(normal, point) - offset;
+            }
+    };
+
+    uint64_t GetEdgeKey(const uint32_t from, const uint32_t to)
+    {
+        return (static_cast<uint64_t>(from) << 32) | to;
+    }
+
+    class HullBuilder
+    {
+        public:
+            HullBuilder(const std::vector<glm::vec3> &points, const double tolerance):
+                tolerance(tolerance),
+                vertexFaceCounts(points.size(), 0)
+            {
+                positions.reserve(points.size());
+                for (const glm::vec3 &point: points)
+                {
+                    positions.emplace_back(point);
+                }
+            }
+
+            /// Create the starting tetrahedron from the most extreme points
+            [[nodiscard]] bool CreateSimplex()
+            {
+                std::array<uint32_t, 6> extremes{};
+                for (uint32_t i = 0; i < positions.size(); i++)
+                {
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        if (positions.at(i)[axis] < positions.at(extremes.at(axis * 2))[axis])
+                        {
+                            extremes.at(axis * 2) = i;
+                        }
+                        if (positions.at(i)[axis] > positions.at(extremes.at((axis * 2) + 1))[axis])
+                        {
+                            extremes.at((axis * 2) + 1) = i;
+                        }
+                    }
+                }
+                uint32_t first = 0;
+                uint32_t second = 0;
+                double bestDistance = 0;
+                for (const uint32_t a: extremes)
+                {
+                    for (const uint32_t b: extremes)
+                    {
+                        const double distance = glm::distance(positions.at(a), positions.at(b));
+                        if (distance > bestDistance)
+                        {
+                            bestDistance = distance;
+                            first = a;
+                            second = b;
+                        }
+                    }
+                }
+                if (bestDistance <= tolerance)
+                {
+                    return false;
+                }
+
+                const glm::dvec3 lineDirection = glm::normalize(positions.at(second) - positions.at(first));
+                const uint32_t third = FindFarthest([&](const glm::dvec3 &position) {
+                    const glm::dvec3 offset = position - positions.at(first);
+                    return glm::length(offset - (lineDirection * glm::dot(offset, lineDirection)));
+                });
+                if (third == NO_POINT)
+                {
+                    return false; // Every point is on one line
+                }
+                const glm::dvec3 planeCross = glm::cross(positions.at(second) - positions.at(first),
+                                                         positions.at(third) - positions.at(first));
+                const double planeCrossLength = glm::length(planeCross);
+                if (planeCrossLength <= 0)
+                {
+                    return false;
+                }
+                const glm::dvec3 planeNormal = planeCross / planeCrossLength;
+                const uint32_t fourth = FindFarthest([&](const glm::dvec3 &position) {
+                    return std::abs(glm::dot(planeNormal, position - positions.at(first)));
+                });
+                if (fourth == NO_POINT)
+                {
+                    return false; // Every point is on one plane
+                }
+
+                const std::array<uint32_t, 4> simplex = {first, second, third, fourth};
+                const glm::dvec3 center = (positions.at(first) +
+                                           positions.at(second) +
+                                           positions.at(third) +
+                                           positions.at(fourth)) /
+                                          4.0;
+                std::vector<uint32_t> newFaces{};
+                for (size_t skipped = 0; skipped < 4; skipped++)
+                {
+                    std::array<uint32_t, 3> corners{};
+                    size_t cornerIndex = 0;
+                    for (size_t i = 0; i < 4; i++)
+                    {
+                        if (i != skipped)
+                        {
+                            corners.at(cornerIndex++) = simplex.at(i);
+                        }
+                    }
+                    // Wind every face so that it faces away from the middle
+                    const glm::dvec3 normal = glm::cross(positions.at(corners.at(1)) - positions.at(corners.at(0)),
+                                                         positions.at(corners.at(2)) - positions.at(corners.at(0)));
+                    if (glm::dot(normal, center - positions.at(corners.at(0))) > 0)
+                    {
+                        std::swap(corners.at(1), corners.at(2));
+                    }
+                    newFaces.push_back(AddFace(corners));
+                }
+
+                std::vector<uint32_t> remaining{};
+                for (uint32_t i = 0; i < positions.size(); i++)
+                {
+                    if (std::ranges::find(simplex, i) == simplex.end())
+                    {
+                        remaining.push_back(i);
+                    }
+                }
+                AssignPoints(remaining, newFaces);
+                return true;
+            }
+
+            /// Add the farthest outside point until there are none left or the hull has maxVertices vertices
+            void Expand(const size_t maxVertices)
+            {
+                size_t vertexCount = 4;
+                while (vertexCount < maxVertices)
+                {
+                    uint32_t conflictFace = NO_POINT;
+                    for (uint32_t i = 0; i < faces.size(); i++)
+                    {
+                        const Face &face = faces.at(i);
+                        if (!face.removed &&
+                            face.farthestPoint != NO_POINT &&
+                            (conflictFace == NO_POINT ||
+                             face.farthestDistance > faces.at(conflictFace).farthestDistance))
+                        {
+                            conflictFace = i;
+                        }
+                    }
+                    if (conflictFace == NO_POINT)
+                    {
+                        break;
+                    }
+                    AddPoint(conflictFace);
+
+                    vertexCount = static_cast<size_t>(std::ranges::count_if(vertexFaceCounts, [](const uint32_t count) {
+                        return count > 0;
+                    }));
+                }
+            }
+
+            void GetHull(QuickHull::Hull &outHull) const
+            {
+                outHull.vertices.clear();
+                outHull.indices.clear();
+                std::vector<uint32_t> remap(positions.size(), NO_POINT);
+                for (const Face &face: faces)
+                {
+                    if (face.removed)
+                    {
+                        continue;
+                    }
+                    for (const uint32_t vertex: face.vertices)
+                    {
+                        if (remap.at(vertex) == NO_POINT)
+                        {
+                            remap.at(vertex) = static_cast<uint32_t>(outHull.vertices.size());
+                            outHull.vertices.emplace_back(positions.at(vertex));
+                        }
+                        outHull.indices.push_back(remap.at(vertex));
+                    }
+                }
+            }
+
+        private:
+            double tolerance;
+            std::vector<glm::dvec3> positions{};
+            std::vector<Face> faces{};
+            /// The face on the left of each directed edge
+            std::unordered_map<uint64_t, uint32_t> edgeFaces{};
+            std::vector<uint32_t> vertexFaceCounts;
+
+            /// Find the point with the largest distance, if it is more than the tolerance
+            template<typename DistanceFunction> [[nodiscard]] uint32_t FindFarthest(const DistanceFunction &distance)
+            {
+                uint32_t farthest = NO_POINT;
+                double farthestDistance = tolerance;
+                for (uint32_t i = 0; i < positions.size(); i++)
+                {
+                    const double pointDistance = distance(positions.at(i));
+                    if (pointDistance > farthestDistance)
+                    {
+                        farthestDistance = pointDistance;
+                        farthest = i;
+                    }
+                }
+                return farthest;
+            }
+
+            uint32_t AddFace(const std::array<uint32_t, 3> &corners)
+            {
+                Face face{};
+                face.vertices = corners;
+                const glm::dvec3 normal = glm::cross(positions.at(corners.at(1)) - positions.at(corners.at(0)),
+                                                     positions.at(corners.at(2)) - positions.at(corners.at(0)));
+                const double normalLength = glm::length(normal);
+                if (normalLength > 0)
+                {
+                    face.normal = normal / normalLength;
+                    face.offset = glm::dot(face.normal, positions.at(corners.at(0)));
+                }
+                const uint32_t faceIndex = static_cast<uint32_t>(faces.size());
+                for (size_t i = 0; i < 3; i++)
+                {
+                    edgeFaces[GetEdgeKey(corners.at(i), corners.at((i + 1) % 3))] = faceIndex;
+                    vertexFaceCounts.at(corners.at(i))++;
+                }
+                faces.push_back(face);
+                return faceIndex;
+            }
+
+            void RemoveFace(const uint32_t faceIndex)
+            {
+                Face &face = faces.at(faceIndex);
+                face.removed = true;
+                for (size_t i = 0; i < 3; i++)
+                {
+                    edgeFaces.erase(GetEdgeKey(face.vertices.at(i), face.vertices.at((i + 1) % 3)));
+                    vertexFaceCounts.at(face.vertices.at(i))--;
+                }
+                face.outside.clear();
+                face.outside.shrink_to_fit();
+            }
+
+            /// Give each point to the face it is farthest outside of, dropping points that are inside every face
+            void AssignPoints(const std::vector<uint32_t> &points, const std::vector<uint32_t> &candidateFaces)
+            {
+                for (const uint32_t point: points)
+                {
+                    uint32_t bestFace = NO_POINT;
+                    double bestDistance = tolerance;
+                    for (const uint32_t faceIndex: candidateFaces)
+                    {
+                        const double distance = faces.at(faceIndex).GetDistance(positions.at(point));
+                        if (distance > bestDistance)
+                        {
+                            bestDistance = distance;
+                            bestFace = faceIndex;
+                        }
+                    }
+                    if (bestFace == NO_POINT)
+                    {
+                        continue;
+                    }
+                    Face &face = faces.at(bestFace);
+                    face.outside.push_back(point);
+                    if (bestDistance > face.farthestDistance)
+                    {
+                        face.farthestDistance = bestDistance;
+                        face.farthestPoint = point;
+                    }
+                }
+            }
+
+            void AddPoint(const uint32_t conflictFace)
+            {
+                const uint32_t point = faces.at(conflictFace).farthestPoint;
+                const glm::dvec3 &position = positions.at(point);
+
+                // The faces the point can see form a connected region, found by walking across edges.
+                // Faces the point is coplanar with (within the tolerance) are merged into the region too, so they get
+                // triangulated again together with the point instead of leaving slivers and a crease in a flat side.
+                std::vector<uint32_t> visibleFaces = {conflictFace};
+                std::vector<bool> visible(faces.size(), false);
+                visible.at(conflictFace) = true;
+                for (size_t i = 0; i < visibleFaces.size(); i++)
+                {
+                    const Face &face = faces.at(visibleFaces.at(i));
+                    for (size_t edge = 0; edge < 3; edge++)
+                    {
+                        const uint64_t twinKey = GetEdgeKey(face.vertices.at((edge + 1) % 3), face.vertices.at(edge));
+                        const auto twin = edgeFaces.find(twinKey);
+                        if (twin == edgeFaces.end() || visible.at(twin->second))
+                        {
+                            continue;
+                        }
+                        if (faces.at(twin->second).GetDistance(position) > -tolerance)
+                        {
+                            visible.at(twin->second) = true;
+                            visibleFaces.push_back(twin->second);
+                        }
+                    }
+                }
+
+                // Edges between a visible and a hidden face form the horizon, which gets joined to the point
+                std::vector<std::array<uint32_t, 2>> horizon{};
+                std::vector<uint32_t> orphans{};
+                for (const uint32_t faceIndex: visibleFaces)
+                {
+                    const Face &face = faces.at(faceIndex);
+                    for (size_t edge = 0; edge < 3; edge++)
+                    {
+                        const uint32_t from = face.vertices.at(edge);
+                        const uint32_t to = face.vertices.at((edge + 1) % 3);
+                        const auto twin = edgeFaces.find(GetEdgeKey(to, from));
+                        if (twin == edgeFaces.end() || !visible.at(twin->second))
+                        {
+                            horizon.push_back({from, to});
+                        }
+                    }
+                    for (const uint32_t outsidePoint: face.outside)
+                    {
+                        if (outsidePoint != point)
+                        {
+                            orphans.push_back(outsidePoint);
+                        }
+                    }
+                }
+                for (const uint32_t faceIndex: visibleFaces)
+                {
+                    RemoveFace(faceIndex);
+                }
+
+                std::vector<uint32_t> newFaces{};
+                newFaces.reserve(horizon.size());
+                for (const std::array<uint32_t, 2> &edge: horizon)
+                {
+                    newFaces.push_back(AddFace({edge.at(0), edge.at(1), point}));
+                }
+                AssignPoints(orphans, newFaces);
+            }
+    };
+} // namespace
+
+bool QuickHull::Compute(const std::vector<glm::vec3> &points,
+                        const float tolerance,
+                        const size_t maxVertices,
+                        Hull &outHull)
+{
+    if (points.size() < 4)
+    {
+        return false;
+    }
+    HullBuilder builder(points, tolerance);
+    if (!builder.CreateSimplex())
+    {
+        return false;
+    }
+    builder.Expand(std::max<size_t>(maxVertices, 4));
+    builder.GetHull(outHull);
+    return true;
+}
+
+float QuickHull::GetVolume(const Hull &hull)
+{
+    if (hull.vertices.empty())
+    {
+        return 0;
+    }
+    // Relative to a vertex to keep precision far from the origin
+    const glm::dvec3 reference = glm::dvec3(hull.vertices.at(0));
+    double volume = 0;
+    for (size_t i = 0; i < hull.indices.size(); i += 3)
+    {
+        const glm::dvec3 a = glm::dvec3(hull.vertices.at(hull.indices.at(i))) - reference;
+        const glm::dvec3 b = glm::dvec3(hull.vertices.at(hull.indices.at(i + 1))) - reference;
+        const glm::dvec3 c = glm::dvec3(hull.vertices.at(hull.indices.at(i + 2))) - reference;
+        volume += glm::dot(a, glm::cross(b, c));
+    }
+    return static_cast<float>(volume / 6.0);
+}
@@ -3,20 +3,39 @@
 //
 
 #include <algorithm>
-#include <cassert>
+#include <condition_variable>
 #include <cstddef>
 #include <filesystem>
 #include <format>
+#include <iterator>
 #include <libassets/asset/DataAsset.h>
 #include <libassets/type/Param.h>
+#include <libassets/util/AssetPack.h>
+#include <libassets/util/DirectoryWatcher.h>
+#include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
 #include <libassets/util/SearchPathManager.h>
+#include <libassets/util/ThreadPool.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+SearchPathManager::SearchPathManager():
+    pathIndex(std::make_shared<PathIndex>()),
+    listingCache(std::make_shared<ListingCache>())
+{}
+
 SearchPathManager::SearchPathManager(DataAsset &gameConfig,
                                      const std::string &executableFolder,
-                                     const std::string &configParentFolder)
+                                     const std::string &configParentFolder):
+    pathIndex(std::make_shared<PathIndex>()),
+    listingCache(std::make_shared<ListingCache>())
 {
     ParamVector defaultParamVectorValue{};
     ParamVector &searchPathData = gameConfig.data["search_paths"].GetRef<ParamVector>(defaultParamVectorValue);
@@ -25,7 +44,7 @@ SearchPathManager::SearchPathManager(DataAsset &gameConfig,
         if (p.GetType() == Param::ParamType::PARAM_TYPE_STRING)
         {
             const std::string searchPath = executableFolder + "/" + p.Get<std::string>("engine");
-            assetPaths.push_back(searchPath);
+            AddSearchPath(searchPath);
         } else if (p.GetType() == Param::ParamType::PARAM_TYPE_KV_LIST)
         {
             KvList defaultKvListValue{};
@@ -35,98 +54,369 @@ SearchPathManager::SearchPathManager(DataAsset &gameConfig,
             const std::string path = searchPathKvl["search_path"].Get<std::string>("engine");
             if (pathType == "relative_to_executable_directory")
             {
-                assetPaths.push_back(std::format("{}/{}", executableFolder, path));
+                AddSearchPath(std::format("{}/{}", executableFolder, path));
             } else if (pathType == "absolute")
             {
-                assetPaths.push_back(path);
+                AddSearchPath(path);
             } else if (pathType == "relative_to_game_config_parent_directory")
             {
-                assetPaths.push_back(std::format("{}/{}", configParentFolder, path));
+                AddSearchPath(std::format("{}/{}", configParentFolder, path));
             }
         }
     }
 }
 
-std::string SearchPathManager::GetAssetPath(const std::string &relPath) const
+void SearchPathManager::AddSearchPath(const std::string &path)
 {
-    for (const std::string &searchPath: assetPaths)
+    std::shared_ptr<AssetPack> pack = nullptr;
+    if (AssetPack::IsPackPath(path))
     {
-        const std::string p = std::format("{}/{}", searchPath, relPath);
-        if (std::filesystem::exists(std::filesystem::path(p)))
+        Error::ErrorCode e = Error::ErrorCode::OK;
+        pack = AssetPack::Mount(path, e);
+        if (e != Error::ErrorCode::OK)
         {
-            return p;
+            return;
         }
     }
-    return "";
+    assetPaths.push_back(path);
+    assetPacks.push_back(pack);
 }
 
-std::vector<std::string> SearchPathManager::ScanFolder(const std::string &directoryPath,
-                                                       const std::string &extension,
-                                                       const bool isRoot)
+std::string SearchPathManager::NormalizeRelativePath(const std::string &relPath)
+{
+    std::string normalized = std::filesystem::path(relPath).lexically_normal().generic_string();
+    while (normalized.starts_with('/'))
+    {
+        normalized.erase(0, 1);
+    }
+    while (normalized.ends_with('/'))
+    {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+void SearchPathManager::BuildIndex(PathIndex &index) const
 {
-    std::vector<std::string> files;
-    try
+    index.paths.clear();
+    // Marked valid before walking so that a change reported mid-walk still invalidates the result
+    index.valid = true;
+    if (index.watcher == nullptr)
     {
-        for (const std::filesystem::directory_entry &entry: std::filesystem::directory_iterator(directoryPath))
+        index.watcher = std::make_unique<DirectoryWatcher>([&index] { index.valid = false; });
+    }
+    IndexFolder(index, "");
+    Logger::Verbose("Indexed {} asset paths", index.paths.size());
+}
+
+void SearchPathManager::IndexFolder(PathIndex &index, const std::string &folder) const
+{
+    const std::string prefix = folder.empty() ? "" : folder + "/";
+    for (size_t i = 0; i < assetPaths.size(); i++)
+    {
+        const std::string &searchPath = assetPaths.at(i);
+        if (assetPacks.at(i) != nullptr)
         {
-            if (entry.is_regular_file())
+            for (const AssetPack::Entry &entry: assetPacks.at(i)->GetEntries())
             {
-                if (entry.path().extension() == extension)
+                if (entry.path.starts_with(prefix))
                 {
-                    files.push_back(entry.path().string());
+                    index.paths.try_emplace(entry.path, std::format("{}/{}", searchPath, entry.path));
                 }
-            } else if (entry.is_directory())
+            }
+            continue;
+        }
+
+        std::error_code error{};
+        if (!std::filesystem::is_directory(searchPath, error))
+        {
+            continue;
+        }
+        (void)index.watcher->AddDirectory(searchPath);
+        // The folder and the folders leading to it are paths in the index as well
+        std::filesystem::path directory = searchPath;
+        for (const std::filesystem::path &part: std::filesystem::path(folder))
+        {
+            directory /= part;
+            if (!std::filesystem::is_directory(directory, error))
+            {
+                break;
+            }
+            const std::string relPath = directory.lexically_relative(searchPath).generic_string();
+            index.paths.try_emplace(relPath, std::format("{}/{}", searchPath, relPath));
+        }
+        if (error || !std::filesystem::is_directory(directory, error))
+        {
+            continue;
+        }
+        std::filesystem::recursive_directory_iterator iterator(directory,
+                                                               std::filesystem::directory_options::
+                                                                       skip_permission_denied,
+                                                               error);
+        for (; !error && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(error))
+        {
+            const std::filesystem::directory_entry &entry = *iterator;
+            const bool isDirectory = entry.is_directory(error);
+            if (isDirectory)
+            {
+                (void)index.watcher->AddDirectory(entry.path().string());
+            }
+            if (isDirectory || entry.is_regular_file(error))
             {
-                const std::vector<std::string> subfolderFiles = ScanFolder(entry.path().string(), extension, false);
-                files.insert(files.end(), subfolderFiles.begin(), subfolderFiles.end());
+                const std::string relPath = entry.path().lexically_relative(searchPath).generic_string();
+                index.paths.try_emplace(relPath, std::format("{}/{}", searchPath, relPath));
             }
         }
-    } catch (const std::filesystem::filesystem_error &exception)
+        if (error)
+        {
+            Logger::Error("Failed to index search path \"{}\": {}", searchPath, error.message());
+        }
+    }
+}
+
+void SearchPathManager::RefreshIndexFolder(const std::string &folder) const
+{
+    if (folder.empty() || folder == ".")
+    {
+        InvalidateIndex();
+        return;
+    }
+    const std::unique_lock lock(pathIndex->mutex);
+    if (!pathIndex->valid)
+    {
+        return; // The whole index is rebuilt on the next lookup anyway
+    }
+    const auto isInside = [](const std::string &path, const std::string &parent) {
+        return path.starts_with(parent) && (path.size() == parent.size() || path.at(parent.size()) == '/');
+    };
+    // The folders leading to the folder may have been created or removed along with it
+    std::erase_if(pathIndex->paths, [&folder, &isInside](const std::pair<const std::string, std::string> &entry) {
+        return isInside(entry.first, folder) || isInside(folder, entry.first);
+    });
+    IndexFolder(*pathIndex, folder);
+}
+
+void SearchPathManager::RefreshIndex() const
+{
+    const std::unique_lock lock(pathIndex->mutex);
+    BuildIndex(*pathIndex);
+}
+
+void SearchPathManager::InvalidateIndex() const
+{
+    pathIndex->valid = false;
+}
+
+std::string SearchPathManager::GetAssetPath(const std::string &relPath) const
+{
+    const std::string key = NormalizeRelativePath(relPath);
+    if (!pathIndex->valid)
+    {
+        const std::unique_lock lock(pathIndex->mutex);
+        if (!pathIndex->valid)
+        {
+            BuildIndex(*pathIndex);
+        }
+    }
+    const std::shared_lock lock(pathIndex->mutex);
+    const std::unordered_map<std::string, std::string>::const_iterator it = pathIndex->paths.find(key);
+    if (it == pathIndex->paths.end())
     {
-        Logger::Error("std::filesystem_error: {}", exception.what());
+        return "";
     }
+    return it->second;
+}
+
+void SearchPathManager::WalkFolder(const std::string &directoryPath,
+                                   const std::string &extension,
+                                   std::vector<std::string> &files,
+                                   std::vector<DirectoryTime> &directoryTimes)
+{
+    std::mutex mutex{};
+    std::condition_variable queueChanged{};
+    std::vector<std::string> pendingDirectories = {directoryPath};
+    size_t busyWorkers = 0;
+
+    const auto worker = [&](size_t) {
+        std::vector<std::string> localFiles{};
+        std::vector<DirectoryTime> localTimes{};
+        std::unique_lock lock(mutex);
+        while (true)
+        {
+            queueChanged.wait(lock, [&] { return !pendingDirectories.empty() || busyWorkers == 0; });
+            if (pendingDirectories.empty())
+            {
+                break; // No work left and nobody is going to produce more
+            }
+            const std::string directory = std::move(pendingDirectories.back());
+            pendingDirectories.pop_back();
+            busyWorkers++;
+            lock.unlock();
+
+            std::vector<std::string> subdirectories{};
+            std::error_code error{};
+            // Record the time before reading so that a change during the walk is seen as stale next time
+            localTimes.push_back({
+                .path = directory,
+                .time = std::filesystem::last_write_time(directory, error),
+            });
+            for (std::filesystem::directory_iterator it(directory, error);
+                 !error && it != std::filesystem::directory_iterator();
+                 it.increment(error))
+            {
+                const std::filesystem::directory_entry &entry = *it;
+                if (entry.is_regular_file(error))
+                {
+                    if (entry.path().extension() == extension)
+                    {
+                        localFiles.push_back(entry.path().string());
+                    }
+                } else if (entry.is_directory(error))
+                {
+                    subdirectories.push_back(entry.path().string());
+                }
+            }
+            if (error)
+            {
+                Logger::Error("Failed to scan \"{}\": {}", directory, error.message());
+            }
+
+            lock.lock();
+            busyWorkers--;
+            pendingDirectories.insert(pendingDirectories.end(),
+                                      std::make_move_iterator(subdirectories.begin()),
+                                      std::make_move_iterator(subdirectories.end()));
+            queueChanged.notify_all();
+        }
+        files.insert(files.end(), localFiles.begin(), localFiles.end());
+        directoryTimes.insert(directoryTimes.end(), localTimes.begin(), localTimes.end());
+        queueChanged.notify_all();
+    };
+
+    // A worker only waits for the queue while another one is reading a directory, so the walk still finishes if the
+    // calling thread ends up running every worker itself
+    ThreadPool &pool = ThreadPool::GetShared();
+    pool.Run(std::min(pool.GetThreadCount() + 1, MAX_SCAN_THREADS), worker);
+}
+
+std::vector<std::string> SearchPathManager::ScanFolder(const std::string &directoryPath,
+                                                       const std::string &extension,
+                                                       const bool isRoot)
+{
+    std::vector<DirectoryTime> directoryTimes{};
+    return ScanFolder(directoryPath, extension, isRoot, directoryTimes);
+}
+
+std::vector<std::string> SearchPathManager::ScanFolder(const std::string &directoryPath,
+                                                       const std::string &extension,
+                                                       const bool isRoot,
+                                                       std::vector<DirectoryTime> &directoryTimes)
+{
+    std::vector<std::string> files{};
+    WalkFolder(directoryPath, extension, files, directoryTimes);
     if (isRoot)
     {
-        for (std::string &file: files)
+        std::vector<std::pair<std::string, std::string>> sortable{};
+        sortable.reserve(files.size());
+        for (const std::string &file: files)
         {
-            file = file.substr(directoryPath.length() + 1);
+            std::string relative = file.substr(directoryPath.length() + 1);
+            std::string filename = std::filesystem::path(relative).filename().string();
+            sortable.emplace_back(std::move(filename), std::move(relative));
+        }
+        std::ranges::sort(sortable);
+        for (size_t i = 0; i < sortable.size(); i++)
+        {
+            files.at(i) = std::move(sortable.at(i).second);
         }
-        std::ranges::sort(files, [](const std::string &a, const std::string &b) {
-            return std::filesystem::path(a).filename().string() < std::filesystem::path(b).filename().string();
-        });
     }
     return files;
 }
 
+bool SearchPathManager::IsListingCurrent(const FolderListing &listing)
+{
+    for (const DirectoryTime &directory: listing.directoryTimes)
+    {
+        std::error_code error{};
+        const std::filesystem::file_time_type time = std::filesystem::last_write_time(directory.path, error);
+        if (error ? directory.time != std::filesystem::file_time_type::min() : time != directory.time)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::vector<SearchPathManager::AssetResult> SearchPathManager::ScanAssetFolder(const std::string &assetFolder,
                                                                                const std::string &extension) const
 {
-    std::vector<std::string> paths{};
-    std::vector<std::string> found{};
-    for (const std::string &searchPath: assetPaths)
+    const std::string key = std::format("{}|{}", NormalizeRelativePath(assetFolder), extension);
+    const std::lock_guard lock(listingCache->mutex);
+    if (listingCache->listings.contains(key) && IsListingCurrent(listingCache->listings.at(key)))
     {
-        const std::string absPath = std::format("{}/{}", searchPath, assetFolder);
-        const std::vector<std::string> searchPathContents = ScanFolder(absPath, extension, true);
+        return listingCache->listings.at(key).results;
+    }
+
+    FolderListing listing{};
+    std::unordered_set<std::string> found{};
+    for (size_t i = 0; i < assetPaths.size(); i++)
+    {
+        const std::string absPath = std::format("{}/{}", assetPaths.at(i), assetFolder);
+        std::vector<std::string> searchPathContents{};
+        if (assetPacks.at(i) != nullptr)
+        {
+            searchPathContents = assetPacks.at(i)->ScanFolder(assetFolder, extension);
+        } else
+        {
+            // Watch each folder leading to the asset folder too, so that creating it is noticed
+            std::filesystem::path ancestor = assetPaths.at(i);
+            for (const std::filesystem::path &part: std::filesystem::path(NormalizeRelativePath(assetFolder)))
+            {
+                std::error_code error{};
+                const std::filesystem::file_time_type time = std::filesystem::last_write_time(ancestor, error);
+                listing.directoryTimes.push_back({
+                    .path = ancestor.string(),
+                    .time = error ? std::filesystem::file_time_type::min() : time,
+                });
+                ancestor /= part;
+            }
+            if (std::filesystem::is_directory(absPath))
+            {
+                searchPathContents = ScanFolder(absPath, extension, true, listing.directoryTimes);
+            } else
+            {
+                listing.directoryTimes.push_back({
+                    .path = absPath,
+                    .time = std::filesystem::file_time_type::min(),
+                });
+            }
+        }
         for (const std::string &content: searchPathContents)
         {
-            if (std::ranges::find(found, content) == found.end())
+            if (found.insert(content).second)
             {
-                found.push_back(content);
-                paths.push_back(std::format("{}/{}", absPath, content));
+                listing.results.push_back({
+                    .relativePath = content,
+                    .absolutePath = std::format("{}/{}", absPath, content),
+                });
             }
         }
     }
-    assert(paths.size() == found.size());
-    std::vector<AssetResult> results{};
-    for (size_t i = 0; i < paths.size(); i++)
+
+    // The files in this folder may have changed since the path index was built. The watcher will already have
+    // noticed if there is one.
+    bool watching = false;
+    {
+        const std::shared_lock indexLock(pathIndex->mutex);
+        watching = pathIndex->watcher != nullptr && pathIndex->watcher->IsWatching();
+    }
+    if (!watching)
     {
-        const AssetResult res = {
-            .relativePath = found.at(i),
-            .absolutePath = paths.at(i),
-        };
-        results.emplace_back(res);
+        RefreshIndexFolder(NormalizeRelativePath(assetFolder));
     }
-    return results;
+
+    listingCache->listings[key] = listing;
+    return listing.results;
 }
 
 std::vector<std::string> SearchPathManager::ScanAssetFolderA(const std::string &assetFolder,
@@ -0,0 +1,133 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <libassets/util/ThreadPool.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        // Leave a hardware thread for the thread submitting the work
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+    }
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard lock(mutex);
+        stopRequested = true;
+        tasks.clear();
+    }
+    taskAvailable.notify_all();
+    for (std::thread &thread: threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        const std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock lock(mutex);
+    tasksFinished.wait(lock, [this] { return tasks.empty() && busyWorkers == 0; });
+}
+
+void ThreadPool::Run(const size_t count, const std::function<void(size_t index)> &task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    // Workers may only get to their part after every call was made, so the batch outlives this function
+    struct Batch
+    {
+            std::function<void(size_t index)> task;
+            size_t count;
+            std::atomic<size_t> nextIndex;
+            std::atomic<size_t> finishedCount;
+            std::mutex mutex;
+            std::condition_variable finished;
+    };
+    const std::shared_ptr<Batch> batch = std::make_shared<Batch>(task, count, 0, 0);
+    const std::function<void()> work = [batch] {
+        for (size_t index = batch->nextIndex++; index < batch->count; index = batch->nextIndex++)
+        {
+            batch->task(index);
+            if (++batch->finishedCount == batch->count)
+            {
+                const std::lock_guard lock(batch->mutex);
+                batch->finished.notify_all();
+            }
+        }
+    };
+
+    const size_t helperCount = std::min(count - 1, threads.size());
+    for (size_t i = 0; i < helperCount; i++)
+    {
+        Submit(work);
+    }
+    work();
+    std::unique_lock lock(batch->mutex);
+    batch->finished.wait(lock, [&batch] { return batch->finishedCount == batch->count; });
+}
+
+size_t ThreadPool::GetThreadCount() const
+{
+    return threads.size();
+}
+
+ThreadPool &ThreadPool::GetShared()
+{
+    static ThreadPool sharedPool{};
+    return sharedPool;
+}
+
+void ThreadPool::WorkerMain()
+{
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+        taskAvailable.wait(lock, [this] { return stopRequested || !tasks.empty(); });
+        if (stopRequested)
+        {
+            break;
+        }
+        const std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        busyWorkers++;
+        lock.unlock();
+
+        task();
+
+        lock.lock();
+        busyWorkers--;
+        if (tasks.empty() && busyWorkers == 0)
+        {
+            tasksFinished.notify_all();
+        }
+    }
+}
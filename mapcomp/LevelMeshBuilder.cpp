@@ -15,9 +15,11 @@
 #include <libassets/type/Sector.h>
 #include <libassets/type/WallMaterial.h>
 #include <libassets/util/DataWriter.h>
+#include <libassets/util/Error.h>
 #include <libassets/util/LightmapHelpers.hpp>
 #include <libassets/util/Logger.h>
 #include <libassets/util/SearchPathManager.h>
+#include <memory>
 #include <stb_rect_pack.h>
 #include <string>
 #include <utility>
@@ -106,10 +108,7 @@ bool LevelMeshBuilder::CalculateLightmapUvs(glm::uvec2 &lightmapSize,
     std::vector<stbrp_rect> rects{};
     for (const LevelMeshBuilder &builder: meshBuilders)
     {
-        const std::string materialPath = pathMgr.GetAssetPath(builder.GetMaterialPath());
-        LevelMaterialAsset material{};
-        material.LoadFromAsset(materialPath);
-        if (material.shader == Material::MaterialShader::SHADER_SHADED)
+        if (GetMaterial(builder.GetMaterialPath(), pathMgr)->shader == Material::MaterialShader::SHADER_SHADED)
         {
             rects.insert(rects.end(), builder.faceRects.begin(), builder.faceRects.end());
         }
@@ -124,10 +123,7 @@ bool LevelMeshBuilder::CalculateLightmapUvs(glm::uvec2 &lightmapSize,
     size_t rectIndexBegin = 0;
     for (LevelMeshBuilder &builder: meshBuilders)
     {
-        const std::string materialPath = pathMgr.GetAssetPath(builder.GetMaterialPath());
-        LevelMaterialAsset material{};
-        material.LoadFromAsset(materialPath);
-        if (material.shader != Material::MaterialShader::SHADER_SHADED)
+        if (GetMaterial(builder.GetMaterialPath(), pathMgr)->shader != Material::MaterialShader::SHADER_SHADED)
         {
             continue;
         }
@@ -222,14 +218,7 @@ void LevelMeshBuilder::AddWallBase(const glm::vec2 &startPoint,
         {
             v.textureIndex = 0;
         }
-        const std::string materialPath = pathManager.GetAssetPath(wallMaterial.material);
-        LevelMaterialAsset material{};
-        Error::ErrorCode error = material.LoadFromAsset(materialPath);
-        if (error != Error::ErrorCode::OK)
-        {
-            Logger::Error("Creating material asset \"{}\" failed with error: {}", materialPath, error);
-        }
-        v.emissive = material.emissive;
+        v.emissive = GetMaterial(wallMaterial.material, pathManager)->emissive;
         vertices.push_back(v);
     }
 
@@ -317,14 +306,7 @@ void LevelMeshBuilder::AddSectorBase(const Sector &sector,
         {
             v.textureIndex = 0;
         }
-        const std::string materialPath = pathManager.GetAssetPath(mat.material);
-        LevelMaterialAsset material{};
-        Error::ErrorCode error = material.LoadFromAsset(materialPath);
-        if (error != Error::ErrorCode::OK)
-        {
-            Logger::Error("Creating material asset \"{}\" failed with error: {}", materialPath, error);
-        }
-        v.emissive = material.emissive;
+        v.emissive = GetMaterial(mat.material, pathManager)->emissive;
         vertices.push_back(v);
     }
 
@@ -387,3 +369,20 @@ const std::string &LevelMeshBuilder::GetMaterialPath() const
 {
     return materialPath;
 }
+
+std::shared_ptr<const LevelMaterialAsset> LevelMeshBuilder::GetMaterial(const std::string &materialPath,
+                                                                        const SearchPathManager &pathManager)
+{
+    return materialCache.GetOrLoad(materialPath, [&pathManager](const std::string &path, size_t &outBytes) {
+        const std::shared_ptr<LevelMaterialAsset> material = std::make_shared<LevelMaterialAsset>();
+        const std::string absolutePath = pathManager.GetAssetPath(path);
+        const Error::ErrorCode e = material->LoadFromAsset(absolutePath);
+        if (e != Error::ErrorCode::OK)
+        {
+            // Cached anyway so that the error is only reported once per material
+            Logger::Error("Failed to load material \"{}\": {}", path, e);
+        }
+        outBytes = sizeof(LevelMaterialAsset) + material->texture.size();
+        return material;
+    });
+}
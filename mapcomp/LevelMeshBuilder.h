@@ -6,11 +6,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <libassets/asset/LevelMaterialAsset.h>
 #include <libassets/type/MapVertex.h>
 #include <libassets/type/Sector.h>
 #include <libassets/type/WallMaterial.h>
+#include <libassets/util/AssetCache.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/SearchPathManager.h>
+#include <memory>
 #include <stb_rect_pack.h>
 #include <string>
 #include <vector>
@@ -71,7 +74,21 @@ class LevelMeshBuilder
 
         [[nodiscard]] const std::string &GetMaterialPath() const;
 
+        /**
+         * Get a level material, loading it the first time it is used
+         * @param materialPath The material path
+         * @param pathManager The search path manager to find the material with
+         * @return The material, or a default material if it failed to load
+         */
+        [[nodiscard]] static std::shared_ptr<const LevelMaterialAsset> GetMaterial(const std::string &materialPath,
+                                                                                   const SearchPathManager &pathManager);
+
     private:
+        /// Materials are tiny, so this only guards against pathological maps
+        static constexpr size_t MATERIAL_CACHE_BUDGET_BYTES = 16ull * 1024 * 1024;
+
+        static inline AssetCache<const LevelMaterialAsset> materialCache{MATERIAL_CACHE_BUDGET_BYTES};
+
         struct FaceData
         {
                 std::vector<uint32_t> indices;
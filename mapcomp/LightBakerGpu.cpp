@@ -27,6 +27,7 @@
 #include <luna/lunaInstance.h>
 #include <luna/lunaSynchronization.h>
 #include <luna/lunaTypes.h>
+#include <memory>
 #include <shaderc/shaderc.h>
 #include <string>
 #include <utility>
@@ -637,27 +638,22 @@ bool LightBakerGpu::GetTextureIndex(const std::string &textureName,
                                     uint32_t &index,
                                     const SearchPathManager &pathManager)
 {
-    for (index = 0; index < loadedTextures.size(); index++)
+    if (loadedTextureIndices.contains(textureName))
     {
-        if (loadedTextures.at(index).first == textureName)
-        {
-            return true;
-        }
-    }
-    const std::string materialPath = pathManager.GetAssetPath(textureName);
-    LevelMaterialAsset material{};
-    Error::ErrorCode error = material.LoadFromAsset(materialPath);
-    if (error != Error::ErrorCode::OK)
-    {
-        Logger::Error("Creating material asset \"{}\" failed with error: {}", materialPath, error);
+        index = loadedTextureIndices.at(textureName);
+        return true;
     }
-    const std::string texturePath = pathManager.GetAssetPath(material.texture);
+    index = static_cast<uint32_t>(loadedTextures.size());
+    const std::shared_ptr<const LevelMaterialAsset> material = LevelMeshBuilder::GetMaterial(textureName, pathManager);
+    const std::string texturePath = pathManager.GetAssetPath(material->texture);
     TextureAsset image{};
-    error = image.LoadFromAsset(texturePath);
+    const Error::ErrorCode error = image.LoadFromAsset(texturePath);
     if (error != Error::ErrorCode::OK)
     {
-        Logger::Error("Creating texture asset \"{}\" failed with error: {}", materialPath, error);
+        Logger::Error("Creating texture asset \"{}\" failed with error: {}", texturePath, error);
     }
+    // The baker reads plain RGBA texels, so compressed textures are decoded rather than relying on device support
+    (void)image.Decompress();
     const VkSamplerAddressMode samplerAddressMode = image.repeat ? VK_SAMPLER_ADDRESS_MODE_REPEAT
                                                                  : VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
     const VkFilter filter = image.filter ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
@@ -714,6 +710,7 @@ bool LightBakerGpu::GetTextureIndex(const std::string &textureName,
     vkUpdateDescriptorSets(lunaGetVkDevice(device), 1, &writeDescriptor, 0, nullptr);
 
     loadedTextures.emplace_back(textureName, lunaImage);
+    loadedTextureIndices.emplace(textureName, index);
     return true;
 }
 
@@ -8,6 +8,7 @@
 #include <luna/lunaTypes.h>
 #include <shaderc/shaderc.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 #include "LevelMeshBuilder.h"
@@ -93,6 +94,8 @@ class LightBakerGpu
         };
 
         static inline std::vector<std::pair<std::string, LunaImage>> loadedTextures{};
+        /// Maps material names to their index in loadedTextures
+        static inline std::unordered_map<std::string, uint32_t> loadedTextureIndices{};
 
         bool initialized{};
         LunaDevice device{};
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <format>
 #include <glm/vec2.hpp>
 #include <libassets/asset/LevelMaterialAsset.h>
 #include <libassets/asset/MapAsset.h>
@@ -16,10 +17,12 @@
 #include <libassets/type/Sector.h>
 #include <libassets/type/WallMaterial.h>
 #include <libassets/util/AssetContainer.h>
+#include <libassets/util/BuildCache.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
 #include <ranges>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -45,39 +48,104 @@ MapCompiler::MapCompiler(MapCompilerSettings &settings)
 
 Error::ErrorCode MapCompiler::LoadMapSource(const std::string &mapSourceFile)
 {
+    mapSourcePath = mapSourceFile;
     mapBasename = std::filesystem::path(mapSourceFile).stem().string();
     return map.Import(mapSourceFile);
 }
 
 Error::ErrorCode MapCompiler::Compile()
 {
+    const std::string outPath = settings.assetsDirectory + "/map/" + mapBasename + ".gmap";
+    uint64_t cacheKey = 0;
+    const bool cacheable = settings.cache.IsEnabled() && GetCacheKey(cacheKey);
+    if (cacheable && settings.cache.Fetch(cacheKey, outPath))
+    {
+        Logger::Info("Found \"{}\" in the build cache", outPath.c_str());
+        return Error::ErrorCode::OK;
+    }
+
     std::vector<uint8_t> buffer;
-    const Error::ErrorCode e = SaveToBuffer(buffer);
+    Error::ErrorCode e = SaveToBuffer(buffer);
     if (e != Error::ErrorCode::OK)
     {
         return e;
     }
 
-    const std::string outPath = settings.assetsDirectory + "/map/" + mapBasename + ".gmap";
     Logger::Info("Saving map to \"{}\"", outPath.c_str());
-    return AssetContainer::SaveToFile(outPath.c_str(),
-                                      buffer,
-                                      Asset::AssetType::ASSET_TYPE_LEVEL,
-                                      MapAsset::MAP_ASSET_VERSION,
-                                      settings.fastCompile ? AssetContainer::FASTEST_COMPRESSION
-                                                           : AssetContainer::BEST_COMPRESSION);
+    e = AssetContainer::SaveToFile(outPath.c_str(),
+                                   buffer,
+                                   Asset::AssetType::ASSET_TYPE_LEVEL,
+                                   MapAsset::MAP_ASSET_VERSION,
+                                   settings.fastCompile ? AssetContainer::FASTEST_COMPRESSION
+                                                        : AssetContainer::BEST_COMPRESSION);
+    if (e == Error::ErrorCode::OK && cacheable && settings.cache.Insert(cacheKey, outPath) != Error::ErrorCode::OK)
+    {
+        Logger::Warning("Failed to add \"{}\" to the build cache", outPath.c_str());
+    }
+    return e;
 }
 
-LevelMaterialAsset MapCompiler::GetMapMaterial(const std::string &path) const
+bool MapCompiler::GetCacheKey(uint64_t &outKey) const
 {
-    LevelMaterialAsset mapMaterial;
-    const std::string absPath = pathManager.GetAssetPath(path);
-    const Error::ErrorCode e = mapMaterial.LoadFromAsset(absPath);
-    if (e != Error::ErrorCode::OK)
+    BuildCache::KeyBuilder key{};
+    key.AddString(std::format("mapcomp:{}:{}:{}:{}",
+                              MAP_COMPILER_VERSION,
+                              MapAsset::MAP_ASSET_VERSION,
+                              settings.skipLighting,
+                              settings.fastCompile));
+    if (!key.AddFile(mapSourcePath) || !key.AddFile(settings.assetsDirectory + "/game.gkvl"))
+    {
+        return false;
+    }
+
+    for (const char *folder: {"defs/actors", "defs/options"})
     {
-        Logger::Error("Failed to load material \"{}\": {}", path.c_str(), Error::ErrorString(e).c_str());
+        // Sorted so that the key doesn't depend on the order the filesystem lists files in
+        std::vector<std::string> defs = pathManager.ScanAssetFolderA(folder, ".json");
+        std::ranges::sort(defs);
+        for (const std::string &def: defs)
+        {
+            if (!key.AddFile(def))
+            {
+                return false;
+            }
+        }
     }
-    return mapMaterial;
+
+    std::set<std::string> materials{};
+    for (const Sector &sector: map.sectors)
+    {
+        for (const WallMaterial &wallMaterial: sector.wallMaterials)
+        {
+            materials.insert(wallMaterial.material);
+        }
+        materials.insert(sector.floorMaterial.material);
+        materials.insert(sector.ceilingMaterial.material);
+    }
+    for (const std::string &material: materials)
+    {
+        key.AddString(material);
+        const std::string texture = LevelMeshBuilder::GetMaterial(material, pathManager)->texture;
+        key.AddString(texture);
+        // Missing materials and textures are compiled as missing, so they only change the key by name
+        const std::string materialPath = pathManager.GetAssetPath(material);
+        const std::string texturePath = pathManager.GetAssetPath(texture);
+        if (!materialPath.empty() && !key.AddFile(materialPath))
+        {
+            return false;
+        }
+        if (!texturePath.empty() && !key.AddFile(texturePath))
+        {
+            return false;
+        }
+    }
+    outKey = key.GetKey();
+    return true;
+}
+
+LevelMaterialAsset MapCompiler::GetMapMaterial(const std::string &path) const
+{
+    return *LevelMeshBuilder::GetMaterial(path, pathManager);
 }
 
 
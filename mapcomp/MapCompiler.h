@@ -10,6 +10,7 @@
 #include <libassets/asset/LevelMaterialAsset.h>
 #include <libassets/asset/MapAsset.h>
 #include <libassets/util/ActorDefinitionManager.h>
+#include <libassets/util/BuildCache.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/SearchPathManager.h>
 #include <string>
@@ -26,6 +27,8 @@ class MapCompiler
                 DataAsset gameConfig;
                 bool skipLighting = false;
                 bool fastCompile = false;
+                /// Where compiled maps are looked up before compiling and stored after, disabled by default
+                BuildCache cache{};
         };
 
         /**
@@ -47,15 +50,26 @@ class MapCompiler
 
     private:
         MapCompilerSettings settings;
+        std::string mapSourcePath;
         std::string mapBasename;
         MapAsset map;
         SearchPathManager pathManager;
         ActorDefinitionManager defManager;
 
         static constexpr float FAST_COMPILE_MIN_UNITS_PER_LUXEL = 2.0f;
+        /// Bump to invalidate cached maps after a change to how maps are compiled
+        static constexpr uint32_t MAP_COMPILER_VERSION = 1;
 
         Error::ErrorCode SaveToBuffer(std::vector<uint8_t> &buffer);
 
+        /**
+         * Get the build cache key of the loaded map, from the map source, game config, actor definitions and the
+         * materials and textures it uses
+         * @param outKey Where to store the key
+         * @return False if an input can't be read, in which case the map can't be cached
+         */
+        [[nodiscard]] bool GetCacheKey(uint64_t &outKey) const;
+
         [[nodiscard]] LevelMaterialAsset GetMapMaterial(const std::string &path) const;
 
         [[nodiscard]] static bool SectorFloorCeilingCompare(const std::array<float, 2> &a,
@@ -2,12 +2,17 @@
 // Created by droc101 on 11/17/25.
 //
 
+#include <cstdint>
 #include <cstdio>
+#include <filesystem>
 #include <libassets/asset/DataAsset.h>
 #include <libassets/util/ArgumentParser.h>
+#include <libassets/util/BuildCache.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
 #include <libassets/util/SearchPathManager.h>
+#include <limits>
+#include <string>
 #include <unistd.h>
 #include <vector>
 #include "MapCompiler.h"
@@ -22,6 +27,25 @@ int main(const int argc, const char **argv)
 
     Logger::Info("GAME SDK Map Compiler");
 
+    if (args.HasFlag("--help") || args.HasFlag("-h"))
+    {
+        printf("Usage: mapcomp [options]\n");
+        printf("\n-- Input Options --\n");
+        printf("--map-source=/path/to/map.json........The map source to compile.\n");
+        printf("--map-sources-dir=/path/to/folder.....Compile every map source (*.json) in a folder.\n");
+        printf("--assets-dir=/path/to/assets..........The game's asset folder, containing game.gkvl.\n");
+        printf("--executable-dir=/path/to/game........The folder containing the game executable.\n");
+        printf("\n-- Build Options --\n");
+        printf("--skip-lighting.......................Don't bake the lightmap.\n");
+        printf("--fast................................Compile quickly at a lower quality.\n");
+        printf("--break-on-error......................Stop at the first map that fails to compile.\n");
+        printf("--cache-dir=/path/to/cache............A build cache folder, which may be shared between checkouts.\n");
+        printf("--cache-size=MB.......................The size limit of the build cache (default: 4096).\n");
+        printf("--verbose.............................Log more detail.\n");
+        printf("--no-ansi.............................Don't color log output.\n");
+        return 0;
+    }
+
     if (!(args.HasFlagWithValue("--map-source") || args.HasFlagWithValue("--map-sources-dir")))
     {
         Logger::Error("--map-source not specified!");
@@ -49,6 +73,20 @@ int main(const int argc, const char **argv)
         return 1;
     }
 
+    uintmax_t cacheSize = BuildCache::DEFAULT_MAX_BYTES;
+    if (args.HasFlagWithValue("--cache-size"))
+    {
+        constexpr uintmax_t MIB = 1024 * 1024;
+        uintmax_t cacheSizeMiB = 0;
+        if (!args.GetFlagNumber("--cache-size", cacheSizeMiB) ||
+            cacheSizeMiB > std::numeric_limits<uintmax_t>::max() / MIB)
+        {
+            Logger::Error("--cache-size must be a number of megabytes!");
+            return 1;
+        }
+        cacheSize = cacheSizeMiB * MIB;
+    }
+
     const std::string assetsPath = args.GetFlagValue("--assets-dir");
 
     MapCompiler::MapCompilerSettings settings = {
@@ -58,6 +96,7 @@ int main(const int argc, const char **argv)
         .gameConfig = gameConfig,
         .skipLighting = args.HasFlag("--skip-lighting"),
         .fastCompile = args.HasFlag("--fast"),
+        .cache = BuildCache(args.HasFlagWithValue("--cache-dir") ? args.GetFlagValue("--cache-dir") : "", cacheSize),
     };
 
     MapCompiler compiler = MapCompiler(settings);
@@ -110,5 +149,6 @@ int main(const int argc, const char **argv)
         }
     }
 
+    settings.cache.CollectGarbage();
     return 0;
 }
@@ -0,0 +1,108 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include "ActorRenderCache.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <game_sdk/Profiler.h>
+#include <libassets/type/Actor.h>
+#include <libassets/type/ActorDefinition.h>
+#include <libassets/type/renderDefs/BoxRenderDefinition.h>
+#include <libassets/type/renderDefs/CircleRenderDefinition.h>
+#include <libassets/type/renderDefs/ConeRenderDefinition.h>
+#include <libassets/type/renderDefs/ModelRenderDefinition.h>
+#include <libassets/type/renderDefs/OrientationRenderDefinition.h>
+#include <libassets/type/renderDefs/PointRenderDefinition.h>
+#include <libassets/type/renderDefs/RenderDefinition.h>
+#include <libassets/type/renderDefs/SpriteRenderDefinition.h>
+#include <libassets/type/renderDefs/WallRenderDefinition.h>
+#include <memory>
+#include <vector>
+#include "MapEditor.h"
+#include "MapHistory.h"
+
+void ActorRenderCache::Update(const MapHistory::ChangedRange &changed)
+{
+    const std::vector<Actor> &mapActors = MapEditor::map.actors;
+    if (changed.start >= changed.end && actors.size() == mapActors.size())
+    {
+        return;
+    }
+    const Profiler::Scope scope("Render definitions");
+    actors.resize(mapActors.size());
+    const size_t end = std::min(changed.end, mapActors.size());
+    for (size_t i = changed.start; i < end; i++)
+    {
+        Evaluate(mapActors.at(i), actors.at(i));
+    }
+}
+
+const std::vector<ActorRenderCache::RenderParams> &ActorRenderCache::Get(const size_t actorIndex)
+{
+    return actors.at(actorIndex);
+}
+
+void ActorRenderCache::Evaluate(const Actor &actor, std::vector<RenderParams> &outParams)
+{
+    const ActorDefinition &definition = MapEditor::adm.GetActorDefinition(actor.className);
+    outParams.clear();
+    outParams.reserve(definition.renderDefinitions.size());
+    for (const std::shared_ptr<RenderDefinition> &rdef: definition.renderDefinitions)
+    {
+        RenderParams params = {
+            .type = rdef->GetType(),
+            .gizmo = rdef->IsGizmo(actor),
+        };
+        if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_BOX)
+        {
+            BoxRenderDefinition *boxDef = dynamic_cast<BoxRenderDefinition *>(rdef.get());
+            params.color = boxDef->GetColor(actor);
+            params.extents = boxDef->GetExtents(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_MODEL)
+        {
+            ModelRenderDefinition *modelDef = dynamic_cast<ModelRenderDefinition *>(rdef.get());
+            params.color = modelDef->GetColor(actor);
+            params.model = modelDef->GetModel(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_ORIENTATION)
+        {
+            params.color = dynamic_cast<OrientationRenderDefinition *>(rdef.get())->GetColor(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_POINT)
+        {
+            PointRenderDefinition *pointDef = dynamic_cast<PointRenderDefinition *>(rdef.get());
+            params.color = pointDef->GetColor(actor);
+            params.pointSize = pointDef->GetPointSize(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_SPRITE)
+        {
+            SpriteRenderDefinition *spriteDef = dynamic_cast<SpriteRenderDefinition *>(rdef.get());
+            params.color = spriteDef->GetTintColor(actor);
+            params.pointSize = spriteDef->GetPointSize(actor);
+            params.texture = spriteDef->GetTexture(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_WALL)
+        {
+            WallRenderDefinition *wallDef = dynamic_cast<WallRenderDefinition *>(rdef.get());
+            params.color = wallDef->GetColor(actor);
+            params.size = wallDef->GetSize(actor);
+            params.localCenter = wallDef->GetLocalCenter(actor);
+            params.zAxisOrientation = wallDef->GetZAxisOrientation(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_CIRCLE)
+        {
+            CircleRenderDefinition *circleDef = dynamic_cast<CircleRenderDefinition *>(rdef.get());
+            params.color = circleDef->GetColor(actor);
+            params.radius = circleDef->GetRadius(actor);
+            params.sides = circleDef->GetNumSides(actor);
+        } else if (params.type == RenderDefinition::RenderDefinitionType::RD_TYPE_CONE)
+        {
+            ConeRenderDefinition *coneDef = dynamic_cast<ConeRenderDefinition *>(rdef.get());
+            params.color = coneDef->GetColor(actor);
+            params.length = coneDef->GetLength(actor);
+            params.angle = coneDef->GetAngle(actor);
+            params.sides = coneDef->GetNumSides(actor);
+        } else
+        {
+            assert(false); // should be impossible
+        }
+        outParams.push_back(params);
+    }
+}
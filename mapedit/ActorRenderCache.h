@@ -0,0 +1,77 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <libassets/type/Actor.h>
+#include <libassets/type/Color.h>
+#include <libassets/type/renderDefs/RenderDefinition.h>
+#include <string>
+#include <vector>
+#include "MapHistory.h"
+
+/**
+ * Keeps the evaluated render definitions of every actor, so parameter expressions only run when an actor changes
+ * instead of every frame in every viewport.
+ * Like the sector geometry cache, only the actors that MapHistory reports as changed are evaluated again.
+ */
+class ActorRenderCache
+{
+    public:
+        /// The values of one render definition, evaluated for one actor. Only the values its type uses are set.
+        struct RenderParams
+        {
+                RenderDefinition::RenderDefinitionType type = RenderDefinition::RenderDefinitionType::RD_TYPE_UNKNOWN;
+                bool gizmo = false;
+                /// The color of every type, or the tint color of sprites
+                Color color{};
+                /// Box extents
+                glm::vec3 extents{};
+                /// Circle radius
+                float radius = 0;
+                /// Point and sprite size
+                float pointSize = 0;
+                /// Cone length and angle
+                float length = 0;
+                float angle = 0;
+                /// Circle and cone side count
+                int32_t sides = 0;
+                /// Model path
+                std::string model{};
+                /// Sprite texture path
+                std::string texture{};
+                /// Wall size, center and orientation
+                glm::vec2 size{};
+                glm::vec2 localCenter{};
+                bool zAxisOrientation = false;
+        };
+
+        ActorRenderCache() = delete;
+
+        /**
+         * Re-evaluate the render definitions of actors that changed since the last update
+         * @param changed The actors that changed, from MapHistory::TakeChanges()
+         */
+        static void Update(const MapHistory::ChangedRange &changed);
+
+        /**
+         * Get the evaluated render definitions of an actor in the map, as of the last update
+         * @param actorIndex The index of the actor
+         */
+        [[nodiscard]] static const std::vector<RenderParams> &Get(size_t actorIndex);
+
+        /**
+         * Evaluate the render definitions of an actor that is not in the map
+         * @param actor The actor
+         * @param outParams Where to store the values
+         */
+        static void Evaluate(const Actor &actor, std::vector<RenderParams> &outParams);
+
+    private:
+        /// The evaluated render definitions of every actor in the map
+        static inline std::vector<std::vector<RenderParams>> actors{};
+};
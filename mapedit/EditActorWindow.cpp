@@ -38,16 +38,30 @@
 #include <misc/cpp/imgui_stdlib.h>
 #include <ranges>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 #include "MapEditor.h"
+#include "MapHistory.h"
 
-void EditActorWindow::Render(Actor &actor)
+void EditActorWindow::Render(const size_t actorIndex)
 {
     if (!visible)
     {
         return;
     }
 
+    // The window edits a copy, so that the history can be told before the actor in the map changes
+    Actor actor = MapEditor::map.actors.at(actorIndex);
+    RenderWindow(actor);
+    if (actor != MapEditor::map.actors.at(actorIndex))
+    {
+        MapHistory::ChangeActors(actorIndex, 1, 1);
+        MapEditor::map.actors.at(actorIndex) = std::move(actor);
+    }
+}
+
+void EditActorWindow::RenderWindow(Actor &actor)
+{
     if (selectedConnection > actor.connections.size() - 1)
     {
         selectedConnection = actor.connections.size() - 1;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <libassets/type/Actor.h>
 
 class EditActorWindow
@@ -15,9 +16,15 @@ class EditActorWindow
         static inline size_t selectedParam = 0;
         static inline size_t selectedConnection = 0;
 
-        static void Render(Actor &actor);
+        /**
+         * Render the window for an actor in the map
+         * @param actorIndex The index of the actor
+         */
+        static void Render(size_t actorIndex);
 
     private:
+        static void RenderWindow(Actor &actor);
+
         static void RenderParamsTab(Actor &actor, const ActorDefinition &definition);
 
         static void RenderOutputsTab(Actor &actor, const ActorDefinition &definition);
@@ -184,6 +184,8 @@ void MapCompileWindow::RenderCompileOutput()
         if (compilerProcess != nullptr || compilerOutputStream != nullptr || compilerErrorStream != nullptr)
         {
             ImGui::ProgressBar(static_cast<float>(ImGui::GetTime()) * -0.5f, ImVec2(-1, 0), "Compiling...");
+            // Animate the progress bar and keep reading the compiler's output
+            SDKWindow::Get().RequestRedraw();
         } else
         {
             if (ImGui::Button("Copy Output"))
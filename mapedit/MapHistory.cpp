@@ -0,0 +1,268 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include "MapHistory.h"
+#include <algorithm>
+#include <cstddef>
+#include <game_sdk/Options.h>
+#include <glm/vec2.hpp>
+#include <imgui.h>
+#include <libassets/type/Actor.h>
+#include <libassets/type/IOConnection.h>
+#include <libassets/type/Param.h>
+#include <libassets/type/Sector.h>
+#include <libassets/type/WallMaterial.h>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+#include "MapEditor.h"
+
+void MapHistory::Clear()
+{
+    openStep = Step();
+    undoSteps.clear();
+    redoSteps.clear();
+    totalBytes = 0;
+    pendingSectorCount = std::nullopt;
+    pendingActorCount = std::nullopt;
+    // The whole map was replaced
+    changes = {
+        .sectors = {.start = 0, .end = std::numeric_limits<size_t>::max()},
+        .actors = {.start = 0, .end = std::numeric_limits<size_t>::max()},
+    };
+}
+
+void MapHistory::ChangeSectors(const size_t index, const size_t removeCount, const size_t insertCount)
+{
+    BeginSplice(MapEditor::map.sectors, openStep.sectorSplices, pendingSectorCount, index, removeCount, insertCount);
+    AddChange(changes.sectors, index, removeCount, insertCount);
+}
+
+void MapHistory::ChangeActors(const size_t index, const size_t removeCount, const size_t insertCount)
+{
+    BeginSplice(MapEditor::map.actors, openStep.actorSplices, pendingActorCount, index, removeCount, insertCount);
+    AddChange(changes.actors, index, removeCount, insertCount);
+}
+
+void MapHistory::Update()
+{
+    FinishSplice(MapEditor::map.sectors, openStep.sectorSplices, pendingSectorCount);
+    FinishSplice(MapEditor::map.actors, openStep.actorSplices, pendingActorCount);
+    // Keep merging changes into the open step until the edit is finished
+    if (!ImGui::IsMouseDown(ImGuiMouseButton_Left) && !ImGui::IsAnyItemActive())
+    {
+        CommitOpenStep();
+    }
+}
+
+bool MapHistory::CanUndo()
+{
+    return !undoSteps.empty() || !openStep.sectorSplices.empty() || !openStep.actorSplices.empty();
+}
+
+bool MapHistory::CanRedo()
+{
+    return !redoSteps.empty();
+}
+
+void MapHistory::Undo()
+{
+    CommitOpenStep();
+    if (undoSteps.empty())
+    {
+        return;
+    }
+
+    Step step = std::move(undoSteps.back());
+    undoSteps.pop_back();
+    for (const Splice<Sector> &splice: std::views::reverse(step.sectorSplices))
+    {
+        ApplySplice(MapEditor::map.sectors, splice.index, splice.after.size(), splice.before);
+        AddChange(changes.sectors, splice.index, splice.after.size(), splice.before.size());
+    }
+    for (const Splice<Actor> &splice: std::views::reverse(step.actorSplices))
+    {
+        ApplySplice(MapEditor::map.actors, splice.index, splice.after.size(), splice.before);
+        AddChange(changes.actors, splice.index, splice.after.size(), splice.before.size());
+    }
+    redoSteps.push_back(std::move(step));
+}
+
+void MapHistory::Redo()
+{
+    // New changes replace whatever could be redone
+    CommitOpenStep();
+    if (redoSteps.empty())
+    {
+        return;
+    }
+
+    Step step = std::move(redoSteps.back());
+    redoSteps.pop_back();
+    for (const Splice<Sector> &splice: step.sectorSplices)
+    {
+        ApplySplice(MapEditor::map.sectors, splice.index, splice.before.size(), splice.after);
+        AddChange(changes.sectors, splice.index, splice.before.size(), splice.after.size());
+    }
+    for (const Splice<Actor> &splice: step.actorSplices)
+    {
+        ApplySplice(MapEditor::map.actors, splice.index, splice.before.size(), splice.after);
+        AddChange(changes.actors, splice.index, splice.before.size(), splice.after.size());
+    }
+    undoSteps.push_back(std::move(step));
+}
+
+MapHistory::Changes MapHistory::TakeChanges()
+{
+    const Changes taken = changes;
+    changes = Changes();
+    return taken;
+}
+
+void MapHistory::CommitOpenStep()
+{
+    FinishSplice(MapEditor::map.sectors, openStep.sectorSplices, pendingSectorCount);
+    FinishSplice(MapEditor::map.actors, openStep.actorSplices, pendingActorCount);
+    if (openStep.sectorSplices.empty() && openStep.actorSplices.empty())
+    {
+        return;
+    }
+
+    for (const Step &step: redoSteps)
+    {
+        totalBytes -= step.bytes;
+    }
+    redoSteps.clear();
+
+    openStep.bytes = sizeof(Step) + GetBytes(openStep.sectorSplices) + GetBytes(openStep.actorSplices);
+    totalBytes += openStep.bytes;
+    undoSteps.push_back(std::move(openStep));
+    openStep = Step();
+    Trim();
+}
+
+void MapHistory::Trim()
+{
+    const size_t budget = static_cast<size_t>(Options::Get().mapUndoMemoryMiB) * 1024 * 1024;
+    // The newest step is always kept, so that even an edit larger than the budget can be undone
+    while (totalBytes > budget && undoSteps.size() > 1)
+    {
+        totalBytes -= undoSteps.front().bytes;
+        undoSteps.pop_front();
+    }
+}
+
+template<typename T> void MapHistory::BeginSplice(const std::vector<T> &items,
+                                                  std::vector<Splice<T>> &splices,
+                                                  std::optional<size_t> &pendingCount,
+                                                  const size_t index,
+                                                  const size_t removeCount,
+                                                  const size_t insertCount)
+{
+    FinishSplice(items, splices, pendingCount);
+    pendingCount = insertCount;
+    if (!splices.empty())
+    {
+        // The last splice's new values are these items as they are now, so it can simply be finished again later
+        const Splice<T> &last = splices.back();
+        if (last.index == index && last.after.size() == removeCount)
+        {
+            return;
+        }
+    }
+    const typename std::vector<T>::const_iterator first = items.begin() + static_cast<ptrdiff_t>(index);
+    splices.push_back({
+        .index = index,
+        .before = std::vector<T>(first, first + static_cast<ptrdiff_t>(removeCount)),
+        .after = {},
+    });
+}
+
+template<typename T> void MapHistory::FinishSplice(const std::vector<T> &items,
+                                                   std::vector<Splice<T>> &splices,
+                                                   std::optional<size_t> &pendingCount)
+{
+    if (!pendingCount.has_value())
+    {
+        return;
+    }
+    Splice<T> &splice = splices.back();
+    const typename std::vector<T>::const_iterator first = items.begin() + static_cast<ptrdiff_t>(splice.index);
+    splice.after.assign(first, first + static_cast<ptrdiff_t>(pendingCount.value()));
+    pendingCount = std::nullopt;
+    // Nothing changed in the end, such as a drag that ended where it started
+    if (splice.before == splice.after)
+    {
+        splices.pop_back();
+    }
+}
+
+template<typename T> void MapHistory::ApplySplice(std::vector<T> &items,
+                                                  const size_t index,
+                                                  const size_t removeCount,
+                                                  const std::vector<T> &insert)
+{
+    const typename std::vector<T>::iterator first = items.begin() + static_cast<ptrdiff_t>(index);
+    if (removeCount == insert.size())
+    {
+        // Replacing items in place doesn't move the rest of them
+        std::ranges::copy(insert, first);
+        return;
+    }
+    items.erase(first, first + static_cast<ptrdiff_t>(removeCount));
+    items.insert(items.begin() + static_cast<ptrdiff_t>(index), insert.begin(), insert.end());
+}
+
+void MapHistory::AddChange(ChangedRange &range, const size_t index, const size_t removeCount, const size_t insertCount)
+{
+    const size_t end = removeCount == insertCount ? index + insertCount : std::numeric_limits<size_t>::max();
+    if (index >= end)
+    {
+        return;
+    }
+    if (range.start >= range.end)
+    {
+        range = {.start = index, .end = end};
+        return;
+    }
+    range.start = std::min(range.start, index);
+    range.end = std::max(range.end, end);
+}
+
+size_t MapHistory::GetBytes(const Sector &sector)
+{
+    return sizeof(Sector) +
+           sector.name.size() +
+           (sector.points.size() * sizeof(glm::vec2)) +
+           (sector.wallMaterials.size() * sizeof(WallMaterial));
+}
+
+size_t MapHistory::GetBytes(const Actor &actor)
+{
+    return sizeof(Actor) +
+           actor.className.size() +
+           (actor.params.size() * (sizeof(std::string) + sizeof(Param))) +
+           (actor.connections.size() * sizeof(IOConnection));
+}
+
+template<typename T> size_t MapHistory::GetBytes(const std::vector<Splice<T>> &splices)
+{
+    size_t bytes = 0;
+    for (const Splice<T> &splice: splices)
+    {
+        bytes += sizeof(Splice<T>);
+        for (const T &item: splice.before)
+        {
+            bytes += GetBytes(item);
+        }
+        for (const T &item: splice.after)
+        {
+            bytes += GetBytes(item);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,156 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <libassets/type/Actor.h>
+#include <libassets/type/Sector.h>
+#include <optional>
+#include <vector>
+
+/**
+ * Undo and redo history for the sectors and actors of the map.
+ * Everything that edits sectors or actors tells the history first, with ChangeSectors() or ChangeActors(). The items
+ * about to change are copied then, and their new values at the next change or update, so each step only keeps the
+ * range of items that changed and recording, undoing and redoing cost as much as the change did, not as much as the
+ * map. The history also keeps the range of items changed since the render caches last caught up, see TakeChanges().
+ * Changes made while the left mouse button is held or a widget is active (such as dragging a vertex or typing in a
+ * field) are merged into one step. Old steps are dropped once the history uses more memory than the options allow.
+ */
+class MapHistory
+{
+    public:
+        /// The items from start up to end changed. Empty when start is not below end.
+        struct ChangedRange
+        {
+                size_t start;
+                size_t end;
+        };
+
+        struct Changes
+        {
+                ChangedRange sectors;
+                ChangedRange actors;
+        };
+
+        MapHistory() = delete;
+
+        /**
+         * Forget all steps and start recording from the current map. Call after loading or creating a map.
+         */
+        static void Clear();
+
+        /**
+         * Record that sectors are about to change. Call right before replacing removeCount sectors starting at index
+         * with insertCount new ones, and finish the edit before the next change. For an edit in place, both counts
+         * are the number of sectors edited.
+         */
+        static void ChangeSectors(size_t index, size_t removeCount, size_t insertCount);
+
+        /**
+         * Record that actors are about to change, like ChangeSectors()
+         */
+        static void ChangeActors(size_t index, size_t removeCount, size_t insertCount);
+
+        /**
+         * Copy the new values of the last changes and finish the step once the edit is done. Call once per frame.
+         */
+        static void Update();
+
+        [[nodiscard]] static bool CanUndo();
+
+        [[nodiscard]] static bool CanRedo();
+
+        /**
+         * Revert the last step
+         */
+        static void Undo();
+
+        /**
+         * Reapply the last undone step
+         */
+        static void Redo();
+
+        /**
+         * Get the sectors and actors changed since the last call, to bring the render caches up to date
+         */
+        [[nodiscard]] static Changes TakeChanges();
+
+    private:
+        /// Replaces the items starting at index that were in before with the items in after
+        template<typename T> struct Splice
+        {
+                size_t index;
+                std::vector<T> before;
+                std::vector<T> after;
+        };
+
+        struct Step
+        {
+                std::vector<Splice<Sector>> sectorSplices;
+                std::vector<Splice<Actor>> actorSplices;
+                /// Roughly how much memory the step uses, set when it is committed
+                size_t bytes;
+        };
+
+        /// The step that changes are currently merged into
+        static inline Step openStep{};
+        static inline std::deque<Step> undoSteps{};
+        static inline std::vector<Step> redoSteps{};
+        /// The memory used by the undo and redo steps
+        static inline size_t totalBytes = 0;
+
+        /// How many items the last splice of each kind inserts, until their new values have been copied
+        static inline std::optional<size_t> pendingSectorCount = std::nullopt;
+        static inline std::optional<size_t> pendingActorCount = std::nullopt;
+
+        static inline Changes changes{};
+
+        /**
+         * Finish the pending splices and add the open step to the undo steps, if it has any changes
+         */
+        static void CommitOpenStep();
+
+        /**
+         * Drop the oldest steps until the history fits in its memory budget
+         */
+        static void Trim();
+
+        /**
+         * Copy the items about to change into a new splice, or keep extending the last splice if it covers the same
+         * items (such as every frame of a drag)
+         */
+        template<typename T> static void BeginSplice(const std::vector<T> &items,
+                                                     std::vector<Splice<T>> &splices,
+                                                     std::optional<size_t> &pendingCount,
+                                                     size_t index,
+                                                     size_t removeCount,
+                                                     size_t insertCount);
+
+        /**
+         * Copy the new values of the last splice, if they haven't been copied yet
+         */
+        template<typename T> static void FinishSplice(const std::vector<T> &items,
+                                                      std::vector<Splice<T>> &splices,
+                                                      std::optional<size_t> &pendingCount);
+
+        template<typename T> static void ApplySplice(std::vector<T> &items,
+                                                     size_t index,
+                                                     size_t removeCount,
+                                                     const std::vector<T> &insert);
+
+        /**
+         * Grow a changed range to cover a splice. Inserting or removing items moves every item after them, so then
+         * the range extends to the last item.
+         */
+        static void AddChange(ChangedRange &range, size_t index, size_t removeCount, size_t insertCount);
+
+        [[nodiscard]] static size_t GetBytes(const Sector &sector);
+
+        [[nodiscard]] static size_t GetBytes(const Actor &actor);
+
+        template<typename T> [[nodiscard]] static size_t GetBytes(const std::vector<Splice<T>> &splices);
+};
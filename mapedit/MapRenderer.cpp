@@ -3,23 +3,29 @@
 //
 
 #include "MapRenderer.h"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <game_sdk/gl/GLHelper.h>
+#include <game_sdk/Profiler.h>
 #include <game_sdk/SharedMgr.h>
 #include <glm/ext.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <libassets/asset/ModelAsset.h>
 #include <libassets/type/Color.h>
 #include <libassets/type/ModelLod.h>
+#include <libassets/util/AssetCache.h>
 #include <libassets/util/DataWriter.h>
 #include <libassets/util/Error.h>
 #include <libassets/util/Logger.h>
 #include <libassets/util/SearchPathManager.h>
-#include <ranges>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "MapEditor.h"
 #include "Viewport.h"
@@ -34,18 +40,44 @@ bool MapRenderer::Init()
                                                                           "assets/shaders/grid.vert",
                                                                           gridProgram);
 
-    const Error::ErrorCode cubeProgramErrorCode = GLHelper::CreateProgram("assets/shaders/generic.frag",
-                                                                          "assets/shaders/generic.vert",
-                                                                          genericProgram);
+    const Error::ErrorCode modelProgramErrorCode = GLHelper::CreateProgram("assets/shaders/batched.frag",
+                                                                           "assets/shaders/instancedModel.vert",
+                                                                           modelProgram);
 
-    const Error::ErrorCode spriteProgramErrorCode = GLHelper::CreateProgram("assets/shaders/sprite.frag",
-                                                                            "assets/shaders/sprite.vert",
-                                                                            spriteProgram);
+    const Error::ErrorCode batchProgramErrorCode = GLHelper::CreateProgram("assets/shaders/batched.frag",
+                                                                           "assets/shaders/batched.vert",
+                                                                           batchProgram);
 
-    if (cubeProgramErrorCode != Error::ErrorCode::OK ||
+    const Error::ErrorCode batchSpriteProgramErrorCode = GLHelper::CreateProgram("assets/shaders/batchedSprite.frag",
+                                                                                 "assets/shaders/batched.vert",
+                                                                                 batchSpriteProgram);
+
+    if (modelProgramErrorCode != Error::ErrorCode::OK ||
         linesProgramErrorCode != Error::ErrorCode::OK ||
         gridProgramErrorCode != Error::ErrorCode::OK ||
-        spriteProgramErrorCode != Error::ErrorCode::OK)
+        batchProgramErrorCode != Error::ErrorCode::OK ||
+        batchSpriteProgramErrorCode != Error::ErrorCode::OK)
+    {
+        return false;
+    }
+
+    gridLocations = {
+        .matrix = glGetUniformLocation(gridProgram, "matrix"),
+        .spacing = glGetUniformLocation(gridProgram, "spacing"),
+        .plane = glGetUniformLocation(gridProgram, "plane"),
+    };
+    lineLocations = {
+        .view = glGetUniformLocation(lineProgram, "VIEW"),
+        .vertex = glGetAttribLocation(lineProgram, "VERTEX"),
+        .vertexColor = glGetAttribLocation(lineProgram, "VERTEX_COLOR"),
+    };
+    batchLocations = GetBatchProgramLocations(batchProgram);
+    batchSpriteLocations = GetBatchProgramLocations(batchSpriteProgram);
+    modelLocations = {
+        .viewMatrix = glGetUniformLocation(modelProgram, "VIEW_MATRIX"),
+    };
+
+    if (!CreateBatchRing())
     {
         return false;
     }
@@ -100,7 +132,6 @@ bool MapRenderer::Init()
     glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(float) * verts.size()), verts.data(), GL_STATIC_DRAW);
 
     workBuffer = GLHelper::CreateIndexedBuffer();
-    workBufferNonIndexed = GLHelper::CreateBuffer();
 
     const std::string errorModelPath = SharedMgr::Get().pathManager.GetAssetPath("model/error.gmdl");
     if (errorModelPath.empty())
@@ -109,29 +140,331 @@ bool MapRenderer::Init()
         return false;
     }
 
-    const ModelBuffer buf = LoadModel(errorModelPath);
-    modelBuffers["model/error.gmdl"] = buf;
+    errorModel = LoadModel(errorModelPath);
 
     return true;
 }
 
 void MapRenderer::Destroy()
 {
-    glDeleteProgram(genericProgram);
+    glDeleteProgram(modelProgram);
     glDeleteProgram(lineProgram);
     glDeleteProgram(gridProgram);
-    glDeleteProgram(spriteProgram);
+    glDeleteProgram(batchProgram);
+    glDeleteProgram(batchSpriteProgram);
     GLHelper::DestroyBuffer(axisHelperBuffer);
     GLHelper::DestroyBuffer(worldBorderBuffer);
-    for (const ModelBuffer &buffer: modelBuffers | std::views::values)
+    DestroyBatchRing();
+    modelBuffers.Clear();
+    errorModel = nullptr;
+}
+
+MapRenderer::BatchProgramLocations MapRenderer::GetBatchProgramLocations(const GLuint program)
+{
+    return {
+        .viewMatrix = glGetUniformLocation(program, "VIEW_MATRIX"),
+        .sprite = glGetUniformLocation(program, "sprite"),
+    };
+}
+
+void MapRenderer::SetBatchVertexFormat()
+{
+    glVertexAttribPointer(BATCH_POSITION_LOCATION,
+                          3,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(BatchVertex),
+                          reinterpret_cast<void *>(offsetof(BatchVertex, position)));
+    glVertexAttribPointer(BATCH_COLOR_LOCATION,
+                          4,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(BatchVertex),
+                          reinterpret_cast<void *>(offsetof(BatchVertex, color)));
+    glVertexAttribPointer(BATCH_SIZE_LOCATION,
+                          1,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(BatchVertex),
+                          reinterpret_cast<void *>(offsetof(BatchVertex, size)));
+    glEnableVertexAttribArray(BATCH_POSITION_LOCATION);
+    glEnableVertexAttribArray(BATCH_COLOR_LOCATION);
+    glEnableVertexAttribArray(BATCH_SIZE_LOCATION);
+}
+
+bool MapRenderer::CreateBatchRing()
+{
+    glGenVertexArrays(1, &batchVao);
+    glBindVertexArray(batchVao);
+
+    glGenBuffers(1, &batchRingBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, batchRingBuffer);
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_ARRAY_BUFFER, BATCH_RING_BYTES, nullptr, flags);
+    batchRingData = static_cast<uint8_t *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, BATCH_RING_BYTES, flags));
+    if (batchRingData == nullptr)
+    {
+        Logger::Error("Failed to map the batch vertex buffer");
+        return false;
+    }
+    batchRingOffset = 0;
+
+    SetBatchVertexFormat();
+
+    return true;
+}
+
+void MapRenderer::DestroyBatchRing()
+{
+    for (const RingFence &fence: batchRingFences)
+    {
+        glDeleteSync(fence.sync);
+    }
+    batchRingFences.clear();
+    batches.clear();
+    modelBatches.clear();
+    modelBatchCount = 0;
+    modelBatchIndices.clear();
+    batchesPending = false;
+
+    if (batchRingData != nullptr)
     {
-        glDeleteVertexArrays(1, &buffer.vao);
-        glDeleteBuffers(1, &buffer.vbo);
-        for (const GLuint &ebo: buffer.ebos)
+        glBindBuffer(GL_ARRAY_BUFFER, batchRingBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        batchRingData = nullptr;
+    }
+    glDeleteBuffers(1, &batchRingBuffer);
+    glDeleteVertexArrays(1, &batchVao);
+}
+
+void MapRenderer::SetBatchMatrix(const glm::mat4 &matrix)
+{
+    if (batchesPending && matrix != batchMatrix)
+    {
+        FlushBatches();
+    }
+    batchMatrix = matrix;
+    batchesPending = true;
+}
+
+MapRenderer::Batch &MapRenderer::GetBatch(const BatchPrimitive primitive,
+                                          const float lineWidth,
+                                          const GLuint texture,
+                                          const glm::mat4 &matrix)
+{
+    SetBatchMatrix(matrix);
+
+    // Consecutive primitives almost always go to the same batch
+    if (lastBatchIndex < batches.size())
+    {
+        Batch &last = batches.at(lastBatchIndex);
+        if (last.primitive == primitive && last.lineWidth == lineWidth && last.texture == texture)
+        {
+            return last;
+        }
+    }
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        Batch &batch = batches.at(i);
+        if (batch.primitive == primitive && batch.lineWidth == lineWidth && batch.texture == texture)
         {
-            glDeleteBuffers(1, &ebo);
+            lastBatchIndex = i;
+            return batch;
         }
     }
+    lastBatchIndex = batches.size();
+    return batches.emplace_back(Batch{.primitive = primitive, .lineWidth = lineWidth, .texture = texture});
+}
+
+size_t MapRenderer::ReserveBatchRing(const size_t bytes, const size_t alignment)
+{
+    batchRingOffset = (batchRingOffset + alignment - 1) / alignment * alignment;
+    if (batchRingOffset + bytes > BATCH_RING_BYTES)
+    {
+        batchRingOffset = 0;
+    }
+    const size_t start = batchRingOffset;
+    const size_t end = start + bytes;
+    std::erase_if(batchRingFences, [start, end](const RingFence &fence) {
+        if (fence.start >= end || fence.end <= start)
+        {
+            return false;
+        }
+        while (glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence.sync);
+        return true;
+    });
+    batchRingOffset = end;
+    return start;
+}
+
+void MapRenderer::DrawBatch(const Batch &batch)
+{
+    // Keep lines whole when a batch is too large for the ring buffer
+    constexpr size_t maxVertices = BATCH_RING_BYTES / sizeof(BatchVertex) / 2 * 2;
+
+    const BatchProgramLocations &locations = batch.primitive == BatchPrimitive::SPRITES ? batchSpriteLocations
+                                                                                         : batchLocations;
+    glUseProgram(batch.primitive == BatchPrimitive::SPRITES ? batchSpriteProgram : batchProgram);
+    glUniformMatrix4fv(locations.viewMatrix, 1, GL_FALSE, glm::value_ptr(batchMatrix));
+
+    GLenum mode = GL_POINTS;
+    if (batch.primitive == BatchPrimitive::LINES)
+    {
+        mode = GL_LINES;
+        glLineWidth(batch.lineWidth);
+    } else if (batch.primitive == BatchPrimitive::SPRITES)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, batch.texture);
+        glUniform1i(locations.sprite, 0);
+    }
+
+    for (size_t first = 0; first < batch.vertices.size(); first += maxVertices)
+    {
+        const size_t count = std::min(maxVertices, batch.vertices.size() - first);
+        const size_t bytes = count * sizeof(BatchVertex);
+        const size_t offset = ReserveBatchRing(bytes, sizeof(BatchVertex));
+        std::memcpy(batchRingData + offset, batch.vertices.data() + first, bytes);
+        glDrawArrays(mode, static_cast<GLint>(offset / sizeof(BatchVertex)), static_cast<GLsizei>(count));
+        Profiler::Get().CountUpload(bytes);
+        Profiler::Get().CountDrawCall();
+        batchRingFences.push_back({
+            .sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+            .start = offset,
+            .end = offset + bytes,
+        });
+    }
+}
+
+void MapRenderer::FlushBatches()
+{
+    if (!batchesPending)
+    {
+        return;
+    }
+    batchesPending = false;
+    const Profiler::Scope scope("Batching");
+
+    if (modelBatchCount > 0)
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        glLineWidth(1);
+        glUseProgram(modelProgram);
+        glUniformMatrix4fv(modelLocations.viewMatrix, 1, GL_FALSE, glm::value_ptr(batchMatrix));
+        for (size_t i = 0; i < modelBatchCount; i++)
+        {
+            ModelBatch &batch = modelBatches.at(i);
+            DrawModelBatch(batch);
+            batch.buffer = nullptr;
+            batch.instances.clear();
+        }
+        modelBatchCount = 0;
+        modelBatchIndices.clear();
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
+
+    glBindVertexArray(batchVao);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    for (Batch &batch: batches)
+    {
+        if (!batch.vertices.empty())
+        {
+            DrawBatch(batch);
+            batch.vertices.clear();
+        }
+    }
+    glDisable(GL_PROGRAM_POINT_SIZE);
+}
+
+MapRenderer::RetainedBuffer MapRenderer::CreateRetainedBuffer()
+{
+    RetainedBuffer buffer{};
+    glGenVertexArrays(1, &buffer.vao);
+    glBindVertexArray(buffer.vao);
+    glGenBuffers(1, &buffer.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+    SetBatchVertexFormat();
+    return buffer;
+}
+
+void MapRenderer::DestroyRetainedBuffer(RetainedBuffer &buffer)
+{
+    glDeleteBuffers(1, &buffer.vbo);
+    glDeleteVertexArrays(1, &buffer.vao);
+    buffer = {};
+}
+
+void MapRenderer::RenderRetained(const RetainedBuffer &buffer,
+                                 const BatchPrimitive primitive,
+                                 const float lineWidth,
+                                 const std::vector<GLint> &firsts,
+                                 const std::vector<GLsizei> &counts,
+                                 const glm::mat4 &matrix)
+{
+    assert(primitive != BatchPrimitive::SPRITES);
+    assert(firsts.size() == counts.size());
+    if (firsts.empty())
+    {
+        return;
+    }
+
+    glUseProgram(batchProgram);
+    glUniformMatrix4fv(batchLocations.viewMatrix, 1, GL_FALSE, glm::value_ptr(matrix));
+    glBindVertexArray(buffer.vao);
+    if (primitive == BatchPrimitive::LINES)
+    {
+        glLineWidth(lineWidth);
+        glMultiDrawArrays(GL_LINES, firsts.data(), counts.data(), static_cast<GLsizei>(firsts.size()));
+    } else
+    {
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        glMultiDrawArrays(GL_POINTS, firsts.data(), counts.data(), static_cast<GLsizei>(firsts.size()));
+        glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+    Profiler::Get().CountDrawCall(firsts.size());
+}
+
+void MapRenderer::DrawModelBatch(const ModelBatch &batch)
+{
+    constexpr size_t maxInstances = BATCH_RING_BYTES / sizeof(ModelInstance);
+
+    const ModelLod &lod = batch.buffer->model.GetLod(0);
+    glBindVertexArray(batch.buffer->vao);
+    for (size_t first = 0; first < batch.instances.size(); first += maxInstances)
+    {
+        const size_t count = std::min(maxInstances, batch.instances.size() - first);
+        const size_t bytes = count * sizeof(ModelInstance);
+        const size_t offset = ReserveBatchRing(bytes, sizeof(ModelInstance));
+        std::memcpy(batchRingData + offset, batch.instances.data() + first, bytes);
+        Profiler::Get().CountUpload(bytes);
+        Profiler::Get().CountDrawCall(batch.buffer->ebos.size());
+        for (size_t i = 0; i < batch.buffer->ebos.size(); i++)
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.buffer->ebos.at(i));
+            glDrawElementsInstancedBaseInstance(GL_TRIANGLES,
+                                                static_cast<GLsizei>(lod.indexCounts.at(i)),
+                                                GL_UNSIGNED_INT,
+                                                nullptr,
+                                                static_cast<GLsizei>(count),
+                                                static_cast<GLuint>(offset / sizeof(ModelInstance)));
+        }
+        batchRingFences.push_back({
+            .sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+            .start = offset,
+            .end = offset + bytes,
+        });
+    }
+}
+
+MapRenderer::ModelBuffer::~ModelBuffer()
+{
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    for (const GLuint &ebo: ebos)
+    {
+        glDeleteBuffers(1, &ebo);
+    }
 }
 
 void MapRenderer::RenderViewportGrid(const Viewport &vp)
@@ -151,19 +484,20 @@ void MapRenderer::RenderViewportGrid(const Viewport &vp)
         const int numInstances = static_cast<int>(MapEditor::MAP_SIZE * 2 / gridSpacing);
 
         glUseProgram(gridProgram);
-        glUniformMatrix4fv(glGetUniformLocation(gridProgram, "matrix"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniform1f(glGetUniformLocation(gridProgram, "spacing"), gridSpacing);
-        glUniform1i(glGetUniformLocation(gridProgram, "plane"), static_cast<int>(vp.GetType()));
+        glUniformMatrix4fv(gridLocations.matrix, 1, GL_FALSE, glm::value_ptr(view));
+        glUniform1f(gridLocations.spacing, gridSpacing);
+        glUniform1i(gridLocations.plane, static_cast<int>(vp.GetType()));
         glDrawArraysInstanced(GL_LINES, 0, 2, numInstances);
+        Profiler::Get().CountDrawCall();
     }
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
 
     glUseProgram(lineProgram);
-    glUniformMatrix4fv(glGetUniformLocation(lineProgram, "VIEW"), 1, GL_FALSE, glm::value_ptr(view));
-    const GLint posAttrib = glGetAttribLocation(lineProgram, "VERTEX");
-    const GLint colorAttrib = glGetAttribLocation(lineProgram, "VERTEX_COLOR");
+    glUniformMatrix4fv(lineLocations.view, 1, GL_FALSE, glm::value_ptr(view));
+    const GLint posAttrib = lineLocations.vertex;
+    const GLint colorAttrib = lineLocations.vertexColor;
     if (MapEditor::drawAxisHelper)
     {
         GLHelper::BindBuffer(axisHelperBuffer);
@@ -177,6 +511,7 @@ void MapRenderer::RenderViewportGrid(const Viewport &vp)
         glEnableVertexAttribArray(posAttrib);
         glEnableVertexAttribArray(colorAttrib);
         glDrawArrays(GL_LINES, 0, 6);
+        Profiler::Get().CountDrawCall();
     }
     if (MapEditor::drawWorldBorder)
     {
@@ -191,6 +526,7 @@ void MapRenderer::RenderViewportGrid(const Viewport &vp)
         glEnableVertexAttribArray(posAttrib);
         glEnableVertexAttribArray(colorAttrib);
         glDrawArrays(GL_LINES, 0, 24);
+        Profiler::Get().CountDrawCall();
     }
 
     glClear(GL_DEPTH_BUFFER_BIT);
@@ -201,74 +537,30 @@ void MapRenderer::RenderViewportGrid(const Viewport &vp)
 
 void MapRenderer::RenderLine(const glm::vec3 start,
                              const glm::vec3 end,
-                             Color color,
+                             const Color color,
                              const glm::mat4 &matrix,
                              const float thickness)
 {
-    glUseProgram(genericProgram);
-
-    glLineWidth(thickness);
-
-    glUniform4fv(glGetUniformLocation(genericProgram, "alb"), 1, color.GetDataPointer());
-    glUniformMatrix4fv(glGetUniformLocation(genericProgram, "VIEW_MATRIX"), 1, GL_FALSE, glm::value_ptr(matrix));
-    glUniformMatrix4fv(glGetUniformLocation(genericProgram, "WORLD_MATRIX"), 1, GL_FALSE, glm::value_ptr(identity));
-
-    const std::vector<float> vertices = {
-        start.x,
-        start.y,
-        start.z,
-        end.x,
-        end.y,
-        end.z,
-    };
-
-    GLHelper::BindBuffer(workBufferNonIndexed);
-    glBufferData(GL_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(vertices.size() * sizeof(GLfloat)),
-                 vertices.data(),
-                 GL_STREAM_DRAW);
-    const GLint posAttrLoc = glGetAttribLocation(genericProgram, "VERTEX");
-    glVertexAttribPointer(posAttrLoc, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
-    glEnableVertexAttribArray(posAttrLoc);
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size()));
+    Batch &batch = GetBatch(BatchPrimitive::LINES, thickness, 0, matrix);
+    batch.vertices.push_back({.position = start, .color = color.CopyData(), .size = thickness});
+    batch.vertices.push_back({.position = end, .color = color.CopyData(), .size = thickness});
 }
 
 void MapRenderer::RenderBillboardPoint(const glm::vec3 position,
                                        const float pointSize,
-                                       Color color,
+                                       const Color color,
                                        const glm::mat4 &matrix)
 {
-    glUseProgram(genericProgram);
-
-    glPointSize(pointSize);
-
-    glUniform4fv(glGetUniformLocation(genericProgram, "alb"), 1, color.GetDataPointer());
-    glUniformMatrix4fv(glGetUniformLocation(genericProgram, "VIEW_MATRIX"), 1, GL_FALSE, glm::value_ptr(matrix));
-    glUniformMatrix4fv(glGetUniformLocation(genericProgram, "WORLD_MATRIX"), 1, GL_FALSE, glm::value_ptr(identity));
-
-    const std::vector<float> vertices = {position.x, position.y, position.z};
-
-    GLHelper::BindBuffer(workBufferNonIndexed);
-    glBufferData(GL_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(vertices.size() * sizeof(GLfloat)),
-                 vertices.data(),
-                 GL_STREAM_DRAW);
-    const GLint posAttrLoc = glGetAttribLocation(genericProgram, "VERTEX");
-    glVertexAttribPointer(posAttrLoc, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
-    glEnableVertexAttribArray(posAttrLoc);
-    glDrawArrays(GL_POINTS, 0, 1);
+    Batch &batch = GetBatch(BatchPrimitive::POINTS, 0, 0, matrix);
+    batch.vertices.push_back({.position = position, .color = color.CopyData(), .size = pointSize});
 }
 
 void MapRenderer::RenderBillboardSprite(const glm::vec3 position,
                                         const float pointSize,
                                         const std::string &texture,
-                                        Color color,
+                                        const Color color,
                                         const glm::mat4 &matrix)
 {
-    glUseProgram(spriteProgram);
-
-    glPointSize(pointSize);
-
     GLuint textureId = -1;
     const Error::ErrorCode e = SharedMgr::Get().textureCache.GetTextureGLuint(texture, textureId);
     if (e != Error::ErrorCode::OK)
@@ -276,24 +568,8 @@ void MapRenderer::RenderBillboardSprite(const glm::vec3 position,
         textureId = SharedMgr::Get().textureCache.GetMissingTextureGLuint();
     }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureId);
-    glUniform1i(glGetUniformLocation(spriteProgram, "sprite"), 0);
-    glUniform4fv(glGetUniformLocation(spriteProgram, "color"), 1, color.GetDataPointer());
-    glUniformMatrix4fv(glGetUniformLocation(spriteProgram, "VIEW_MATRIX"), 1, GL_FALSE, glm::value_ptr(matrix));
-    glUniformMatrix4fv(glGetUniformLocation(spriteProgram, "WORLD_MATRIX"), 1, GL_FALSE, glm::value_ptr(identity));
-
-    const std::vector<float> vertices = {position.x, position.y, position.z};
-
-    GLHelper::BindBuffer(workBufferNonIndexed);
-    glBufferData(GL_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>(vertices.size() * sizeof(GLfloat)),
-                 vertices.data(),
-                 GL_STREAM_DRAW);
-    const GLint posAttrLoc = glGetAttribLocation(spriteProgram, "VERTEX");
-    glVertexAttribPointer(posAttrLoc, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
-    glEnableVertexAttribArray(posAttrLoc);
-    glDrawArrays(GL_POINTS, 0, 1);
+    Batch &batch = GetBatch(BatchPrimitive::SPRITES, 0, textureId, matrix);
+    batch.vertices.push_back({.position = position, .color = color.CopyData(), .size = pointSize});
 }
 
 void MapRenderer::RenderUnitVector(const glm::vec3 origin,
@@ -320,64 +596,93 @@ void MapRenderer::RenderModel(std::string model,
                               const glm::mat4 &worldMatrix,
                               const Color &c)
 {
-    if (!model.empty())
+    if (model.empty())
+    {
+        return;
+    }
+    std::shared_ptr<ModelBuffer> buffer = GetModelBuffer(model);
+    SetBatchMatrix(viewMatrix);
+
+    const auto [iterator, inserted] = modelBatchIndices.try_emplace(buffer.get(), modelBatchCount);
+    if (inserted)
     {
-        if (!modelBuffers.contains(model))
+        if (modelBatchCount == modelBatches.size())
         {
-            const std::string absolutePath = SharedMgr::Get().pathManager.GetAssetPath(model);
-            if (absolutePath.empty())
-            {
-                model = "model/error.gmdl";
-            } else
-            {
-                const ModelBuffer buf = LoadModel(absolutePath);
-                modelBuffers[model] = buf;
-            }
+            modelBatches.emplace_back();
         }
-        RenderModel(modelBuffers.at(model), viewMatrix, worldMatrix, c);
+        modelBatches.at(modelBatchCount).buffer = std::move(buffer);
+        modelBatchCount++;
     }
+    modelBatches.at(iterator->second).instances.push_back({.worldMatrix = worldMatrix, .color = c.CopyData()});
 }
 
-const ModelAsset &MapRenderer::GetModel(std::string model)
+std::shared_ptr<const ModelAsset> MapRenderer::GetModel(std::string model)
 {
-    if (!model.empty())
+    const std::shared_ptr<ModelBuffer> buffer = model.empty() ? errorModel : GetModelBuffer(model);
+    return {buffer, &buffer->model};
+}
+
+std::shared_ptr<MapRenderer::ModelBuffer> MapRenderer::GetModelBuffer(const std::string &model)
+{
+    std::shared_ptr<ModelBuffer> buffer = modelBuffers.Get(model);
+    if (buffer != nullptr)
     {
-        if (!modelBuffers.contains(model))
-        {
-            const std::string absolutePath = SharedMgr::Get().pathManager.GetAssetPath(model);
-            if (absolutePath.empty())
-            {
-                model = "model/error.gmdl";
-            } else
-            {
-                const ModelBuffer buf = LoadModel(absolutePath);
-                modelBuffers[model] = buf;
-            }
-        }
-        return modelBuffers[model].model;
+        return buffer;
     }
-    return modelBuffers["model/error.gmdl"].model;
+    const std::string absolutePath = SharedMgr::Get().pathManager.GetAssetPath(model);
+    if (absolutePath.empty())
+    {
+        return errorModel;
+    }
+    buffer = LoadModel(absolutePath);
+    return modelBuffers.Insert(model, buffer, buffer->bytes);
 }
 
-MapRenderer::ModelBuffer MapRenderer::LoadModel(const std::string &path)
+std::shared_ptr<MapRenderer::ModelBuffer> MapRenderer::LoadModel(const std::string &path)
 {
     Logger::Info("Loading model \"{}\"", path);
-    ModelBuffer buf{};
-    const Error::ErrorCode e = buf.model.LoadFromAsset(path);
+    const std::shared_ptr<ModelBuffer> buf = std::make_shared<ModelBuffer>();
+    const Error::ErrorCode e = buf->model.LoadFromAsset(path);
     assert(e == Error::ErrorCode::OK); // TODO proper handling
-    glGenVertexArrays(1, &buf.vao);
-    glBindVertexArray(buf.vao);
+    glGenVertexArrays(1, &buf->vao);
+    glBindVertexArray(buf->vao);
 
-    glGenBuffers(1, &buf.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, buf.vbo);
+    glGenBuffers(1, &buf->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, buf->vbo);
 
     DataWriter writer;
-    buf.model.GetVertexBuffer(0, writer);
+    buf->model.GetVertexBuffer(0, writer);
     std::vector<uint8_t> buffer;
     writer.CopyToVector(buffer);
     glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(writer.GetBufferSize()), buffer.data(), GL_STATIC_DRAW);
+    size_t dataBytes = writer.GetBufferSize();
+    glVertexAttribPointer(MODEL_POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), nullptr);
+    glEnableVertexAttribArray(MODEL_POSITION_LOCATION);
 
-    const ModelLod &lod = buf.model.GetLod(0);
+    // Instances are streamed through the ring buffer and picked with the base instance of each draw
+    glBindBuffer(GL_ARRAY_BUFFER, batchRingBuffer);
+    for (GLuint column = 0; column < 4; column++)
+    {
+        glVertexAttribPointer(INSTANCE_MATRIX_LOCATION + column,
+                              4,
+                              GL_FLOAT,
+                              GL_FALSE,
+                              sizeof(ModelInstance),
+                              reinterpret_cast<void *>(offsetof(ModelInstance, worldMatrix) +
+                                                       (column * sizeof(glm::vec4))));
+        glVertexAttribDivisor(INSTANCE_MATRIX_LOCATION + column, 1);
+        glEnableVertexAttribArray(INSTANCE_MATRIX_LOCATION + column);
+    }
+    glVertexAttribPointer(INSTANCE_COLOR_LOCATION,
+                          4,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(ModelInstance),
+                          reinterpret_cast<void *>(offsetof(ModelInstance, color)));
+    glVertexAttribDivisor(INSTANCE_COLOR_LOCATION, 1);
+    glEnableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+
+    const ModelLod &lod = buf->model.GetLod(0);
     for (size_t i = 0; i < lod.indexCounts.size(); i++)
     {
         GLuint ebo = 0;
@@ -387,42 +692,11 @@ MapRenderer::ModelBuffer MapRenderer::LoadModel(const std::string &path)
                      static_cast<GLsizeiptr>(lod.indexCounts.at(i) * sizeof(uint32_t)),
                      lod.materialIndices.at(i).data(),
                      GL_STATIC_DRAW);
-        buf.ebos.push_back(ebo);
+        buf->ebos.push_back(ebo);
+        dataBytes += lod.indexCounts.at(i) * sizeof(uint32_t);
     }
+    buf->bytes = dataBytes * 2;
+    Profiler::Get().CountUpload(dataBytes);
 
     return buf;
 }
-
-void MapRenderer::RenderModel(ModelBuffer &buffer,
-                              const glm::mat4 &viewMatrix,
-                              const glm::mat4 &worldMatrix,
-                              const Color &c)
-{
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glUseProgram(genericProgram);
-
-    glLineWidth(1);
-
-    glUniform4fv(glGetUniformLocation(genericProgram, "alb"), 1, c.GetDataPointer());
-    glUniformMatrix4fv(glGetUniformLocation(genericProgram, "VIEW_MATRIX"), 1, GL_FALSE, glm::value_ptr(viewMatrix));
-    glUniformMatrix4fv(glGetUniformLocation(genericProgram, "WORLD_MATRIX"), 1, GL_FALSE, glm::value_ptr(worldMatrix));
-
-    glBindVertexArray(buffer.vao);
-    glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
-
-    const GLint posAttrib = glGetAttribLocation(genericProgram, "VERTEX");
-    glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(posAttrib);
-
-    for (size_t i = 0; i < buffer.ebos.size(); i++)
-    {
-        const GLuint ebo = buffer.ebos.at(i);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-        glDrawElements(GL_TRIANGLES,
-                       static_cast<GLsizei>(buffer.model.GetLod(0).indexCounts.at(i)),
-                       GL_UNSIGNED_INT,
-                       nullptr);
-    }
-
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-}
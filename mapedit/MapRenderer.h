@@ -8,8 +8,13 @@
 #include <GL/glew.h>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <libassets/asset/ModelAsset.h>
 #include <libassets/type/Color.h>
+#include <libassets/util/AssetCache.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +23,28 @@
 class MapRenderer
 {
     public:
+        enum class BatchPrimitive : uint8_t
+        {
+            LINES,
+            POINTS,
+            SPRITES
+        };
+
+        struct BatchVertex
+        {
+                glm::vec3 position;
+                std::array<float, 4> color;
+                /// The point size, unused by lines
+                float size;
+        };
+
+        /// Vertices that stay on the GPU between frames, in the same format as batched vertices
+        struct RetainedBuffer
+        {
+                GLuint vao = 0;
+                GLuint vbo = 0;
+        };
+
         MapRenderer() = delete;
 
         static bool Init();
@@ -25,6 +52,12 @@ class MapRenderer
 
         static void RenderViewportGrid(const Viewport &vp);
 
+        /**
+         * Draw the lines, points and sprites queued since the last flush.
+         * This must be called before clearing the depth buffer and once the viewport is done rendering.
+         */
+        static void FlushBatches();
+
         static void RenderLine(glm::vec3 start, glm::vec3 end, Color color, const glm::mat4 &matrix, float thickness);
 
         static void RenderBillboardPoint(glm::vec3 position, float pointSize, Color color, const glm::mat4 &matrix);
@@ -42,41 +75,202 @@ class MapRenderer
                                      float thickness,
                                      float length);
 
+        /**
+         * Queue an instance of a model. Instances of the same model are drawn together when the batches are flushed.
+         */
         static void RenderModel(std::string model,
                                 const glm::mat4 &viewMatrix,
                                 const glm::mat4 &worldMatrix,
                                 const Color &c);
 
-        static const ModelAsset &GetModel(std::string model);
+        static std::shared_ptr<const ModelAsset> GetModel(std::string model);
+
+        [[nodiscard]] static RetainedBuffer CreateRetainedBuffer();
+
+        static void DestroyRetainedBuffer(RetainedBuffer &buffer);
+
+        /**
+         * Draw ranges of a retained buffer in one call
+         * @param buffer The buffer to draw from
+         * @param primitive LINES or POINTS
+         * @param lineWidth The width of lines
+         * @param firsts The first vertex of each range
+         * @param counts The number of vertices in each range
+         * @param matrix The view matrix
+         */
+        static void RenderRetained(const RetainedBuffer &buffer,
+                                   BatchPrimitive primitive,
+                                   float lineWidth,
+                                   const std::vector<GLint> &firsts,
+                                   const std::vector<GLsizei> &counts,
+                                   const glm::mat4 &matrix);
 
     private:
+        /// The amount of memory that loaded models may use before the least recently used ones are unloaded
+        static constexpr size_t MODEL_CACHE_BUDGET_BYTES = 256ull * 1024 * 1024;
+
+        /// A model and its OpenGL buffers, which are deleted along with it
         struct ModelBuffer
         {
-                ModelAsset model;
-                GLuint vao;
-                GLuint vbo;
-                std::vector<GLuint> ebos;
+                ModelAsset model{};
+                GLuint vao = 0;
+                GLuint vbo = 0;
+                std::vector<GLuint> ebos{};
+                /// The size of the vertex and index data, counting both the CPU and GPU copies
+                size_t bytes = 0;
+
+                ModelBuffer() = default;
+                ~ModelBuffer();
+                ModelBuffer(const ModelBuffer &) = delete;
+                ModelBuffer &operator=(const ModelBuffer &) = delete;
+        };
+
+        /// The size of the persistently mapped buffer that batched vertices are streamed through
+        static constexpr size_t BATCH_RING_BYTES = 4ull * 1024 * 1024;
+        /// Attribute locations set in batched.vert, which is shared by both batch programs and their VAO
+        static constexpr GLuint BATCH_POSITION_LOCATION = 0;
+        static constexpr GLuint BATCH_COLOR_LOCATION = 1;
+        static constexpr GLuint BATCH_SIZE_LOCATION = 2;
+        /// Attribute locations set in instancedModel.vert. The matrix takes one location per column.
+        static constexpr GLuint MODEL_POSITION_LOCATION = 0;
+        static constexpr GLuint INSTANCE_MATRIX_LOCATION = 3;
+        static constexpr GLuint INSTANCE_COLOR_LOCATION = 7;
+
+        /// Primitives that can be drawn with one draw call
+        struct Batch
+        {
+                BatchPrimitive primitive;
+                float lineWidth;
+                GLuint texture;
+                std::vector<BatchVertex> vertices{};
+        };
+
+        struct ModelInstance
+        {
+                glm::mat4 worldMatrix;
+                std::array<float, 4> color;
+        };
+
+        /// The instances of one model queued since the last flush
+        struct ModelBatch
+        {
+                std::shared_ptr<ModelBuffer> buffer{};
+                std::vector<ModelInstance> instances{};
+        };
+
+        /// A range of the ring buffer that can't be written to until the GPU is done drawing from it
+        struct RingFence
+        {
+                GLsync sync;
+                size_t start;
+                size_t end;
+        };
+
+        struct GridProgramLocations
+        {
+                GLint matrix;
+                GLint spacing;
+                GLint plane;
+        };
+
+        struct LineProgramLocations
+        {
+                GLint view;
+                GLint vertex;
+                GLint vertexColor;
+        };
+
+        struct BatchProgramLocations
+        {
+                GLint viewMatrix;
+                GLint sprite;
+        };
+
+        struct ModelProgramLocations
+        {
+                GLint viewMatrix;
         };
 
-        static inline GLuint genericProgram = 0;
         static inline GLuint lineProgram = 0;
         static inline GLuint gridProgram = 0;
-        static inline GLuint spriteProgram = 0;
+        static inline GLuint batchProgram = 0;
+        static inline GLuint batchSpriteProgram = 0;
+        static inline GLuint modelProgram = 0;
+
+        static inline GridProgramLocations gridLocations{};
+        static inline LineProgramLocations lineLocations{};
+        static inline BatchProgramLocations batchLocations{};
+        static inline BatchProgramLocations batchSpriteLocations{};
+        static inline ModelProgramLocations modelLocations{};
 
         static inline GLHelper::GL_Buffer axisHelperBuffer{};
         static inline GLHelper::GL_Buffer worldBorderBuffer{};
 
         static inline GLHelper::GL_IndexedBuffer workBuffer{};
-        static inline GLHelper::GL_Buffer workBufferNonIndexed{};
 
-        static inline std::unordered_map<std::string, ModelBuffer> modelBuffers{};
+        static inline GLuint batchVao = 0;
+        static inline GLuint batchRingBuffer = 0;
+        static inline uint8_t *batchRingData = nullptr;
+        static inline size_t batchRingOffset = 0;
+        static inline std::vector<RingFence> batchRingFences{};
+
+        /// Batches are kept between flushes so their vertex storage is reused
+        static inline std::vector<Batch> batches{};
+        static inline size_t lastBatchIndex = 0;
+        static inline glm::mat4 batchMatrix{};
+        static inline bool batchesPending = false;
+
+        /// Model batches are kept between flushes so their instance storage is reused, but release their model
+        static inline std::vector<ModelBatch> modelBatches{};
+        static inline size_t modelBatchCount = 0;
+        static inline std::unordered_map<const ModelBuffer *, size_t> modelBatchIndices{};
+
+        static inline AssetCache<ModelBuffer> modelBuffers{MODEL_CACHE_BUDGET_BYTES};
+        /// The fallback model, which is never evicted
+        static inline std::shared_ptr<ModelBuffer> errorModel{};
 
         static inline glm::mat4 identity = glm::identity<glm::mat4>();
 
-        static ModelBuffer LoadModel(const std::string &path);
+        static std::shared_ptr<ModelBuffer> LoadModel(const std::string &path);
+
+        static BatchProgramLocations GetBatchProgramLocations(GLuint program);
+
+        /**
+         * Set up the vertex attributes of the bound VAO for the bound buffer of batch vertices
+         */
+        static void SetBatchVertexFormat();
+
+        static bool CreateBatchRing();
+
+        static void DestroyBatchRing();
+
+        /**
+         * Set the view matrix of the queued batches, flushing them first if it changed
+         */
+        static void SetBatchMatrix(const glm::mat4 &matrix);
+
+        /**
+         * Get the batch that a primitive should be added to, flushing the queued batches first if the matrix changed
+         */
+        static Batch &GetBatch(BatchPrimitive primitive, float lineWidth, GLuint texture, const glm::mat4 &matrix);
+
+        /**
+         * Reserve space in the ring buffer, waiting for the GPU to finish with it if needed
+         * @param bytes The number of bytes to reserve, which must fit in the ring buffer
+         * @param alignment The offset is a multiple of this, so that it can be used as a first vertex or instance
+         * @return The offset of the reserved space
+         */
+        static size_t ReserveBatchRing(size_t bytes, size_t alignment);
+
+        static void DrawBatch(const Batch &batch);
+
+        static void DrawModelBatch(const ModelBatch &batch);
+
+        /**
+         * Get a model, loading it if needed
+         * @param model The model path
+         * @return The model, or the error model if it does not exist
+         */
+        static std::shared_ptr<ModelBuffer> GetModelBuffer(const std::string &model);
 
-        static void RenderModel(ModelBuffer &buffer,
-                                const glm::mat4 &viewMatrix,
-                                const glm::mat4 &worldMatrix,
-                                const Color &c);
 };
@@ -0,0 +1,256 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include "MapSpatialIndex.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <game_sdk/Profiler.h>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/glm.hpp>
+#include <iterator>
+#include <libassets/asset/ModelAsset.h>
+#include <libassets/type/Actor.h>
+#include <libassets/type/BoundingBox.h>
+#include <libassets/type/renderDefs/RenderDefinition.h>
+#include <libassets/type/Sector.h>
+#include <libassets/util/AABBTree.h>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <vector>
+#include "ActorRenderCache.h"
+#include "MapEditor.h"
+#include "MapHistory.h"
+#include "MapRenderer.h"
+#include "SectorGeometryCache.h"
+#include "Viewport.h"
+
+void MapSpatialIndex::Update(const MapHistory::Changes &changes)
+{
+    const std::vector<Actor> &mapActors = MapEditor::map.actors;
+    const std::vector<Sector> &mapSectors = MapEditor::map.sectors;
+    MapHistory::ChangedRange changedActors = changes.actors;
+    if (lastDrawGizmos != MapEditor::drawGizmos)
+    {
+        changedActors = {.start = 0, .end = mapActors.size()};
+        lastDrawGizmos = MapEditor::drawGizmos;
+    }
+    const MapHistory::ChangedRange &changedSectors = changes.sectors;
+    if (changedActors.start >= changedActors.end &&
+        changedSectors.start >= changedSectors.end &&
+        actors.size() == mapActors.size() &&
+        sectors.size() == mapSectors.size())
+    {
+        return;
+    }
+    const Profiler::Scope scope("Spatial index");
+    generation++;
+
+    while (actors.size() > mapActors.size())
+    {
+        tree.Remove(actors.back().proxy);
+        actors.pop_back();
+    }
+    while (sectors.size() > mapSectors.size())
+    {
+        tree.Remove(sectors.back().proxy);
+        sectors.pop_back();
+    }
+    // New items are part of the changed range, so they get their bounds below
+    actors.resize(mapActors.size());
+    sectors.resize(mapSectors.size());
+
+    const size_t actorEnd = std::min(changedActors.end, mapActors.size());
+    for (size_t i = changedActors.start; i < actorEnd; i++)
+    {
+        SetBounds(actors.at(i),
+                  CalculateActorBounds(mapActors.at(i), ActorRenderCache::Get(i)),
+                  static_cast<uint32_t>(i));
+    }
+
+    const size_t sectorEnd = std::min(changedSectors.end, mapSectors.size());
+    for (size_t i = changedSectors.start; i < sectorEnd; i++)
+    {
+        const Sector &sector = mapSectors.at(i);
+        const glm::vec4 &aabb = SectorGeometryCache::GetAABB(i);
+        const AABBTree::Bounds bounds = {
+            .min = glm::vec3(aabb.x - aabb.z, sector.floorHeight, aabb.y - aabb.w),
+            .max = glm::vec3(aabb.x + aabb.z, sector.ceilingHeight, aabb.y + aabb.w),
+        };
+        SetBounds(sectors.at(i), bounds, static_cast<uint32_t>(i) | SECTOR_FLAG);
+    }
+}
+
+void MapSpatialIndex::SetBounds(Entry &entry, const AABBTree::Bounds &bounds, const uint32_t userData)
+{
+    entry.bounds = bounds;
+    if (entry.proxy == AABBTree::NULL_NODE)
+    {
+        entry.proxy = tree.Insert(bounds, userData);
+    } else
+    {
+        tree.Move(entry.proxy, bounds);
+    }
+}
+
+void MapSpatialIndex::Query(const Viewport &vp,
+                            std::vector<size_t> &outActorIndices,
+                            std::vector<size_t> &outSectorIndices)
+{
+    const glm::vec2 halfSize = vp.GetWorldSpaceSize() / 2.0f;
+    const glm::vec3 cameraPos = vp.GetCameraPos();
+    constexpr float infinity = std::numeric_limits<float>::max();
+
+    // Viewports are orthographic, so they see everything along their depth axis
+    AABBTree::Bounds viewBounds{};
+    switch (vp.GetType())
+    {
+        case Viewport::ViewportType::TOP_DOWN_XZ:
+            viewBounds.min = glm::vec3(cameraPos.x - halfSize.x, -infinity, cameraPos.z - halfSize.y);
+            viewBounds.max = glm::vec3(cameraPos.x + halfSize.x, infinity, cameraPos.z + halfSize.y);
+            break;
+        case Viewport::ViewportType::FRONT_XY:
+            viewBounds.min = glm::vec3(cameraPos.x - halfSize.x, cameraPos.y - halfSize.y, -infinity);
+            viewBounds.max = glm::vec3(cameraPos.x + halfSize.x, cameraPos.y + halfSize.y, infinity);
+            break;
+        case Viewport::ViewportType::SIDE_YZ:
+        default:
+            viewBounds.min = glm::vec3(-infinity, cameraPos.y - halfSize.y, cameraPos.z - halfSize.x);
+            viewBounds.max = glm::vec3(infinity, cameraPos.y + halfSize.y, cameraPos.z + halfSize.x);
+            break;
+    }
+
+    queryResults.clear();
+    tree.Query(viewBounds, queryResults);
+
+    outActorIndices.clear();
+    outSectorIndices.clear();
+    for (const uint32_t userData: queryResults)
+    {
+        const size_t index = userData & ~SECTOR_FLAG;
+        // Leaves are larger than what they hold, so check the exact bounds too
+        if ((userData & SECTOR_FLAG) != 0)
+        {
+            if (sectors.at(index).bounds.Overlaps(viewBounds))
+            {
+                outSectorIndices.push_back(index);
+            }
+        } else if (actors.at(index).bounds.Overlaps(viewBounds))
+        {
+            outActorIndices.push_back(index);
+        }
+    }
+    // Keep the map's draw order
+    std::ranges::sort(outActorIndices);
+    std::ranges::sort(outSectorIndices);
+}
+
+uint64_t MapSpatialIndex::GetGeneration()
+{
+    return generation;
+}
+
+AABBTree::Bounds MapSpatialIndex::CalculateActorBounds(const Actor &actor,
+                                                       const std::vector<ActorRenderCache::RenderParams> &renderParams)
+{
+    glm::mat4 worldMatrix = glm::identity<glm::mat4>();
+    worldMatrix = glm::translate(worldMatrix, actor.position);
+    worldMatrix = glm::rotate(worldMatrix, glm::radians(actor.rotation.y), glm::vec3(0, 1, 0));
+    worldMatrix = glm::rotate(worldMatrix, glm::radians(actor.rotation.x), glm::vec3(1, 0, 0));
+    worldMatrix = glm::rotate(worldMatrix, glm::radians(actor.rotation.z), glm::vec3(0, 0, 1));
+
+    std::vector<glm::vec3> boundingBoxPoints{}; // not aabb, just bb
+
+    for (const ActorRenderCache::RenderParams &params: renderParams)
+    {
+        if (!MapEditor::drawGizmos && params.gizmo)
+        {
+            continue;
+        }
+
+        const RenderDefinition::RenderDefinitionType type = params.type;
+        if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_POINT ||
+            type == RenderDefinition::RenderDefinitionType::RD_TYPE_ORIENTATION ||
+            type == RenderDefinition::RenderDefinitionType::RD_TYPE_SPRITE)
+        {
+            std::ranges::copy(BoundingBox(actor.position, {0.25, 0.25, 0.25}).GetPoints(),
+                              std::back_inserter(boundingBoxPoints));
+        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_MODEL)
+        {
+            const std::shared_ptr<const ModelAsset> model = MapRenderer::GetModel(params.model);
+            const std::array<glm::vec3, 8> &modelBboxPoints = model->GetBoundingBox().GetPoints();
+            for (const glm::vec3 &point: modelBboxPoints)
+            {
+                boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(point, 1.0));
+            }
+        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_BOX)
+        {
+            const BoundingBox bb = BoundingBox(params.extents / 2.0f);
+            for (const glm::vec3 &point: bb.GetPoints())
+            {
+                boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(point, 1.0));
+            }
+        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_CIRCLE)
+        {
+            const BoundingBox bb = BoundingBox(glm::vec3(params.radius));
+            for (const glm::vec3 &point: bb.GetPoints())
+            {
+                boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(point, 1.0));
+            }
+        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_CONE)
+        {
+            const float length = params.length;
+            const float angle = params.angle;
+
+            const float radius = glm::tan(glm::radians(angle)) * length;
+
+            constexpr uint32_t NUM_VERTS = 8;
+            std::vector<glm::vec2> pts;
+            pts.reserve(NUM_VERTS);
+            for (uint32_t i = 0; i < NUM_VERTS; i++)
+            {
+                const float theta = 1 * (2.0f *
+                                         std::numbers::pi_v<float> *
+                                         static_cast<float>(i) /
+                                         static_cast<float>(NUM_VERTS));
+                const float x = radius * std::cos(theta);
+                const float y = radius * std::sin(theta);
+                pts.emplace_back(x, y);
+            }
+
+            boundingBoxPoints.emplace_back(actor.position);
+            for (size_t i = 0; i < NUM_VERTS; i++)
+            {
+                const glm::vec3 startPoint = worldMatrix * glm::vec4(pts.at(i).x, pts.at(i).y, -length, 1);
+                boundingBoxPoints.emplace_back(startPoint);
+            }
+        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_WALL)
+        {
+            const glm::vec2 &size = params.size;
+            const glm::vec2 &localOrigin = params.localCenter;
+            const float bottom = localOrigin.y - (size.y / 2.0f);
+            const float top = localOrigin.y + (size.y / 2.0f);
+            const glm::vec2 startPoint = params.zAxisOrientation ? glm::vec2(0, localOrigin.x - size.x / 2.0f)
+                                                                 : glm::vec2(localOrigin.x - size.x / 2.0f, 0);
+            const glm::vec2 endPoint = params.zAxisOrientation ? glm::vec2(0, localOrigin.x + size.x / 2.0f)
+                                                               : glm::vec2(localOrigin.x + size.x / 2.0f, 0);
+
+            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(startPoint.x, top, startPoint.y, 1.0f));
+            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(endPoint.x, top, endPoint.y, 1.0f));
+            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(startPoint.x, bottom, startPoint.y, 1.0f));
+            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(endPoint.x, bottom, endPoint.y, 1.0f));
+        }
+    }
+
+
+    if (boundingBoxPoints.empty())
+    {
+        return {.min = actor.position, .max = actor.position};
+    }
+    const BoundingBox bbox = BoundingBox(boundingBoxPoints);
+    return {.min = bbox.origin - bbox.extents, .max = bbox.origin + bbox.extents};
+}
@@ -0,0 +1,75 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec3.hpp>
+#include <libassets/type/Actor.h>
+#include <libassets/util/AABBTree.h>
+#include <vector>
+#include "ActorRenderCache.h"
+#include "MapHistory.h"
+#include "Viewport.h"
+
+/**
+ * Keeps the world bounds of every actor and sector in an AABB tree, so viewports only visit what they can see.
+ * Like the sector geometry cache, only the items that MapHistory reports as changed are refreshed.
+ */
+class MapSpatialIndex
+{
+    public:
+        MapSpatialIndex() = delete;
+
+        /**
+         * Refresh the bounds of actors and sectors that changed since the last update.
+         * The sector geometry cache and the actor render cache must be updated first.
+         * @param changes The actors and sectors that changed, from MapHistory::TakeChanges()
+         */
+        static void Update(const MapHistory::Changes &changes);
+
+        /**
+         * Find the actors and sectors that may be visible in a viewport
+         * @param vp The viewport
+         * @param outActorIndices Where to store the indices of the actors, in ascending order
+         * @param outSectorIndices Where to store the indices of the sectors, in ascending order
+         */
+        static void Query(const Viewport &vp,
+                          std::vector<size_t> &outActorIndices,
+                          std::vector<size_t> &outSectorIndices);
+
+        /**
+         * Get a number that changes whenever any actor or sector bounds change
+         */
+        [[nodiscard]] static uint64_t GetGeneration();
+
+    private:
+        /// Set in the user data of sectors, to tell them apart from actors
+        static constexpr uint32_t SECTOR_FLAG = 1u << 31;
+
+        struct Entry
+        {
+                AABBTree::Bounds bounds{};
+                int32_t proxy = AABBTree::NULL_NODE;
+        };
+
+        static inline AABBTree tree{};
+        static inline std::vector<Entry> actors{};
+        static inline std::vector<Entry> sectors{};
+        /// Gizmos are part of an actor's bounds, so toggling them refreshes every actor
+        static inline bool lastDrawGizmos = true;
+        static inline uint64_t generation = 0;
+        /// Reused by queries to avoid allocating
+        static inline std::vector<uint32_t> queryResults{};
+
+        /**
+         * Set the bounds of an entry, adding it to the tree if it isn't in it yet
+         */
+        static void SetBounds(Entry &entry, const AABBTree::Bounds &bounds, uint32_t userData);
+
+        [[nodiscard]] static AABBTree::Bounds CalculateActorBounds(const Actor &actor,
+                                                                   const std::vector<ActorRenderCache::RenderParams>
+                                                                           &renderParams);
+};
@@ -0,0 +1,162 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include "SectorGeometryCache.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <game_sdk/Profiler.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <libassets/type/Sector.h>
+#include <vector>
+#include "MapEditor.h"
+#include "MapHistory.h"
+#include "MapRenderer.h"
+#include "Viewport.h"
+
+void SectorGeometryCache::Init()
+{
+    buffer = MapRenderer::CreateRetainedBuffer();
+}
+
+void SectorGeometryCache::Destroy()
+{
+    MapRenderer::DestroyRetainedBuffer(buffer);
+    sectors.clear();
+}
+
+void SectorGeometryCache::Update(const MapHistory::ChangedRange &changed)
+{
+    const std::vector<Sector> &mapSectors = MapEditor::map.sectors;
+    if (changed.start >= changed.end && sectors.size() == mapSectors.size())
+    {
+        return;
+    }
+    const Profiler::Scope scope("Sector geometry");
+    bool layoutChanged = sectors.size() != mapSectors.size();
+    sectors.resize(mapSectors.size());
+
+    const size_t end = std::min(changed.end, mapSectors.size());
+    for (size_t i = changed.start; i < end; i++)
+    {
+        const Sector &sector = mapSectors.at(i);
+        SectorGeometry &geometry = sectors.at(i);
+        const size_t oldVertexCount = geometry.vertices.size();
+        geometry.aabb = sector.GetAABB();
+        Generate(sector, geometry);
+        layoutChanged |= geometry.vertices.size() != oldVertexCount;
+    }
+    generation++;
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo);
+    if (layoutChanged)
+    {
+        size_t vertexCount = 0;
+        for (SectorGeometry &geometry: sectors)
+        {
+            geometry.firstVertex = vertexCount;
+            vertexCount += geometry.vertices.size();
+        }
+        glBufferData(GL_ARRAY_BUFFER,
+                     static_cast<GLsizeiptr>(vertexCount * sizeof(MapRenderer::BatchVertex)),
+                     nullptr,
+                     GL_DYNAMIC_DRAW);
+    }
+    // Clean sectors keep their vertices, unless they moved in the buffer
+    const size_t uploadStart = layoutChanged ? 0 : changed.start;
+    const size_t uploadEnd = layoutChanged ? sectors.size() : end;
+    for (size_t i = uploadStart; i < uploadEnd; i++)
+    {
+        const SectorGeometry &geometry = sectors.at(i);
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        static_cast<GLintptr>(geometry.firstVertex * sizeof(MapRenderer::BatchVertex)),
+                        static_cast<GLsizeiptr>(geometry.vertices.size() * sizeof(MapRenderer::BatchVertex)),
+                        geometry.vertices.data());
+        Profiler::Get().CountUpload(geometry.vertices.size() * sizeof(MapRenderer::BatchVertex));
+    }
+}
+
+const glm::vec4 &SectorGeometryCache::GetAABB(const size_t sectorIndex)
+{
+    return sectors.at(sectorIndex).aabb;
+}
+
+uint64_t SectorGeometryCache::GetGeneration()
+{
+    return generation;
+}
+
+void SectorGeometryCache::Render(const Viewport &vp,
+                                 const glm::mat4 &matrix,
+                                 const std::vector<size_t> &sectorIndices)
+{
+    const bool topDown = vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ;
+
+    lineFirsts.clear();
+    lineCounts.clear();
+    pointFirsts.clear();
+    pointCounts.clear();
+    for (const size_t sectorIndex: sectorIndices)
+    {
+        const SectorGeometry &geometry = sectors.at(sectorIndex);
+        const size_t pointCount = geometry.pointCount;
+        if (pointCount == 0)
+        {
+            continue;
+        }
+        lineFirsts.push_back(static_cast<GLint>(geometry.firstVertex));
+        if (topDown)
+        {
+            // Floor and vertical edges are hidden behind the ceiling edges from above
+            lineCounts.push_back(static_cast<GLsizei>(pointCount * 2));
+            pointFirsts.push_back(static_cast<GLint>(geometry.firstVertex + (pointCount * 6)));
+            pointCounts.push_back(static_cast<GLsizei>(pointCount));
+        } else
+        {
+            lineCounts.push_back(static_cast<GLsizei>(pointCount * 6));
+        }
+    }
+
+    MapRenderer::RenderRetained(buffer,
+                                MapRenderer::BatchPrimitive::LINES,
+                                LINE_WIDTH,
+                                lineFirsts,
+                                lineCounts,
+                                matrix);
+    MapRenderer::RenderRetained(buffer, MapRenderer::BatchPrimitive::POINTS, 0, pointFirsts, pointCounts, matrix);
+}
+
+void SectorGeometryCache::Generate(const Sector &sector, SectorGeometry &geometry)
+{
+    const size_t pointCount = sector.points.size();
+    geometry.pointCount = pointCount;
+    geometry.vertices.clear();
+    geometry.vertices.reserve(pointCount * 7);
+
+    const auto addVertex = [&geometry](const glm::vec3 position, const Color &color, const float size) {
+        geometry.vertices.push_back({.position = position, .color = color.CopyData(), .size = size});
+    };
+
+    for (size_t i = 0; i < pointCount; i++)
+    {
+        const glm::vec2 &start = sector.points.at(i);
+        const glm::vec2 &end = sector.points.at((i + 1) % pointCount);
+        addVertex(glm::vec3(start.x, sector.ceilingHeight, start.y), LINE_COLOR, LINE_WIDTH);
+        addVertex(glm::vec3(end.x, sector.ceilingHeight, end.y), LINE_COLOR, LINE_WIDTH);
+    }
+    for (size_t i = 0; i < pointCount; i++)
+    {
+        const glm::vec2 &start = sector.points.at(i);
+        const glm::vec2 &end = sector.points.at((i + 1) % pointCount);
+        addVertex(glm::vec3(start.x, sector.floorHeight, start.y), LINE_COLOR, LINE_WIDTH);
+        addVertex(glm::vec3(end.x, sector.floorHeight, end.y), LINE_COLOR, LINE_WIDTH);
+        addVertex(glm::vec3(start.x, sector.ceilingHeight, start.y), LINE_COLOR, LINE_WIDTH);
+        addVertex(glm::vec3(start.x, sector.floorHeight, start.y), LINE_COLOR, LINE_WIDTH);
+    }
+    for (const glm::vec2 &point: sector.points)
+    {
+        addVertex(glm::vec3(point.x, sector.ceilingHeight + 0.1f, point.y), POINT_COLOR, POINT_SIZE);
+    }
+}
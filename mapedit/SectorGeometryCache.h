@@ -0,0 +1,82 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <libassets/type/Color.h>
+#include <libassets/type/Sector.h>
+#include <vector>
+#include "MapHistory.h"
+#include "MapRenderer.h"
+#include "Viewport.h"
+
+/**
+ * Keeps the outlines of every sector in a GPU buffer, so drawing them takes a few draw calls.
+ * Only the sectors that MapHistory reports as changed are regenerated.
+ */
+class SectorGeometryCache
+{
+    public:
+        SectorGeometryCache() = delete;
+
+        static void Init();
+        static void Destroy();
+
+        /**
+         * Regenerate the geometry of sectors that changed since the last update
+         * @param changed The sectors that changed, from MapHistory::TakeChanges()
+         */
+        static void Update(const MapHistory::ChangedRange &changed);
+
+        /**
+         * Get the 2D AABB of a sector, as of the last update
+         * @return {origin.x, origin.y, extents.x, extents.y}
+         */
+        [[nodiscard]] static const glm::vec4 &GetAABB(size_t sectorIndex);
+
+        /**
+         * Get a number that changes whenever the geometry of any sector changes
+         */
+        [[nodiscard]] static uint64_t GetGeneration();
+
+        /**
+         * Draw the outlines of sectors in their unselected style
+         * @param vp The viewport to draw in
+         * @param matrix The view matrix
+         * @param sectorIndices The sectors to draw
+         */
+        static void Render(const Viewport &vp, const glm::mat4 &matrix, const std::vector<size_t> &sectorIndices);
+
+    private:
+        static constexpr float LINE_WIDTH = 4;
+        static constexpr float POINT_SIZE = 6;
+        static inline const Color LINE_COLOR = Color(0.6, 0.6, 0.6, 1);
+        static inline const Color POINT_COLOR = Color(1, 0.7, 0.7, 1);
+
+        struct SectorGeometry
+        {
+                size_t pointCount = 0;
+                glm::vec4 aabb{};
+                /// Ceiling edges, then floor edges and vertical edges, then the points
+                std::vector<MapRenderer::BatchVertex> vertices{};
+                /// The index of the first vertex in the GPU buffer
+                size_t firstVertex = 0;
+        };
+
+        static inline std::vector<SectorGeometry> sectors{};
+        static inline MapRenderer::RetainedBuffer buffer{};
+        static inline uint64_t generation = 0;
+
+        /// Reused every frame to avoid allocating
+        static inline std::vector<GLint> lineFirsts{};
+        static inline std::vector<GLsizei> lineCounts{};
+        static inline std::vector<GLint> pointFirsts{};
+        static inline std::vector<GLsizei> pointCounts{};
+
+        static void Generate(const Sector &sector, SectorGeometry &geometry);
+};
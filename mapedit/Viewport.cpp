@@ -9,6 +9,7 @@
 #include <imgui.h>
 #include <string>
 #include "MapEditor.h"
+#include "ViewportRenderer.h"
 
 Viewport::Viewport(const ViewportType type)
 {
@@ -73,6 +74,8 @@ void Viewport::Render()
 
     RecalculateMatrices();
 
+    // The tool looks things up in the caches before it renders, so include the edits made since the last viewport
+    ViewportRenderer::UpdateCaches();
     MapEditor::tool->RenderViewport(*this);
 
     GLHelper::UnbindFramebuffer();
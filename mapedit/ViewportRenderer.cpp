@@ -10,66 +10,89 @@
 #include <cstddef>
 #include <cstdint>
 #include <game_sdk/gl/GLHelper.h>
-#include <iterator>
-#include <libassets/asset/ModelAsset.h>
+#include <game_sdk/Profiler.h>
+#include <imgui.h>
 #include <libassets/type/Actor.h>
 #include <libassets/type/ActorDefinition.h>
-#include <libassets/type/BoundingBox.h>
 #include <libassets/type/Color.h>
-#include <libassets/type/renderDefs/BoxRenderDefinition.h>
-#include <libassets/type/renderDefs/CircleRenderDefinition.h>
-#include <libassets/type/renderDefs/ConeRenderDefinition.h>
-#include <libassets/type/renderDefs/ModelRenderDefinition.h>
-#include <libassets/type/renderDefs/OrientationRenderDefinition.h>
-#include <libassets/type/renderDefs/PointRenderDefinition.h>
 #include <libassets/type/renderDefs/RenderDefinition.h>
-#include <libassets/type/renderDefs/SpriteRenderDefinition.h>
-#include <libassets/type/renderDefs/WallRenderDefinition.h>
 #include <libassets/type/Sector.h>
-#include <memory>
 #include <numbers>
+#include <numeric>
+#include <optional>
+#include <utility>
 #include <vector>
+#include "ActorRenderCache.h"
 #include "MapEditor.h"
+#include "MapHistory.h"
 #include "MapRenderer.h"
+#include "MapSpatialIndex.h"
+#include "SectorGeometryCache.h"
 #include "tools/EditorTool.h"
 #include "Viewport.h"
 
+void ViewportRenderer::UpdateCaches()
+{
+    const MapHistory::Changes changes = MapHistory::TakeChanges();
+    SectorGeometryCache::Update(changes.sectors);
+    ActorRenderCache::Update(changes.actors);
+    MapSpatialIndex::Update(changes);
+}
+
 void ViewportRenderer::RenderViewport(Viewport &vp, const ViewportRenderSettings &settings)
 {
+    UpdateCaches();
+
+    // Usually only the viewport under the mouse changes, the others can keep what they showed last frame
+    std::optional<RenderKey> &lastRenderKey = lastRenderKeys.at(static_cast<size_t>(vp.GetType()));
+    RenderKey renderKey = GetRenderKey(vp, settings);
+    if (lastRenderKey.has_value() && lastRenderKey.value() == renderKey)
+    {
+        return;
+    }
+    lastRenderKey = std::move(renderKey);
+
+    constexpr std::array<const char *, 3> passNames = {"Top down viewport", "Front viewport", "Side viewport"};
+    const char *passName = passNames.at(static_cast<size_t>(vp.GetType()));
+    const Profiler::Scope scope(passName);
+    const Profiler::GpuScope gpuScope(passName);
+
     MapRenderer::RenderViewportGrid(vp);
 
     glm::mat4 matrix = vp.GetMatrix();
 
-    for (size_t actorIndex = 0; actorIndex < MapEditor::map.actors.size(); actorIndex++)
+    if (MapEditor::culling)
     {
-        if (settings.selectionType == EditorTool::ItemType::ACTOR && settings.selectionIndex == actorIndex)
-        {
-            continue;
-        }
-        if (settings.hoverType == EditorTool::ItemType::ACTOR && settings.hoverIndex == actorIndex)
-        {
-            continue;
-        }
-        RenderActor(MapEditor::map.actors.at(actorIndex), matrix, vp);
+        const Profiler::Scope cullingScope("Culling");
+        MapSpatialIndex::Query(vp, visibleActors, visibleSectors);
+    } else
+    {
+        visibleActors.resize(MapEditor::map.actors.size());
+        std::iota(visibleActors.begin(), visibleActors.end(), size_t{0});
+        visibleSectors.resize(MapEditor::map.sectors.size());
+        std::iota(visibleSectors.begin(), visibleSectors.end(), size_t{0});
     }
 
-    for (size_t sectorIndex = 0; sectorIndex < MapEditor::map.sectors.size(); sectorIndex++)
+    for (const size_t actorIndex: visibleActors)
     {
-        if (settings.sectorFocusMode && sectorIndex == settings.focusedSectorIndex)
-        {
-            continue;
-        }
-        if (settings.selectionType == EditorTool::ItemType::SECTOR && settings.selectionIndex == sectorIndex)
+        if (settings.selectionType == EditorTool::ItemType::ACTOR && settings.selectionIndex == actorIndex)
         {
             continue;
         }
-        if (settings.hoverType == EditorTool::ItemType::SECTOR && settings.hoverIndex == sectorIndex)
+        if (settings.hoverType == EditorTool::ItemType::ACTOR && settings.hoverIndex == actorIndex)
         {
             continue;
         }
-        RenderSector(vp, settings, sectorIndex, matrix);
+        RenderActor(MapEditor::map.actors.at(actorIndex), ActorRenderCache::Get(actorIndex), matrix, vp);
     }
 
+    std::erase_if(visibleSectors, [&settings](const size_t sectorIndex) {
+        return (settings.sectorFocusMode && sectorIndex == settings.focusedSectorIndex) ||
+               (settings.selectionType == EditorTool::ItemType::SECTOR && settings.selectionIndex == sectorIndex) ||
+               (settings.hoverType == EditorTool::ItemType::SECTOR && settings.hoverIndex == sectorIndex);
+    });
+    SectorGeometryCache::Render(vp, matrix, visibleSectors);
+
     if (settings.point != nullptr)
     {
         RenderPoint(settings.point, matrix);
@@ -92,29 +115,87 @@ void ViewportRenderer::RenderViewport(Viewport &vp, const ViewportRenderSettings
 
     if (settings.hoverType == EditorTool::ItemType::SECTOR)
     {
+        MapRenderer::FlushBatches();
         GLHelper::ClearDepth();
         RenderSector(vp, settings, settings.hoverIndex, matrix);
     } else if (settings.hoverType == EditorTool::ItemType::ACTOR)
     {
+        MapRenderer::FlushBatches();
         GLHelper::ClearDepth();
-        RenderActor(MapEditor::map.actors.at(settings.hoverIndex), matrix, vp);
+        RenderActor(MapEditor::map.actors.at(settings.hoverIndex),
+                    ActorRenderCache::Get(settings.hoverIndex),
+                    matrix,
+                    vp);
     }
 
     if (settings.selectionType == EditorTool::ItemType::SECTOR)
     {
+        MapRenderer::FlushBatches();
         GLHelper::ClearDepth();
         RenderSector(vp, settings, settings.selectionIndex, matrix);
     } else if (settings.selectionType == EditorTool::ItemType::ACTOR)
     {
+        MapRenderer::FlushBatches();
         GLHelper::ClearDepth();
-        RenderActor(MapEditor::map.actors.at(settings.selectionIndex), matrix, vp);
+        RenderActor(MapEditor::map.actors.at(settings.selectionIndex),
+                    ActorRenderCache::Get(settings.selectionIndex),
+                    matrix,
+                    vp);
     }
 
     if (settings.sectorFocusMode)
     {
+        MapRenderer::FlushBatches();
         GLHelper::ClearDepth();
         RenderSector(vp, settings, settings.focusedSectorIndex, matrix);
     }
+
+    MapRenderer::FlushBatches();
+}
+
+ViewportRenderer::RenderKey ViewportRenderer::GetRenderKey(const Viewport &vp, const ViewportRenderSettings &settings)
+{
+    ImVec2 windowPos;
+    ImVec2 windowSize;
+    vp.GetWindowRect(windowPos, windowSize);
+
+    RenderKey key = {
+        .matrix = vp.GetMatrix(),
+        .size = glm::vec2(windowSize.x, windowSize.y),
+        .geometryGeneration = SectorGeometryCache::GetGeneration(),
+        .indexGeneration = MapSpatialIndex::GetGeneration(),
+        .sectorFocusMode = settings.sectorFocusMode,
+        .focusedSectorIndex = settings.focusedSectorIndex,
+        .hoverType = settings.hoverType,
+        .hoverIndex = settings.hoverIndex,
+        .selectionType = settings.selectionType,
+        .selectionIndex = settings.selectionIndex,
+        .selectionVertexIndex = settings.selectionVertexIndex,
+        .gridSpacingIndex = MapEditor::gridSpacingIndex,
+        .drawGrid = MapEditor::drawGrid,
+        .drawAxisHelper = MapEditor::drawAxisHelper,
+        .drawWorldBorder = MapEditor::drawWorldBorder,
+        .drawModels = MapEditor::drawModels,
+        .drawGizmos = MapEditor::drawGizmos,
+    };
+    if (settings.point != nullptr)
+    {
+        key.point = *settings.point;
+    }
+    if (settings.newPrimitive != nullptr)
+    {
+        key.newPrimitive = *settings.newPrimitive;
+    }
+    if (settings.newActor != nullptr)
+    {
+        key.newActor = *settings.newActor;
+    }
+    if (settings.newPolygon != nullptr)
+    {
+        key.newPolygon = *settings.newPolygon;
+        key.mousePos = MapEditor::SnapToGrid(vp.GetWorldSpaceMousePos());
+    }
+    return key;
 }
 
 void ViewportRenderer::RenderSector(const Viewport &vp,
@@ -124,11 +205,6 @@ void ViewportRenderer::RenderSector(const Viewport &vp,
 {
     const Sector &sector = MapEditor::map.sectors.at(sectorIndex);
 
-    if (MapEditor::culling && SectorIsCulled(sector, vp))
-    {
-        return;
-    }
-
     const bool isFocusedSector = settings.sectorFocusMode && settings.focusedSectorIndex == sectorIndex;
 
     Color c = Color(0.6, 0.6, 0.6, 1);
@@ -248,7 +324,8 @@ void ViewportRenderer::RenderNewActor(const Viewport &vp, const ViewportRenderNe
     tempActor.position = actor->position;
     tempActor.rotation = actor->rotation;
     tempActor.className = actor->className;
-    RenderActor(tempActor, matrix, vp);
+    ActorRenderCache::Evaluate(tempActor, newActorRenderParams);
+    RenderActor(tempActor, newActorRenderParams, matrix, vp);
 }
 
 void ViewportRenderer::RenderNewPolygon(const Viewport &vp,
@@ -283,105 +360,48 @@ void ViewportRenderer::RenderNewPolygon(const Viewport &vp,
     }
 }
 
-bool ViewportRenderer::SectorIsCulled(const Sector &sector, const Viewport &vp)
-{
-    const glm::vec4 aabb = sector.GetAABB();
-
-    const glm::vec2 cameraViewSize = vp.GetWorldSpaceSize();
-    const glm::vec3 cameraPos = vp.GetCameraPos();
-
-    if (vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ)
-    {
-        const glm::vec2 aabbTopLeft = {aabb.x - aabb.z, aabb.y - aabb.w};
-        const glm::vec2 aabbBottomRight = {aabb.x + aabb.z, aabb.y + aabb.w};
-        const glm::vec2 cameraTopLeft = {cameraPos.x - (cameraViewSize.x / 2), cameraPos.z - (cameraViewSize.y / 2)};
-        const glm::vec2 cameraBottomRight = {cameraPos.x + (cameraViewSize.x / 2),
-                                             cameraPos.z + (cameraViewSize.y / 2)};
-        if (aabbBottomRight.x < cameraTopLeft.x ||
-            aabbTopLeft.x > cameraBottomRight.x ||
-            aabbBottomRight.y < cameraTopLeft.y ||
-            aabbTopLeft.y > cameraBottomRight.y)
-        {
-            return true;
-        }
-    } else if (vp.GetType() == Viewport::ViewportType::FRONT_XY)
-    {
-        const glm::vec2 aabbTopLeft = {aabb.x - aabb.z, sector.floorHeight};
-        const glm::vec2 aabbBottomRight = {aabb.x + aabb.z, sector.ceilingHeight};
-        const glm::vec2 cameraTopLeft = {cameraPos.x - (cameraViewSize.x / 2), cameraPos.y - (cameraViewSize.y / 2)};
-        const glm::vec2 cameraBottomRight = {cameraPos.x + (cameraViewSize.x / 2),
-                                             cameraPos.y + (cameraViewSize.y / 2)};
-        if (aabbBottomRight.x < cameraTopLeft.x ||
-            aabbTopLeft.x > cameraBottomRight.x ||
-            aabbBottomRight.y < cameraTopLeft.y ||
-            aabbTopLeft.y > cameraBottomRight.y)
-        {
-            return true;
-        }
-    } else if (vp.GetType() == Viewport::ViewportType::SIDE_YZ)
-    {
-        const glm::vec2 aabbTopLeft = {sector.floorHeight, aabb.y - aabb.w};
-        const glm::vec2 aabbBottomRight = {sector.ceilingHeight, aabb.y + aabb.w};
-        const glm::vec2 cameraTopLeft = {cameraPos.y - (cameraViewSize.y / 2), cameraPos.z - (cameraViewSize.x / 2)};
-        const glm::vec2 cameraBottomRight = {cameraPos.y + (cameraViewSize.y / 2),
-                                             cameraPos.z + (cameraViewSize.x / 2)};
-        if (aabbBottomRight.x < cameraTopLeft.x ||
-            aabbTopLeft.x > cameraBottomRight.x ||
-            aabbBottomRight.y < cameraTopLeft.y ||
-            aabbTopLeft.y > cameraBottomRight.y)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-void ViewportRenderer::RenderActor(const Actor &a, const glm::mat4 &matrix, const Viewport &vp)
+void ViewportRenderer::RenderActor(const Actor &a,
+                                   const std::vector<ActorRenderCache::RenderParams> &renderParams,
+                                   const glm::mat4 &matrix,
+                                   const Viewport &vp)
 {
-    if (MapEditor::culling && ActorIsCulled(a, vp))
-    {
-        return;
-    }
-
-    const ActorDefinition &definition = MapEditor::adm.GetActorDefinition(a.className);
-
     glm::mat4 worldMatrix = glm::identity<glm::mat4>();
     worldMatrix = glm::translate(worldMatrix, a.position);
     worldMatrix = glm::rotate(worldMatrix, glm::radians(a.rotation.y), glm::vec3(0, 1, 0));
     worldMatrix = glm::rotate(worldMatrix, glm::radians(a.rotation.x), glm::vec3(1, 0, 0));
     worldMatrix = glm::rotate(worldMatrix, glm::radians(a.rotation.z), glm::vec3(0, 0, 1));
 
-    for (const std::shared_ptr<RenderDefinition> &rdef: definition.renderDefinitions)
+    for (const ActorRenderCache::RenderParams &params: renderParams)
     {
-        if (!MapEditor::drawGizmos && rdef.get()->IsGizmo(a))
+        if (!MapEditor::drawGizmos && params.gizmo)
         {
             continue;
         }
-        switch (rdef.get()->GetType())
+        switch (params.type)
         {
             case RenderDefinition::RenderDefinitionType::RD_TYPE_BOX:
-                RenderBoxRdef(dynamic_cast<BoxRenderDefinition *>(rdef.get()), a, worldMatrix, matrix);
+                RenderBoxRdef(params, worldMatrix, matrix);
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_MODEL:
-                RenderModelRdef(dynamic_cast<ModelRenderDefinition *>(rdef.get()), a, worldMatrix, matrix);
+                RenderModelRdef(params, worldMatrix, matrix);
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_ORIENTATION:
-                RenderOrientationRdef(dynamic_cast<OrientationRenderDefinition *>(rdef.get()), a, matrix, vp);
+                RenderOrientationRdef(params, a, matrix, vp);
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_POINT:
-                RenderPointRdef(dynamic_cast<PointRenderDefinition *>(rdef.get()), a, matrix);
+                RenderPointRdef(params, a, matrix);
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_SPRITE:
-                RenderSpriteRdef(dynamic_cast<SpriteRenderDefinition *>(rdef.get()), a, matrix);
+                RenderSpriteRdef(params, a, matrix);
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_WALL:
-                RenderWallRdef(dynamic_cast<WallRenderDefinition *>(rdef.get()), a, worldMatrix, matrix);
+                RenderWallRdef(params, worldMatrix, matrix);
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_CIRCLE:
-                RenderCircleRdef(dynamic_cast<CircleRenderDefinition *>(rdef.get()), a, matrix, vp.GetType());
+                RenderCircleRdef(params, a, matrix, vp.GetType());
                 break;
             case RenderDefinition::RenderDefinitionType::RD_TYPE_CONE:
-                RenderConeRdef(dynamic_cast<ConeRenderDefinition *>(rdef.get()), a, matrix, worldMatrix);
+                RenderConeRdef(params, a, matrix, worldMatrix);
                 break;
             default:
             case RenderDefinition::RenderDefinitionType::RD_TYPE_UNKNOWN:
@@ -391,165 +411,12 @@ void ViewportRenderer::RenderActor(const Actor &a, const glm::mat4 &matrix, cons
     }
 }
 
-bool ViewportRenderer::ActorIsCulled(const Actor &actor, const Viewport &vp)
-{
-    const ActorDefinition &definition = MapEditor::adm.GetActorDefinition(actor.className);
-
-    glm::mat4 worldMatrix = glm::identity<glm::mat4>();
-    worldMatrix = glm::translate(worldMatrix, actor.position);
-    worldMatrix = glm::rotate(worldMatrix, glm::radians(actor.rotation.y), glm::vec3(0, 1, 0));
-    worldMatrix = glm::rotate(worldMatrix, glm::radians(actor.rotation.x), glm::vec3(1, 0, 0));
-    worldMatrix = glm::rotate(worldMatrix, glm::radians(actor.rotation.z), glm::vec3(0, 0, 1));
-
-    std::vector<glm::vec3> boundingBoxPoints{}; // not aabb, just bb
-
-    for (const std::shared_ptr<RenderDefinition> &rdef: definition.renderDefinitions)
-    {
-        if (!MapEditor::drawGizmos && rdef.get()->IsGizmo(actor))
-        {
-            continue;
-        }
-
-        const RenderDefinition::RenderDefinitionType type = rdef.get()->GetType();
-        if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_POINT ||
-            type == RenderDefinition::RenderDefinitionType::RD_TYPE_ORIENTATION ||
-            type == RenderDefinition::RenderDefinitionType::RD_TYPE_SPRITE)
-        {
-            std::ranges::copy(BoundingBox(actor.position, {0.25, 0.25, 0.25}).GetPoints(),
-                              std::back_inserter(boundingBoxPoints));
-        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_MODEL)
-        {
-            ModelRenderDefinition *modelDef = dynamic_cast<ModelRenderDefinition *>(rdef.get());
-            const ModelAsset &model = MapRenderer::GetModel(modelDef->GetModel(actor));
-            const std::array<glm::vec3, 8> &modelBboxPoints = model.GetBoundingBox().GetPoints();
-            for (const glm::vec3 &point: modelBboxPoints)
-            {
-                boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(point, 1.0));
-            }
-        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_BOX)
-        {
-            BoxRenderDefinition *boxDef = dynamic_cast<BoxRenderDefinition *>(rdef.get());
-            const BoundingBox bb = BoundingBox(boxDef->GetExtents(actor) / 2.0f);
-            for (const glm::vec3 &point: bb.GetPoints())
-            {
-                boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(point, 1.0));
-            }
-        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_CIRCLE)
-        {
-            CircleRenderDefinition *circleDef = dynamic_cast<CircleRenderDefinition *>(rdef.get());
-            const BoundingBox bb = BoundingBox(glm::vec3(circleDef->GetRadius(actor)));
-            for (const glm::vec3 &point: bb.GetPoints())
-            {
-                boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(point, 1.0));
-            }
-        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_CONE)
-        {
-            ConeRenderDefinition *coneDef = dynamic_cast<ConeRenderDefinition *>(rdef.get());
-            const float length = coneDef->GetLength(actor);
-            const float angle = coneDef->GetAngle(actor);
-
-            const float radius = glm::tan(glm::radians(angle)) * length;
-
-            constexpr uint32_t NUM_VERTS = 8;
-            std::vector<glm::vec2> pts;
-            pts.reserve(NUM_VERTS);
-            for (uint32_t i = 0; i < NUM_VERTS; i++)
-            {
-                const float theta = 1 * (2.0f *
-                                         std::numbers::pi_v<float> *
-                                         static_cast<float>(i) /
-                                         static_cast<float>(NUM_VERTS));
-                const float x = radius * std::cos(theta);
-                const float y = radius * std::sin(theta);
-                pts.emplace_back(x, y);
-            }
-
-            boundingBoxPoints.emplace_back(actor.position);
-            for (size_t i = 0; i < NUM_VERTS; i++)
-            {
-                const glm::vec3 startPoint = worldMatrix * glm::vec4(pts.at(i).x, pts.at(i).y, -length, 1);
-                boundingBoxPoints.emplace_back(startPoint);
-            }
-        } else if (type == RenderDefinition::RenderDefinitionType::RD_TYPE_WALL)
-        {
-            WallRenderDefinition *wallDef = dynamic_cast<WallRenderDefinition *>(rdef.get());
-            const glm::vec2 size = wallDef->GetSize(actor);
-            const glm::vec2 localOrigin = wallDef->GetLocalCenter(actor);
-            const float bottom = localOrigin.y - (size.y / 2.0f);
-            const float top = localOrigin.y + (size.y / 2.0f);
-            const glm::vec2 startPoint = wallDef->GetZAxisOrientation(actor)
-                                                 ? glm::vec2(0, localOrigin.x - size.x / 2.0f)
-                                                 : glm::vec2(localOrigin.x - size.x / 2.0f, 0);
-            const glm::vec2 endPoint = wallDef->GetZAxisOrientation(actor)
-                                               ? glm::vec2(0, localOrigin.x + size.x / 2.0f)
-                                               : glm::vec2(localOrigin.x + size.x / 2.0f, 0);
-
-            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(startPoint.x, top, startPoint.y, 1.0f));
-            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(endPoint.x, top, endPoint.y, 1.0f));
-            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(startPoint.x, bottom, startPoint.y, 1.0f));
-            boundingBoxPoints.emplace_back(worldMatrix * glm::vec4(endPoint.x, bottom, endPoint.y, 1.0f));
-        }
-    }
-
-    const BoundingBox bbox = BoundingBox(boundingBoxPoints);
-
-    const glm::vec2 cameraViewSize = vp.GetWorldSpaceSize();
-    const glm::vec3 cameraPos = vp.GetCameraPos();
-
-    if (vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ)
-    {
-        const glm::vec2 aabbTopLeft = {bbox.origin.x - bbox.extents.x, bbox.origin.z - bbox.extents.z};
-        const glm::vec2 aabbBottomRight = {bbox.origin.x + bbox.extents.x, bbox.origin.z + bbox.extents.z};
-        const glm::vec2 cameraTopLeft = {cameraPos.x - (cameraViewSize.x / 2), cameraPos.z - (cameraViewSize.y / 2)};
-        const glm::vec2 cameraBottomRight = {cameraPos.x + (cameraViewSize.x / 2),
-                                             cameraPos.z + (cameraViewSize.y / 2)};
-        if (aabbBottomRight.x < cameraTopLeft.x ||
-            aabbTopLeft.x > cameraBottomRight.x ||
-            aabbBottomRight.y < cameraTopLeft.y ||
-            aabbTopLeft.y > cameraBottomRight.y)
-        {
-            return true;
-        }
-    } else if (vp.GetType() == Viewport::ViewportType::FRONT_XY)
-    {
-        const glm::vec2 aabbTopLeft = {bbox.origin.x - bbox.extents.x, bbox.origin.y - bbox.extents.y};
-        const glm::vec2 aabbBottomRight = {bbox.origin.x + bbox.extents.x, bbox.origin.y + bbox.extents.y};
-        const glm::vec2 cameraTopLeft = {cameraPos.x - (cameraViewSize.x / 2), cameraPos.y - (cameraViewSize.y / 2)};
-        const glm::vec2 cameraBottomRight = {cameraPos.x + (cameraViewSize.x / 2),
-                                             cameraPos.y + (cameraViewSize.y / 2)};
-        if (aabbBottomRight.x < cameraTopLeft.x ||
-            aabbTopLeft.x > cameraBottomRight.x ||
-            aabbBottomRight.y < cameraTopLeft.y ||
-            aabbTopLeft.y > cameraBottomRight.y)
-        {
-            return true;
-        }
-    } else if (vp.GetType() == Viewport::ViewportType::SIDE_YZ)
-    {
-        const glm::vec2 aabbTopLeft = {bbox.origin.y - bbox.extents.y, bbox.origin.z - bbox.extents.z};
-        const glm::vec2 aabbBottomRight = {bbox.origin.y + bbox.extents.y, bbox.origin.z + bbox.extents.z};
-        const glm::vec2 cameraTopLeft = {cameraPos.y - (cameraViewSize.y / 2), cameraPos.z - (cameraViewSize.x / 2)};
-        const glm::vec2 cameraBottomRight = {cameraPos.y + (cameraViewSize.y / 2),
-                                             cameraPos.z + (cameraViewSize.x / 2)};
-        if (aabbBottomRight.x < cameraTopLeft.x ||
-            aabbTopLeft.x > cameraBottomRight.x ||
-            aabbBottomRight.y < cameraTopLeft.y ||
-            aabbTopLeft.y > cameraBottomRight.y)
-        {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-void ViewportRenderer::RenderBoxRdef(BoxRenderDefinition *rdef,
-                                     const Actor &actor,
+void ViewportRenderer::RenderBoxRdef(const ActorRenderCache::RenderParams &params,
                                      const glm::mat4 &worldMatrix,
                                      const glm::mat4 &matrix)
 {
-    const Color c = rdef->GetColor(actor);
-    const glm::vec3 boxExtents = rdef->GetExtents(actor);
+    const Color &c = params.color;
+    const glm::vec3 &boxExtents = params.extents;
     const std::array<glm::vec2, 4> boxPoints = {
         glm::vec2(-boxExtents.x / 2.0f, -boxExtents.z / 2.0f),
         glm::vec2(-boxExtents.x / 2.0f, boxExtents.z / 2.0f),
@@ -574,74 +441,72 @@ void ViewportRenderer::RenderBoxRdef(BoxRenderDefinition *rdef,
     }
 }
 
-void ViewportRenderer::RenderModelRdef(ModelRenderDefinition *rdef,
-                                       const Actor &actor,
+void ViewportRenderer::RenderModelRdef(const ActorRenderCache::RenderParams &params,
                                        const glm::mat4 &worldMatrix,
                                        const glm::mat4 &matrix)
 {
     if (MapEditor::drawModels)
     {
-        MapRenderer::RenderModel(rdef->GetModel(actor), matrix, worldMatrix, rdef->GetColor(actor));
+        MapRenderer::RenderModel(params.model, matrix, worldMatrix, params.color);
     }
 }
 
-void ViewportRenderer::RenderOrientationRdef(OrientationRenderDefinition *rdef,
+void ViewportRenderer::RenderOrientationRdef(const ActorRenderCache::RenderParams &params,
                                              const Actor &actor,
                                              const glm::mat4 &matrix,
                                              const Viewport &vp)
 {
-    MapRenderer::RenderUnitVector(actor.position, actor.rotation, rdef->GetColor(actor), matrix, 2, vp.GetZoom() / 20);
+    MapRenderer::RenderUnitVector(actor.position, actor.rotation, params.color, matrix, 2, vp.GetZoom() / 20);
 }
 
-void ViewportRenderer::RenderPointRdef(PointRenderDefinition *rdef, const Actor &actor, const glm::mat4 &matrix)
+void ViewportRenderer::RenderPointRdef(const ActorRenderCache::RenderParams &params,
+                                       const Actor &actor,
+                                       const glm::mat4 &matrix)
 {
-    MapRenderer::RenderBillboardPoint(actor.position, rdef->GetPointSize(actor), rdef->GetColor(actor), matrix);
+    MapRenderer::RenderBillboardPoint(actor.position, params.pointSize, params.color, matrix);
 }
 
-void ViewportRenderer::RenderSpriteRdef(SpriteRenderDefinition *rdef, const Actor &actor, const glm::mat4 &matrix)
+void ViewportRenderer::RenderSpriteRdef(const ActorRenderCache::RenderParams &params,
+                                        const Actor &actor,
+                                        const glm::mat4 &matrix)
 {
-    MapRenderer::RenderBillboardSprite(actor.position,
-                                       rdef->GetPointSize(actor),
-                                       rdef->GetTexture(actor),
-                                       rdef->GetTintColor(actor),
-                                       matrix);
+    MapRenderer::RenderBillboardSprite(actor.position, params.pointSize, params.texture, params.color, matrix);
 }
 
-void ViewportRenderer::RenderWallRdef(WallRenderDefinition *rdef,
-                                      const Actor &actor,
+void ViewportRenderer::RenderWallRdef(const ActorRenderCache::RenderParams &params,
                                       const glm::mat4 &worldMatrix,
                                       const glm::mat4 &matrix)
 {
-    const glm::vec2 size = rdef->GetSize(actor);
-    const glm::vec2 localOrigin = rdef->GetLocalCenter(actor);
+    const glm::vec2 &size = params.size;
+    const glm::vec2 &localOrigin = params.localCenter;
     const float bottom = localOrigin.y - (size.y / 2.0f);
     const float top = localOrigin.y + (size.y / 2.0f);
-    const glm::vec2 startPoint = rdef->GetZAxisOrientation(actor) ? glm::vec2(0, localOrigin.x - size.x / 2.0f)
-                                                                  : glm::vec2(localOrigin.x - size.x / 2.0f, 0);
-    const glm::vec2 endPoint = rdef->GetZAxisOrientation(actor) ? glm::vec2(0, localOrigin.x + size.x / 2.0f)
-                                                                : glm::vec2(localOrigin.x + size.x / 2.0f, 0);
+    const glm::vec2 startPoint = params.zAxisOrientation ? glm::vec2(0, localOrigin.x - size.x / 2.0f)
+                                                         : glm::vec2(localOrigin.x - size.x / 2.0f, 0);
+    const glm::vec2 endPoint = params.zAxisOrientation ? glm::vec2(0, localOrigin.x + size.x / 2.0f)
+                                                       : glm::vec2(localOrigin.x + size.x / 2.0f, 0);
 
     const glm::vec3 startCeiling = worldMatrix * glm::vec4(startPoint.x, top, startPoint.y, 1.0f);
     const glm::vec3 endCeiling = worldMatrix * glm::vec4(endPoint.x, top, endPoint.y, 1.0f);
     const glm::vec3 startFloor = worldMatrix * glm::vec4(startPoint.x, bottom, startPoint.y, 1.0f);
     const glm::vec3 endFloor = worldMatrix * glm::vec4(endPoint.x, bottom, endPoint.y, 1.0f);
 
-    const Color c = rdef->GetColor(actor);
+    const Color &c = params.color;
     MapRenderer::RenderLine(startCeiling, endCeiling, c, matrix, 2.0f);
     MapRenderer::RenderLine(startFloor, endFloor, c, matrix, 2.0f);
     MapRenderer::RenderLine(startCeiling, startFloor, c, matrix, 2.0f);
     MapRenderer::RenderLine(endCeiling, endFloor, c, matrix, 2.0f);
 }
 
-void ViewportRenderer::RenderCircleRdef(CircleRenderDefinition *rdef,
+void ViewportRenderer::RenderCircleRdef(const ActorRenderCache::RenderParams &params,
                                         const Actor &actor,
                                         const glm::mat4 &worldMatrix,
                                         const Viewport::ViewportType type)
 {
-    const float radius = rdef->GetRadius(actor);
-    const Color color = rdef->GetColor(actor);
+    const float radius = params.radius;
+    const Color &color = params.color;
 
-    const uint32_t numVerts = rdef->GetNumSides(actor);
+    const uint32_t numVerts = params.sides;
     std::vector<glm::vec2> pts;
     pts.reserve(numVerts);
     for (uint32_t i = 0; i < numVerts; i++)
@@ -697,18 +562,18 @@ void ViewportRenderer::RenderCircleRdef(CircleRenderDefinition *rdef,
     }
 }
 
-void ViewportRenderer::RenderConeRdef(ConeRenderDefinition *rdef,
+void ViewportRenderer::RenderConeRdef(const ActorRenderCache::RenderParams &params,
                                       const Actor &actor,
                                       const glm::mat4 &matrix,
                                       const glm::mat4 &worldMatrix)
 {
-    const float length = rdef->GetLength(actor);
-    const Color color = rdef->GetColor(actor);
-    const float angle = rdef->GetAngle(actor);
+    const float length = params.length;
+    const Color &color = params.color;
+    const float angle = params.angle;
 
     const float radius = glm::tan(glm::radians(angle)) * length;
 
-    const uint32_t numVerts = rdef->GetNumSides(actor);
+    const uint32_t numVerts = params.sides;
     std::vector<glm::vec2> pts;
     pts.reserve(numVerts);
     for (uint32_t i = 0; i < numVerts; i++)
@@ -4,21 +4,19 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <libassets/type/Actor.h>
 #include <libassets/type/Color.h>
-#include <libassets/type/renderDefs/BoxRenderDefinition.h>
-#include <libassets/type/renderDefs/CircleRenderDefinition.h>
-#include <libassets/type/renderDefs/ConeRenderDefinition.h>
-#include <libassets/type/renderDefs/ModelRenderDefinition.h>
-#include <libassets/type/renderDefs/OrientationRenderDefinition.h>
-#include <libassets/type/renderDefs/PointRenderDefinition.h>
-#include <libassets/type/renderDefs/SpriteRenderDefinition.h>
-#include <libassets/type/renderDefs/WallRenderDefinition.h>
 #include <libassets/type/Sector.h>
+#include <optional>
 #include <string>
 #include <vector>
+#include "ActorRenderCache.h"
 #include "tools/EditorTool.h"
 #include "Viewport.h"
 
@@ -39,6 +37,8 @@ class ViewportRenderer
                 glm::vec3 aabbStart;
                 /// The AABB end of the new primitive
                 glm::vec3 aabbEnd;
+
+                bool operator==(const ViewportRenderNewPrimitive &) const = default;
         };
 
         /// A new polygon, rendered without the final line connecting the first and last points.
@@ -51,6 +51,8 @@ class ViewportRenderer
                 float floor;
                 /// The ceiling height of the new polygon
                 float ceiling;
+
+                bool operator==(const ViewportRenderNewPolygon &) const = default;
         };
 
         /// A new actor, rendered according to the class's definition with default params
@@ -62,6 +64,8 @@ class ViewportRenderer
                 glm::vec3 position;
                 /// The new actor's rotation
                 glm::vec3 rotation;
+
+                bool operator==(const ViewportRenderNewActor &) const = default;
         };
 
         /// A single point in 3D space
@@ -73,6 +77,8 @@ class ViewportRenderer
                 Color color;
                 /// The size (in pixels) of the point
                 float size;
+
+                bool operator==(const ViewportRenderPoint &) const = default;
         };
 
         struct ViewportRenderSettings
@@ -102,14 +108,61 @@ class ViewportRenderer
 
         ViewportRenderer() = delete;
 
+        /**
+         * Bring the sector geometry, actor render and spatial index caches up to date with the edits reported to
+         * MapHistory. Only the sectors and actors that changed are visited, so this is cheap when the map didn't
+         * change. Called before each viewport's tool runs, and again before the viewport renders to include the edits
+         * the tool just made.
+         */
+        static void UpdateCaches();
+
         /**
          * Render a viewport with the given settings
          * @param vp The viewport to render
          * @param settings The settings to render with
+         * @note If nothing the viewport shows changed since it was last rendered, the viewport's framebuffer is left
+         * as it is
          */
         static void RenderViewport(Viewport &vp, const ViewportRenderSettings &settings);
 
     private:
+        /// Everything that affects what a viewport shows
+        struct RenderKey
+        {
+                glm::mat4 matrix{};
+                glm::vec2 size{};
+                uint64_t geometryGeneration = 0;
+                uint64_t indexGeneration = 0;
+
+                bool sectorFocusMode = false;
+                size_t focusedSectorIndex = 0;
+                EditorTool::ItemType hoverType = EditorTool::ItemType::NONE;
+                size_t hoverIndex = 0;
+                EditorTool::ItemType selectionType = EditorTool::ItemType::NONE;
+                size_t selectionIndex = 0;
+                size_t selectionVertexIndex = 0;
+                std::optional<ViewportRenderPoint> point = std::nullopt;
+                std::optional<ViewportRenderNewPrimitive> newPrimitive = std::nullopt;
+                std::optional<ViewportRenderNewActor> newActor = std::nullopt;
+                std::optional<ViewportRenderNewPolygon> newPolygon = std::nullopt;
+                /// The last line of the new polygon follows the mouse
+                glm::vec3 mousePos{};
+
+                int gridSpacingIndex = 0;
+                bool drawGrid = false;
+                bool drawAxisHelper = false;
+                bool drawWorldBorder = false;
+                bool drawModels = false;
+                bool drawGizmos = false;
+
+                bool operator==(const RenderKey &) const = default;
+        };
+
+        /// The key each viewport was last rendered with, indexed by viewport type
+        static inline std::array<std::optional<RenderKey>, 3> lastRenderKeys{};
+
+        [[nodiscard]] static RenderKey GetRenderKey(const Viewport &vp, const ViewportRenderSettings &settings);
+
         static void RenderSector(const Viewport &vp,
                                  const ViewportRenderSettings &settings,
                                  size_t sectorIndex,
@@ -119,42 +172,49 @@ class ViewportRenderer
         static void RenderNewActor(const Viewport &vp, const ViewportRenderNewActor *actor, const glm::mat4 &matrix);
         static void RenderNewPolygon(const Viewport &vp, const ViewportRenderNewPolygon *poly, const glm::mat4 &matrix);
 
-        static bool SectorIsCulled(const Sector &sector, const Viewport &vp);
+        /// The actors and sectors found in this viewport, reused to avoid allocating
+        static inline std::vector<size_t> visibleActors{};
+        static inline std::vector<size_t> visibleSectors{};
 
-        static void RenderActor(const Actor &a, const glm::mat4 &matrix, const Viewport &vp);
+        /// Reused by the new actor preview to avoid allocating
+        static inline std::vector<ActorRenderCache::RenderParams> newActorRenderParams{};
 
-        static bool ActorIsCulled(const Actor &actor, const Viewport &vp);
+        static void RenderActor(const Actor &a,
+                                const std::vector<ActorRenderCache::RenderParams> &renderParams,
+                                const glm::mat4 &matrix,
+                                const Viewport &vp);
 
-        static void RenderBoxRdef(BoxRenderDefinition *rdef,
-                                  const Actor &actor,
+        static void RenderBoxRdef(const ActorRenderCache::RenderParams &params,
                                   const glm::mat4 &worldMatrix,
                                   const glm::mat4 &matrix);
 
-        static void RenderModelRdef(ModelRenderDefinition *rdef,
-                                    const Actor &actor,
+        static void RenderModelRdef(const ActorRenderCache::RenderParams &params,
                                     const glm::mat4 &worldMatrix,
                                     const glm::mat4 &matrix);
 
-        static void RenderOrientationRdef(OrientationRenderDefinition *rdef,
+        static void RenderOrientationRdef(const ActorRenderCache::RenderParams &params,
                                           const Actor &actor,
                                           const glm::mat4 &matrix,
                                           const Viewport &vp);
 
-        static void RenderPointRdef(PointRenderDefinition *rdef, const Actor &actor, const glm::mat4 &matrix);
+        static void RenderPointRdef(const ActorRenderCache::RenderParams &params,
+                                    const Actor &actor,
+                                    const glm::mat4 &matrix);
 
-        static void RenderSpriteRdef(SpriteRenderDefinition *rdef, const Actor &actor, const glm::mat4 &matrix);
+        static void RenderSpriteRdef(const ActorRenderCache::RenderParams &params,
+                                     const Actor &actor,
+                                     const glm::mat4 &matrix);
 
-        static void RenderWallRdef(WallRenderDefinition *rdef,
-                                   const Actor &actor,
+        static void RenderWallRdef(const ActorRenderCache::RenderParams &params,
                                    const glm::mat4 &worldMatrix,
                                    const glm::mat4 &matrix);
 
-        static void RenderCircleRdef(CircleRenderDefinition *rdef,
+        static void RenderCircleRdef(const ActorRenderCache::RenderParams &params,
                                      const Actor &actor,
                                      const glm::mat4 &worldMatrix,
                                      Viewport::ViewportType type);
 
-        static void RenderConeRdef(ConeRenderDefinition *rdef,
+        static void RenderConeRdef(const ActorRenderCache::RenderParams &params,
                                    const Actor &actor,
                                    const glm::mat4 &matrix,
                                    const glm::mat4 &worldMatrix);
@@ -24,8 +24,10 @@
 #include "ActorBrowserWindow.h"
 #include "MapCompileWindow.h"
 #include "MapEditor.h"
+#include "MapHistory.h"
 #include "MapPropertiesWindow.h"
 #include "MapRenderer.h"
+#include "SectorGeometryCache.h"
 #include "tools/AddActorTool.h"
 #include "tools/AddPolygonTool.h"
 #include "tools/AddPrimitiveTool.h"
@@ -108,11 +110,13 @@ static void OpenJson(const std::string &path)
                                                       "class \"{}\"",
                                                       actor.className));
             MapEditor::map = MapAsset();
+            MapHistory::Clear();
             return;
         }
 
         actor.ApplyDefinition(MapEditor::adm.GetActorDefinition(actor.className), false);
     }
+    MapHistory::Clear();
 }
 
 static void SetupDockspace()
@@ -215,6 +219,10 @@ static void Render()
     bool cutPressed = canCutCopy && ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_X, ImGuiInputFlags_RouteGlobal);
     bool copyPressed = canCutCopy && ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_C, ImGuiInputFlags_RouteGlobal);
     bool pastePressed = canPaste && ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_V, ImGuiInputFlags_RouteGlobal);
+    constexpr ImGuiInputFlags UNDO_FLAGS = ImGuiInputFlags_RouteGlobal | ImGuiInputFlags_Repeat;
+    bool undoPressed = ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_Z, UNDO_FLAGS);
+    bool redoPressed = ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_Y, UNDO_FLAGS) ||
+                       ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_Z, UNDO_FLAGS);
 
     if (ImGui::BeginMainMenuBar())
     {
@@ -235,6 +243,9 @@ static void Render()
         }
         if (ImGui::BeginMenu("Edit"))
         {
+            undoPressed |= ImGui::MenuItem("Undo", "Ctrl+Z", false, MapHistory::CanUndo());
+            redoPressed |= ImGui::MenuItem("Redo", "Ctrl+Y", false, MapHistory::CanRedo());
+            ImGui::Separator();
             if (ImGui::MenuItem("Map Properties", ""))
             {
                 MapPropertiesWindow::visible = true;
@@ -398,6 +409,7 @@ static void Render()
             ImGui::Separator();
             if (ImGui::MenuItem("Remove unknown/obsolete actor params"))
             {
+                MapHistory::ChangeActors(0, MapEditor::map.actors.size(), MapEditor::map.actors.size());
                 for (Actor &actor: MapEditor::map.actors)
                 {
                     const ActorDefinition &def = MapEditor::adm.GetActorDefinition(actor.className);
@@ -417,6 +429,7 @@ static void Render()
         MapEditor::toolType = MapEditor::EditorToolType::SELECT;
         MapEditor::tool = std::unique_ptr<EditorTool>(new SelectTool());
         MapEditor::mapFile = "";
+        MapHistory::Clear();
     }
     if (openPressed)
     {
@@ -444,6 +457,21 @@ static void Render()
     {
         dynamic_cast<SelectTool *>(MapEditor::tool.get())->Paste();
     }
+    if (undoPressed || redoPressed)
+    {
+        if (undoPressed)
+        {
+            MapHistory::Undo();
+        } else
+        {
+            MapHistory::Redo();
+        }
+        // The selection may refer to sectors and actors that moved or no longer exist
+        if (MapEditor::toolType == MapEditor::EditorToolType::SELECT)
+        {
+            MapEditor::tool = std::unique_ptr<EditorTool>(new SelectTool());
+        }
+    }
 
     const ImVec2 workSize{viewport->WorkSize.x, MapEditor::TOOLBAR_HEIGHT};
     const ImVec2 workPos{viewport->WorkPos.x, viewport->WorkPos.y};
@@ -553,6 +581,8 @@ static void Render()
     MapPropertiesWindow::Render();
     MapCompileWindow::Render();
     MapCompileWindow::RenderCompileOutput();
+
+    MapHistory::Update();
 }
 
 int main(const int argc, char **argv)
@@ -597,6 +627,7 @@ int main(const int argc, char **argv)
         Logger::Error("Failed to start renderer!");
         return -1;
     }
+    SectorGeometryCache::Init();
     (void)SDL_SetWindowMinimumSize(SDKWindow::Get().GetWindow(), 640, 480);
 
     (void)SharedMgr::Get().textureCache.RegisterPng("assets/icons/select.png", MapEditor::SELECT_ICON_NAME);
@@ -617,6 +648,7 @@ int main(const int argc, char **argv)
     SDKWindow::Get().MainLoop(Render);
 
     SoundSystem::Get().Destroy();
+    SectorGeometryCache::Destroy();
     MapRenderer::Destroy();
     SDKWindow::Get().Destroy();
     return 0;
@@ -9,6 +9,7 @@
 #include <libassets/type/Color.h>
 #include <memory>
 #include "../MapEditor.h"
+#include "../MapHistory.h"
 #include "../Viewport.h"
 #include "../ViewportRenderer.h"
 #include "EditorTool.h"
@@ -24,6 +25,7 @@ void AddActorTool::PlaceActor()
     const ActorDefinition &def = MapEditor::adm.GetActorDefinition(newActorType);
     a.ApplyDefinition(def, true);
 
+    MapHistory::ChangeActors(MapEditor::map.actors.size(), 0, 1);
     MapEditor::map.actors.push_back(a);
     hasPlacedActor = false;
 }
@@ -11,6 +11,7 @@
 #include <libassets/type/WallMaterial.h>
 #include <memory>
 #include "../MapEditor.h"
+#include "../MapHistory.h"
 #include "../Viewport.h"
 #include "../ViewportRenderer.h"
 #include "EditorTool.h"
@@ -113,6 +114,7 @@ void AddPolygonTool::RenderViewport(Viewport &vp)
                                 SDKWindow::Get().ErrorMessage("Sector has invalid shape and will not be added");
                             } else
                             {
+                                MapHistory::ChangeSectors(MapEditor::map.sectors.size(), 0, 1);
                                 MapEditor::map.sectors.push_back(s);
                             }
                         }
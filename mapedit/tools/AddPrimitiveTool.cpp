@@ -14,6 +14,7 @@
 #include <numbers>
 #include <vector>
 #include "../MapEditor.h"
+#include "../MapHistory.h"
 #include "../Viewport.h"
 #include "../ViewportRenderer.h"
 #include "EditorTool.h"
@@ -69,6 +70,7 @@ void AddPrimitiveTool::RenderViewport(Viewport &vp)
                         SDKWindow::Get().ErrorMessage("Sector has invalid shape and will not be added");
                     } else
                     {
+                        MapHistory::ChangeSectors(MapEditor::map.sectors.size(), 0, 1);
                         MapEditor::map.sectors.push_back(s);
                     }
                     hasDrawnShape = false;
@@ -0,0 +1,209 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#include "PickGrid.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <imgui.h>
+#include <libassets/type/Actor.h>
+#include <libassets/type/Sector.h>
+#include <optional>
+#include <vector>
+#include "../MapEditor.h"
+#include "../MapSpatialIndex.h"
+#include "../SectorGeometryCache.h"
+#include "../Viewport.h"
+#include "EditorTool.h"
+
+void PickGrid::Update(const Viewport &vp, const std::optional<size_t> focusedSectorIndex)
+{
+    // The caches were brought up to date right before the tool ran, so their generations cover every edit made
+    // before this query
+    ImVec2 windowPos;
+    ImVec2 windowSize;
+    vp.GetWindowRect(windowPos, windowSize);
+    const glm::vec2 size = glm::vec2(windowSize.x, windowSize.y);
+    const glm::mat4 matrix = vp.GetMatrix();
+    if (built &&
+        lastMatrix == matrix &&
+        lastWindowSize == size &&
+        lastGeometryGeneration == SectorGeometryCache::GetGeneration() &&
+        lastIndexGeneration == MapSpatialIndex::GetGeneration() &&
+        lastFocusedSectorIndex == focusedSectorIndex)
+    {
+        return;
+    }
+
+    lastMatrix = matrix;
+    lastWindowSize = size;
+    lastGeometryGeneration = SectorGeometryCache::GetGeneration();
+    lastIndexGeneration = MapSpatialIndex::GetGeneration();
+    lastFocusedSectorIndex = focusedSectorIndex;
+    built = true;
+    Rebuild(vp, focusedSectorIndex);
+}
+
+void PickGrid::Query(const glm::vec2 screenMin, const glm::vec2 screenMax, std::vector<Item> &outItems) const
+{
+    outItems.clear();
+    if (items.empty())
+    {
+        return;
+    }
+
+    stamp++;
+    if (stamp == 0)
+    {
+        std::ranges::fill(itemStamps, 0);
+        stamp = 1;
+    }
+
+    queryResults.clear();
+    const glm::ivec2 minCell = GetCell(screenMin);
+    const glm::ivec2 maxCell = GetCell(screenMax);
+    for (int y = minCell.y; y <= maxCell.y; y++)
+    {
+        for (int x = minCell.x; x <= maxCell.x; x++)
+        {
+            const size_t cell = static_cast<size_t>((y * cellCount.x) + x);
+            for (uint32_t i = cellStarts.at(cell); i < cellStarts.at(cell + 1); i++)
+            {
+                const uint32_t itemIndex = cellItems.at(i);
+                if (itemStamps.at(itemIndex) == stamp)
+                {
+                    continue;
+                }
+                itemStamps.at(itemIndex) = stamp;
+                const Item &item = items.at(itemIndex);
+                if (item.screenMin.x <= screenMax.x &&
+                    item.screenMax.x >= screenMin.x &&
+                    item.screenMin.y <= screenMax.y &&
+                    item.screenMax.y >= screenMin.y)
+                {
+                    queryResults.push_back(itemIndex);
+                }
+            }
+        }
+    }
+
+    // Items were added by type and index, so this puts the results back in that order
+    std::ranges::sort(queryResults);
+    for (const uint32_t itemIndex: queryResults)
+    {
+        outItems.push_back(items.at(itemIndex));
+    }
+}
+
+void PickGrid::Rebuild(const Viewport &vp, const std::optional<size_t> focusedSectorIndex)
+{
+    const bool topDown = vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ;
+
+    items.clear();
+    if (focusedSectorIndex.has_value())
+    {
+        // Edges can only be picked from above
+        if (topDown && focusedSectorIndex.value() < MapEditor::map.sectors.size())
+        {
+            const Sector &sector = MapEditor::map.sectors.at(focusedSectorIndex.value());
+            for (size_t i = 0; i < sector.points.size(); i++)
+            {
+                const glm::vec2 &start2 = sector.points.at(i);
+                const glm::vec2 &end2 = sector.points.at((i + 1) % sector.points.size());
+                const glm::vec2 start = vp.WorldToScreenPos(glm::vec3(start2.x, sector.ceilingHeight, start2.y));
+                const glm::vec2 end = vp.WorldToScreenPos(glm::vec3(end2.x, sector.ceilingHeight, end2.y));
+                items.push_back({
+                    .type = EditorTool::ItemType::LINE,
+                    .index = i,
+                    .screenMin = glm::min(start, end),
+                    .screenMax = glm::max(start, end),
+                });
+            }
+        }
+    } else
+    {
+        for (size_t i = 0; i < MapEditor::map.actors.size(); i++)
+        {
+            const glm::vec2 position = vp.WorldToScreenPos(MapEditor::map.actors.at(i).position);
+            items.push_back({
+                .type = EditorTool::ItemType::ACTOR,
+                .index = i,
+                .screenMin = position,
+                .screenMax = position,
+            });
+        }
+        // Sectors can only be picked from above
+        if (topDown)
+        {
+            for (size_t i = 0; i < MapEditor::map.sectors.size(); i++)
+            {
+                const glm::vec4 &aabb = SectorGeometryCache::GetAABB(i);
+                const glm::vec2 a = vp.WorldToScreenPos(glm::vec3(aabb.x - aabb.z, 0, aabb.y - aabb.w));
+                const glm::vec2 b = vp.WorldToScreenPos(glm::vec3(aabb.x + aabb.z, 0, aabb.y + aabb.w));
+                items.push_back({
+                    .type = EditorTool::ItemType::SECTOR,
+                    .index = i,
+                    .screenMin = glm::min(a, b),
+                    .screenMax = glm::max(a, b),
+                });
+            }
+        }
+    }
+
+    itemStamps.assign(items.size(), 0);
+    stamp = 0;
+
+    cellCount = glm::max(glm::ivec2(glm::ceil(lastWindowSize / CELL_SIZE)), glm::ivec2(1));
+    const size_t totalCells = static_cast<size_t>(cellCount.x) * static_cast<size_t>(cellCount.y);
+
+    // Items entirely off screen can't be hovered, but ones just past the edge can still be within reach of the mouse
+    const glm::vec2 visibleMin = glm::vec2(-CELL_SIZE);
+    const glm::vec2 visibleMax = lastWindowSize + CELL_SIZE;
+    const auto forEachCell = [&](const Item &item, const auto &callback) {
+        if (item.screenMin.x > visibleMax.x ||
+            item.screenMax.x < visibleMin.x ||
+            item.screenMin.y > visibleMax.y ||
+            item.screenMax.y < visibleMin.y)
+        {
+            return;
+        }
+        const glm::ivec2 minCell = GetCell(item.screenMin);
+        const glm::ivec2 maxCell = GetCell(item.screenMax);
+        for (int y = minCell.y; y <= maxCell.y; y++)
+        {
+            for (int x = minCell.x; x <= maxCell.x; x++)
+            {
+                callback(static_cast<size_t>((y * cellCount.x) + x));
+            }
+        }
+    };
+
+    // Count the items in each cell, turn the counts into offsets, then fill the cells in
+    cellStarts.assign(totalCells + 1, 0);
+    for (const Item &item: items)
+    {
+        forEachCell(item, [this](const size_t cell) { cellStarts.at(cell + 1)++; });
+    }
+    for (size_t i = 0; i < totalCells; i++)
+    {
+        cellStarts.at(i + 1) += cellStarts.at(i);
+    }
+    cellItems.resize(cellStarts.back());
+    std::vector<uint32_t> cellCursors(cellStarts.begin(), cellStarts.end() - 1);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        forEachCell(items.at(i), [this, &cellCursors, i](const size_t cell) {
+            cellItems.at(cellCursors.at(cell)) = static_cast<uint32_t>(i);
+            cellCursors.at(cell)++;
+        });
+    }
+}
+
+glm::ivec2 PickGrid::GetCell(const glm::vec2 screenPos) const
+{
+    // Clamped as floats, since converting a position far off screen to an int could overflow
+    const glm::vec2 cell = glm::clamp(glm::floor(screenPos / CELL_SIZE), glm::vec2(0), glm::vec2(cellCount - 1));
+    return glm::ivec2(cell);
+}
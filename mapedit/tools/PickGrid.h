@@ -0,0 +1,73 @@
+//
+// Created by droc101 on 10/19/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <optional>
+#include <vector>
+#include "../Viewport.h"
+#include "EditorTool.h"
+
+/**
+ * A grid over a viewport's screen that buckets the screen-space bounds of pickable items, so finding what is under
+ * the mouse (or inside a selection box) only visits the items in a few cells instead of the whole map.
+ * The grid is only rebuilt when the camera, the window or the map changes.
+ */
+class PickGrid
+{
+    public:
+        struct Item
+        {
+                EditorTool::ItemType type;
+                /// The actor or sector index, or for lines the index of the edge's first vertex
+                size_t index;
+                glm::vec2 screenMin;
+                glm::vec2 screenMax;
+        };
+
+        /**
+         * Rebuild the grid if anything it was built from changed
+         * @param vp The viewport the grid covers
+         * @param focusedSectorIndex The sector being edited in sector focus mode, whose edges are indexed instead of
+         * the actors and sectors
+         */
+        void Update(const Viewport &vp, std::optional<size_t> focusedSectorIndex);
+
+        /**
+         * Find the items whose screen bounds overlap a rectangle
+         * @param screenMin The top left of the rectangle, in viewport-local pixels
+         * @param screenMax The bottom right of the rectangle, in viewport-local pixels
+         * @param outItems Where to store the items, actors first, each type in ascending index order
+         */
+        void Query(glm::vec2 screenMin, glm::vec2 screenMax, std::vector<Item> &outItems) const;
+
+    private:
+        static constexpr float CELL_SIZE = 32;
+
+        /// What the grid was built from
+        glm::mat4 lastMatrix{};
+        glm::vec2 lastWindowSize{};
+        uint64_t lastGeometryGeneration = 0;
+        uint64_t lastIndexGeneration = 0;
+        std::optional<size_t> lastFocusedSectorIndex = std::nullopt;
+        bool built = false;
+
+        glm::ivec2 cellCount{};
+        std::vector<Item> items{};
+        /// Items of cell i are cellItems[cellStarts[i]] to cellItems[cellStarts[i + 1]]
+        std::vector<uint32_t> cellStarts{};
+        std::vector<uint32_t> cellItems{};
+
+        /// Marks items already found by the current query, so items spanning several cells are only returned once
+        mutable std::vector<uint32_t> itemStamps{};
+        mutable uint32_t stamp = 0;
+        mutable std::vector<uint32_t> queryResults{};
+
+        void Rebuild(const Viewport &vp, std::optional<size_t> focusedSectorIndex);
+
+        [[nodiscard]] glm::ivec2 GetCell(glm::vec2 screenPos) const;
+};
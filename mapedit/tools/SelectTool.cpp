@@ -10,21 +10,26 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 #include <libassets/type/Actor.h>
 #include <libassets/type/Color.h>
 #include <libassets/type/Sector.h>
 #include <misc/cpp/imgui_stdlib.h>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <variant>
 #include <vector>
 #include "../EditActorWindow.h"
 #include "../MapEditor.h"
+#include "../MapHistory.h"
 #include "../Viewport.h"
 #include "../ViewportRenderer.h"
 #include "EditorTool.h"
+#include "PickGrid.h"
 
 void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm::vec3 worldSpaceHover)
 {
@@ -40,6 +45,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
             {
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                MapHistory::ChangeActors(selectionIndex, 1, 1);
                 Actor &actor = MapEditor::map.actors.at(selectionIndex);
                 const glm::vec3 snapped = MapEditor::SnapToGrid(worldSpaceHover);
                 actor.position.x = snapped.x;
@@ -56,6 +62,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
             {
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                 const glm::vec3 snapped = MapEditor::SnapToGrid(worldSpaceHover);
                 sector.points.at(selectionVertexIndex).x = snapped.x;
                 sector.points.at(selectionVertexIndex).y = snapped.z;
@@ -64,6 +71,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             {
                 if (!sector.IsValid())
                 {
+                    MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                     sector.points.at(selectionVertexIndex) = vertexDragOriginalPoint;
                 }
                 dragging = false;
@@ -75,6 +83,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
             {
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                 const glm::vec2 worldHover2D = glm::vec2(worldSpaceHover.x, worldSpaceHover.z);
                 const glm::vec2 startPos = worldHover2D - lineDragModeMouseOffset;
                 const glm::vec2 endPos = startPos - lineDragModeSecondVertexOffset;
@@ -89,6 +98,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             {
                 if (!sector.IsValid())
                 {
+                    MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                     sector.points.at(selectionVertexIndex) = vertexDragOriginalPoint;
                     sector.points.at((selectionVertexIndex + 1) %
                                      sector.points.size()) = vertexDragOriginalPoint - lineDragModeSecondVertexOffset;
@@ -121,6 +131,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
                     }
                 }
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                MapHistory::ChangeSectors(selectionIndex, 1, 1);
                 const glm::vec2 worldHover2D = glm::vec2(worldSpaceHover.x, worldSpaceHover.z);
                 const glm::vec2 startPos = worldHover2D - sectorDragMouseOffset;
                 for (size_t i = 0; i < sector.points.size(); i++)
@@ -145,6 +156,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
             {
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
+                MapHistory::ChangeActors(selectionIndex, 1, 1);
                 Actor &actor = MapEditor::map.actors.at(selectionIndex);
                 const glm::vec3 snapped = MapEditor::SnapToGrid(worldSpaceHover);
                 if (vp.GetType() == Viewport::ViewportType::SIDE_YZ)
@@ -167,6 +179,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
             {
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeNS);
+                MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                 const glm::vec3 snapped = MapEditor::SnapToGrid(worldSpaceHover);
                 sector.ceilingHeight = snapped.y;
                 dragging = true;
@@ -174,6 +187,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             {
                 if (!sector.IsValid())
                 {
+                    MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                     sector.ceilingHeight = vertexDragOriginalPoint.x;
                 }
                 dragging = false;
@@ -184,6 +198,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
             {
                 ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeNS);
+                MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                 const glm::vec3 snapped = MapEditor::SnapToGrid(worldSpaceHover);
                 sector.floorHeight = snapped.y;
                 dragging = true;
@@ -191,6 +206,7 @@ void SelectTool::HandleDrag(const Viewport &vp, const bool isHovered, const glm:
             {
                 if (!sector.IsValid())
                 {
+                    MapHistory::ChangeSectors(focusedSectorIndex, 1, 1);
                     sector.floorHeight = vertexDragOriginalPoint.y;
                 }
                 dragging = false;
@@ -309,10 +325,12 @@ void SelectTool::ProcessVertexHover(const Viewport &viewport,
             {
                 if (sector.points.size() > 3)
                 {
+                    MapHistory::ChangeSectors(sectorIndex, 1, 1);
                     sector.points.erase(sector.points.begin() + static_cast<ptrdiff_t>(vertexIndex));
                     selectionType = ItemType::SECTOR;
                 } else
                 {
+                    MapHistory::ChangeSectors(sectorIndex, 1, 0);
                     MapEditor::map.sectors.erase(MapEditor::map.sectors.begin() + static_cast<int64_t>(sectorIndex));
                     if (hoverType == ItemType::SECTOR && hoverIndex == selectionIndex)
                     {
@@ -341,6 +359,7 @@ void SelectTool::ProcessVertexHover(const Viewport &viewport,
                 if (addPointMode)
                 {
                     const glm::vec3 newVertexPos = MapEditor::SnapToGrid(worldSpaceHover);
+                    MapHistory::ChangeSectors(sectorIndex, 1, 1);
                     sector.points.insert(sector.points.begin() + static_cast<ptrdiff_t>(vertexIndex) + 1,
                                          {newVertexPos.x, newVertexPos.z});
                     sector.wallMaterials.insert(sector.wallMaterials.begin() + static_cast<ptrdiff_t>(vertexIndex) + 1,
@@ -382,14 +401,28 @@ std::vector<std::tuple<EditorTool::ItemType, size_t, float>> SelectTool::Determi
     std::vector<std::tuple<ItemType, size_t, float>> actorHoverStack{};
     std::vector<std::tuple<ItemType, size_t, float>> sectorHoverStack{};
 
-    for (size_t actorIndex = 0; actorIndex < MapEditor::map.actors.size(); actorIndex++)
+    const ImVec2 hoverScreenSpaceIV = vp.GetLocalMousePos();
+    const glm::vec2 hoverScreenSpace = glm::vec2(hoverScreenSpaceIV.x, hoverScreenSpaceIV.y);
+    pickResults.clear();
+    if (isHovered)
+    {
+        PickGrid &pickGrid = pickGrids.at(static_cast<size_t>(vp.GetType()));
+        pickGrid.Update(vp, std::nullopt);
+        const glm::vec2 hoverDistance = glm::vec2(MapEditor::HOVER_DISTANCE_PIXELS);
+        pickGrid.Query(hoverScreenSpace - hoverDistance, hoverScreenSpace + hoverDistance, pickResults);
+    }
+
+    for (const PickGrid::Item &item: pickResults)
     {
+        if (item.type != ItemType::ACTOR)
+        {
+            continue;
+        }
+        const size_t actorIndex = item.index;
         const Actor &a = MapEditor::map.actors.at(actorIndex);
         const glm::vec2 posScreenSpace = vp.WorldToScreenPos(a.position);
-        const ImVec2 hoverScreenSpaceIV = vp.GetLocalMousePos();
-        const glm::vec2 hoverScreenSpace = glm::vec2(hoverScreenSpaceIV.x, hoverScreenSpaceIV.y);
 
-        if (distance(posScreenSpace, hoverScreenSpace) <= MapEditor::HOVER_DISTANCE_PIXELS && isHovered)
+        if (distance(posScreenSpace, hoverScreenSpace) <= MapEditor::HOVER_DISTANCE_PIXELS)
         {
             if (selectionType == ItemType::ACTOR && selectionIndex == actorIndex)
             {
@@ -422,10 +455,15 @@ std::vector<std::tuple<EditorTool::ItemType, size_t, float>> SelectTool::Determi
 
     if (vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ)
     {
-        for (size_t sectorIndex = 0; sectorIndex < MapEditor::map.sectors.size(); sectorIndex++)
+        for (const PickGrid::Item &item: pickResults)
         {
+            if (item.type != ItemType::SECTOR)
+            {
+                continue;
+            }
+            const size_t sectorIndex = item.index;
             const Sector &sector = MapEditor::map.sectors.at(sectorIndex);
-            if (sector.ContainsPoint({worldSpaceHover.x, worldSpaceHover.z}) && isHovered)
+            if (sector.ContainsPoint({worldSpaceHover.x, worldSpaceHover.z}))
             {
                 if (selectionType == ItemType::SECTOR && selectionIndex == sectorIndex)
                 {
@@ -614,6 +652,7 @@ void SelectTool::ProcessViewportSelectMode(const Viewport &vp, const bool isHove
     {
         if (selectionType == ItemType::ACTOR)
         {
+            MapHistory::ChangeActors(selectionIndex, 1, 0);
             MapEditor::map.actors.erase(MapEditor::map.actors.begin() + selectionIndex);
             if (hoverType == ItemType::ACTOR && hoverIndex == selectionIndex)
             {
@@ -622,6 +661,7 @@ void SelectTool::ProcessViewportSelectMode(const Viewport &vp, const bool isHove
             selectionType = ItemType::NONE;
         } else if (selectionType == ItemType::SECTOR)
         {
+            MapHistory::ChangeSectors(selectionIndex, 1, 0);
             MapEditor::map.sectors.erase(MapEditor::map.sectors.begin() + selectionIndex);
             if (hoverType == ItemType::SECTOR && hoverIndex == selectionIndex)
             {
@@ -649,19 +689,31 @@ void SelectTool::ProcessViewportVertexMode(Viewport &vp,
 
     bool haveAddedNewVertex = false;
 
-    for (size_t sectorIndex = 0; sectorIndex < MapEditor::map.sectors.size(); sectorIndex++)
+    if (focusedSectorIndex < MapEditor::map.sectors.size())
     {
+        const size_t sectorIndex = focusedSectorIndex;
         Sector &sector = MapEditor::map.sectors.at(sectorIndex);
-        if (focusedSectorIndex == sectorIndex)
-        {
-            ProcessSectorHover(vp, sector, isHovered, screenSpaceHover, sectorIndex);
-        } else
+        ProcessSectorHover(vp, sector, isHovered, screenSpaceHover, sectorIndex);
+
+        pickResults.clear();
+        if (vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ)
         {
-            continue;
+            PickGrid &pickGrid = pickGrids.at(static_cast<size_t>(vp.GetType()));
+            pickGrid.Update(vp, sectorIndex);
+            const glm::vec2 hoverDistance = glm::vec2(MapEditor::HOVER_DISTANCE_PIXELS);
+            pickGrid.Query(screenSpaceHover - hoverDistance, screenSpaceHover + hoverDistance, pickResults);
         }
 
-        for (size_t vertexIndex = 0; vertexIndex < sector.points.size(); vertexIndex++)
+        const size_t sectorCount = MapEditor::map.sectors.size();
+        const size_t pointCount = sector.points.size();
+        for (const PickGrid::Item &item: pickResults)
         {
+            // Hovering can add or remove vertices, or delete the sector, which makes the rest of the results stale
+            if (MapEditor::map.sectors.size() != sectorCount || sector.points.size() != pointCount)
+            {
+                break;
+            }
+            const size_t vertexIndex = item.index;
             const glm::vec2 &start2 = sector.points.at(vertexIndex);
             const glm::vec2 &end2 = sector.points.at((vertexIndex + 1) % sector.points.size());
             const glm::vec3 startCeiling = glm::vec3(start2.x, sector.ceilingHeight, start2.y);
@@ -696,10 +748,12 @@ void SelectTool::ProcessViewportVertexMode(Viewport &vp,
             Sector &s = MapEditor::map.sectors.at(selectionIndex);
             if (s.points.size() > 3)
             {
+                MapHistory::ChangeSectors(selectionIndex, 1, 1);
                 s.points.erase(s.points.begin() + selectionVertexIndex);
                 selectionType = ItemType::NONE;
             } else
             {
+                MapHistory::ChangeSectors(selectionIndex, 1, 0);
                 MapEditor::map.sectors.erase(MapEditor::map.sectors.begin() + selectionIndex);
                 selectionType = ItemType::NONE;
             }
@@ -737,7 +791,7 @@ void SelectTool::RenderViewport(Viewport &vp)
 
     if (vp.GetType() == Viewport::ViewportType::TOP_DOWN_XZ && selectionType == ItemType::ACTOR)
     {
-        EditActorWindow::Render(MapEditor::map.actors.at(selectionIndex));
+        EditActorWindow::Render(selectionIndex);
     }
 
     const ViewportRenderer::ViewportRenderSettings vps = {
@@ -763,52 +817,70 @@ void SelectTool::RenderToolWindow()
         return;
     }
     ImGui::PushItemWidth(-1);
-    size_t sectIndex = 0;
+    // The widgets edit a copy, so that the history can be told before the sector or actor in the map changes
+    const auto editSector = [](const size_t sectorIndex, const auto &renderWidgets) {
+        Sector sector = MapEditor::map.sectors.at(sectorIndex);
+        renderWidgets(sector);
+        if (sector != MapEditor::map.sectors.at(sectorIndex))
+        {
+            MapHistory::ChangeSectors(sectorIndex, 1, 1);
+            MapEditor::map.sectors.at(sectorIndex) = std::move(sector);
+        }
+    };
     switch (selectionType)
     {
         case ItemType::NONE:
             ImGui::Text("No Selection");
             break;
         case ItemType::VERTEX:
-            ImGui::InputFloat2("##vertexPosition",
-                               glm::value_ptr(MapEditor::map.sectors.at(focusedSectorIndex)
-                                                      .points.at(selectionVertexIndex)));
+            editSector(focusedSectorIndex, [this](Sector &sector) {
+                ImGui::InputFloat2("##vertexPosition", glm::value_ptr(sector.points.at(selectionVertexIndex)));
+            });
             break;
         case ItemType::LINE:
-            MapEditor::MaterialToolWindow(MapEditor::map.sectors.at(focusedSectorIndex)
-                                                  .wallMaterials.at(selectionVertexIndex));
+            editSector(focusedSectorIndex, [this](Sector &sector) {
+                MapEditor::MaterialToolWindow(sector.wallMaterials.at(selectionVertexIndex));
+            });
             break;
         case ItemType::CEILING:
-            MapEditor::MaterialToolWindow(MapEditor::map.sectors.at(focusedSectorIndex).ceilingMaterial);
-            ImGui::Separator();
-            ImGui::Text("Height");
-            ImGui::InputFloat("##ceilHeight", &MapEditor::map.sectors.at(focusedSectorIndex).ceilingHeight, 1, 1, "%.0f");
+            editSector(focusedSectorIndex, [](Sector &sector) {
+                MapEditor::MaterialToolWindow(sector.ceilingMaterial);
+                ImGui::Separator();
+                ImGui::Text("Height");
+                ImGui::InputFloat("##ceilHeight", &sector.ceilingHeight, 1, 1, "%.0f");
+            });
             break;
         case ItemType::FLOOR:
-            MapEditor::MaterialToolWindow(MapEditor::map.sectors.at(focusedSectorIndex).floorMaterial);
-            ImGui::Separator();
-            ImGui::Text("Height");
-            ImGui::InputFloat("##floorHeight", &MapEditor::map.sectors.at(focusedSectorIndex).floorHeight, 1, 1, "%.0f");
+            editSector(focusedSectorIndex, [](Sector &sector) {
+                MapEditor::MaterialToolWindow(sector.floorMaterial);
+                ImGui::Separator();
+                ImGui::Text("Height");
+                ImGui::InputFloat("##floorHeight", &sector.floorHeight, 1, 1, "%.0f");
+            });
             break;
         case ItemType::SECTOR:
-            if (sectorFocusMode)
-            {
-                sectIndex = focusedSectorIndex;
-            } else
-            {
-                sectIndex = selectionIndex;
-            }
-
-            ImGui::Text("Name");
-            ImGui::SameLine();
-            ImGui::TextDisabled("(editor only)");
-            ImGui::InputText("##sectorName", &MapEditor::map.sectors.at(sectIndex).name);
+            editSector(sectorFocusMode ? focusedSectorIndex : selectionIndex, [](Sector &sector) {
+                ImGui::Text("Name");
+                ImGui::SameLine();
+                ImGui::TextDisabled("(editor only)");
+                ImGui::InputText("##sectorName", &sector.name);
+            });
             break;
         case ItemType::ACTOR:
+        {
+            const Actor &actor = MapEditor::map.actors.at(selectionIndex);
+            glm::vec3 position = actor.position;
+            glm::vec3 rotation = actor.rotation;
             ImGui::Text("Position");
-            ImGui::InputFloat3("##position", glm::value_ptr(MapEditor::map.actors.at(selectionIndex).position));
+            const bool positionChanged = ImGui::InputFloat3("##position", glm::value_ptr(position));
             ImGui::Text("Rotation");
-            ImGui::InputFloat3("##rotation", glm::value_ptr(MapEditor::map.actors.at(selectionIndex).rotation));
+            const bool rotationChanged = ImGui::InputFloat3("##rotation", glm::value_ptr(rotation));
+            if (positionChanged || rotationChanged)
+            {
+                MapHistory::ChangeActors(selectionIndex, 1, 1);
+                MapEditor::map.actors.at(selectionIndex).position = position;
+                MapEditor::map.actors.at(selectionIndex).rotation = rotation;
+            }
             ImGui::Separator();
             if (ImGui::Button("Actor Properties"))
             {
@@ -816,6 +888,7 @@ void SelectTool::RenderToolWindow()
                 EditActorWindow::visible = true;
             }
             break;
+        }
         default:
             ImGui::Text("The current selection has no properties");
     }
@@ -842,9 +915,11 @@ void SelectTool::Cut()
     Copy();
     if (selectionType == ItemType::ACTOR)
     {
+        MapHistory::ChangeActors(selectionIndex, 1, 0);
         MapEditor::map.actors.erase(MapEditor::map.actors.begin() + selectionIndex);
     } else if (selectionType == ItemType::SECTOR)
     {
+        MapHistory::ChangeSectors(selectionIndex, 1, 0);
         MapEditor::map.sectors.erase(MapEditor::map.sectors.begin() + selectionIndex);
     }
     selectionType = ItemType::NONE;
@@ -860,11 +935,13 @@ void SelectTool::Paste()
     const std::variant<Sector, Actor> &clipboard = MapEditor::clipboard.value();
     if (std::holds_alternative<Actor>(clipboard))
     {
+        MapHistory::ChangeActors(MapEditor::map.actors.size(), 0, 1);
         MapEditor::map.actors.push_back(std::get<Actor>(clipboard));
         selectionIndex = MapEditor::map.actors.size() - 1;
         selectionType = ItemType::ACTOR;
     } else if (std::holds_alternative<Sector>(clipboard))
     {
+        MapHistory::ChangeSectors(MapEditor::map.sectors.size(), 0, 1);
         MapEditor::map.sectors.push_back(std::get<Sector>(clipboard));
         selectionIndex = MapEditor::map.sectors.size() - 1;
         selectionType = ItemType::SECTOR;
@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <libassets/type/Color.h>
 #include <libassets/type/Sector.h>
 #include <tuple>
 #include <vector>
 #include "../Viewport.h"
 #include "EditorTool.h"
+#include "PickGrid.h"
 
 class SelectTool final: public EditorTool
 {
@@ -91,4 +94,9 @@ class SelectTool final: public EditorTool
         std::vector<std::tuple<ItemType, size_t, float>> menuHoveredItems{};
 
         bool dragging = false;
+
+        /// One per viewport type, since each viewport sees the map from a different side
+        std::array<PickGrid, 3> pickGrids{};
+        /// Reused by hover queries to avoid allocating
+        std::vector<PickGrid::Item> pickResults{};
 };
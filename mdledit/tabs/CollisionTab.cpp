@@ -3,19 +3,26 @@
 //
 
 #include "CollisionTab.h"
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <format>
 #include <game_sdk/DialogFilters.h>
 #include <game_sdk/SDKWindow.h>
+#include <game_sdk/SharedMgr.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 #include <libassets/asset/ModelAsset.h>
 #include <libassets/type/ConvexHull.h>
+#include <libassets/util/ConvexDecomposition.h>
+#include <memory>
 #include <string>
 #include "../ModelEditor.h"
 
 void CollisionTab::Render()
 {
+    UpdateGenerate();
     ModelAsset &model = ModelEditor::modelViewer.GetModel();
     ImGui::Begin("Collision", nullptr, ImGuiWindowFlags_NoCollapse);
     ImGui::Text("Bounding Box");
@@ -51,8 +58,7 @@ void CollisionTab::Render()
     if (ImGui::IsItemHovered())
     {
         ImGui::SetTooltip("Dynamic collision models are a collection of convex hulls.\nConcave shapes can only be "
-                          "created using multiple hulls.\nIt is up to you to ensure the imported hulls are "
-                          "actually convex.");
+                          "created using multiple hulls.\nImported meshes are replaced with their convex hull.");
     }
 
     if (model.GetCollisionModelType() == ModelAsset::CollisionModelType::DYNAMIC_MULTIPLE_CONVEX)
@@ -88,6 +94,7 @@ void CollisionTab::RenderCHullUI()
     {
         SDKWindow::Get().OpenFileDialog(ModelEditor::ImportMultipleHulls, DialogFilters::STANDARD_MODEL_FILTERS);
     }
+    RenderGenerate();
     constexpr float PANEL_HEIGHT = 250.0f;
     ImGui::BeginChild("ScrollableRegion",
                       ImVec2(0, PANEL_HEIGHT),
@@ -97,7 +104,10 @@ void CollisionTab::RenderCHullUI()
         const std::string title = std::format("Shape {}", hullIndex);
         ImGui::SeparatorText(title.c_str());
         ConvexHull &hull = ModelEditor::modelViewer.GetModel().GetHull(hullIndex);
-        ImGui::TextUnformatted(std::format("{} points", hull.GetPoints().size()).c_str());
+        ImGui::TextUnformatted(std::format("{} points, volume {:.3f}",
+                                           hull.GetPoints().size(),
+                                           hull.GetMassProperties().volume)
+                                       .c_str());
         ImGui::Dummy(ImVec2(0.0f, 2.0f));
         const ImVec2 space = ImGui::GetContentRegionAvail();
         const float buttonWidth = space.x / 2.0f;
@@ -109,3 +119,85 @@ void CollisionTab::RenderCHullUI()
     }
     ImGui::EndChild();
 }
+
+void CollisionTab::UpdateGenerate()
+{
+    if (pendingHulls == nullptr || !pendingHulls->done.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    const std::shared_ptr<PendingHulls> pending = std::move(pendingHulls);
+    pendingHulls = nullptr;
+    if (pending->modelGeneration != ModelEditor::modelViewer.GetModelGeneration())
+    {
+        SDKWindow::Get().WarningMessage("The model changed while the hulls were being generated, generate them again");
+        return;
+    }
+    if (pending->generated == 0)
+    {
+        SDKWindow::Get().ErrorMessage("Failed to generate hulls, LOD 0 has no triangles");
+        return;
+    }
+    // Only the hulls are taken from the copy, anything else may have been edited since
+    ModelAsset &model = ModelEditor::modelViewer.GetModel();
+    while (model.GetNumHulls() != 0)
+    {
+        model.RemoveHull(model.GetNumHulls() - 1);
+    }
+    for (size_t i = 0; i < pending->model.GetNumHulls(); i++)
+    {
+        model.AddHull(pending->model.GetHull(i));
+    }
+    ModelEditor::modelViewer.ReloadModel();
+}
+
+void CollisionTab::RenderGenerate()
+{
+    if (!ImGui::CollapsingHeader("Generate Hulls"))
+    {
+        return;
+    }
+    ImGui::PushItemWidth(-1);
+    ImGui::TextUnformatted("Max Hulls");
+    ImGui::SliderInt("##GenerateMaxHulls", &generateMaxHulls, 1, 64);
+    ImGui::TextUnformatted("Max Concavity (% of volume)");
+    ImGui::InputFloat("##GenerateMaxConcavity", &generateMaxConcavity, 0.1f, 1.0f, "%.2f");
+    generateMaxConcavity = std::max(generateMaxConcavity, 0.0f);
+    ImGui::TextUnformatted("Max Vertices Per Hull");
+    ImGui::SliderInt("##GenerateMaxVertices",
+                     &generateMaxVertices,
+                     4,
+                     static_cast<int>(ConvexHull::DEFAULT_MAX_POINTS));
+    ImGui::TextUnformatted("Voxel Resolution");
+    ImGui::SliderInt("##GenerateResolution", &generateResolution, 16, 128);
+    ImGui::PopItemWidth();
+    if (pendingHulls != nullptr)
+    {
+        ImGui::BeginDisabled();
+        ImGui::Button("Generating...", ImVec2(-1, 0));
+        ImGui::EndDisabled();
+    } else if (ImGui::Button("Generate", ImVec2(-1, 0)))
+    {
+        const std::shared_ptr<PendingHulls> pending = std::make_shared<PendingHulls>();
+        pending->model = ModelEditor::modelViewer.GetModel();
+        pending->modelGeneration = ModelEditor::modelViewer.GetModelGeneration();
+        const ConvexDecomposition::Parameters parameters = {
+            .maxHulls = static_cast<size_t>(generateMaxHulls),
+            .maxConcavity = generateMaxConcavity / 100.0f,
+            .maxVerticesPerHull = static_cast<size_t>(generateMaxVertices),
+            .resolution = static_cast<uint32_t>(generateResolution),
+        };
+        SharedMgr::Get().loadPool.Submit([pending, parameters] {
+            pending->generated = pending->model.GenerateHulls(parameters);
+            pending->done.store(true, std::memory_order_release);
+            SDKWindow::Get().RequestRedraw();
+        });
+        pendingHulls = pending;
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Replace every hull with convex parts of LOD 0.\n"
+                          "Parts are split until the space their hulls add is below the max concavity,\n"
+                          "or there are max hulls parts.");
+    }
+}
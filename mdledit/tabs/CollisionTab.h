@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <libassets/asset/ModelAsset.h>
+#include <memory>
+
 class CollisionTab
 {
     public:
@@ -12,7 +17,34 @@ class CollisionTab
         static void Render();
 
     private:
+        /// Hulls that are generated in the background
+        struct PendingHulls
+        {
+                /// Set by the generating thread once model and generated are ready to read
+                std::atomic<bool> done = false;
+                /// A copy of the model to decompose, so the model can be edited while the hulls are generated
+                ModelAsset model{};
+                /// The model generation the copy was taken at
+                size_t modelGeneration = 0;
+                /// The number of hulls generated, 0 if the decomposition failed
+                size_t generated = 0;
+        };
+
+        static inline int generateMaxHulls = 16;
+        /// Percent of the volume of the model's convex hull
+        static inline float generateMaxConcavity = 1.0f;
+        static inline int generateMaxVertices = 32;
+        static inline int generateResolution = 64;
+        static inline std::shared_ptr<PendingHulls> pendingHulls{};
+
         static void RenderCHullUI();
 
+        static void RenderGenerate();
+
+        /**
+         * Replace the hulls with the pending ones if they have finished generating
+         */
+        static void UpdateGenerate();
+
         static void RenderStaticMeshUI();
 };
@@ -3,20 +3,28 @@
 //
 
 #include "LodsTab.h"
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <format>
 #include <game_sdk/DialogFilters.h>
 #include <game_sdk/SDKWindow.h>
+#include <game_sdk/SharedMgr.h>
 #include <imgui.h>
+#include <libassets/asset/ModelAsset.h>
 #include <libassets/type/ModelLod.h>
+#include <libassets/util/MeshOptimizer.h>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <utility>
+#include <vector>
 #include "../ModelEditor.h"
 
 void LodsTab::Render()
 {
+    UpdateGenerate();
     ImGui::Begin("LODs", nullptr, ImGuiWindowFlags_NoCollapse);
     ImGui::PushItemWidth(-1);
     if (ImGui::Button("Add", ImVec2(70, 0)))
@@ -44,6 +52,17 @@ void LodsTab::Render()
             SDKWindow::Get().InfoMessage("LOD distances are valid", "Success");
         }
     }
+    ModelAsset::VertexFormat &vertexFormat = ModelEditor::modelViewer.GetModel().vertexFormat;
+    bool quantized = vertexFormat == ModelAsset::VertexFormat::QUANTIZED;
+    if (ImGui::Checkbox("Quantize Vertices", &quantized))
+    {
+        vertexFormat = quantized ? ModelAsset::VertexFormat::QUANTIZED : ModelAsset::VertexFormat::FLOAT32;
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Store vertices in half the space, with slightly less precise positions, UVs and normals");
+    }
+    RenderGenerate();
 
     const float panelHeight = ImGui::GetContentRegionAvail().y;
     ImGui::BeginChild("ScrollableRegion",
@@ -56,6 +75,14 @@ void LodsTab::Render()
         ModelLod &lod = ModelEditor::modelViewer.GetModel().GetLod(lodIndex);
         const uint32_t tris = std::accumulate(lod.indexCounts.begin(), lod.indexCounts.end(), 0u) / 3u;
         ImGui::TextUnformatted(std::format("{} vertices, {} triangles", lod.vertices.size(), tris).c_str());
+        const MeshOptimizer::VertexCacheStats &stats = GetStats(lodIndex);
+        ImGui::TextUnformatted(std::format("ACMR {:.3f}, ATVR {:.3f}", stats.GetAcmr(), stats.GetAtvr()).c_str());
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Vertices transformed per triangle (0.5 is ideal) and per vertex (1 is ideal),\n"
+                              "with a %u entry post-transform vertex cache",
+                              MeshOptimizer::CACHE_SIZE);
+        }
         ImGui::Dummy(ImVec2(0.0f, 2.0f));
         ImGui::TextUnformatted("Distance");
         ImGui::PushItemWidth(-1);
@@ -67,7 +94,7 @@ void LodsTab::Render()
         }
         ImGui::Dummy(ImVec2(0.0f, 2.0f));
         const ImVec2 space = ImGui::GetContentRegionAvail();
-        const float buttonWidth = (space.x / 4.0f) - 6.0f;
+        const float buttonWidth = (space.x / 5.0f) - 6.0f;
         if (ImGui::Button(std::format("Export##{}", lodIndex).c_str(), ImVec2(buttonWidth, 0)))
         {
             lodToExport = &lod;
@@ -92,6 +119,17 @@ void LodsTab::Render()
                 ModelEditor::modelViewer.SetModel(std::move(model));
             }
         }
+        ImGui::SameLine();
+        if (ImGui::Button(std::format("Optimize##{}", lodIndex).c_str(), ImVec2(buttonWidth, 0)))
+        {
+            ModelAsset model = ModelEditor::modelViewer.GetModel();
+            model.GetLod(lodIndex).Optimize();
+            ModelEditor::modelViewer.SetModel(std::move(model));
+        }
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("Reorder triangles and vertices to draw faster.\nNew LODs are optimized on import.");
+        }
         if (ModelEditor::modelViewer.GetModel().GetLodCount() != 1)
         {
             ImGui::SameLine();
@@ -107,6 +145,96 @@ void LodsTab::Render()
     ImGui::End();
 }
 
+const MeshOptimizer::VertexCacheStats &LodsTab::GetStats(const size_t lodIndex)
+{
+    // Every change to the LODs ends in the model being set or reloaded
+    if (lodStatsGeneration != ModelEditor::modelViewer.GetModelGeneration())
+    {
+        lodStats.clear();
+        lodStatsGeneration = ModelEditor::modelViewer.GetModelGeneration();
+    }
+    while (lodStats.size() <= lodIndex)
+    {
+        lodStats.push_back(ModelEditor::modelViewer.GetModel().GetLod(lodStats.size()).AnalyzeVertexCache());
+    }
+    return lodStats.at(lodIndex);
+}
+
+void LodsTab::RenderGenerate()
+{
+    if (!ImGui::CollapsingHeader("Generate LODs"))
+    {
+        return;
+    }
+    ImGui::PushItemWidth(-1);
+    ImGui::TextUnformatted("LOD Count");
+    ImGui::SliderInt("##GenerateCount", &generateCount, 1, 8);
+    ImGui::TextUnformatted("Triangles Kept Per LOD");
+    ImGui::SliderFloat("##GenerateRatio", &generateRatio, 0.05f, 0.95f, "%.2f");
+    ImGui::TextUnformatted("Max Error (% of model size)");
+    ImGui::InputFloat("##GenerateMaxError", &generateMaxError, 0.1f, 1.0f, "%.2f");
+    generateMaxError = std::max(generateMaxError, 0.0f);
+    ImGui::PopItemWidth();
+    if (pendingLods != nullptr)
+    {
+        ImGui::BeginDisabled();
+        ImGui::Button("Generating...", ImVec2(-1, 0));
+        ImGui::EndDisabled();
+    } else if (ImGui::Button("Generate", ImVec2(-1, 0)))
+    {
+        const std::shared_ptr<PendingLods> pending = std::make_shared<PendingLods>();
+        pending->model = ModelEditor::modelViewer.GetModel();
+        pending->modelGeneration = ModelEditor::modelViewer.GetModelGeneration();
+        float ratio = 1.0f;
+        for (int i = 0; i < generateCount; i++)
+        {
+            ratio *= generateRatio;
+            pending->steps.push_back({
+                .ratio = ratio,
+                .maxError = generateMaxError / 100.0f,
+            });
+        }
+        SharedMgr::Get().loadPool.Submit([pending] {
+            pending->lods = pending->model.SimplifyLods(pending->steps);
+            pending->done.store(true, std::memory_order_release);
+            SDKWindow::Get().RequestRedraw();
+        });
+        pendingLods = pending;
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Replace every LOD after LOD 0 with simplified versions of it.\n"
+                          "UV seams, borders and edges between materials are kept in place.");
+    }
+}
+
+void LodsTab::UpdateGenerate()
+{
+    if (pendingLods == nullptr || !pendingLods->done.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    const std::shared_ptr<PendingLods> pending = std::move(pendingLods);
+    pendingLods = nullptr;
+    if (pending->modelGeneration != ModelEditor::modelViewer.GetModelGeneration())
+    {
+        SDKWindow::Get().WarningMessage("The model changed while the LODs were being generated, generate them again");
+        return;
+    }
+    const size_t generated = pending->lods.size();
+    ModelEditor::modelViewer.GetModel().ReplaceGeneratedLods(std::move(pending->lods));
+    ModelEditor::modelViewer.lodIndex = 0;
+    ModelEditor::modelViewer.ReloadModel();
+    if (generated < pending->steps.size())
+    {
+        SDKWindow::Get().InfoMessage(std::format("Generated {} of {} LODs, the rest can't be simplified further "
+                                                 "within the max error",
+                                                 generated,
+                                                 pending->steps.size()),
+                                     "Generate LODs");
+    }
+}
+
 void LodsTab::SaveLodCallback(const std::string &path)
 {
     lodToExport->Export(path.c_str());
@@ -4,8 +4,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <libassets/asset/ModelAsset.h>
 #include <libassets/type/ModelLod.h>
+#include <libassets/util/MeshOptimizer.h>
+#include <memory>
 #include <string>
+#include <vector>
 
 class LodsTab
 {
@@ -15,7 +21,39 @@ class LodsTab
         static void Render();
 
     private:
+        /// LODs that are generated in the background
+        struct PendingLods
+        {
+                /// Set by the generating thread once lods is ready to read
+                std::atomic<bool> done = false;
+                /// A copy of the model to simplify, so the model can be edited while the LODs are generated
+                ModelAsset model{};
+                /// The model generation the copy was taken at
+                size_t modelGeneration = 0;
+                std::vector<ModelAsset::LodGenerationStep> steps{};
+                std::vector<ModelLod> lods{};
+        };
+
         static inline ModelLod *lodToExport = nullptr;
+        /// Vertex cache stats of each LOD, kept until the model viewer reloads the model
+        static inline std::vector<MeshOptimizer::VertexCacheStats> lodStats{};
+        /// The model generation lodStats belongs to
+        static inline size_t lodStatsGeneration = 0;
+
+        static inline int generateCount = 3;
+        static inline float generateRatio = 0.5f;
+        /// Percent of the model size
+        static inline float generateMaxError = 1.0f;
+        static inline std::shared_ptr<PendingLods> pendingLods{};
+
+        static void RenderGenerate();
+
+        /**
+         * Replace the LODs with the pending ones if they have finished generating
+         */
+        static void UpdateGenerate();
+
+        static const MeshOptimizer::VertexCacheStats &GetStats(size_t lodIndex);
 
         static void SaveLodCallback(const std::string &path);
 };
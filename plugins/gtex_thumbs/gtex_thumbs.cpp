@@ -3,6 +3,7 @@
 //
 
 #include "gtex_thumbs.h"
+#include <algorithm>
 #include <cstdint>
 #include <kio/thumbnailcreator.h>
 #include <KPluginFactory>
@@ -10,7 +11,6 @@
 #include <libassets/util/Error.h>
 #include <QFile>
 #include <QImage>
-#include <vector>
 
 K_PLUGIN_CLASS_WITH_JSON(gtex_thumbs, "gtex_thumbs.json")
 
@@ -24,16 +24,21 @@ KIO::ThumbnailResult gtex_thumbs::create(const KIO::ThumbnailRequest &request)
         return KIO::ThumbnailResult::fail();
     }
     TextureAsset t;
-    const Error::ErrorCode e = TextureAsset::CreateFromAsset(request.url().toLocalFile().toUtf8().data(), t);
-    if (e != Error::ErrorCode::OK)
+    Error::ErrorCode e = t.LoadFromAsset(request.url().toLocalFile().toUtf8().data());
+    if (e == Error::ErrorCode::OK)
+    {
+        e = t.Decompress();
+    }
+    if (e != Error::ErrorCode::OK || t.GetFormat() != TextureAsset::PixelFormat::RGBA8)
     {
         return KIO::ThumbnailResult::fail();
     }
-    std::vector<uint32_t> pixels;
-    t.GetPixelsRGBA(pixels);
-    const QImage texture = QImage(reinterpret_cast<const uint8_t *>(pixels.data()),
-                                  static_cast<int>(t.GetWidth()),
-                                  static_cast<int>(t.GetHeight()),
+    // Read the smallest stored mip level that still fills the thumbnail instead of scaling down the full image
+    const int targetSize = std::max(request.targetSize().width(), request.targetSize().height());
+    const uint32_t level = t.GetLevelForSize(static_cast<uint32_t>(std::max(targetSize, 1)));
+    const QImage texture = QImage(t.GetLevelPixels(level),
+                                  static_cast<int>(t.GetLevelWidth(level)),
+                                  static_cast<int>(t.GetLevelHeight(level)),
                                   QImage::Format_RGBA8888)
                                    .convertToFormat(QImage::Format_ARGB32_Premultiplied);
     if (texture.isNull())
@@ -119,6 +119,11 @@ static void Render()
         const float cursor = sound.GetCursor();
         const bool isPlaying = sound.IsPlaying();
         bool isLooping = sound.IsLooping();
+        if (isPlaying)
+        {
+            // Keep the seek bar moving
+            SDKWindow::Get().RequestRedraw();
+        }
 
         ImGui::SeparatorText("Sound Player");
 
@@ -1,4 +1,8 @@
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <filesystem>
 #include <format>
 #include <game_sdk/DesktopInterface.h>
 #include <game_sdk/DialogFilters.h>
@@ -8,22 +12,49 @@
 #include <GL/glew.h>
 #include <imgui.h>
 #include <libassets/asset/TextureAsset.h>
+#include <libassets/util/BlockCompressor.h>
 #include <libassets/util/Error.h>
+#include <memory>
 #include <string>
+#include <system_error>
 #include <vector>
 
 static float zoom = 1.0f;
 static ImVec2 pan = {0, 0};
 
 static TextureAsset texture{};
+/// The texture before compression, so changing the compression settings doesn't compound the loss
+static TextureAsset sourceTexture{};
 static bool textureLoaded = false;
 static GLuint glTexture;
 
 static bool showTransparencyCheckerboard = true;
 
+/// Progress of converting a folder of images, shared with the import tasks
+struct FolderImport
+{
+        std::atomic<size_t> finishedCount = 0;
+        std::atomic<size_t> failedCount = 0;
+        size_t totalCount = 0;
+};
+static std::shared_ptr<FolderImport> folderImport = nullptr;
+
 constexpr const char *CHECKERBOARD_ICON_NAME = "editor/checkerboard";
 static ImTextureID checkerboardTexture;
 
+constexpr std::array<TextureAsset::PixelFormat, 8> PIXEL_FORMATS = {
+    TextureAsset::PixelFormat::RGBA8,
+    TextureAsset::PixelFormat::BC1,
+    TextureAsset::PixelFormat::BC3,
+    TextureAsset::PixelFormat::BC4,
+    TextureAsset::PixelFormat::BC5,
+    TextureAsset::PixelFormat::BC7,
+    TextureAsset::PixelFormat::RGBAF16,
+    TextureAsset::PixelFormat::BC6H,
+};
+constexpr std::array<const char *, 3> COMPRESSION_QUALITY_NAMES = {"Fast", "Normal", "Best"};
+static BlockCompressor::Quality compressionQuality = BlockCompressor::Quality::NORMAL;
+
 constexpr float MIN_ZOOM = 0.1f;
 constexpr float MAX_ZOOM = 10.0f;
 
@@ -45,9 +76,61 @@ static void LoadTexture()
     textureLoaded = true;
 }
 
+static const char *GetFormatName(const TextureAsset::PixelFormat format)
+{
+    switch (format)
+    {
+        case TextureAsset::PixelFormat::RGBA8:
+            return "RGBA8 (SDR)";
+        case TextureAsset::PixelFormat::RGBAF16:
+            return "RGBA16F (HDR)";
+        case TextureAsset::PixelFormat::BC1:
+            return "BC1 (RGB, 1-bit A)";
+        case TextureAsset::PixelFormat::BC3:
+            return "BC3 (RGBA)";
+        case TextureAsset::PixelFormat::BC4:
+            return "BC4 (Grayscale)";
+        case TextureAsset::PixelFormat::BC5:
+            return "BC5 (RG)";
+        case TextureAsset::PixelFormat::BC7:
+            return "BC7 (RGBA)";
+        case TextureAsset::PixelFormat::BC6H:
+            return "BC6H (HDR)";
+    }
+    return "Unknown";
+}
+
+/// Rebuild the texture from the source texture in the given format, keeping the current settings
+static void ApplyFormat(const TextureAsset::PixelFormat format)
+{
+    sourceTexture.filter = texture.filter;
+    sourceTexture.repeat = texture.repeat;
+    sourceTexture.mipmaps = texture.mipmaps;
+    if (sourceTexture.mipmaps && sourceTexture.GetLevelCount() == 1)
+    {
+        sourceTexture.GenerateMipmaps();
+    }
+    texture = sourceTexture;
+    if (TextureAsset::IsCompressedFormat(format))
+    {
+        const Error::ErrorCode errorCode = texture.Compress(format, compressionQuality);
+        if (errorCode != Error::ErrorCode::OK)
+        {
+            SDKWindow::Get().ErrorMessage(std::format("Failed to compress the texture!\n{}", errorCode));
+            texture = sourceTexture;
+        }
+    }
+    LoadTexture();
+}
+
 static void OpenGtex(const std::string &path)
 {
-    const Error::ErrorCode errorCode = texture.LoadFromAsset(path);
+    Error::ErrorCode errorCode = texture.LoadFromAsset(path);
+    if (errorCode == Error::ErrorCode::OK)
+    {
+        sourceTexture = texture;
+        errorCode = sourceTexture.Decompress();
+    }
     if (errorCode != Error::ErrorCode::OK)
     {
         SDKWindow::Get().ErrorMessage(std::format("Failed to open the texture!\n{}", errorCode));
@@ -64,9 +147,84 @@ static void ImportImage(const std::string &path)
         SDKWindow::Get().ErrorMessage(std::format("Failed to import the texture!\n{}", errorCode));
         return;
     }
+    sourceTexture = texture;
     LoadTexture();
 }
 
+/// Convert every image in a folder and its subfolders to a gtex next to it, in parallel
+static void ImportFolder(const std::string &path)
+{
+    if (folderImport != nullptr)
+    {
+        return;
+    }
+    std::vector<std::filesystem::path> imagePaths{};
+    std::error_code error{};
+    for (std::filesystem::recursive_directory_iterator
+                 iterator(path, std::filesystem::directory_options::skip_permission_denied, error);
+         !error && iterator != std::filesystem::recursive_directory_iterator();
+         iterator.increment(error))
+    {
+        const std::string extension = iterator->path().extension().string();
+        if (iterator->is_regular_file() && (extension == ".png" || extension == ".exr"))
+        {
+            imagePaths.push_back(iterator->path());
+        }
+    }
+    if (imagePaths.empty())
+    {
+        SDKWindow::Get().WarningMessage("The folder doesn't contain any PNG or EXR images.");
+        return;
+    }
+
+    const std::shared_ptr<FolderImport> import = std::make_shared<FolderImport>();
+    import->totalCount = imagePaths.size();
+    for (const std::filesystem::path &imagePath: imagePaths)
+    {
+        SharedMgr::Get().loadPool.Submit([import, imagePath] {
+            std::filesystem::path outputPath = imagePath;
+            outputPath.replace_extension(".gtex");
+            TextureAsset asset{};
+            if (asset.Import(imagePath.string()) != Error::ErrorCode::OK ||
+                asset.SaveToAsset(outputPath.string()) != Error::ErrorCode::OK)
+            {
+                import->failedCount++;
+            }
+            import->finishedCount++;
+            SDKWindow::Get().RequestRedraw();
+        });
+    }
+    folderImport = import;
+}
+
+static void RenderFolderImportProgress()
+{
+    if (folderImport == nullptr)
+    {
+        return;
+    }
+    const size_t finishedCount = folderImport->finishedCount;
+    if (finishedCount < folderImport->totalCount)
+    {
+        ImGui::ProgressBar(static_cast<float>(finishedCount) / static_cast<float>(folderImport->totalCount),
+                           ImVec2(-1, 0),
+                           std::format("Importing folder: {}/{}", finishedCount, folderImport->totalCount).c_str());
+        return;
+    }
+    const size_t failedCount = folderImport->failedCount;
+    if (failedCount == 0)
+    {
+        SDKWindow::Get().InfoMessage(std::format("Imported {} images.", finishedCount), "Import Folder");
+    } else
+    {
+        SDKWindow::Get().WarningMessage(std::format("Imported {} of {} images. {} could not be converted.",
+                                                    finishedCount - failedCount,
+                                                    finishedCount,
+                                                    failedCount));
+    }
+    folderImport = nullptr;
+}
+
 static void SaveGtex(const std::string &path)
 {
     const Error::ErrorCode errorCode = texture.SaveToAsset(path);
@@ -122,6 +280,10 @@ static void Render()
         {
             openPressed |= ImGui::MenuItem("Open", "Ctrl+O");
             importPressed |= ImGui::MenuItem("Import", "Ctrl+Shift+O");
+            if (ImGui::MenuItem("Import Folder...", "", false, folderImport == nullptr))
+            {
+                SDKWindow::Get().OpenFolderDialog(ImportFolder);
+            }
             savePressed |= ImGui::MenuItem("Save", "Ctrl+S", false, textureLoaded);
             exportPressed |= ImGui::MenuItem("Export", "Ctrl+Shift+S", false, textureLoaded);
             ImGui::Separator();
@@ -160,12 +322,12 @@ static void Render()
         SDKWindow::Get().SaveFileDialog(SaveGtex, DialogFilters::GTEX_FILTERS);
     } else if (exportPressed)
     {
-        if (texture.GetFormat() == TextureAsset::PixelFormat::RGBA8)
+        if (TextureAsset::IsHdrFormat(texture.GetFormat()))
         {
-            SDKWindow::Get().SaveFileDialog(Export, DialogFilters::PNG_FILTERS);
+            SDKWindow::Get().SaveFileDialog(Export, DialogFilters::EXR_FILTERS);
         } else
         {
-            SDKWindow::Get().SaveFileDialog(Export, DialogFilters::EXR_FILTERS);
+            SDKWindow::Get().SaveFileDialog(Export, DialogFilters::PNG_FILTERS);
         }
     } else if (zoomInPressed)
     {
@@ -180,6 +342,8 @@ static void Render()
         zoom = 1.0f;
     }
 
+    RenderFolderImportProgress();
+
     if (textureLoaded)
     {
         zoom += ImGui::GetIO().MouseWheel * 0.1f;
@@ -224,13 +388,13 @@ static void Render()
 
         ImGui::BeginChild("StatsPane", ImVec2(STATS_WIDTH, availableSize.y));
         {
-            ImGui::TextUnformatted(std::format("Width: {}px\nHeight: {}px\nMemory: {} bytes\nFormat: {}",
+            ImGui::TextUnformatted(std::format("Width: {}px\nHeight: {}px\nMip Levels: {}\nMemory: {} bytes\n"
+                                               "Format: {}",
                                                texture.GetWidth(),
                                                texture.GetHeight(),
+                                               texture.GetLevelCount(),
                                                texture.GetPixelDataSize(),
-                                               texture.GetFormat() == TextureAsset::PixelFormat::RGBA8
-                                                       ? "RGBA8 (SDR)"
-                                                       : "RGBA16F (HDR)")
+                                               GetFormatName(texture.GetFormat()))
                                            .c_str());
 
             ImGui::Separator();
@@ -244,7 +408,41 @@ static void Render()
             }
             if (ImGui::Checkbox("Mipmaps", &texture.mipmaps))
             {
-                LoadTexture();
+                // Compressed levels can't be generated from each other, so rebuild from the source texture
+                ApplyFormat(texture.GetFormat());
+            }
+
+            ImGui::Separator();
+            ImGui::TextUnformatted("Format");
+            ImGui::SetNextItemWidth(-1);
+            if (ImGui::BeginCombo("##Format", GetFormatName(texture.GetFormat())))
+            {
+                for (const TextureAsset::PixelFormat format: PIXEL_FORMATS)
+                {
+                    if (TextureAsset::IsHdrFormat(format) != TextureAsset::IsHdrFormat(sourceTexture.GetFormat()))
+                    {
+                        continue;
+                    }
+                    if (ImGui::Selectable(GetFormatName(format), format == texture.GetFormat()))
+                    {
+                        ApplyFormat(format);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            ImGui::TextUnformatted("Compression Quality");
+            ImGui::SetNextItemWidth(-1);
+            int quality = static_cast<int>(compressionQuality);
+            if (ImGui::Combo("##CompressionQuality",
+                             &quality,
+                             COMPRESSION_QUALITY_NAMES.data(),
+                             static_cast<int>(COMPRESSION_QUALITY_NAMES.size())))
+            {
+                compressionQuality = static_cast<BlockCompressor::Quality>(quality);
+                if (TextureAsset::IsCompressedFormat(texture.GetFormat()))
+                {
+                    ApplyFormat(texture.GetFormat());
+                }
             }
         }
         ImGui::EndChild();